@@ -80,3 +80,9 @@ distclean::     distclean-$(MODNAME)
 
 # Optimize dictionary with stl containers.
 $(HISTDO): NOOPT = $(OPT)
+
+# for openMP (parallel merge of histograms with identical binning in TH1)
+ifneq ($(USE_OPENMP),)
+$(call stripsrc,$(HISTDIRS)/TH1.o): CXXFLAGS += -fopenmp
+$(HISTLIB): LDFLAGS += -fopenmp
+endif
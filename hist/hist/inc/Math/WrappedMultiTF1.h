@@ -124,6 +124,11 @@ private:
       return fFunc->EvalPar(x,p); 
    }
 
+   /// evaluate function on a set of points (vectorized for some of the TF1 built-in functions)
+   void DoEvalParVec (unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      fFunc->EvalParVec(n,x,stride,f,p); 
+   }
+
    /// evaluate the partial derivative with respect to the parameter
    double DoParameterDerivative(const double * x, const double * p, unsigned int ipar) const; 
 
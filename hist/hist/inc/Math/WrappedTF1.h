@@ -127,6 +127,11 @@ private:
       return fFunc->EvalPar(fX,p); 
    }
 
+   /// evaluate function on a set of points (vectorized for some of the TF1 built-in functions)
+   void DoEvalParVec (unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      fFunc->EvalParVec(n,x,stride,f,p); 
+   }
+
    /// evaluate function using the cached parameter values of this class (not of TF1)
    /// re-implement for better efficiency
    double DoEval (double x) const { 
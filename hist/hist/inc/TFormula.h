@@ -67,6 +67,7 @@ class TFormula : public TNamed {
 protected:
 
    typedef Double_t (TObject::*TFuncG)(const Double_t*,const Double_t*) const;
+   typedef Double_t (*TFuncCompiled)(const Double_t*,const Double_t*);
 
    Int_t      fNdim;            //Dimension of function (1=1-Dim, 2=2-Dim,etc)
    Int_t      fNpar;            //Number of parameters
@@ -94,6 +95,10 @@ protected:
    TOperOffset         *fOperOffset;     //![fNOperOptimized]         Offsets of operrands
    TFormulaPrimitive  **fPredefined;      //![fNPar] predefined function  
    TFuncG               fOptimal; //!pointer to optimal function
+   TFuncCompiled        fCompiled; //!pointer to the natively compiled function (see CompileNative)
+
+   static Bool_t        fgNativeCompilation; //if true, formulae are compiled natively after optimization
+   static TString       fgNativeCacheDir;    //directory where the generated code is cached
 
    Int_t             PreCompile();
    virtual Bool_t    CheckOperands(Int_t operation, Int_t &err);
@@ -124,6 +129,7 @@ protected:
    //
    // Functions  - used for formula evaluation
    Double_t        EvalParFast(const Double_t *x, const Double_t *params);
+   Double_t        EvalParCompiled(const Double_t *x, const Double_t *params);
    Double_t        EvalPrimitive(const Double_t *x, const Double_t *params);
    Double_t        EvalPrimitive0(const Double_t *x, const Double_t *params);
    Double_t        EvalPrimitive1(const Double_t *x, const Double_t *params);
@@ -225,6 +231,7 @@ public:
    virtual void        Analyze(const char *schain, Int_t &err, Int_t offset=0);
    virtual Bool_t      AnalyzeFunction(TString &chaine, Int_t &err, Int_t offset=0);
    virtual Int_t       Compile(const char *expression="");
+   Bool_t              CompileNative(Option_t *option="");
    virtual void        Copy(TObject &formula) const;
    virtual void        Clear(Option_t *option="");
    virtual char       *DefinedString(Int_t code);
@@ -233,6 +240,7 @@ public:
    virtual Double_t    Eval(Double_t x, Double_t y=0, Double_t z=0, Double_t t=0) const;
    virtual Double_t    EvalParOld(const Double_t *x, const Double_t *params=0);
    virtual Double_t    EvalPar(const Double_t *x, const Double_t *params=0){return ((*this).*fOptimal)(x,params);};
+   Bool_t              GenerateCode(TString &code, const char *funcname) const;
    virtual const TObject *GetLinearPart(Int_t i);
    virtual Int_t       GetNdim() const {return fNdim;}
    virtual Int_t       GetNpar() const {return fNpar;}
@@ -244,6 +252,7 @@ public:
    virtual void        GetParameters(Double_t *params){for(Int_t i=0;i<fNpar;i++) params[i] = fParams[i];}
    virtual const char *GetParName(Int_t ipar) const;
    virtual Int_t       GetParNumber(const char *name) const;
+   Bool_t              IsCompiledNative() const {return fCompiled != 0;}
    virtual Bool_t      IsLinear() {return TestBit(kLinear);}
    virtual Bool_t      IsNormalized() {return TestBit(kNormalized);}
    virtual void        Print(Option_t *option="") const; // *MENU*
@@ -263,6 +272,7 @@ public:
    virtual void        Update() {;}
 
    static  void        SetMaxima(Int_t maxop=1000, Int_t maxpar=1000, Int_t maxconst=1000);
+   static  void        SetNativeCompilation(Bool_t on=kTRUE, const char *cachedir=0);
    
    ClassDef(TFormula,8)  //The formula base class  f(x,y,z,par)
 };
@@ -137,6 +137,9 @@ protected:
    virtual void     SavePrimitiveHelp(ostream &out, const char *hname, Option_t *option = "");
    static Bool_t    RecomputeAxisLimits(TAxis& destAxis, const TAxis& anAxis);
    static Bool_t    SameLimitsAndNBins(const TAxis& axis1, const TAxis& axis2);
+   static Bool_t    SameBinning(const TH1 *h1, const TH1 *h2);
+   static Bool_t    AddArrays(TArray *dest, const TArray **src, Int_t nsrc);
+   Bool_t           MergeSameBinning(TCollection *list, Long64_t &nentries);
 
    virtual Double_t DoIntegral(Int_t ix1, Int_t ix2, Int_t iy1, Int_t iy2, Int_t iz1, Int_t iz2, Double_t & err, 
                                Option_t * opt, Bool_t doerr = kFALSE) const;
@@ -76,6 +76,7 @@ class THnSparse: public THnBase {
    void FillExMap();
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
+   Bool_t AddSameBinning(const THnBase* h);
    void FillBin(Long64_t bin, Double_t w) {
       // Increment the bin content of "bin" by "w",
       // return the bin index.
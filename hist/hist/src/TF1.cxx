@@ -27,6 +27,7 @@
 #include "TF1Helper.h"
 #include "Math/WrappedFunction.h"
 #include "Math/WrappedTF1.h"
+#include "Math/FastMath.h"
 #include "Math/BrentRootFinder.h"
 #include "Math/BrentMinimizer1D.h"
 #include "Math/BrentMethods.h"
@@ -70,8 +71,10 @@ public:
 
 // class wrapping function evaluation directly in 1D interface (used for integration) 
 // and implementing the methods for the momentum calculations
+// It implements the parametric interface so that the integrators can evaluate
+// the function on a set of points with TF1::EvalParVec
 
-class  TF1_EvalWrapper : public ROOT::Math::IGenFunction { 
+class  TF1_EvalWrapper : public ROOT::Math::IParamFunction { 
 public: 
    TF1_EvalWrapper(TF1 * f, const Double_t * par, bool useAbsVal, Double_t n = 1, Double_t x0 = 0) : 
       fFunc(f), 
@@ -96,6 +99,29 @@ public:
       if (fAbsVal && fval < 0)  return -fval;
       return fval; 
    } 
+   // parametric interface (parameters are not copied)
+   const double * Parameters() const { return fPar; }
+   void SetParameters(const double * p) { fPar = p; }
+   unsigned int NPar() const { return fFunc->GetNpar(); }
+   Double_t DoEvalPar( Double_t x, const Double_t * p) const { 
+      fX[0] = x; 
+      Double_t fval = fFunc->EvalPar( fX, p);
+      if (fAbsVal && fval < 0)  return -fval;
+      return fval; 
+   }
+   // evaluate |f(x)| on n points
+   void DoEvalParVec(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      if (fFunc->GetMethodCall() ) { 
+         // interpreted functions use the argument address set in the constructor
+         for (unsigned int i = 0; i < n; ++i) f[i] = DoEvalPar(x[i*stride], p); 
+         return;
+      }
+      fFunc->EvalParVec(n, x, stride, f, p);
+      if (fAbsVal) { 
+         for (unsigned int i = 0; i < n; ++i) 
+            if (f[i] < 0) f[i] = -f[i];
+      }
+   }
    // evaluate x * |f(x)|
    Double_t EvalFirstMom( Double_t x) { 
       fX[0] = x; 
@@ -1562,6 +1588,88 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
 }
 
 
+//______________________________________________________________________________
+void TF1::EvalParVec(Int_t n, const Double_t *x, Int_t stride, Double_t *f, const Double_t *params)
+{
+   // Evaluate function at n points with given parameters.
+   //
+   // The coordinates of the i-th point are x[i*stride], x[i*stride+1],...
+   // (for n contiguous points of a 1-D function use stride=1) and its value is
+   // stored in f[i]. The array f must have at least n elements.
+   // If argument params is omitted or equal 0, the internal values
+   // of parameters (array fParams) will be used instead.
+   //
+   // For the 1-D built-in functions gaus, gausn, expo, polN, landau and landaun
+   // all the points are computed in a single loop which can be vectorized by the
+   // compiler, using for the exponential ROOT::Math::fast_exp. The result can
+   // therefore differ from EvalPar in the last bits. This is only done when the
+   // formula is the built-in function alone (a single operator), for all the
+   // other functions, e.g. "2*landau" or "gaus+pol0", EvalPar is called for
+   // each point (with InitArgs in case of interpreted functions).
+
+   if (n <= 0) return;
+   fgCurrent = this;
+   const Double_t *p = (params) ? params : fParams;
+
+   if (fType == 0 && fNdim == 1 && fNoper == 1) {
+      const Int_t action = GetAction(0);
+      const Int_t param = GetActionParam(0);
+      // gaus and gausn
+      if (action == kxgaus) {
+         const Double_t *pg = p + param;
+         const Double_t sigma = pg[2];
+         if (sigma == 0) {
+            for (Int_t i = 0; i < n; ++i) f[i] = pg[0]*1.e30;
+            return;
+         }
+         const Double_t mean = pg[1];
+         const Double_t invSigma = 1./sigma;
+         const Double_t a = (IsNormalized()) ? pg[0]/(2.50662827463100024*sigma) : pg[0];
+         for (Int_t i = 0; i < n; ++i) {
+            Double_t arg = (x[i*stride] - mean)*invSigma;
+            f[i] = a*ROOT::Math::fast_exp(-0.5*arg*arg);
+         }
+         return;
+      }
+      // expo
+      if (action == kxexpo) {
+         const Double_t p0 = p[param];
+         const Double_t p1 = p[param+1];
+         for (Int_t i = 0; i < n; ++i)
+            f[i] = ROOT::Math::fast_exp(p0 + p1*x[i*stride]);
+         return;
+      }
+      // polN, evaluated with the Horner scheme (the parameter code is 
+      // 100*degree + first parameter + 1)
+      if (action == kxpol) {
+         const Int_t degree = param/100;
+         const Double_t *pp = p + (param - degree*100 - 1);
+         for (Int_t i = 0; i < n; ++i) {
+            Double_t xx = x[i*stride];
+            Double_t r = pp[degree];
+            for (Int_t j = degree-1; j >= 0; --j) r = r*xx + pp[j];
+            f[i] = r;
+         }
+         return;
+      }
+      // landau and landaun
+      if (action == kxlandau) {
+         const Double_t *pl = p + param;
+         Bool_t norm = IsNormalized();
+         for (Int_t i = 0; i < n; ++i)
+            f[i] = pl[0]*TMath::Landau(x[i*stride],pl[1],pl[2],norm);
+         return;
+      }
+   }
+
+   for (Int_t i = 0; i < n; ++i) {
+      const Double_t *xi = x + i*stride;
+      if (fMethodCall) InitArgs(xi,p);
+      f[i] = EvalPar(xi,p);
+   }
+}
+
+
 //______________________________________________________________________________
 void TF1::ExecuteEvent(Int_t event, Int_t px, Int_t py)
 {
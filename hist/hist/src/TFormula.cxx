@@ -22,6 +22,8 @@
 #include "TObjString.h"
 #include "TError.h"
 #include "TFormulaPrimitive.h"
+#include "TSystem.h"
+#include "TMD5.h"
 
 #ifdef WIN32
 #pragma optimize("",off)
@@ -31,6 +33,9 @@ static Int_t gMAXOP=1000,gMAXPAR=1000,gMAXCONST=1000;
 const Int_t  gMAXSTRINGFOUND = 10;
 const UInt_t kOptimizationError = BIT(19);
 
+Bool_t  TFormula::fgNativeCompilation = kFALSE;
+TString TFormula::fgNativeCacheDir;
+
 ClassImp(TFormula)
 
 //______________________________________________________________________________
@@ -149,6 +154,7 @@ TFormula::TFormula(): TNamed()
    fOperOffset     = 0;
    fPredefined     = 0;
    fOptimal        = (TFormulaPrimitive::TFuncG)&TFormula::EvalParOld;
+   fCompiled       = 0;
 }
 
 //______________________________________________________________________________
@@ -178,6 +184,7 @@ TFormula::TFormula(const char *name,const char *expression) :
    fOperOffset     = 0;
    fPredefined     = 0;
    fOptimal        = (TFormulaPrimitive::TFuncG)&TFormula::EvalParOld;
+   fCompiled       = 0;
 
    if (!expression || !*expression) {
       Error("TFormula", "expression may not be 0 or have 0 length");
@@ -266,6 +273,7 @@ TFormula::TFormula(const TFormula &formula) : TNamed()
    fOperOffset     = 0;
    fExprOptimized  = 0;
    fOperOptimized  = 0;
+   fCompiled       = 0;
 
    ((TFormula&)formula).TFormula::Copy(*this);
 }
@@ -2207,6 +2215,8 @@ void TFormula::ClearFormula(Option_t * /*option*/ )
    if (fOperOffset)    { delete [] fOperOffset;    fOperOffset    = 0;}
    if (fExprOptimized) { delete [] fExprOptimized; fExprOptimized = 0;}
    if (fOperOptimized) { delete [] fOperOptimized; fOperOptimized = 0;}
+   fCompiled = 0;
+   fOptimal  = (TFormulaPrimitive::TFuncG)&TFormula::EvalParOld;
    // should we also remove the object from the list?
    // gROOT->GetListOfFunctions()->Remove(this);
    // if we don't, what happens if it fails the new compilation?
@@ -2463,6 +2473,7 @@ void TFormula::Copy(TObject &obj) const
    }
    ((TFormula&)obj).fNOperOptimized = fNOperOptimized;
    ((TFormula&)obj).fOptimal = fOptimal;
+   ((TFormula&)obj).fCompiled = fCompiled;
 
 }
 
@@ -4019,6 +4030,8 @@ void TFormula::Optimize()
          case kFDM    : {fOptimal= (TFormulaPrimitive::TFuncG)&TFormula::EvalPrimitive4; break;}
       }
    }
+   fCompiled = 0;
+   if (fgNativeCompilation) CompileNative();
 
    delete [] map1;
    delete [] map0;
@@ -4445,6 +4458,285 @@ Int_t TFormula::PreCompile()
 }
 
 
+//______________________________________________________________________________
+Double_t TFormula::EvalParCompiled(const Double_t *x, const Double_t *uparams)
+{
+   // Evaluate this formula with the natively compiled function (see CompileNative)
+
+   return (*fCompiled)(x, (uparams) ? uparams : fParams);
+}
+
+
+//______________________________________________________________________________
+Bool_t TFormula::GenerateCode(TString &code, const char *funcname) const
+{
+   // Translate the list of operators of this formula in the C++ code of
+   // a function with signature:
+   //
+   //    extern "C" Double_t funcname(const Double_t *x, const Double_t *p)
+   //
+   // computing the same value as EvalPar(x,p). The stack of the interpreter is
+   // replaced by local variables and the jumps by goto statements, so that the
+   // generated code can be fully optimized by the compiler.
+   // Return kFALSE (and an empty code) if the formula contains operators which
+   // cannot be translated (calls to interpreted functions, strings, variables
+   // defined by derived classes like TTreeFormula).
+
+   code = "";
+   if (fNoper <= 0 || !fOper) return kFALSE;
+
+   TString body;
+   Int_t *posAt = new Int_t[fNoper+1];   // stack position at the jump targets
+   for (Int_t i = 0; i <= fNoper; ++i) posAt[i] = -1;
+   Int_t pos = 0, maxpos = 0;
+   Bool_t reachable = kTRUE;
+   Bool_t ok = kTRUE;
+   const char *norm = (((TFormula*)this)->IsNormalized()) ? "kTRUE" : "kFALSE";
+
+   for (Int_t i = 0; i < fNoper && ok; ++i) {
+
+      // reconcile the stack position with the jumps to this operator
+      if (posAt[i] >= 0) {
+         if (reachable && pos != posAt[i]) { ok = kFALSE; break; }
+         pos = posAt[i];
+         reachable = kTRUE;
+         body += Form("L%d:\n",i);
+      } else if (!reachable) { ok = kFALSE; break; }
+
+      const Int_t oper   = fOper[i];
+      const Int_t opcode = oper >> kTFOperShift;
+      const Int_t param  = oper & kTFOperMask;
+      const Int_t p1 = pos-1, p2 = pos-2;
+
+      switch(opcode) {
+
+         case kParameter : body += Form("   t%d = p[%d];\n",pos,param); pos++; break;
+         case kConstant  : {
+            if (!TMath::Finite(fConst[param])) { ok = kFALSE; break; }
+            body += Form("   t%d = %.17g;\n",pos,fConst[param]); pos++; break;
+         }
+         case kVariable  : body += Form("   t%d = x[%d];\n",pos,param); pos++; break;
+         case kpi        : body += Form("   t%d = TMath::Pi();\n",pos); pos++; break;
+         case krndm      : body += Form("   t%d = gRandom->Rndm(1);\n",pos); pos++; break;
+
+         case kAdd       : body += Form("   t%d += t%d;\n",p2,p1); pos--; break;
+         case kSubstract : body += Form("   t%d -= t%d;\n",p2,p1); pos--; break;
+         case kMultiply  : body += Form("   t%d *= t%d;\n",p2,p1); pos--; break;
+         case kDivide    : body += Form("   t%d = (t%d == 0) ? 0 : t%d/t%d;\n",p2,p1,p2,p1); pos--; break;
+         case kModulo    : body += Form("   t%d = Double_t(Long64_t(t%d) %% Long64_t(t%d));\n",p2,p2,p1); pos--; break;
+
+         case kcos  : body += Form("   t%d = TMath::Cos(t%d);\n",p1,p1); break;
+         case ksin  : body += Form("   t%d = TMath::Sin(t%d);\n",p1,p1); break;
+         case ktan  : body += Form("   t%d = (TMath::Cos(t%d) == 0) ? 0 : TMath::Tan(t%d);\n",p1,p1,p1); break;
+         case kacos : body += Form("   t%d = (TMath::Abs(t%d) > 1) ? 0 : TMath::ACos(t%d);\n",p1,p1,p1); break;
+         case kasin : body += Form("   t%d = (TMath::Abs(t%d) > 1) ? 0 : TMath::ASin(t%d);\n",p1,p1,p1); break;
+         case katan : body += Form("   t%d = TMath::ATan(t%d);\n",p1,p1); break;
+         case kcosh : body += Form("   t%d = TMath::CosH(t%d);\n",p1,p1); break;
+         case ksinh : body += Form("   t%d = TMath::SinH(t%d);\n",p1,p1); break;
+         case ktanh : body += Form("   t%d = (TMath::CosH(t%d) == 0) ? 0 : TMath::TanH(t%d);\n",p1,p1,p1); break;
+         case kacosh: body += Form("   t%d = (t%d < 1) ? 0 : TMath::ACosH(t%d);\n",p1,p1,p1); break;
+         case kasinh: body += Form("   t%d = TMath::ASinH(t%d);\n",p1,p1); break;
+         case katanh: body += Form("   t%d = (TMath::Abs(t%d) > 1) ? 0 : TMath::ATanH(t%d);\n",p1,p1,p1); break;
+         case katan2: body += Form("   t%d = TMath::ATan2(t%d,t%d);\n",p2,p2,p1); pos--; break;
+         case kfmod : body += Form("   t%d = fmod(t%d,t%d);\n",p2,p2,p1); pos--; break;
+         case kpow  : body += Form("   t%d = TMath::Power(t%d,t%d);\n",p2,p2,p1); pos--; break;
+         case ksq   : body += Form("   t%d = t%d*t%d;\n",p1,p1,p1); break;
+         case ksqrt : body += Form("   t%d = TMath::Sqrt(TMath::Abs(t%d));\n",p1,p1); break;
+         case kmin  : body += Form("   t%d = TMath::Min(t%d,t%d);\n",p2,p2,p1); pos--; break;
+         case kmax  : body += Form("   t%d = TMath::Max(t%d,t%d);\n",p2,p2,p1); pos--; break;
+         case klog  : body += Form("   t%d = (t%d > 0) ? TMath::Log(t%d) : 0;\n",p1,p1,p1); break;
+         case kexp  : body += Form("   t%d = (t%d < -700) ? 0 : TMath::Exp( (t%d > 700) ? 700 : t%d );\n",p1,p1,p1,p1); break;
+         case klog10: body += Form("   t%d = (t%d > 0) ? TMath::Log10(t%d) : 0;\n",p1,p1,p1); break;
+         case kabs  : body += Form("   t%d = TMath::Abs(t%d);\n",p1,p1); break;
+         case ksign : body += Form("   t%d = (t%d < 0) ? -1 : 1;\n",p1,p1); break;
+         case kint  : body += Form("   t%d = Double_t(Int_t(t%d));\n",p1,p1); break;
+         case kSignInv: body += Form("   t%d = -t%d;\n",p1,p1); break;
+
+         case kAnd        : body += Form("   t%d = (t%d != 0 && t%d != 0) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kOr         : body += Form("   t%d = (t%d != 0 || t%d != 0) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kEqual      : body += Form("   t%d = (t%d == t%d) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kNotEqual   : body += Form("   t%d = (t%d != t%d) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kLess       : body += Form("   t%d = (t%d < t%d) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kGreater    : body += Form("   t%d = (t%d > t%d) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kLessThan   : body += Form("   t%d = (t%d <= t%d) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kGreaterThan: body += Form("   t%d = (t%d >= t%d) ? 1 : 0;\n",p2,p2,p1); pos--; break;
+         case kNot        : body += Form("   t%d = (t%d != 0) ? 0 : 1;\n",p1,p1); break;
+
+         case kBitAnd    : body += Form("   t%d = Int_t(t%d) & Int_t(t%d);\n",p2,p2,p1); pos--; break;
+         case kBitOr     : body += Form("   t%d = Int_t(t%d) | Int_t(t%d);\n",p2,p2,p1); pos--; break;
+         case kLeftShift : body += Form("   t%d = Int_t(t%d) << Int_t(t%d);\n",p2,p2,p1); pos--; break;
+         case kRightShift: body += Form("   t%d = Int_t(t%d) >> Int_t(t%d);\n",p2,p2,p1); pos--; break;
+
+         case kJump   :
+         case kJumpIf : {
+            // the operator executed after the jump is param+1
+            if (opcode == kJumpIf) {
+               pos--;
+               body += Form("   if (!t%d) goto L%d;\n",pos,param+1);
+            } else {
+               body += Form("   goto L%d;\n",param+1);
+               reachable = kFALSE;
+            }
+            if (param+1 > fNoper || param+1 <= i || (posAt[param+1] >= 0 && posAt[param+1] != pos)) { ok = kFALSE; break; }
+            posAt[param+1] = pos;
+            break;
+         }
+         case kBoolOptimize: {
+            // skip the right operand if the result is already known
+            Int_t target = i + param/10 + 1;
+            Int_t op = param % 10;
+            if (target > fNoper || (posAt[target] >= 0 && posAt[target] != pos)) { ok = kFALSE; break; }
+            if (op == 1)      body += Form("   if (!t%d) { t%d = 0; goto L%d; }\n",p1,p1,target);
+            else if (op == 2) body += Form("   if (t%d) { t%d = 1; goto L%d; }\n",p1,p1,target);
+            posAt[target] = pos;
+            break;
+         }
+
+         case kxexpo: case kyexpo: case kzexpo:
+            body += Form("   t%d = TMath::Exp(p[%d]+p[%d]*x[%d]);\n",pos,param,param+1,opcode-kxexpo); pos++; break;
+         case kxyexpo:
+            body += Form("   t%d = TMath::Exp(p[%d]+p[%d]*x[0]+p[%d]*x[1]);\n",pos,param,param+1,param+2); pos++; break;
+         case kxgaus: case kygaus: case kzgaus:
+            body += Form("   t%d = p[%d]*TMath::Gaus(x[%d],p[%d],p[%d],%s);\n",pos,param,opcode-kxgaus,param+1,param+2,norm); pos++; break;
+         case kxygaus:
+            body += Form("   {\n      Double_t u1 = (p[%d] == 0) ? 1e10 : (x[0]-p[%d])/p[%d];\n",param+2,param+1,param+2);
+            body += Form("      Double_t u2 = (p[%d] == 0) ? 1e10 : (x[1]-p[%d])/p[%d];\n",param+4,param+3,param+4);
+            body += Form("      t%d = p[%d]*TMath::Exp(-0.5*(u1*u1+u2*u2));\n   }\n",pos,param);
+            pos++; break;
+         case kxlandau: case kylandau: case kzlandau:
+            body += Form("   t%d = p[%d]*TMath::Landau(x[%d],p[%d],p[%d],%s);\n",pos,param,opcode-kxlandau,param+1,param+2,norm); pos++; break;
+         case kxylandau:
+            body += Form("   t%d = p[%d]*TMath::Landau(x[0],p[%d],p[%d],%s)*TMath::Landau(x[1],p[%d],p[%d],%s);\n",
+                         pos,param,param+1,param+2,norm,param+3,param+4,norm);
+            pos++; break;
+         case kxpol: case kypol: case kzpol: {
+            // polynomial of degree n with parameters starting at first, Horner scheme
+            Int_t n = param/100;
+            Int_t first = param - n*100 - 1;
+            body += Form("   t%d = p[%d];\n",pos,first+n);
+            for (Int_t j = n-1; j >= 0; --j)
+               body += Form("   t%d = t%d*x[%d] + p[%d];\n",pos,pos,opcode-kxpol,first+j);
+            pos++; break;
+         }
+
+         default:
+            // strings, defined variables and calls to interpreted functions
+            ok = kFALSE;
+      }
+      if (pos > maxpos) maxpos = pos;
+   }
+   if (ok && posAt[fNoper] >= 0) {
+      if (reachable && pos != posAt[fNoper]) ok = kFALSE;
+      pos = posAt[fNoper];
+      body += Form("L%d:\n",fNoper);
+   }
+   if (pos != 1) ok = kFALSE;
+   delete [] posAt;
+   if (!ok) return kFALSE;
+
+   TString title = fTitle;
+   title.ReplaceAll("\n"," ");
+   code += "// This code has been automatically generated by TFormula::GenerateCode\n";
+   code += "// for the formula: "; code += title; code += "\n";
+   code += "#include \"TMath.h\"\n#include \"TRandom.h\"\n#include <math.h>\n\n";
+   code += Form("extern \"C\" Double_t %s(const Double_t *x, const Double_t *p)\n{\n",funcname);
+   for (Int_t i = 0; i < maxpos; ++i) code += Form("   Double_t t%d = 0;\n",i);
+   code += body;
+   code += "   return t0;\n}\n";
+   return kTRUE;
+}
+
+
+//______________________________________________________________________________
+Bool_t TFormula::CompileNative(Option_t *option)
+{
+   // Compile this formula in native code.
+   //
+   // The C++ code generated by GenerateCode is compiled with ACLiC in a shared
+   // library which is kept on disk (by default in the directory "TFormula_cache"
+   // of the temporary directory, see SetNativeCompilation) and re-used by all the
+   // formulae with the same operators. On success EvalPar calls directly the
+   // compiled function, and the interpretation overhead disappears.
+   // If the formula cannot be translated or the compilation fails, the formula
+   // keeps being interpreted and kFALSE is returned.
+   //
+   // If option contains "f" the library is re-compiled even if it exists.
+   //
+   // Example:
+   //    TF1 *f1 = new TF1("f1","[0]*exp(-0.5*((x-[1])/[2])^2)+[3]+[4]*x",-5,5);
+   //    f1->CompileNative();
+   //    h->Fit(f1);
+   //
+   // To compile automatically all the new formulae call
+   //    TFormula::SetNativeCompilation();
+
+   TString opt = option;
+   opt.ToLower();
+
+   // the function name contains a digest of the code, so that identical formulae share the library
+   TString code;
+   if (!GenerateCode(code, "TFormula_native")) return kFALSE;
+   TMD5 md5;
+   md5.Update((const UChar_t*)code.Data(), code.Length());
+   md5.Final();
+   TString funcname = Form("TFormula_%s", md5.AsString());
+   code.ReplaceAll("TFormula_native", funcname);
+
+   TFuncCompiled func = 0;
+   if (!opt.Contains("f"))
+      func = (TFuncCompiled)gSystem->DynFindSymbol("*", funcname);
+
+   if (!func) {
+      TString dir = fgNativeCacheDir;
+      if (dir.IsNull()) dir = Form("%s/TFormula_cache", gSystem->TempDirectory());
+      gSystem->mkdir(dir, kTRUE);
+      TString fileName = Form("%s/%s.C", dir.Data(), funcname.Data());
+      // write the file only if needed, to keep the library up to date for ACLiC
+      if (gSystem->AccessPathName(fileName)) {
+         FILE *hf = fopen(fileName.Data(),"w");
+         if (hf == 0) {
+            Error("CompileNative","Unable to open the file %s for writing.",fileName.Data());
+            return kFALSE;
+         }
+         fputs(code.Data(), hf);
+         fclose(hf);
+      }
+      TString aclicOpt = (opt.Contains("f")) ? "kOf" : "kO";
+      if (!gSystem->CompileMacro(fileName, aclicOpt)) {
+         Warning("CompileNative","Compilation of %s failed, the formula %s is interpreted",
+                 fileName.Data(), GetName());
+         return kFALSE;
+      }
+      func = (TFuncCompiled)gSystem->DynFindSymbol("*", funcname);
+      if (!func) {
+         Warning("CompileNative","Function %s not found, the formula %s is interpreted",
+                 funcname.Data(), GetName());
+         return kFALSE;
+      }
+   }
+
+   fCompiled = func;
+   fOptimal  = (TFormulaPrimitive::TFuncG)&TFormula::EvalParCompiled;
+   return kTRUE;
+}
+
+
+//______________________________________________________________________________
+void TFormula::SetNativeCompilation(Bool_t on, const char *cachedir)
+{
+   // static function to compile natively (see CompileNative) all the formulae
+   // created or read from a file afterwards.
+   //  -on       : switch on/off the native compilation (default is off)
+   //  -cachedir : directory where the generated code and the libraries are
+   //              stored (default is $TMPDIR/TFormula_cache)
+   // The first compilation of a formula takes a few seconds, this is worth only
+   // for functions evaluated many times, like in fits of large data sets.
+
+   fgNativeCompilation = on;
+   if (cachedir) fgNativeCacheDir = cachedir;
+}
+
+
 //______________________________________________________________________________
 void TFormula::SetMaxima(Int_t maxop, Int_t maxpar, Int_t maxconst)
 {
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <vector>
 
 #include "Riostream.h"
 #include "TROOT.h"
@@ -5140,6 +5141,219 @@ Bool_t TH1::RecomputeAxisLimits(TAxis& destAxis, const TAxis& anAxis)
    return kTRUE;
 }
 
+namespace {
+
+   // parameters of the merge of histograms with identical binning
+   const Int_t kMergeChunk = 1024; // number of bins added at once (fitting in the cache)
+   const Int_t kMergeLeaf  = 8;    // number of arrays added sequentially at the leaves of the tree
+
+   template <class T>
+   void PairwiseSum(const T * const *src, Int_t nsrc, Int_t first, Int_t n, Double_t *sum, Double_t *work)
+   {
+      // Sum in sum[0,n) the bins [first,first+n) of the nsrc arrays src,
+      // splitting recursively the arrays in two halves (tree reduction).
+      // work must have n elements for each level of the tree.
+
+      if (nsrc <= kMergeLeaf) {
+         const T *a = src[0] + first;
+         for (Int_t i = 0; i < n; ++i) sum[i] = a[i];
+         for (Int_t k = 1; k < nsrc; ++k) {
+            a = src[k] + first;
+            for (Int_t i = 0; i < n; ++i) sum[i] += a[i];
+         }
+         return;
+      }
+      Int_t half = nsrc/2;
+      PairwiseSum(src, half, first, n, sum, work);
+      PairwiseSum(src + half, nsrc - half, first, n, work, work + n);
+      for (Int_t i = 0; i < n; ++i) sum[i] += work[i];
+   }
+
+   template <class T>
+   void AddPairwise(T *dest, const T * const *src, Int_t nsrc, Int_t ncells)
+   {
+      // Add the nsrc arrays src to dest: the arrays are summed in double
+      // precision with a tree reduction, chunk by chunk of bins.
+      // The chunks are processed in parallel when compiled with OpenMP;
+      // the result does not depend on the number of threads.
+
+      Int_t nlevels = 0;
+      for (Int_t m = nsrc; m > kMergeLeaf; m = (m + 1)/2) ++nlevels;
+      Int_t nchunks = (ncells + kMergeChunk - 1)/kMergeChunk;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+         std::vector<Double_t> buf((nlevels + 1)*kMergeChunk);
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+         for (Int_t ichunk = 0; ichunk < nchunks; ++ichunk) {
+            Int_t first = ichunk*kMergeChunk;
+            Int_t n = TMath::Min(kMergeChunk, ncells - first);
+            PairwiseSum(src, nsrc, first, n, &buf[0], &buf[kMergeChunk]);
+            T *d = dest + first;
+            for (Int_t i = 0; i < n; ++i) d[i] = T(d[i] + buf[i]);
+         }
+      }
+   }
+
+   template <class T>
+   void AddSaturated(T *dest, const T * const *src, Int_t nsrc, Int_t ncells, Long64_t maxval)
+   {
+      // Add the nsrc integer arrays src to dest, one after the other, with the
+      // content saturating at +-maxval as in TH1C/S/I::AddBinContent.
+
+      Int_t nchunks = (ncells + kMergeChunk - 1)/kMergeChunk;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (Int_t ichunk = 0; ichunk < nchunks; ++ichunk) {
+         Int_t first = ichunk*kMergeChunk;
+         Int_t last = TMath::Min(first + kMergeChunk, ncells);
+         for (Int_t k = 0; k < nsrc; ++k) {
+            const T *a = src[k];
+            for (Int_t i = first; i < last; ++i) {
+               Long64_t v = Long64_t(dest[i]) + Long64_t(a[i]);
+               if (v > maxval) v = maxval;
+               if (v < -maxval) v = -maxval;
+               dest[i] = T(v);
+            }
+         }
+      }
+   }
+
+   template <class A, class T>
+   Bool_t GetArrays(TArray *dest, const TArray **src, Int_t nsrc, T *&d, std::vector<const T*> &s)
+   {
+      // Get the data of dest and src if they are all of type A.
+
+      A *a = dynamic_cast<A*>(dest);
+      if (!a) return kFALSE;
+      d = a->GetArray();
+      s.resize(nsrc);
+      for (Int_t k = 0; k < nsrc; ++k) {
+         const A *b = dynamic_cast<const A*>(src[k]);
+         if (!b || b->GetSize() < dest->GetSize()) return kFALSE;
+         s[k] = b->GetArray();
+      }
+      return kTRUE;
+   }
+
+}
+
+//______________________________________________________________________________
+Bool_t TH1::AddArrays(TArray *dest, const TArray **src, Int_t nsrc)
+{
+   // Add to dest the nsrc arrays src, of the same type and at least of the
+   // same size. Used by Merge for histograms with identical binning.
+   // The floating point arrays are added with a tree (pairwise) reduction in
+   // double precision, the integer arrays saturate as in AddBinContent.
+   // Return kFALSE, without modifying dest, if the arrays are not all of the
+   // same type (TArrayD, TArrayF, TArrayI, TArrayS or TArrayC).
+
+   if (!dest || nsrc <= 0) return kTRUE;
+   Int_t n = dest->GetSize();
+
+   Double_t *dd; std::vector<const Double_t*> sd;
+   Float_t  *df; std::vector<const Float_t*>  sf;
+   Int_t    *di; std::vector<const Int_t*>    si;
+   Short_t  *ds; std::vector<const Short_t*>  ss;
+   Char_t   *dc; std::vector<const Char_t*>   sc;
+   if (GetArrays<TArrayD>(dest, src, nsrc, dd, sd))
+      AddPairwise(dd, &sd[0], nsrc, n);
+   else if (GetArrays<TArrayF>(dest, src, nsrc, df, sf))
+      AddPairwise(df, &sf[0], nsrc, n);
+   else if (GetArrays<TArrayI>(dest, src, nsrc, di, si))
+      AddSaturated(di, &si[0], nsrc, n, 2147483647);
+   else if (GetArrays<TArrayS>(dest, src, nsrc, ds, ss))
+      AddSaturated(ds, &ss[0], nsrc, n, 32767);
+   else if (GetArrays<TArrayC>(dest, src, nsrc, dc, sc))
+      AddSaturated(dc, &sc[0], nsrc, n, 127);
+   else
+      return kFALSE;
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TH1::SameBinning(const TH1 *h1, const TH1 *h2)
+{
+   // Return kTRUE if the two histograms have exactly the same binning on all
+   // axes, with defined limits, and no bin labels, so that the bins can be
+   // merged by adding their arrays.
+
+   if (h1->fDimension != h2->fDimension || h1->fNcells != h2->fNcells) return kFALSE;
+   if (h1->fXaxis.GetXmin() >= h1->fXaxis.GetXmax()) return kFALSE;
+   TAxis *axes1[3] = { h1->GetXaxis(), h1->GetYaxis(), h1->GetZaxis() };
+   TAxis *axes2[3] = { h2->GetXaxis(), h2->GetYaxis(), h2->GetZaxis() };
+   for (Int_t i = 0; i < 3; ++i) {
+      if (!SameLimitsAndNBins(*axes1[i], *axes2[i])) return kFALSE;
+      if (axes1[i]->GetLabels() || axes2[i]->GetLabels()) return kFALSE;
+      const TArrayD *bins1 = axes1[i]->GetXbins();
+      const TArrayD *bins2 = axes2[i]->GetXbins();
+      if (bins1->fN != bins2->fN) return kFALSE;
+      for (Int_t j = 0; j < bins1->fN; ++j)
+         if (bins1->fArray[j] != bins2->fArray[j]) return kFALSE;
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TH1::MergeSameBinning(TCollection *li, Long64_t &nentries)
+{
+   // Merge the histograms in the collection when they are all of the class of
+   // this histogram and have the same binning (see SameBinning).
+   // In this case the bin contents and errors are added array by array (see
+   // AddArrays), which scales to a large number of histograms and runs in
+   // parallel when compiled with OpenMP.
+   // Return kFALSE, without modifying the histograms, if this is not the case
+   // and the general algorithm of Merge has to be used.
+
+   TArray *dest = dynamic_cast<TArray*>(this);
+   if (!dest || dest->GetSize() != fNcells || InheritsFrom("TH1K")) return kFALSE;
+
+   std::vector<TH1*> hists;
+   TIter next(li);
+   while (TObject *obj = next()) {
+      TH1 *h = dynamic_cast<TH1*>(obj);
+      if (!h || h->IsA() != IsA()) return kFALSE;
+      // skip empty histograms
+      if (h->fTsumw == 0 && h->GetEntries() == 0) continue;
+      if (!SameBinning(this, h)) return kFALSE;
+      if (fSumw2.fN && h->fSumw2.fN != fNcells) return kFALSE;
+      hists.push_back(h);
+   }
+   if (!SameBinning(this, this)) return kFALSE;
+
+   Int_t nhists = hists.size();
+   std::vector<const TArray*> contents(nhists), sumw2(nhists);
+   Double_t stats[kNstat], totstats[kNstat];
+   for (Int_t i = 0; i < kNstat; i++) {totstats[i] = stats[i] = 0;}
+   BufferEmpty();
+   GetStats(totstats);
+   Double_t ntot = GetEntries();
+   for (Int_t k = 0; k < nhists; ++k) {
+      TH1 *h = hists[k];
+      h->BufferEmpty();
+      h->GetStats(stats);
+      for (Int_t i = 0; i < kNstat; i++)
+         totstats[i] += stats[i];
+      ntot += h->GetEntries();
+      contents[k] = dynamic_cast<const TArray*>(h);
+      sumw2[k] = &h->fSumw2;
+   }
+   if (nhists) {
+      if (!AddArrays(dest, &contents[0], nhists)) return kFALSE;
+      if (fSumw2.fN) AddArrays(&fSumw2, &sumw2[0], nhists);
+   }
+
+   //copy merged stats
+   PutStats(totstats);
+   SetEntries(ntot);
+   nentries = (Long64_t)ntot;
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 Long64_t TH1::Merge(TCollection *li)
 {
@@ -5152,6 +5366,8 @@ Long64_t TH1::Merge(TCollection *li)
    // If overflows are present and limits are different the function will fail.
    // The function returns the total number of entries in the result histogram
    // if the merge is successful, -1 otherwise.
+   // If all histograms have the same binning and no labels, the bin contents
+   // and errors are added array by array (see TH1::MergeSameBinning).
    //
    // IMPORTANT remark. The axis x may have different number
    // of bins and different limits, BUT the largest bin width must be
@@ -5182,6 +5398,10 @@ Long64_t TH1::Merge(TCollection *li)
    if (!li) return 0;
    if (li->IsEmpty()) return (Long64_t) GetEntries();
 
+   // fast merge of histograms with identical binning
+   Long64_t nentriesSame = 0;
+   if (MergeSameBinning(li, nentriesSame)) return nentriesSame;
+
    // is this really needed ? 
    TList inlist;
    inlist.AddAll(li);
@@ -1436,6 +1436,8 @@ Long64_t TH2::Merge(TCollection *list)
    //If overflows are present and limits are different the function will fail.
    //The function returns the total number of entries in the result histogram
    //if the merge is successfull, -1 otherwise.
+   //If all histograms have the same binning and no labels, the bin contents
+   //and errors are added array by array (see TH1::MergeSameBinning).
    //
    //IMPORTANT remark. The 2 axis x and y may have different number
    //of bins and different limits, BUT the largest bin width must be
@@ -1445,6 +1447,10 @@ Long64_t TH2::Merge(TCollection *list)
    if (!list) return 0;
    if (list->IsEmpty()) return (Long64_t) GetEntries();
 
+   // fast merge of histograms with identical binning
+   Long64_t nentriesSame = 0;
+   if (MergeSameBinning(list, nentriesSame)) return nentriesSame;
+
    TList inlist;
    inlist.AddAll(list);
 
@@ -720,6 +720,8 @@ Long64_t THnBase::Merge(TCollection* list)
 {
    // Merge this with a list of THnBase's. All THnBase's provided
    // in the list must have the same bin layout!
+   // Histograms of the same storage type as this are added directly from
+   // their internal storage if possible (see AddSameBinning()).
 
    if (!list) return 0;
    if (list->IsEmpty()) return (Long64_t)GetEntries();
@@ -741,7 +743,7 @@ Long64_t THnBase::Merge(TCollection* list)
       if (!addMe)
          Error("Merge", "Object named %s is not THnBase! Skipping it.",
                addMeObj->GetName());
-      else
+      else if (!AddSameBinning(addMe))
          Add(addMe);
    }
    return (Long64_t)GetEntries();
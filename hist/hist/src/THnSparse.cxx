@@ -620,6 +620,51 @@ void THnSparse::AddBinContent(Long64_t bin, Double_t v)
    return chunk->fContent->SetAt(v, bin);
 }
 
+//______________________________________________________________________________
+Bool_t THnSparse::AddSameBinning(const THnBase* hbase)
+{
+   // Add the sparse histogram h, with the same number of bins on all axes,
+   // to this. The compact bin coordinates of h are then identical to the ones
+   // of this: they are copied directly from the chunks of h, instead of being
+   // decoded into bin coordinates and encoded again for each filled bin.
+   // Return kFALSE if h is not a THnSparse with the same binning.
+
+   const THnSparse* h = dynamic_cast<const THnSparse*>(hbase);
+   if (!h || h->GetNdimensions() != fNdimensions) return kFALSE;
+   for (Int_t dim = 0; dim < fNdimensions; ++dim)
+      if (GetAxis(dim)->GetNbins() != h->GetAxis(dim)->GetNbins())
+         return kFALSE;
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   Int_t sizeCompact = cc->GetBufferSize();
+   if (h->GetCompactCoord()->GetBufferSize() != sizeCompact) return kFALSE;
+
+   // Trigger error calculation if h has it
+   if (!GetCalculateErrors() && h->GetCalculateErrors())
+      Sumw2();
+   Bool_t haveErrors = GetCalculateErrors();
+   Bool_t hHasErrors = h->GetCalculateErrors();
+
+   Reserve(GetNbins() + h->GetNbins());
+
+   for (Int_t ichunk = 0; ichunk < h->GetNChunks(); ++ichunk) {
+      THnSparseArrayChunk* hchunk = h->GetChunk(ichunk);
+      Int_t nbins = hchunk->GetEntries();
+      for (Int_t i = 0; i < nbins; ++i) {
+         cc->SetBuffer(hchunk->fCoordinates + i * sizeCompact);
+         Long64_t idx = GetBinIndexForCurrentBin(kTRUE);
+         THnSparseArrayChunk* chunk = GetChunk(idx / fChunkSize);
+         idx %= fChunkSize;
+         Double_t v = hchunk->fContent->GetAt(i);
+         if (haveErrors)
+            (*chunk->fSumw2)[idx] += hHasErrors ? hchunk->fSumw2->GetAt(i) : v;
+         chunk->fContent->SetAt(v + chunk->fContent->GetAt(idx), idx);
+      }
+   }
+
+   SetEntries(GetEntries() + h->GetEntries());
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 THnSparseArrayChunk* THnSparse::AddChunk()
 {
@@ -27,6 +27,8 @@
 #include "THashList.h"
 #include "TMath.h"
 
+#include <vector>
+
 class TProfileHelper {
 
 public:
@@ -39,6 +41,9 @@ public:
    template <typename T>
    static Long64_t Merge(T* p, TCollection *list);
 
+   template <typename T>
+   static Bool_t MergeSameBinning(T* p, TCollection *list, Long64_t &nentries);
+
    template <typename T>
    static T* RebinAxis(T* p, Double_t x, TAxis *axis);
 
@@ -144,6 +149,59 @@ Double_t TProfileHelper::GetBinEffectiveEntries(T* p, Int_t bin)
    return ( sumOfWeightsSquare > 0 ?  sumOfWeights * sumOfWeights /   sumOfWeightsSquare : 0 ); 
 }
 
+template <typename T>
+Bool_t TProfileHelper::MergeSameBinning(T* p, TCollection *li, Long64_t &nentries) {
+   // Merge the profiles in the collection when they are all of the class of p
+   // and have the same binning (see TH1::MergeSameBinning).
+   // Return kFALSE, without modifying the profiles, if this is not the case.
+
+   std::vector<T*> hists;
+   TIter next(li);
+   while (TObject *obj = next()) {
+      T *h = dynamic_cast<T*>(obj);
+      if (!h || h->IsA() != p->IsA()) return kFALSE;
+      // skip empty histograms
+      if (h->fTsumw == 0 && h->GetEntries() == 0) continue;
+      if (!T::SameBinning(p, h)) return kFALSE;
+      if (h->fSumw2.fN != p->fNcells || h->fBinEntries.fN != p->fNcells) return kFALSE;
+      hists.push_back(h);
+   }
+   if (!T::SameBinning(p, p)) return kFALSE;
+   if (p->fSumw2.fN != p->fNcells || p->fBinEntries.fN != p->fNcells) return kFALSE;
+
+   Int_t nhists = hists.size();
+   std::vector<const TArray*> w(nhists), w2(nhists), b(nhists), b2(nhists);
+   Double_t stats[TH1::kNstat], totstats[TH1::kNstat];
+   for (Int_t i=0;i<TH1::kNstat;i++) {totstats[i] = stats[i] = 0;}
+   p->BufferEmpty();
+   p->GetStats(totstats);
+   Double_t ntot = p->GetEntries();
+   for (Int_t k = 0; k < nhists; ++k) {
+      T *h = hists[k];
+      h->BufferEmpty();
+      h->GetStats(stats);
+      for (Int_t i = 0; i < TH1::kNstat; i++)
+         totstats[i] += stats[i];
+      ntot += h->GetEntries();
+      w[k]  = static_cast<const TArrayD*>(h);
+      w2[k] = &h->fSumw2;
+      b[k]  = &h->fBinEntries;
+      b2[k] = h->fBinSumw2.fN ? &h->fBinSumw2 : &h->fBinEntries;
+   }
+   if (nhists) {
+      T::AddArrays(static_cast<TArrayD*>(p), &w[0], nhists);
+      T::AddArrays(&p->fSumw2, &w2[0], nhists);
+      T::AddArrays(&p->fBinEntries, &b[0], nhists);
+      if (p->fBinSumw2.fN) T::AddArrays(&p->fBinSumw2, &b2[0], nhists);
+   }
+
+   //copy merged stats
+   p->PutStats(totstats);
+   p->SetEntries(ntot);
+   nentries = (Long64_t)ntot;
+   return kTRUE;
+}
+
 template <typename T>
 Long64_t TProfileHelper::Merge(T* p, TCollection *li) {
    //Merge all histograms in the collection in this histogram.
@@ -153,6 +211,8 @@ Long64_t TProfileHelper::Merge(T* p, TCollection *li) {
    //If overflows are present and limits are different the function will fail.
    //The function returns the total number of entries in the result histogram
    //if the merge is successfull, -1 otherwise.
+   //If all profiles have the same binning and no labels, the bin contents
+   //and errors are added array by array (see TH1::MergeSameBinning).
    //
    //IMPORTANT remark. The 2 axis x and y may have different number
    //of bins and different limits, BUT the largest bin width must be
@@ -162,6 +222,10 @@ Long64_t TProfileHelper::Merge(T* p, TCollection *li) {
    if (!li) return 0;
    if (li->IsEmpty()) return (Int_t) p->GetEntries();
 
+   // fast merge of profiles with identical binning
+   Long64_t nentriesSame = 0;
+   if (MergeSameBinning(p, li, nentriesSame)) return nentriesSame;
+
    TList inlist;
    inlist.AddAll(li);
 
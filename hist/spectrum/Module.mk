@@ -69,3 +69,9 @@ distclean-$(MODNAME): clean-$(MODNAME)
 		   $(SPECTRUMDS) $(SPECTRUMDH)
 
 distclean::     distclean-$(MODNAME)
+
+# for openMP (parallel deconvolution in TSpectrumHelper)
+ifneq ($(USE_OPENMP),)
+$(call stripsrc,$(SPECTRUMDIRS)/TSpectrumHelper.o): CXXFLAGS += -fopenmp
+$(SPECTRUMLIB): LDFLAGS += -fopenmp
+endif
@@ -83,6 +83,9 @@ style='font-size:16.0pt'><a href="http://www.fu.sav.sk/nph/projects/ProcFunc/">h
 #include "TList.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TSpectrumHelper.h"
+
+#include <vector>
 #define PEAK_WINDOW 1024
 
 Int_t TSpectrum2::fgIterations    = 3;
@@ -1976,18 +1979,14 @@ deconvolution&quot;,10,10,1000,700);</p>
 
 <!-- */
 // --> End_Html
-   int i, j, lhx, lhy, i1, i2, j1, j2, k1, k2, lindex, i1min, i1max,
-       i2min, i2max, j1min, j1max, j2min, j2max, positx = 0, posity = 0, repet;
-   double lda, ldb, ldc, area, maximum = 0;
+   int i, j, lhx, lhy, positx = 0, posity = 0;
+   double lda, area, maximum = 0;
    if (ssizex <= 0 || ssizey <= 0)
       return "Wrong parameters";
    if (numberIterations <= 0)
       return "Number of iterations must be positive";
    if (numberRepetitions <= 0)
       return "Number of repetitions must be positive";   
-   double **working_space = new double *[ssizex];
-   for (i = 0; i < ssizex; i++)
-      working_space[i] = new double[5 * ssizey];
    area = 0;
    lhx = -1, lhy = -1;
    for (i = 0; i < ssizex; i++) {
@@ -1999,7 +1998,6 @@ deconvolution&quot;,10,10,1000,700);</p>
             if ((j + 1) > lhy)
                lhy = j + 1;
          }
-         working_space[i][j] = lda;
          area = area + lda;
          if (lda > maximum) {
             maximum = lda;
@@ -2007,130 +2005,31 @@ deconvolution&quot;,10,10,1000,700);</p>
          }
       }
    }
-   if (lhx == -1 || lhy == -1) {
-      delete [] working_space;
+   if (lhx == -1 || lhy == -1)
       return ("Zero response data");
-   }
-   
-//calculate ht*y and write into p 
-   for (i2 = 0; i2 < ssizey; i2++) {
-      for (i1 = 0; i1 < ssizex; i1++) {
-         ldc = 0;
-         for (j2 = 0; j2 <= (lhy - 1); j2++) {
-            for (j1 = 0; j1 <= (lhx - 1); j1++) {
-               k2 = i2 + j2, k1 = i1 + j1;
-               if (k2 >= 0 && k2 < ssizey && k1 >= 0 && k1 < ssizex) {
-                  lda = working_space[j1][j2];
-                  ldb = source[k1][k2];
-                  ldc = ldc + lda * ldb;
-               }
-            }
-         }
-         working_space[i1][i2 + ssizey] = ldc;
-      }
-   }
-   
-//calculate matrix b=ht*h 
-   i1min = -(lhx - 1), i1max = lhx - 1;
-   i2min = -(lhy - 1), i2max = lhy - 1;
-   for (i2 = i2min; i2 <= i2max; i2++) {
-      for (i1 = i1min; i1 <= i1max; i1++) {
-         ldc = 0;
-         j2min = -i2;
-         if (j2min < 0)
-            j2min = 0;
-         j2max = lhy - 1 - i2;
-         if (j2max > lhy - 1)
-            j2max = lhy - 1;
-         for (j2 = j2min; j2 <= j2max; j2++) {
-            j1min = -i1;
-            if (j1min < 0)
-               j1min = 0;
-            j1max = lhx - 1 - i1;
-            if (j1max > lhx - 1)
-               j1max = lhx - 1;
-            for (j1 = j1min; j1 <= j1max; j1++) {
-               lda = working_space[j1][j2];
-               if (i1 + j1 < ssizex && i2 + j2 < ssizey)
-                  ldb = working_space[i1 + j1][i2 + j2];
-               else
-                  ldb = 0;
-               ldc = ldc + lda * ldb;
-            }
-         }
-         working_space[i1 - i1min][i2 - i2min + 2 * ssizey ] = ldc;
-      }
-   }
-   
-//initialization in x1 matrix 
-   for (i2 = 0; i2 < ssizey; i2++) {
-      for (i1 = 0; i1 < ssizex; i1++) {
-         working_space[i1][i2 + 3 * ssizey] = 1;
-         working_space[i1][i2 + 4 * ssizey] = 0;
-      }
-   }
-   
-   //START OF ITERATIONS 
-   for (repet = 0; repet < numberRepetitions; repet++) {
-      if (repet != 0) {
-         for (i = 0; i < ssizex; i++) {
-            for (j = 0; j < ssizey; j++) {
-               working_space[i][j + 3 * ssizey] =
-                   TMath::Power(working_space[i][j + 3 * ssizey], boost);
-            }
-         }
-      }
-      for (lindex = 0; lindex < numberIterations; lindex++) {
-         for (i2 = 0; i2 < ssizey; i2++) {
-            for (i1 = 0; i1 < ssizex; i1++) {
-               ldb = 0;                 
-               j2min = i2;
-               if (j2min > lhy - 1)
-                  j2min = lhy - 1;
-               j2min = -j2min;
-               j2max = ssizey - i2 - 1;
-               if (j2max > lhy - 1)
-                  j2max = lhy - 1;
-               j1min = i1;
-               if (j1min > lhx - 1)
-                  j1min = lhx - 1;
-               j1min = -j1min;
-               j1max = ssizex - i1 - 1;
-               if (j1max > lhx - 1)
-                  j1max = lhx - 1;
-               for (j2 = j2min; j2 <= j2max; j2++) {
-                  for (j1 = j1min; j1 <= j1max; j1++) {
-                     ldc =  working_space[j1 - i1min][j2 - i2min + 2 * ssizey];
-                     lda = working_space[i1 + j1][i2 + j2 + 3 * ssizey];
-                     ldb = ldb + lda * ldc;
-                  }
-               }
-               lda = working_space[i1][i2 + 3 * ssizey];
-               ldc = working_space[i1][i2 + 1 * ssizey];
-               if (ldc * lda != 0 && ldb != 0) {
-                  lda = lda * ldc / ldb;
-               }
 
-               else
-                  lda = 0;
-               working_space[i1][i2 + 4 * ssizey] = lda;
-            }
-         }
-         for (i2 = 0; i2 < ssizey; i2++) {
-            for (i1 = 0; i1 < ssizex; i1++)
-               working_space[i1][i2 + 3 * ssizey] =
-                   working_space[i1][i2 + 4 * ssizey];
-         }
-      }
+   //the iterations are done in ROOT::TSpectrumHelper on contiguous arrays
+   //with the first index running fastest
+   Int_t n[2]  = {ssizex, ssizey};
+   Int_t lh[2] = {lhx, lhy};
+   std::vector<Double_t> hresp(lhx * lhy);
+   std::vector<Double_t> ysrc(ssizex * ssizey);
+   std::vector<Double_t> xdec(ssizex * ssizey);
+   for (j = 0; j < lhy; j++) {
+      for (i = 0; i < lhx; i++)
+         hresp[j * lhx + i] = resp[i][j];
    }
+   for (j = 0; j < ssizey; j++) {
+      for (i = 0; i < ssizex; i++)
+         ysrc[j * ssizex + i] = source[i][j];
+   }
+   ROOT::TSpectrumHelper::GoldDeconvolution(2, n, lh, &hresp[0], &ysrc[0], &xdec[0],
+                                            numberIterations, numberRepetitions, boost);
    for (i = 0; i < ssizex; i++) {
       for (j = 0; j < ssizey; j++)
          source[(i + positx) % ssizex][(j + posity) % ssizey] =
-             area * working_space[i][j + 3 * ssizey];
+             area * xdec[j * ssizex + i];
    }
-   for (i = 0; i < ssizex; i++)
-      delete[]working_space[i];
-   delete[]working_space;
    return 0;
 }
 
@@ -2850,15 +2749,15 @@ nbinsy, 2, 5, kFALSE, 10, kFALSE, 1);
 <!-- */
 // --> End_Html
    int number_of_iterations = (int)(4 * sigma + 0.5);
-   int k, lindex, priz;
-   double lda, ldb, ldc, area, maximum;
+   int k, priz;
+   double lda, ldb, area, maximum;
    int xmin, xmax, l, peak_index = 0, ssizex_ext = ssizex + 4 * number_of_iterations, ssizey_ext = ssizey + 4 * number_of_iterations, shift = 2 * number_of_iterations;
    int ymin, ymax, i, j;
    double a, b, ax, ay, maxch, plocha = 0;
    double nom, nip, nim, sp, sm, spx, spy, smx, smy;
    double p1, p2, p3, p4, s1, s2, s3, s4;
    int x, y;
-   int lhx, lhy, i1, i2, j1, j2, k1, k2, i1min, i1max, i2min, i2max, j1min, j1max, j2min, j2max, positx, posity;
+   int lhx, lhy, positx, posity;
    if (sigma < 1) {
       Error("SearchHighRes", "Invalid sigma, must be greater than or equal to 1");
       return 0;
@@ -3232,140 +3131,26 @@ nbinsy, 2, 5, kFALSE, 10, kFALSE, 1);
          working_space[i][j + 14 * ssizey_ext] = TMath::Abs(working_space[i][j + ssizey_ext]);
       }
    }
-   //calculate matrix b=ht*h
-   i = lhx - 1;
-   if(i > ssizex_ext)
-      i = ssizex_ext;
-
-   j = lhy - 1;
-   if(j>ssizey_ext)
-      j = ssizey_ext;
-
-   i1min = -i,i1max = i;
-   i2min = -j,i2max = j;
-   for(i2 = i2min; i2 <= i2max; i2++){
-      for(i1 = i1min; i1 <= i1max; i1++){
-         ldc = 0;
-         j2min = -i2;
-         if(j2min < 0)
-            j2min = 0;
-
-         j2max = lhy - 1 - i2;
-         if(j2max > lhy - 1)
-            j2max = lhy - 1;
-
-         for(j2 = j2min; j2 <= j2max; j2++){
-            j1min = -i1;
-            if(j1min < 0)
-               j1min = 0;
-
-            j1max = lhx - 1 - i1;
-            if(j1max > lhx - 1)
-               j1max = lhx - 1;
-
-            for(j1 = j1min; j1 <= j1max; j1++){
-               lda = working_space[j1][j2];
-               ldb = working_space[i1 + j1][i2 + j2];
-               ldc = ldc + lda * ldb;
-            }
-         }
-         k = (i1 + ssizex_ext) / ssizex_ext;
-         working_space[(i1 + ssizex_ext) % ssizex_ext][i2 + ssizey_ext + 10 * ssizey_ext + k * 2 * ssizey_ext] = ldc;
-      }
-   }
-   //calculate at*y and write into p
-   i = lhx - 1;
-   if(i > ssizex_ext)
-      i = ssizex_ext;
-
-   j = lhy - 1;
-   if(j > ssizey_ext)
-      j = ssizey_ext;
-
-   i2min = -j,i2max = ssizey_ext + j - 1;
-   i1min = -i,i1max = ssizex_ext + i - 1;
-   for(i2 = i2min; i2 <= i2max; i2++){
-      for(i1=i1min;i1<=i1max;i1++){
-         ldc=0;
-         for(j2 = 0; j2 <= (lhy - 1); j2++){
-            for(j1 = 0; j1 <= (lhx - 1); j1++){
-               k2 = i2 + j2,k1 = i1 + j1;
-               if(k2 >= 0 && k2 < ssizey_ext && k1 >= 0 && k1 < ssizex_ext){
-                  lda = working_space[j1][j2];
-                  ldb = working_space[k1][k2 + 14 * ssizey_ext];
-                  ldc = ldc + lda * ldb;
-               }
-            }
-         }
-         k = (i1 + ssizex_ext) / ssizex_ext;
-         working_space[(i1 + ssizex_ext) % ssizex_ext][i2 + ssizey_ext + ssizey_ext + k * 3 * ssizey_ext] = ldc;
-      }
-   }
-   //move matrix p
-   for(i2 = 0; i2 < ssizey_ext; i2++){
-      for(i1 = 0; i1 < ssizex_ext; i1++){
-         k = (i1 + ssizex_ext) / ssizex_ext;
-         ldb = working_space[(i1 + ssizex_ext) % ssizex_ext][i2 + ssizey_ext + ssizey_ext + k * 3 * ssizey_ext];
-         working_space[i1][i2 + 14 * ssizey_ext] = ldb;
-      }
+   //the iterations are done in ROOT::TSpectrumHelper on contiguous arrays
+   //with the first index running fastest
+   Int_t next[2] = {ssizex_ext, ssizey_ext};
+   Int_t lh[2]   = {lhx, lhy};
+   std::vector<Double_t> hresp(lhx * lhy);
+   std::vector<Double_t> ysrc(ssizex_ext * ssizey_ext);
+   std::vector<Double_t> xdec(ssizex_ext * ssizey_ext);
+   for (j = 0; j < lhy; j++) {
+      for (i = 0; i < lhx; i++)
+         hresp[j * lhx + i] = working_space[i][j];
    }
-   //initialization in x1 matrix
-   for(i2 = 0; i2 < ssizey_ext; i2++){
-      for(i1 = 0; i1 < ssizex_ext; i1++){
-         working_space[i1][i2 + ssizey_ext] = 1;
-         working_space[i1][i2 + 2 * ssizey_ext] = 0;
-      }
+   for (j = 0; j < ssizey_ext; j++) {
+      for (i = 0; i < ssizex_ext; i++)
+         ysrc[j * ssizex_ext + i] = working_space[i][j + 14 * ssizey_ext];
    }
-   //START OF ITERATIONS
-   for(lindex = 0; lindex < deconIterations; lindex++){
-      for(i2 = 0; i2 < ssizey_ext; i2++){
-         for(i1 = 0; i1 < ssizex_ext; i1++){
-            lda = working_space[i1][i2 + ssizey_ext];
-            ldc = working_space[i1][i2 + 14 * ssizey_ext];
-            if(lda > 0.000001 && ldc > 0.000001){
-               ldb=0;
-               j2min=i2;
-               if(j2min > lhy - 1)
-                  j2min = lhy - 1;
-
-               j2min = -j2min;
-               j2max = ssizey_ext - i2 - 1;
-               if(j2max > lhy - 1)
-                  j2max = lhy - 1;
-
-               j1min = i1;
-               if(j1min > lhx - 1)
-                  j1min = lhx - 1;
-
-               j1min = -j1min;
-               j1max = ssizex_ext - i1 - 1;
-               if(j1max > lhx - 1)
-                  j1max = lhx - 1;
-
-               for(j2 = j2min; j2 <= j2max; j2++){
-                  for(j1 = j1min; j1 <= j1max; j1++){
-                     k = (j1 + ssizex_ext) / ssizex_ext;
-                     ldc = working_space[(j1 + ssizex_ext) % ssizex_ext][j2 + ssizey_ext + 10 * ssizey_ext + k * 2 * ssizey_ext];
-                     lda = working_space[i1 + j1][i2 + j2 + ssizey_ext];
-                     ldb = ldb + lda * ldc;
-                  }
-               }
-               lda = working_space[i1][i2 + ssizey_ext];
-               ldc = working_space[i1][i2 + 14 * ssizey_ext];
-               if(ldc * lda != 0 && ldb != 0){
-                  lda =lda * ldc / ldb;
-               }
-
-               else
-                  lda=0;
-               working_space[i1][i2 + 2 * ssizey_ext] = lda;
-            }
-         }
-      }
-      for(i2 = 0; i2 < ssizey_ext; i2++){
-         for(i1 = 0; i1 < ssizex_ext; i1++)
-            working_space[i1][i2 + ssizey_ext] = working_space[i1][i2 + 2 * ssizey_ext];
-      }
+   ROOT::TSpectrumHelper::GoldDeconvolution(2, next, lh, &hresp[0], &ysrc[0], &xdec[0],
+                                            deconIterations, 1, 1, 0.000001);
+   for (j = 0; j < ssizey_ext; j++) {
+      for (i = 0; i < ssizex_ext; i++)
+         working_space[i][j + ssizey_ext] = xdec[j * ssizex_ext + i];
    }
    //looking for maximum
    maximum=0;
@@ -54,6 +54,9 @@
 #include "TSpectrum3.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TSpectrumHelper.h"
+
+#include <vector>
 #define PEAK_WINDOW 1024
 
 ClassImp(TSpectrum3)  
@@ -2347,20 +2350,14 @@ decon_in-&gt;Draw(&quot;&quot;);
 <!-- */
 // --> End_Html
 
-   int i, j, k, lhx, lhy, lhz, i1, i2, i3, j1, j2, j3, k1, k2, k3, lindex, i1min, i1max, i2min, i2max, i3min, i3max, j1min, j1max, j2min, j2max, j3min, j3max, positx = 0, posity = 0, positz = 0, repet;
-   double lda, ldb, ldc, area, maximum = 0;
+   int i, j, k, lhx, lhy, lhz, positx = 0, posity = 0, positz = 0;
+   double lda, area, maximum = 0;
    if (ssizex <= 0 || ssizey <= 0 || ssizez <= 0)
       return "Wrong parameters";   
    if (numberIterations <= 0)
       return "Number of iterations must be positive";   
    if (numberRepetitions <= 0)
       return "Number of repetitions must be positive";      
-   double ***working_space=new double** [ssizex];
-   for(i=0;i<ssizex;i++){
-      working_space[i]=new double* [ssizey];
-      for(j=0;j<ssizey;j++)
-         working_space[i][j]=new double [5*ssizez];
-   }
    area = 0;
    lhx = -1, lhy = -1, lhz = -1;
    for (i = 0; i < ssizex; i++) {
@@ -2375,7 +2372,6 @@ decon_in-&gt;Draw(&quot;&quot;);
                if ((k + 1) > lhz)
                   lhz = k + 1;
             }
-            working_space[i][j][k] = lda;
             area = area + lda;
             if (lda > maximum) {
                maximum = lda;
@@ -2387,154 +2383,33 @@ decon_in-&gt;Draw(&quot;&quot;);
    if (lhx == -1 || lhy == -1 || lhz == -1)
       return ("Zero response data");   
 
-//calculate ht*y and write into p
-   for (i3 = 0; i3 < ssizez; i3++) {
-      for (i2 = 0; i2 < ssizey; i2++) {
-         for (i1 = 0; i1 < ssizex; i1++) {
-            ldc = 0;
-            for (j3 = 0; j3 <= (lhz - 1); j3++) {
-               for (j2 = 0; j2 <= (lhy - 1); j2++) {
-                  for (j1 = 0; j1 <= (lhx - 1); j1++) {
-                     k3 = i3 + j3, k2 = i2 + j2, k1 = i1 + j1;
-                     if (k3 >= 0 && k3 < ssizez && k2 >= 0 && k2 < ssizey && k1 >= 0 && k1 < ssizex) {
-                        lda = working_space[j1][j2][j3];
-                        ldb = source[k1][k2][k3];
-                        ldc = ldc + lda * ldb;
-                     }
-                  }
-               }
-            }
-            working_space[i1][i2][i3 + ssizez] = ldc;
-         }
-      }
-   }
-
-//calculate matrix b=ht*h
-   i1min = -(lhx - 1), i1max = lhx - 1;
-   i2min = -(lhy - 1), i2max = lhy - 1;
-   i3min = -(lhz - 1), i3max = lhz - 1;
-   for (i3 = i3min; i3 <= i3max; i3++) {
-      for (i2 = i2min; i2 <= i2max; i2++) {
-         for (i1 = i1min; i1 <= i1max; i1++) {
-            ldc = 0;
-            j3min = -i3;
-            if (j3min < 0)
-               j3min = 0;
-            j3max = lhz - 1 - i3;
-            if (j3max > lhz - 1)
-               j3max = lhz - 1;
-            for (j3 = j3min; j3 <= j3max; j3++) {
-               j2min = -i2;
-               if (j2min < 0)
-                  j2min = 0;
-               j2max = lhy - 1 - i2;
-               if (j2max > lhy - 1)
-                  j2max = lhy - 1;
-               for (j2 = j2min; j2 <= j2max; j2++) {
-                  j1min = -i1;
-                  if (j1min < 0)
-                     j1min = 0;
-                  j1max = lhx - 1 - i1;
-                  if (j1max > lhx - 1)
-                     j1max = lhx - 1;
-                  for (j1 = j1min; j1 <= j1max; j1++) {
-                     lda = working_space[j1][j2][j3];
-                     if (i1 + j1 < ssizex && i2 + j2 < ssizey)
-                        ldb = working_space[i1 + j1][i2 + j2][i3 + j3];
-                     else
-                        ldb = 0;
-                     ldc = ldc + lda * ldb;
-                  }
-               }
-            }
-            working_space[i1 - i1min][i2 - i2min][i3 - i3min + 2 * ssizez ] = ldc;
-         }
+   //the iterations are done in ROOT::TSpectrumHelper on contiguous arrays
+   //with the first index running fastest
+   Int_t n[3]  = {ssizex, ssizey, ssizez};
+   Int_t lh[3] = {lhx, lhy, lhz};
+   std::vector<Double_t> hresp(lhx * lhy * lhz);
+   std::vector<Double_t> ysrc(ssizex * ssizey * ssizez);
+   std::vector<Double_t> xdec(ssizex * ssizey * ssizez);
+   for (k = 0; k < lhz; k++) {
+      for (j = 0; j < lhy; j++) {
+         for (i = 0; i < lhx; i++)
+            hresp[(k * lhy + j) * lhx + i] = resp[i][j][k];
       }
    }
-
-//initialization in x1 matrix
-   for (i3 = 0; i3 < ssizez; i3++) {
-      for (i2 = 0; i2 < ssizey; i2++) {
-         for (i1 = 0; i1 < ssizex; i1++) {
-            working_space[i1][i2][i3 + 3 * ssizez] = 1;
-            working_space[i1][i2][i3 + 4 * ssizez] = 0;
-         }
-      }
-   }
-
- //START OF ITERATIONS
-   for (repet = 0; repet < numberRepetitions; repet++) {
-      if (repet != 0) {
-         for (i = 0; i < ssizex; i++) {
-            for (j = 0; j < ssizey; j++) {
-               for (k = 0; k < ssizez; k++) {
-                  working_space[i][j][k + 3 * ssizez] = TMath::Power(working_space[i][j][k + 3 * ssizez],boost);
-               }
-            }
-         }
-      }
-      for (lindex = 0; lindex < numberIterations; lindex++) {
-         for (i3 = 0; i3 < ssizez; i3++) {
-            for (i2 = 0; i2 < ssizey; i2++) {
-               for (i1 = 0; i1 < ssizex; i1++) {
-                  ldb = 0;
-                  j3min = i3;
-                  if (j3min > lhz - 1)
-                     j3min = lhz - 1;
-                  j3min = -j3min;
-                  j3max = ssizez - i3 - 1;
-                  if (j3max > lhz - 1)
-                     j3max = lhz - 1;
-                  j2min = i2;
-                  if (j2min > lhy - 1)
-                     j2min = lhy - 1;
-                  j2min = -j2min;
-                  j2max = ssizey - i2 - 1;
-                  if (j2max > lhy - 1)
-                     j2max = lhy - 1;
-                  j1min = i1;
-                  if (j1min > lhx - 1)
-                     j1min = lhx - 1;
-                  j1min = -j1min;
-                  j1max = ssizex - i1 - 1;
-                  if (j1max > lhx - 1)
-                     j1max = lhx - 1;
-                  for (j3 = j3min; j3 <= j3max; j3++) {
-                     for (j2 = j2min; j2 <= j2max; j2++) {
-                        for (j1 = j1min; j1 <= j1max; j1++) {
-                           ldc =  working_space[j1 - i1min][j2 - i2min][j3 - i3min + 2 * ssizez];
-                           lda = working_space[i1 + j1][i2 + j2][i3 + j3 + 3 * ssizez];
-                           ldb = ldb + lda * ldc;
-                        }
-                     }
-                  }
-                  lda = working_space[i1][i2][i3 + 3 * ssizez];
-                  ldc = working_space[i1][i2][i3 + 1 * ssizez];
-                  if (ldc * lda != 0 && ldb != 0) {
-                     lda = lda * ldc / ldb;
-                  }
-
-                  else
-                     lda = 0;
-                  working_space[i1][i2][i3 + 4 * ssizez] = lda;
-               }
-            }
-         }
-         for (i3 = 0; i3 < ssizez; i3++) {
-            for (i2 = 0; i2 < ssizey; i2++) {
-               for (i1 = 0; i1 < ssizex; i1++)
-                  working_space[i1][i2][i3 + 3 * ssizez] = working_space[i1][i2][i3 + 4 * ssizez];
-            }
-         }
+   for (k = 0; k < ssizez; k++) {
+      for (j = 0; j < ssizey; j++) {
+         for (i = 0; i < ssizex; i++)
+            ysrc[(k * ssizey + j) * ssizex + i] = source[i][j][k];
       }
    }
+   ROOT::TSpectrumHelper::GoldDeconvolution(3, n, lh, &hresp[0], &ysrc[0], &xdec[0],
+                                            numberIterations, numberRepetitions, boost);
    for (i = 0; i < ssizex; i++) {
       for (j = 0; j < ssizey; j++){
          for (k = 0; k < ssizez; k++)
-            source[(i + positx) % ssizex][(j + posity) % ssizey][(k + positz) % ssizez] = area * working_space[i][j][k + 3 * ssizez];
+            source[(i + positx) % ssizex][(j + posity) % ssizey][(k + positz) % ssizez] = area * xdec[(k * ssizey + j) * ssizex + i];
       }
    }
-   delete [] working_space;
    return 0;
 }
 
@@ -2889,7 +2764,7 @@ style='font-size:10.0pt'>search-&gt;Draw(&quot;&quot;);
 // --> End_Html
 
    int number_of_iterations = (int)(4 * sigma + 0.5);
-   int k,lindex;
+   int k;
    double lda,ldb,ldc,area,maximum;
    int xmin,xmax,l,peak_index = 0,sizex_ext=ssizex + 4 * number_of_iterations,sizey_ext = ssizey + 4 * number_of_iterations,sizez_ext = ssizez + 4 * number_of_iterations,shift = 2 * number_of_iterations;
    int ymin,ymax,zmin,zmax,i,j;
@@ -2898,7 +2773,7 @@ style='font-size:10.0pt'>search-&gt;Draw(&quot;&quot;);
    double p1,p2,p3,p4,p5,p6,p7,p8,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,r1,r2,r3,r4,r5,r6;
    int x,y,z;
    double pocet_sigma = 5;
-   int lhx,lhy,lhz,i1,i2,i3,j1,j2,j3,k1,k2,k3,i1min,i1max,i2min,i2max,i3min,i3max,j1min,j1max,j2min,j2max,j3min,j3max,positx,posity,positz;
+   int lhx,lhy,lhz,positx,posity,positz;
    if(sigma < 1){
       Error("SearchHighRes", "Invalid sigma, must be greater than or equal to 1");   
       return 0;
@@ -3877,148 +3752,31 @@ style='font-size:10.0pt'>search-&gt;Draw(&quot;&quot;);
          }
       }
    }
-   //calculate ht*y and write into p
-   for (i3 = 0; i3 < sizez_ext; i3++) {
-      for (i2 = 0; i2 < sizey_ext; i2++) {
-         for (i1 = 0; i1 < sizex_ext; i1++) {
-            ldc = 0;
-            for (j3 = 0; j3 <= (lhz - 1); j3++) {
-               for (j2 = 0; j2 <= (lhy - 1); j2++) {
-                  for (j1 = 0; j1 <= (lhx - 1); j1++) {
-                     k3 = i3 + j3, k2 = i2 + j2, k1 = i1 + j1;
-                     if (k3 >= 0 && k3 < sizez_ext && k2 >= 0 && k2 < sizey_ext && k1 >= 0 && k1 < sizex_ext) {
-                        lda = working_space[j1][j2][j3];
-                        ldb = working_space[k1][k2][k3+2*sizez_ext];
-                        ldc = ldc + lda * ldb;
-                     }
-                  }
-               }
-            }
-            working_space[i1][i2][i3 + sizez_ext] = ldc;
-         }
+   //the iterations are done in ROOT::TSpectrumHelper on contiguous arrays
+   //with the first index running fastest
+   Int_t next[3] = {sizex_ext, sizey_ext, sizez_ext};
+   Int_t lh[3]   = {lhx, lhy, lhz};
+   std::vector<Double_t> hresp(lhx * lhy * lhz);
+   std::vector<Double_t> ysrc(sizex_ext * sizey_ext * sizez_ext);
+   std::vector<Double_t> xdec(sizex_ext * sizey_ext * sizez_ext);
+   for (k = 0; k < lhz; k++) {
+      for (j = 0; j < lhy; j++) {
+         for (i = 0; i < lhx; i++)
+            hresp[(k * lhy + j) * lhx + i] = working_space[i][j][k];
       }
    }
-//calculate b=ht*h
-   i1min = -(lhx - 1), i1max = lhx - 1;
-   i2min = -(lhy - 1), i2max = lhy - 1;
-   i3min = -(lhz - 1), i3max = lhz - 1;
-   for (i3 = i3min; i3 <= i3max; i3++) {
-      for (i2 = i2min; i2 <= i2max; i2++) {
-         for (i1 = i1min; i1 <= i1max; i1++) {
-            ldc = 0;
-            j3min = -i3;
-            if (j3min < 0)
-               j3min = 0;
-               
-            j3max = lhz - 1 - i3;
-            if (j3max > lhz - 1)
-               j3max = lhz - 1;
-               
-            for (j3 = j3min; j3 <= j3max; j3++) {
-               j2min = -i2;
-               if (j2min < 0)
-                  j2min = 0;
-            
-               j2max = lhy - 1 - i2;
-               if (j2max > lhy - 1)
-                  j2max = lhy - 1;
-            
-               for (j2 = j2min; j2 <= j2max; j2++) {
-                  j1min = -i1;
-                  if (j1min < 0)
-                     j1min = 0;
-            
-                  j1max = lhx - 1 - i1;
-                  if (j1max > lhx - 1)
-                     j1max = lhx - 1;
-            
-                  for (j1 = j1min; j1 <= j1max; j1++) {
-                     lda = working_space[j1][j2][j3];
-                     if (i1 + j1 < sizex_ext && i2 + j2 < sizey_ext)
-                        ldb = working_space[i1 + j1][i2 + j2][i3 + j3];
-            
-                     else
-                        ldb = 0;
-                        
-                     ldc = ldc + lda * ldb;
-                  }
-               }
-            }
-            working_space[i1 - i1min][i2 - i2min][i3 - i3min + 2 * sizez_ext ] = ldc;
-         }
+   for (k = 0; k < sizez_ext; k++) {
+      for (j = 0; j < sizey_ext; j++) {
+         for (i = 0; i < sizex_ext; i++)
+            ysrc[(k * sizey_ext + j) * sizex_ext + i] = working_space[i][j][k + 2 * sizez_ext];
       }
    }
-//initialization in x1 cube
-   for (i3 = 0; i3 < sizez_ext; i3++) {
-      for (i2 = 0; i2 < sizey_ext; i2++) {
-         for (i1 = 0; i1 < sizex_ext; i1++) {
-            working_space[i1][i2][i3 + 3 * sizez_ext] = 1;
-            working_space[i1][i2][i3 + 4 * sizez_ext] = 0;
-         }
-      }
-   }
-
-//START OF ITERATIONS
-   for (lindex=0;lindex<deconIterations;lindex++){
-      for (i3 = 0; i3 < sizez_ext; i3++) {
-         for (i2 = 0; i2 < sizey_ext; i2++) {
-            for (i1 = 0; i1 < sizex_ext; i1++) {
-               if (TMath::Abs(working_space[i1][i2][i3 + 3 * sizez_ext])>1e-6 && TMath::Abs(working_space[i1][i2][i3 + 1 * sizez_ext])>1e-6){
-                  ldb = 0;
-                  j3min = i3;
-                  if (j3min > lhz - 1)
-                     j3min = lhz - 1;
-                     
-                  j3min = -j3min;
-                  j3max = sizez_ext - i3 - 1;
-                  if (j3max > lhz - 1)
-                     j3max = lhz - 1;
-                     
-                  j2min = i2;
-                  if (j2min > lhy - 1)
-                     j2min = lhy - 1;
-                     
-                  j2min = -j2min;
-                  j2max = sizey_ext - i2 - 1;
-                  if (j2max > lhy - 1)
-                     j2max = lhy - 1;
-                     
-                  j1min = i1;
-                  if (j1min > lhx - 1)
-                     j1min = lhx - 1;
-                     
-                  j1min = -j1min;
-                  j1max = sizex_ext - i1 - 1;
-                  if (j1max > lhx - 1)
-                     j1max = lhx - 1;
-                     
-                  for (j3 = j3min; j3 <= j3max; j3++) {
-                     for (j2 = j2min; j2 <= j2max; j2++) {
-                        for (j1 = j1min; j1 <= j1max; j1++) {
-                           ldc =  working_space[j1 - i1min][j2 - i2min][j3 - i3min + 2 * sizez_ext];
-                           lda = working_space[i1 + j1][i2 + j2][i3 + j3 + 3 * sizez_ext];
-                           ldb = ldb + lda * ldc;
-                        }
-                     }
-                  }
-                  lda = working_space[i1][i2][i3 + 3 * sizez_ext];
-                  ldc = working_space[i1][i2][i3 + 1 * sizez_ext];
-                  if (ldc * lda != 0 && ldb != 0) {
-                     lda = lda * ldc / ldb;
-                  }
-
-                  else
-                     lda = 0;
-                  working_space[i1][i2][i3 + 4 * sizez_ext] = lda;
-               }
-            }
-         }
-      }
-      for (i3 = 0; i3 < sizez_ext; i3++) {
-         for (i2 = 0; i2 < sizey_ext; i2++) {
-            for (i1 = 0; i1 < sizex_ext; i1++)
-               working_space[i1][i2][i3 + 3 * sizez_ext] = working_space[i1][i2][i3 + 4 * sizez_ext];
-         }
+   ROOT::TSpectrumHelper::GoldDeconvolution(3, next, lh, &hresp[0], &ysrc[0], &xdec[0],
+                                            deconIterations, 1, 1, 1e-6);
+   for (k = 0; k < sizez_ext; k++) {
+      for (j = 0; j < sizey_ext; j++) {
+         for (i = 0; i < sizex_ext; i++)
+            working_space[i][j][k + 3 * sizez_ext] = xdec[(k * sizey_ext + j) * sizex_ext + i];
       }
    }
 //write back resulting spectrum
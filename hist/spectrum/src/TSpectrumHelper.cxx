@@ -0,0 +1,313 @@
+// @(#)root/spectrum:$Id$
+// Author: Miroslav Morhac   17/01/2006
+
+/*************************************************************************
+ * Copyright (C) 1995-2006, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// helper functions and classes used internally by TSpectrum2 and TSpectrum3
+
+#include "TSpectrumHelper.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "TPluginManager.h"
+#include "TVirtualFFT.h"
+
+#include <algorithm>
+
+namespace ROOT {
+
+   namespace TSpectrumHelper {
+
+      // number of output points processed together for each kernel entry
+      // (the block of the output row stays in the L1 cache)
+      const Int_t kBlockSize = 512;
+
+      // the FFT is used when the direct sum costs more than kFFTCost * N log2(N)
+      const Double_t kFFTCost = 20;
+
+      // relative precision of the correlation computed with FFT
+      const Double_t kFFTPrecision = 1.E-13;
+
+      //______________________________________________________________________________
+      static Int_t GoodFFTSize(Int_t n)
+      {
+         // return the smallest size >= n with only 2,3,5 and 7 as prime factors
+         for (Int_t m = n; ; m++) {
+            Int_t r = m;
+            while (r % 2 == 0) r /= 2;
+            while (r % 3 == 0) r /= 3;
+            while (r % 5 == 0) r /= 5;
+            while (r % 7 == 0) r /= 7;
+            if (r == 1) return m;
+         }
+         return n;
+      }
+
+      //______________________________________________________________________________
+      TCorrelation::TCorrelation(Int_t ndim, const Int_t *nx, const Int_t *nk, const Double_t *k,
+                                 const Int_t *dmin, const Int_t *omin, const Int_t *nout) :
+         fNdim(ndim),
+         fKernelNorm(0),
+         fFFTForward(0),
+         fFFTBackward(0)
+      {
+         // constructor from the sizes (ndim values) of the input array, of the kernel,
+         // of the output array, the kernel values and the first kernel and output indices
+
+         Int_t nkk[3];
+         for (Int_t d = 0; d < 3; d++) {
+            if (d < ndim) {
+               fNx[d]   = nx[d];
+               nkk[d]   = nk[d];
+               fNout[d] = nout[d];
+               fA[d]    = omin[d] + dmin[d];
+            } else {
+               fNx[d] = nkk[d] = fNout[d] = 1;
+               fA[d] = 0;
+            }
+            fP[d] = fNout[d] + nkk[d] - 1;
+            fN[d] = 1;
+         }
+         fXp.assign(fP[0] * fP[1] * fP[2], 0.);
+
+         // keep the non-zero kernel entries in the order of the original loops
+         for (Int_t k3 = 0; k3 < nkk[2]; k3++) {
+            for (Int_t k2 = 0; k2 < nkk[1]; k2++) {
+               for (Int_t k1 = 0; k1 < nkk[0]; k1++) {
+                  Double_t c = k[(k3 * nkk[1] + k2) * nkk[0] + k1];
+                  if (c == 0) continue;
+                  fOffset.push_back((k3 * fP[1] + k2) * fP[0] + k1);
+                  fCoef.push_back(c);
+                  fKernelNorm += TMath::Abs(c);
+               }
+            }
+         }
+
+         // choose between the direct sum and the FFT
+         Double_t ntot = 1;
+         for (Int_t d = 0; d < ndim; d++) {
+            fN[d] = GoodFFTSize(fP[d]);
+            ntot *= fN[d];
+         }
+         Double_t direct = Double_t(fCoef.size()) * fNout[0] * fNout[1] * fNout[2];
+         if (ntot > 1 && direct > kFFTCost * ntot * TMath::Log2(ntot)) InitFFT(k);
+      }
+
+      //______________________________________________________________________________
+      TCorrelation::~TCorrelation()
+      {
+         // destructor
+
+         delete fFFTForward;
+         delete fFFTBackward;
+      }
+
+      //______________________________________________________________________________
+      void TCorrelation::InitFFT(const Double_t *k)
+      {
+         // create the transforms and compute the transform of the kernel.
+         // Nothing is done if the FFTW plugin is not available
+
+         TPluginHandler *h = gROOT->GetPluginManager()->FindHandler("TVirtualFFT", "fftwr2c");
+         if (!h || h->CheckPlugin() == -1) return;
+
+         // TVirtualFFT wants the last index running fastest
+         Int_t n[3];
+         for (Int_t d = 0; d < fNdim; d++) n[d] = fN[fNdim - 1 - d];
+         fFFTForward  = TVirtualFFT::FFT(fNdim, n, "R2C ES K");
+         fFFTBackward = TVirtualFFT::FFT(fNdim, n, "C2R ES K");
+         if (!fFFTForward || !fFFTBackward) {
+            delete fFFTForward;
+            delete fFFTBackward;
+            fFFTForward = fFFTBackward = 0;
+            return;
+         }
+
+         const Int_t ntot = fN[0] * fN[1] * fN[2];
+         const Int_t ncomplex = (fN[0] / 2 + 1) * fN[1] * fN[2];
+         fBuf.assign(ntot, 0.);
+         fRe.resize(ncomplex);
+         fIm.resize(ncomplex);
+         fKre.resize(ncomplex);
+         fKim.resize(ncomplex);
+
+         // out(i) = sum_j x(j) * k(j - i) : the kernel is stored reversed
+         const Int_t nk1 = fP[0] - fNout[0] + 1;
+         const Int_t nk2 = fP[1] - fNout[1] + 1;
+         const Int_t nk3 = fP[2] - fNout[2] + 1;
+         for (Int_t k3 = 0; k3 < nk3; k3++) {
+            for (Int_t k2 = 0; k2 < nk2; k2++) {
+               for (Int_t k1 = 0; k1 < nk1; k1++) {
+                  Int_t j = (((fN[2] - k3) % fN[2]) * fN[1] + (fN[1] - k2) % fN[1]) * fN[0] + (fN[0] - k1) % fN[0];
+                  fBuf[j] = k[(k3 * nk2 + k2) * nk1 + k1];
+               }
+            }
+         }
+         fFFTForward->SetPoints(&fBuf[0]);
+         fFFTForward->Transform();
+         fFFTForward->GetPointsComplex(&fKre[0], &fKim[0]);
+         // include the normalization of the backward transform
+         for (Int_t i = 0; i < ncomplex; i++) {
+            fKre[i] /= ntot;
+            fKim[i] /= ntot;
+         }
+         fBuf.assign(ntot, 0.);
+      }
+
+      //______________________________________________________________________________
+      void TCorrelation::CopyPadded(const Double_t *x, Double_t *buf, const Int_t *len) const
+      {
+         // copy the needed part of x in the zero-padded array buf of size len
+
+         Int_t lo[3], hi[3];
+         for (Int_t d = 0; d < 3; d++) {
+            lo[d] = TMath::Max(0, fA[d]);
+            hi[d] = TMath::Min(fNx[d], fA[d] + fP[d]);
+            if (lo[d] >= hi[d]) return;
+         }
+         for (Int_t j3 = lo[2]; j3 < hi[2]; j3++) {
+            for (Int_t j2 = lo[1]; j2 < hi[1]; j2++) {
+               const Double_t *src = x + (j3 * fNx[1] + j2) * fNx[0];
+               Double_t *dst = buf + ((j3 - fA[2]) * len[1] + (j2 - fA[1])) * len[0] - fA[0];
+               for (Int_t j1 = lo[0]; j1 < hi[0]; j1++) dst[j1] = src[j1];
+            }
+         }
+      }
+
+      //______________________________________________________________________________
+      void TCorrelation::Apply(const Double_t *x, Double_t *out)
+      {
+         // compute the correlation of x with the kernel
+
+         if (fFFTForward) {
+            CopyPadded(x, &fBuf[0], fN);
+            Double_t xmax = 0;
+            for (Int_t i = 0; i < fNx[0] * fNx[1] * fNx[2]; i++)
+               xmax = TMath::Max(xmax, TMath::Abs(x[i]));
+            fFFTForward->SetPoints(&fBuf[0]);
+            fFFTForward->Transform();
+            fFFTForward->GetPointsComplex(&fRe[0], &fIm[0]);
+            const Int_t ncomplex = fRe.size();
+            for (Int_t i = 0; i < ncomplex; i++) {
+               Double_t re = fRe[i] * fKre[i] - fIm[i] * fKim[i];
+               fIm[i] = fRe[i] * fKim[i] + fIm[i] * fKre[i];
+               fRe[i] = re;
+            }
+            fFFTBackward->SetPointsComplex(&fRe[0], &fIm[0]);
+            fFFTBackward->Transform();
+            const Double_t *y = fFFTBackward->GetPointsReal();
+            const Double_t eps = kFFTPrecision * fKernelNorm * xmax;
+            for (Int_t i3 = 0; i3 < fNout[2]; i3++) {
+               for (Int_t i2 = 0; i2 < fNout[1]; i2++) {
+                  const Double_t *yrow = y + (i3 * fN[1] + i2) * fN[0];
+                  Double_t *orow = out + (i3 * fNout[1] + i2) * fNout[0];
+                  for (Int_t i1 = 0; i1 < fNout[0]; i1++)
+                     orow[i1] = (TMath::Abs(yrow[i1]) > eps) ? yrow[i1] : 0;
+               }
+            }
+            return;
+         }
+
+         CopyPadded(x, &fXp[0], fP);
+         const Double_t *xp = &fXp[0];
+         const Int_t ncoef = fCoef.size();
+         const Int_t *offset = (ncoef > 0) ? &fOffset[0] : 0;
+         const Double_t *coef = (ncoef > 0) ? &fCoef[0] : 0;
+         const Int_t nout1 = fNout[0];
+         const Int_t nout2 = fNout[1];
+         const Int_t nrows = fNout[1] * fNout[2];
+         const Int_t p1 = fP[0];
+         const Int_t p2 = fP[1];
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+         for (Int_t row = 0; row < nrows; row++) {
+            const Double_t *xrow = xp + ((row / nout2) * p2 + row % nout2) * p1;
+            Double_t *orow = out + row * nout1;
+            for (Int_t i1 = 0; i1 < nout1; i1++) orow[i1] = 0;
+            for (Int_t ib = 0; ib < nout1; ib += kBlockSize) {
+               const Int_t ie = TMath::Min(ib + kBlockSize, nout1);
+               for (Int_t ic = 0; ic < ncoef; ic++) {
+                  const Double_t c = coef[ic];
+                  const Double_t *xs = xrow + offset[ic];
+                  for (Int_t i1 = ib; i1 < ie; i1++) orow[i1] += c * xs[i1];
+               }
+            }
+         }
+      }
+
+      //______________________________________________________________________________
+      void GoldDeconvolution(Int_t ndim, const Int_t *n, const Int_t *lh, const Double_t *resp,
+                             const Double_t *source, Double_t *x,
+                             Int_t numberIterations, Int_t numberRepetitions,
+                             Double_t boost, Double_t threshold)
+      {
+         // Gold deconvolution algorithm (see TSpectrum2::Deconvolution)
+
+         Int_t zero[3] = {0, 0, 0};
+         Int_t bmin[3], nb[3];
+         Int_t ntot = 1, nbtot = 1;
+         for (Int_t d = 0; d < ndim; d++) {
+            bmin[d] = -(lh[d] - 1);
+            nb[d] = 2 * lh[d] - 1;
+            ntot *= n[d];
+            nbtot *= nb[d];
+         }
+
+         //calculate ht*y and write into p
+         std::vector<Double_t> p(ntot);
+         {
+            TCorrelation corr(ndim, n, lh, resp, zero, zero, n);
+            corr.Apply(source, &p[0]);
+         }
+
+         //calculate matrix b=ht*h
+         std::vector<Double_t> b(nbtot);
+         {
+            TCorrelation corr(ndim, lh, lh, resp, zero, bmin, nb);
+            corr.Apply(resp, &b[0]);
+         }
+
+         //initialization in x1 matrix
+         TCorrelation corr(ndim, n, nb, &b[0], bmin, zero, n);
+         std::vector<Double_t> ldb(ntot);
+         std::vector<Double_t> xnew(ntot, 0.);
+         for (Int_t i = 0; i < ntot; i++) x[i] = 1;
+
+         //START OF ITERATIONS
+         for (Int_t repet = 0; repet < numberRepetitions; repet++) {
+            if (repet != 0) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+               for (Int_t i = 0; i < ntot; i++) x[i] = TMath::Power(x[i], boost);
+            }
+            for (Int_t lindex = 0; lindex < numberIterations; lindex++) {
+               corr.Apply(x, &ldb[0]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+               for (Int_t i = 0; i < ntot; i++) {
+                  Double_t lda = x[i];
+                  Double_t ldc = p[i];
+                  if (threshold < 0 || (lda > threshold && ldc > threshold)) {
+                     if (ldc * lda != 0 && ldb[i] != 0)
+                        lda = lda * ldc / ldb[i];
+                     else
+                        lda = 0;
+                     xnew[i] = lda;
+                  }
+               }
+               std::copy(xnew.begin(), xnew.end(), x);
+            }
+         }
+      }
+
+   } // end namespace TSpectrumHelper
+
+} // end namespace ROOT
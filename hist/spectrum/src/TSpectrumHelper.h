@@ -0,0 +1,110 @@
+// @(#)root/spectrum:$Id$
+// Author: Miroslav Morhac   17/01/2006
+
+/*************************************************************************
+ * Copyright (C) 1995-2006, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// helper functions and classes used internally by TSpectrum2 and TSpectrum3
+// for the iterative (Gold) deconvolution
+
+#ifndef ROOT_TSpectrumHelper
+#define ROOT_TSpectrumHelper
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#include <vector>
+
+class TVirtualFFT;
+
+namespace ROOT {
+
+   namespace TSpectrumHelper {
+
+  /**
+     Correlation of an array with a kernel in up to 3 dimensions
+
+        out(i) = sum_d  k(d) * x(i + d)
+
+     with x(j) = 0 outside [0,nx). d runs in [dmin, dmin + nk) and the output
+     is computed for i in [omin, omin + nout). All the arrays are stored
+     contiguously with the first index running fastest.
+
+     For small kernels the sum is computed directly: the rows of the output are
+     processed in parallel (when compiled with OpenMP) and in blocks fitting in
+     the cache, while each output point gets the kernel terms added in the same
+     order as the original serial loops (last index outermost), so the result is
+     identical to them.
+     For large kernels, when the FFTW plugin is available, the correlation is
+     computed with FFT, with the transform of the kernel computed only once.
+     The result agrees then within round-off and values below the FFT precision
+     are set to zero.
+  */
+      class TCorrelation {
+
+      public:
+
+         TCorrelation(Int_t ndim, const Int_t *nx, const Int_t *nk, const Double_t *k,
+                      const Int_t *dmin, const Int_t *omin, const Int_t *nout);
+
+         ~TCorrelation();
+
+         // compute the correlation of x (of size nx) and write it in out (of size nout)
+         void Apply(const Double_t *x, Double_t *out);
+
+         // return true if the correlation is computed with FFT
+         Bool_t UseFFT() const { return fFFTForward != 0; }
+
+      private:
+
+         TCorrelation(const TCorrelation &);
+         TCorrelation & operator=(const TCorrelation &);
+
+         void InitFFT(const Double_t *k);
+         void CopyPadded(const Double_t *x, Double_t *buf, const Int_t *len) const;
+
+         Int_t fNdim;
+         Int_t fNx[3];                 // size of the input array
+         Int_t fNout[3];               // size of the output array
+         Int_t fA[3];                  // first input index needed (omin + dmin)
+         Int_t fP[3];                  // size of the zero-padded input (nout + nk - 1)
+         std::vector<Double_t> fXp;    // zero-padded input
+         std::vector<Int_t> fOffset;   // offsets in fXp of the non-zero kernel entries
+         std::vector<Double_t> fCoef;  // values of the non-zero kernel entries
+         Double_t fKernelNorm;         // sum of |k|
+
+         // FFT data
+         Int_t fN[3];                  // size of the transforms
+         TVirtualFFT *fFFTForward;     // R2C transform
+         TVirtualFFT *fFFTBackward;    // C2R transform
+         std::vector<Double_t> fKre;   // transform of the kernel (real part)
+         std::vector<Double_t> fKim;   // transform of the kernel (imaginary part)
+         std::vector<Double_t> fBuf;   // work array for the real data
+         std::vector<Double_t> fRe;    // work array for the transform (real part)
+         std::vector<Double_t> fIm;    // work array for the transform (imaginary part)
+      };
+
+  /**
+     Gold deconvolution of the source array (of size n) with the response
+     function resp (of size lh), both with the first index running fastest.
+     The result (before the shift by the position of the response maximum) is
+     written in x.
+     If threshold < 0 all the points are updated at every iteration (Deconvolution),
+     otherwise only the points with x > threshold and ht*y > threshold (SearchHighRes).
+  */
+      void GoldDeconvolution(Int_t ndim, const Int_t *n, const Int_t *lh, const Double_t *resp,
+                             const Double_t *source, Double_t *x,
+                             Int_t numberIterations, Int_t numberRepetitions = 1,
+                             Double_t boost = 1, Double_t threshold = -1);
+
+   } // end namespace TSpectrumHelper
+
+} // end namespace ROOT
+
+#endif
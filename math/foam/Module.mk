@@ -57,6 +57,12 @@ $(FOAMMAP):     $(RLIBMAP) $(MAKEFILEDEP) $(FOAML)
 
 all-$(MODNAME): $(FOAMLIB) $(FOAMMAP)
 
+# for openMP (parallel build-up of the foam and bulk generation in TFoam)
+ifneq ($(USE_OPENMP),)
+$(call stripsrc,$(FOAMDIRS)/TFoam.o): CXXFLAGS += -fopenmp
+$(FOAMLIB): LDFLAGS += -fopenmp
+endif
+
 clean-$(MODNAME):
 		@rm -f $(FOAMO) $(FOAMDO)
 
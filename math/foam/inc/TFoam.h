@@ -81,6 +81,10 @@ protected:
    Double_t fMCerror;         // and its error
    //----------  working space for CELL exploration -------------
    Double_t *fAlpha;          // [fDim] Internal parameters of the hyperrectangle
+   //----------  parallel build-up and bulk generation -------------
+   Int_t     fNThreads;       // No. of threads in the foam build-up and in MakeEvents, =0 for the serial build-up
+   Int_t     fNDivide;        // No. of cells divided at once in the parallel build-up
+   Double_t *fCellsGeom;      //! Position, size, volume and primary of the active cells, used by MakeEvents
    //////////////////////////////////////////////////////////////////////////////////////////////
    //                                     METHODS                                              //
    //////////////////////////////////////////////////////////////////////////////////////////////
@@ -110,6 +114,10 @@ public:
    virtual void     GetMCwt(Double_t &);     // Provides generated MC weight
    virtual Double_t GetMCwt();               // Provides generates MC weight
    virtual Double_t MCgenerate(Double_t *MCvect);// All three above function in one
+   virtual void     MakeEvents(Int_t nev, Double_t *vect, Double_t *wt = 0); // Makes nev MC events at once
+   // Persistency of the cells
+   virtual Int_t    WriteCells(const char *name) const; // Writes the cells in the current directory
+   virtual Bool_t   ReadCells(const char *name);        // Alternative to Initialize, reads the cells written by WriteCells
    // Finalization
    virtual void GetIntegMC(Double_t&, Double_t&);// Provides Integrand and abs. error from MC run
    virtual void GetIntNorm(Double_t&, Double_t&);// Provides normalization Inegrand
@@ -131,6 +139,8 @@ public:
    virtual void SetOptRej(Int_t OptRej){fOptRej =OptRej;}   // Sets option for MC rejection
    virtual void SetOptDrive(Int_t OptDrive){fOptDrive =OptDrive;}  // Sets optimization switch
    virtual void SetEvPerBin(Int_t EvPerBin){fEvPerBin =EvPerBin;}  // Sets max. no. of effective events per bin
+   virtual void SetnThreads(Int_t nThreads){fNThreads =nThreads;}  // Sets no. of threads, >0 for the parallel build-up
+   virtual void SetnDivide(Int_t nDivide){fNDivide =nDivide;}      // Sets no. of cells divided at once in the parallel build-up
    virtual void SetMaxWtRej(Double_t MaxWtRej){fMaxWtRej=MaxWtRej;}  // Sets max. weight for rejection
    virtual void SetInhiDiv(Int_t, Int_t );            // Set inhibition of cell division along certain edge
    virtual void SetXdivPRD(Int_t, Int_t, Double_t[]); // Set predefined division points
@@ -141,6 +151,8 @@ public:
    virtual void GetPrimary(Double_t &prime) {prime = fPrime;}      // Get value of primary integral R'
    virtual Long_t GetnCalls() const {return fNCalls;}            // Get total no. of the function calls
    virtual Long_t GetnEffev() const {return fNEffev;}            // Get total no. of effective wt=1 events
+   virtual Int_t  GetnThreads() const {return fNThreads;}        // Get no. of threads
+   virtual Int_t  GetnDivide() const {return fNDivide;}          // Get no. of cells divided at once in the parallel build-up
    // Debug
    virtual void CheckAll(Int_t);     // Checks correctness of the entire data structure in the FOAM object
    virtual void PrintCells();        // Prints content of all cells
@@ -149,8 +161,15 @@ public:
    // Inline
 private:
    Double_t Sqr(Double_t x) const { return x*x;}      // Square function
+   void   InitWorkSpace();                            // Allocates the buffers and the histograms
+   void   InitGeneration();                           // Prepares the MC generation after the build-up
+   void   ExploreCell(TFoamCell *, const Double_t *sample, Long_t nSample); // Explore with given MC sample
+   void   GrowParallel();                             // Grow dividing fNDivide cells at once
+   void   ExploreCells(Int_t n, const Long_t *iCells, UInt_t seed); // Explores n new cells in parallel
+   Long_t SampleCell(const Double_t *posi, const Double_t *size, Double_t dx, TRandom *rnd, Double_t *sample);
+   Long_t FindCell(Double_t random) const;           // Index of the active cell for the cumulative primary random
    //////////////////////////////////////////////////////////////////////////////////////////////
-   ClassDef(TFoam,1);   // General purpose self-adapting Monte Carlo event generator
+   ClassDef(TFoam,2);   // General purpose self-adapting Monte Carlo event generator
 };
 
 #endif
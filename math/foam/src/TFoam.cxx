@@ -109,6 +109,14 @@
 // Increasing nSampl sometimes helps, but it may cost CPU time.
 // MaxWtRej may need to be increased for wild a distribution, while using OptRej=0.
 //
+// Parallel build-up, bulk generation and restart from the cells
+// ==============================================================
+// With SetnThreads(n), n>0, nDivide cells (SetnDivide, default 16) are divided
+// at once in the build-up and the new cells are explored in parallel by n
+// threads when ROOT is built with openMP, see GrowParallel. MakeEvents(nev,...)
+// generates nev events at once. WriteCells and ReadCells save the cells of a
+// built foam and make the foam again from them without exploration.
+//
 // --------------------------------------------------------------------
 // Past versions of FOAM: August 2003, v.1.00; September 2003 v.1.01
 // Adopted starting from FOAM-2.06 by P. Sawicki
@@ -128,9 +136,20 @@
 #include "TRefArray.h"
 #include "TMethodCall.h"
 #include "TRandom.h"
+#include "TRandomPhilox.h"
+#include "TArrayD.h"
+#include "TDirectory.h"
 #include "TMath.h"
 #include "TInterpreter.h"
 
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ClassImp(TFoam);
 
 //FFFFFF  BoX-FORMATs for nice and flexible outputs
@@ -172,7 +191,8 @@ TFoam::TFoam() :
    fSumOve(0), fNevGen(0), 
    fWtMax(0), fWtMin(0), 
    fPrime(0), fMCresult(0), fMCerror(0), 
-   fAlpha(0)
+   fAlpha(0), 
+   fNThreads(0), fNDivide(0), fCellsGeom(0)
 {
   // Default constructor for streamer, user should not use it.
 }
@@ -192,7 +212,8 @@ TFoam::TFoam(const Char_t* Name) :
    fSumOve(0), fNevGen(0), 
    fWtMax(0), fWtMin(0), 
    fPrime(0), fMCresult(0), fMCerror(0), 
-   fAlpha(0)
+   fAlpha(0), 
+   fNThreads(0), fNDivide(0), fCellsGeom(0)
 {
 // User constructor, to be employed by the user
 
@@ -223,6 +244,9 @@ TFoam::TFoam(const Char_t* Name) :
    fNBin     = 8;                // binning of edge-histogram in cell exploration
    fEvPerBin =25;                // maximum no. of EFFECTIVE event per bin, =0 option is inactive
    //------------------------------------------------------
+   fNThreads = 0;                // serial build-up of the foam
+   fNDivide  =16;                // cells divided at once in the parallel build-up
+   //------------------------------------------------------
    fNCalls = 0;                  // No of function calls
    fNEffev = 0;                  // Total no of eff. wt=1 events in build=up
    fLastCe =-1;                  // Index of the last cell
@@ -255,6 +279,7 @@ TFoam::~TFoam()
    if (fAlpha)   delete [] fAlpha;   //double[]
    if (fMCvect)  delete [] fMCvect;  //double[]
    if (fPrimAcu) delete [] fPrimAcu; //double[]
+   if (fCellsGeom) delete [] fCellsGeom; //double[]
    if (fMaskDiv) delete [] fMaskDiv; //int[]
    if (fInhiDiv) delete [] fInhiDiv; //int[]
  
@@ -341,7 +366,6 @@ void TFoam::Initialize()
 
    Bool_t addStatus = TH1::AddDirectoryStatus();
    TH1::AddDirectory(kFALSE);
-   Int_t i;
 
    if(fChat>0){
       BXOPE;
@@ -358,6 +382,8 @@ void TFoam::Initialize()
       BX1I(" OptDrive",fOptDrive, " Type of Driver   =1,2 for Sigma,WtMax            ");
       BX1I("   OptRej",fOptRej,   " MC rejection on/off for OptRej=0,1               ");
       BX1F(" MaxWtRej",fMaxWtRej, " Maximum wt in rejection for wt=1 evts");
+      if(fNThreads>0)
+      BX1I(" nThreads",fNThreads, " No of threads in the parallel build-up          ");
       BXCLO;
    }
 
@@ -365,6 +391,59 @@ void TFoam::Initialize()
    if(fRho==0 && fMethodCall==0 ) Error("Initialize", "Distribution function not set \n");
    if(fDim==0) Error("Initialize", "Zero dimension not allowed \n");
 
+   InitWorkSpace();
+
+   // ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||| //
+   //                     BUILD-UP of the FOAM                            //
+   // ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||| //
+   //
+   //        Define and explore root cell(s)
+   InitCells();
+   //        PrintCells(); cout<<" ===== after InitCells ====="<<endl;
+   Grow();
+   //        PrintCells(); cout<<" ===== after Grow      ====="<<endl;
+
+   InitGeneration(); // Final Preperations for the M.C. generation
+   //
+   if(fChat>0){
+      Double_t driver = fCells[0]->GetDriv();
+      BXOPE;
+      BXTXT("***  TFoam::Initialize FINISHED!!!  ***");
+      BX1I("    nCalls",fNCalls,  "Total number of function calls         ");
+      BX1F("    XPrime",fPrime,   "Primary total integral                 ");
+      BX1F("    XDiver",driver,    "Driver  total integral                 ");
+      BX1F("  mcResult",fMCresult,"Estimate of the true MC Integral       ");
+      BXCLO;
+   }
+   if(fChat==2) PrintCells();
+   TH1::AddDirectory(addStatus);
+} // Initialize
+
+//_______________________________________________________________________________________
+void TFoam::InitWorkSpace()
+{
+// Internal subprogram used by Initialize and ReadCells.
+// It allocates the small lists and the histograms used in the build-up and in the MC generation.
+
+   Int_t i;
+
+   // flush the buffers and histograms of a previous Initialize or ReadCells
+   if (fRvec)    delete [] fRvec;
+   if (fAlpha)   delete [] fAlpha;
+   if (fMCvect)  delete [] fMCvect;
+   fRvec = 0; fAlpha = 0; fMCvect = 0;
+   if (fHistWt)  delete fHistWt;
+   fHistWt = 0;
+   if (fHistEdg) {
+      fHistEdg->Delete();
+      delete fHistEdg;
+   }
+   if (fHistDbg) {
+      fHistDbg->Delete();
+      delete fHistDbg;
+   }
+   fHistEdg = 0; fHistDbg = 0;
+
    /////////////////////////////////////////////////////////////////////////
    //                   ALLOCATE SMALL LISTS                              //
    //  it is done globally, not for each cell, to save on allocation time //
@@ -418,18 +497,15 @@ void TFoam::Initialize()
       htitle+=i;
       (*fHistDbg)[i] = new TH1D(hname.Data(),htitle.Data(),fNBin,0.0, 1.0); // Initialize histogram for each edge
    }
+} // InitWorkSpace
 
-   // ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||| //
-   //                     BUILD-UP of the FOAM                            //
-   // ||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||| //
-   //
-   //        Define and explore root cell(s)
-   InitCells();
-   //        PrintCells(); cout<<" ===== after InitCells ====="<<endl;
-   Grow();
-   //        PrintCells(); cout<<" ===== after Grow      ====="<<endl;
+//_______________________________________________________________________________________
+void TFoam::InitGeneration()
+{
+// Internal subprogram used by Initialize and ReadCells.
+// It prepares the M.C. generation once the cells are defined.
 
-   MakeActiveList(); // Final Preperations for the M.C. generation
+   MakeActiveList(); // Table of active cells
 
    // Preperations for the M.C. generation
    fSumWt  = 0.0;               // M.C. generation sum of Wt
@@ -441,21 +517,9 @@ void TFoam::Initialize()
    fMCresult=fCells[0]->GetIntg(); // M.C. Value of INTEGRAL,temporary assignment
    fMCresult=fCells[0]->GetIntg(); // M.C. Value of INTEGRAL,temporary assignment
    fMCerror =fCells[0]->GetIntg(); // M.C. Value of ERROR   ,temporary assignment
+   if (fMCMonit) delete fMCMonit;
    fMCMonit = new TFoamMaxwt(5.0,1000);  // monitoring M.C. efficiency
-   //
-   if(fChat>0){
-      Double_t driver = fCells[0]->GetDriv();
-      BXOPE;
-      BXTXT("***  TFoam::Initialize FINISHED!!!  ***");
-      BX1I("    nCalls",fNCalls,  "Total number of function calls         ");
-      BX1F("    XPrime",fPrime,   "Primary total integral                 ");
-      BX1F("    XDiver",driver,    "Driver  total integral                 ");
-      BX1F("  mcResult",fMCresult,"Estimate of the true MC Integral       ");
-      BXCLO;
-   }
-   if(fChat==2) PrintCells();
-   TH1::AddDirectory(addStatus);
-} // Initialize
+} // InitGeneration
 
 //_______________________________________________________________________________________
 void TFoam::InitCells()
@@ -536,6 +600,18 @@ void TFoam::Explore(TFoamCell *cell)
 // Note that links to parents and initial volume = 1/2 parent has to be
 // already defined prior to calling this routine.
 
+   ExploreCell(cell, 0, 0);
+} // TFoam::Explore
+
+//______________________________________________________________________________________
+void TFoam::ExploreCell(TFoamCell *cell, const Double_t *sample, Long_t nSample)
+{
+// Internal subprogram used by Explore and ExploreCells.
+// It does the job of Explore, see above. If sample is not zero the MC points
+// are not generated but taken from sample, which contains nSample points made
+// by SampleCell, each one given by the fDim internal parameters alpha followed
+// by the weight.
+
    Double_t wt, dx, xBest=0, yBest=0;
    Double_t intOld, driOld;
 
@@ -577,6 +653,12 @@ void TFoam::Explore(TFoamCell *cell)
    // ||||||||||||||||||||||||||BEGIN MC LOOP|||||||||||||||||||||||||||||
    Double_t nevEff=0.;
    for(iev=0;iev<fNSampl;iev++){
+      if(sample) {               // point already generated by SampleCell
+         if(iev>=nSample) break;
+         const Double_t *point = sample +iev*(fDim+1);
+         for(k=0; k<fDim; k++) fAlpha[k] = point[k];
+         wt = point[fDim];
+      } else {
       MakeAlpha();               // generate uniformly vector inside hypercube
 
       if(fDim>0){
@@ -585,6 +667,7 @@ void TFoam::Explore(TFoamCell *cell)
       }
 
       wt=dx*Eval(xRand);
+      }
 
       nProj = 0;
       if(fDim>0) {
@@ -676,7 +759,7 @@ void TFoam::Explore(TFoamCell *cell)
    delete [] volPart;
    delete [] xRand;
    //cell->Print();
-} // TFoam::Explore
+} // TFoam::ExploreCell
 
 //______________________________________________________________________________________
 void TFoam::Varedu(Double_t ceSum[5], Int_t &kBest, Double_t &xBest, Double_t &yBest)
@@ -873,10 +956,17 @@ void TFoam::Grow()
 {
 // Internal subrogram used by Initialize.
 // It grow new cells by the binary division process.
+// With SetnThreads(n>0) the cells are divided and explored in groups,
+// see GrowParallel.
 
    Long_t iCell;
    TFoamCell* newCell;
 
+   if(fNThreads>0) {
+      GrowParallel();
+      return;
+   }
+
    while ( (fLastCe+2) < fNCells ) {  // this condition also checked inside Divide
       iCell   = PeekMax();            // peek up cell with maximum driver integral
       if( (iCell<0) || (iCell>fLastCe) ) Error("Grow", "Wrong iCell \n");
@@ -903,6 +993,163 @@ void TFoam::Grow()
    CheckAll(0);   // set arg=1 for more info
 }// Grow
 
+//_____________________________________________________________________________________________
+void TFoam::GrowParallel()
+{
+// Internal subprogram used by Grow when the number of threads is set (SetnThreads(n), n>0).
+// At each step the fNDivide active cells with the largest driver integrals
+// (the first one being the cell chosen by PeekMax) are divided at once and
+// their daughters are explored together by ExploreCells: the MC sampling of
+// the new cells, where the time is spent, is made in parallel by n threads.
+// Each new cell is sampled with its own stream of a TRandomPhilox generator,
+// the stream number being the cell index and the seed being taken from the
+// generator of the foam. The foam obtained does therefore not depend on the
+// number of threads, but it differs from the one of the serial build-up.
+// IMPORTANT: the integrand (TFoamIntegrand::Density) is called concurrently
+// from several threads and must be thread safe. An integrand given with
+// SetRhoInt is always evaluated by one thread.
+
+   Int_t i;
+   const Int_t nDivide = TMath::Max(fNDivide, 1);
+   UInt_t seed = 1 + fPseRan->Integer(kMaxUInt);   // seed of the exploration streams
+
+   std::vector<std::pair<Double_t, Long_t> > drivers;
+   std::vector<Long_t> newCells;
+   while ( (fLastCe+2) < fNCells ) {
+      // active cells ordered by decreasing driver integral (by index for equal drivers, as in PeekMax)
+      drivers.clear();
+      for(Long_t iCell=0; iCell<=fLastCe; iCell++) {
+         if( fCells[iCell]->GetStat() == 1 )
+            drivers.push_back(std::make_pair(-TMath::Abs(fCells[iCell]->GetDriv()), iCell));
+      }
+      Int_t nDiv = TMath::Min(nDivide, (fNCells -fLastCe -1)/2);
+      nDiv = TMath::Min(nDiv, (Int_t) drivers.size());
+      if(nDiv == 0) {
+         Error("GrowParallel", "No active cell \n");
+         break;
+      }
+      std::partial_sort(drivers.begin(), drivers.begin() +nDiv, drivers.end());
+
+      Long_t lastCe = fLastCe;
+      newCells.clear();
+      for(i=0; i<nDiv; i++) {
+         TFoamCell *cell = fCells[drivers[i].second];
+         cell->SetStat(0);    // reset cell as inactive
+         fNoAct--;
+         Int_t kBest = cell->GetBest();
+         if( kBest<0 || kBest>=fDim ) Error("GrowParallel", "Wrong kBest \n");
+         Int_t d1 = CellFill(1,   cell);
+         Int_t d2 = CellFill(1,   cell);
+         cell->SetDau0((fCells[d1]));
+         cell->SetDau1((fCells[d2]));
+         newCells.push_back(d1);
+         newCells.push_back(d2);
+      }
+      ExploreCells((Int_t) newCells.size(), &newCells[0], seed);
+
+      if (fChat>0) {
+         Int_t kEcho=10;
+         if(fLastCe>=10000) kEcho=100;
+         if( fLastCe/kEcho != lastCe/kEcho ) {
+            if(fDim<10)
+               cout<<fDim<<flush;
+            else
+               cout<<"."<<flush;
+            if( fLastCe/(100*kEcho) != lastCe/(100*kEcho) )  cout<<"|"<<fLastCe<<endl<<flush;
+         }
+      }
+   }
+   if (fChat>0) {
+     cout<<endl<<flush;
+   }
+   CheckAll(0);   // set arg=1 for more info
+}// GrowParallel
+
+//_____________________________________________________________________________________________
+void TFoam::ExploreCells(Int_t n, const Long_t *iCells, UInt_t seed)
+{
+// Internal subprogram used by GrowParallel.
+// It explores the n new cells of index iCells: the MC sampling of all the cells
+// is made first, in parallel, with SampleCell and the stream iCells[i] of a
+// TRandomPhilox generator with the given seed. The samples are then analyzed
+// cell by cell, in order, by ExploreCell.
+
+   Int_t i, j;
+   const Int_t stride = fDim+1;
+   const Long_t sampleSize = fNSampl*stride;
+
+   // geometry of the cells, found from the tree of cells before the parallel loop
+   std::vector<Double_t> geom(2*n*fDim);
+   std::vector<Double_t> volume(n);
+   TFoamVect  cellSize(fDim);
+   TFoamVect  cellPosi(fDim);
+   for(i=0; i<n; i++) {
+      TFoamCell *cell = fCells[iCells[i]];
+      cell->GetHcub(cellPosi,cellSize);
+      for(j=0; j<fDim; j++) {
+         geom[2*i*fDim +j]      = cellPosi[j];
+         geom[(2*i+1)*fDim +j]  = cellSize[j];
+      }
+      cell->CalcVolume();
+      volume[i] = cell->GetVolume();
+   }
+
+   std::vector<Double_t> sample(n*sampleSize);
+   std::vector<Long_t> nSample(n);
+#ifdef _OPENMP
+   Int_t nThreads = (fRho != 0) ? fNThreads : 1;   // TMethodCall is not thread safe
+   if(nThreads > 1) {
+      // one generator per thread, created outside the parallel region
+      std::vector<TRandomPhilox *> rnd(nThreads);
+      for(i=0; i<nThreads; i++) rnd[i] = new TRandomPhilox(seed);
+#pragma omp parallel for num_threads(nThreads) schedule(dynamic)
+      for(i=0; i<n; i++) {
+         TRandomPhilox *r = rnd[omp_get_thread_num()];
+         r->SetStream(iCells[i]);
+         nSample[i] = SampleCell(&geom[2*i*fDim], &geom[(2*i+1)*fDim], volume[i], r, &sample[i*sampleSize]);
+      }
+      for(i=0; i<nThreads; i++) delete rnd[i];
+   } else
+#endif
+   {
+      TRandomPhilox r(seed);
+      for(i=0; i<n; i++) {
+         r.SetStream(iCells[i]);
+         nSample[i] = SampleCell(&geom[2*i*fDim], &geom[(2*i+1)*fDim], volume[i], &r, &sample[i*sampleSize]);
+      }
+   }
+
+   for(i=0; i<n; i++) ExploreCell(fCells[iCells[i]], &sample[i*sampleSize], nSample[i]);
+} // ExploreCells
+
+//_____________________________________________________________________________________________
+Long_t TFoam::SampleCell(const Double_t *posi, const Double_t *size, Double_t dx, TRandom *rnd, Double_t *sample)
+{
+// Internal subprogram used by ExploreCells, it may be called concurrently by several threads.
+// It makes the MC sampling of the cell of position posi, size size and volume dx,
+// as done in Explore, with the random numbers of rnd: the fDim internal parameters
+// alpha and the weight of each point are stored in sample.
+// Returns the number of points, which is smaller than fNSampl if the
+// exit condition of the MC loop of Explore is reached before.
+
+   Double_t sumWt = 0, sumWt2 = 0;
+   std::vector<Double_t> xRand(fDim);
+   Long_t iev;
+   for(iev=0; iev<fNSampl; iev++) {
+      Double_t *alpha = sample +iev*(fDim+1);
+      rnd->RndmArray(fDim, alpha);
+      for(Int_t j=0; j<fDim; j++)
+         xRand[j]= posi[j] +alpha[j]*(size[j]);
+      Double_t wt = dx*Eval(&xRand[0]);
+      alpha[fDim] = wt;
+      sumWt  += wt;
+      sumWt2 += wt*wt;
+      // same exit condition as in Explore
+      if( sumWt*sumWt/sumWt2 >= fNBin*fEvPerBin) return iev+1;
+   }
+   return iev;
+} // SampleCell
+
 //_____________________________________________________________________________________________
 Long_t  TFoam::PeekMax()
 {
@@ -979,6 +1226,8 @@ void TFoam::MakeActiveList()
    // flush previous result
    if(fPrimAcu  != 0) delete [] fPrimAcu;
    if(fCellsAct != 0) delete fCellsAct;
+   if(fCellsGeom != 0) delete [] fCellsGeom;
+   fCellsGeom = 0;              // made again by MakeEvents
 
    // Allocate tables of active cells
    fCellsAct = new TRefArray();
@@ -1099,11 +1348,24 @@ void TFoam::GenerCel2(TFoamCell *&pCell)
 // Return randomly chosen active cell with probability equal to its
 // contribution into total driver integral using interpolation search.
 
-   Long_t  lo, hi, hit;
-   Double_t fhit, flo, fhi;
    Double_t random;
 
    random=fPseRan->Rndm();
+   pCell = (TFoamCell *) fCellsAct->At(FindCell(random));
+}       // TFoam::GenerCel2
+
+
+//___________________________________________________________________________________________
+Long_t TFoam::FindCell(Double_t random) const
+{
+// Internal subprogram used by GenerCel2 and MakeEvents.
+// Returns the index in the list of active cells of the cell corresponding
+// to the random number in [0,1] using interpolation search in the cumulative
+// primary integral.
+
+   Long_t  lo, hi, hit;
+   Double_t fhit, flo, fhi;
+
    lo  = 0;              hi =fNoAct-1;
    flo = fPrimAcu[lo];  fhi=fPrimAcu[hi];
    while(lo+1<hi) {
@@ -1122,11 +1384,10 @@ void TFoam::GenerCel2(TFoamCell *&pCell)
       }
    }
    if (fPrimAcu[lo]>random)
-      pCell = (TFoamCell *) fCellsAct->At(lo);
+      return lo;
    else
-      pCell = (TFoamCell *) fCellsAct->At(hi);
-}       // TFoam::GenerCel2
-
+      return hi;
+}       // TFoam::FindCell
 
 //___________________________________________________________________________________________
 void TFoam::MakeEvent(void)
@@ -1215,6 +1476,114 @@ Double_t TFoam::MCgenerate(Double_t *MCvect)
    return(fMCwt);
 }//MCgenerate
 
+//___________________________________________________________________________________
+void TFoam::MakeEvents(Int_t nev, Double_t *vect, Double_t *wt)
+{
+// User subprogram which generates nev MC events at once: the event i is
+// returned in vect[i*kDim],...,vect[i*kDim+kDim-1] and, if wt is not zero,
+// its weight in wt[i].
+// The events, the MC weight statistics and the random numbers used are the
+// same as for nev calls of MakeEvent, but the position and the size of the
+// active cells are computed once for all instead of being found for every
+// event from the tree of cells.
+// With SetnThreads(n>1) and an integrand set with SetRho, the integrand is
+// evaluated in parallel by n threads on groups of candidate points, in which
+// case it must be thread safe. The events are still the same, but with
+// rejection (OptRej=1) the r.n. generator may be left a few numbers further
+// than by the sequential generation, as the random numbers of the candidates
+// of the last group are all drawn.
+
+   Int_t j, c;
+   if(nev<=0) return;
+   if(fCellsAct==0 || fPrimAcu==0) {
+      Error("MakeEvents", "Foam not initialized \n");
+      return;
+   }
+   // position, size, volume and primary integral of all active cells
+   const Int_t geoStride = 2*fDim+2;
+   if(fCellsGeom==0) {
+      fCellsGeom = new Double_t[fNoAct*geoStride];
+      TFoamVect  cellPosi(fDim); TFoamVect  cellSize(fDim);
+      for(Long_t iCell=0; iCell<fNoAct; iCell++) {
+         TFoamCell *cell = (TFoamCell *) fCellsAct->At(iCell);
+         cell->GetHcub(cellPosi,cellSize);
+         Double_t *geom = fCellsGeom +iCell*geoStride;
+         for(j=0; j<fDim; j++) {
+            geom[j]      = cellPosi[j];
+            geom[fDim+j] = cellSize[j];
+         }
+         geom[2*fDim]   = cell->GetVolume();
+         geom[2*fDim+1] = cell->GetPrim();
+      }
+   }
+
+   Int_t nThreads = (fRho != 0) ? fNThreads : 1;   // TMethodCall is not thread safe
+   const Int_t kBlock = 256;                       // candidates evaluated at once by the threads
+   const Int_t nBlock = (nThreads > 1) ? kBlock*nThreads : 1;
+   const Int_t rndStride = (fOptRej == 1) ? fDim+2 : fDim+1;
+   std::vector<Double_t> rnd(nBlock*rndStride);
+   std::vector<Double_t> xs(nBlock*fDim);
+   std::vector<Double_t> rho(nBlock);
+   std::vector<Long_t> cells(nBlock);
+
+   Int_t iev = 0;
+   while(iev < nev) {
+      const Int_t nb = TMath::Min(nBlock, nev-iev);
+      // random numbers of the candidates in the order of MakeEvent
+      for(c=0; c<nb; c++) {
+         Double_t *r = &rnd[c*rndStride];
+         r[0] = fPseRan->Rndm();              // choice of the cell
+         fPseRan->RndmArray(fDim, r+1);       // point inside the cell
+         if(fOptRej == 1) r[fDim+1] = fPseRan->Rndm();   // rejection
+      }
+      for(c=0; c<nb; c++) {
+         const Double_t *r = &rnd[c*rndStride];
+         cells[c] = FindCell(r[0]);
+         const Double_t *geom = fCellsGeom +cells[c]*geoStride;
+         for(j=0; j<fDim; j++)
+            xs[c*fDim+j] = geom[j] +r[1+j]*geom[fDim+j];
+      }
+#ifdef _OPENMP
+      if(nThreads > 1) {
+#pragma omp parallel for num_threads(nThreads)
+         for(c=0; c<nb; c++) rho[c] = Eval(&xs[c*fDim]);
+      } else
+#endif
+      {
+         for(c=0; c<nb; c++) rho[c] = Eval(&xs[c*fDim]);
+      }
+      // weights, statistics and rejection in the order of MakeEvent
+      for(c=0; c<nb && iev<nev; c++) {
+         const Double_t *geom = fCellsGeom +cells[c]*geoStride;
+         Double_t mcwt = geom[2*fDim]*rho[c] / geom[2*fDim+1];  // PRIMARY controls normalization
+         fNCalls++;
+         fMCwt   =  mcwt;
+         fSumWt  += mcwt;           // sum of Wt
+         fSumWt2 += mcwt*mcwt;      // sum of Wt**2
+         fNevGen++;                 // sum of 1d0
+         fWtMax  =  TMath::Max(fWtMax, mcwt);   // maximum wt
+         fWtMin  =  TMath::Min(fWtMin, mcwt);   // minimum wt
+         fMCMonit->Fill(mcwt);
+         fHistWt->Fill(mcwt,1.0);          // histogram
+         if(fOptRej == 1) {
+            if( fMaxWtRej*rnd[c*rndStride+fDim+1] > fMCwt) continue;  // Wt=1 events, internal rejection
+            if( fMCwt<fMaxWtRej ) {
+               fMCwt = 1.0;                  // normal Wt=1 event
+            } else {
+               fMCwt = fMCwt/fMaxWtRej;    // weight for overweighted events! kept for debug
+               fSumOve += fMCwt-fMaxWtRej; // contribution of overweighted
+            }
+         }
+         for(j=0; j<fDim; j++) {
+            fMCvect[j] = xs[c*fDim+j];
+            vect[iev*fDim+j] = fMCvect[j];
+         }
+         if(wt) wt[iev] = fMCwt;
+         iev++;
+      }
+   }
+} // MakeEvents
+
 //___________________________________________________________________________________
 void TFoam::GetIntegMC(Double_t &mcResult, Double_t &mcError)
 {
@@ -1313,6 +1682,152 @@ void TFoam::Finalize(Double_t& IntNorm, Double_t& Errel)
    }
 }  // Finalize
 
+//_____________________________________________________________________________________
+Int_t TFoam::WriteCells(const char *name) const
+{
+// Writes the cells of the foam in the current directory (e.g. an open TFile)
+// with the given name, as one array of numbers (TArrayD) with the links between
+// cells given by their indices. This is much faster to write and to read back
+// than the TFoam object itself, whose cells are linked by TRef's. The foam is
+// made again from it with ReadCells, so that a generator job does not need
+// to explore the cells:
+//    // build-up job
+//    FoamX->Initialize();
+//    TFile f("foam_cells.root","RECREATE");
+//    FoamX->WriteCells("FoamXCells");
+//    // generator job, same kDim, integrand and r.n. generator set before
+//    TFile f("foam_cells.root");
+//    FoamY->ReadCells("FoamXCells");
+//    FoamY->MakeEvent(); ...
+// Returns the number of bytes written, 0 in case of error.
+
+   const Int_t kNPar = 9;
+   if(fCells==0 || fLastCe<0) {
+      Error("WriteCells", "Foam not initialized \n");
+      return 0;
+   }
+   if(gDirectory==0) {
+      Error("WriteCells", "No current directory \n");
+      return 0;
+   }
+   Int_t nCells = fLastCe+1;
+   TArrayD buffer(3 +kNPar*nCells);
+   buffer[0] = fDim;
+   buffer[1] = fNCells;
+   buffer[2] = nCells;
+   for(Int_t iCell=0; iCell<nCells; iCell++) {
+      const TFoamCell *cell = fCells[iCell];
+      Double_t *par = buffer.GetArray() +3 +kNPar*iCell;
+      par[0] = cell->GetStat();
+      par[1] = cell->GetPare() ? cell->GetPare()->GetSerial() : -1;
+      par[2] = cell->GetDau0() ? cell->GetDau0()->GetSerial() : -1;
+      par[3] = cell->GetDau1() ? cell->GetDau1()->GetSerial() : -1;
+      par[4] = cell->GetBest();
+      par[5] = cell->GetXdiv();
+      par[6] = cell->GetIntg();
+      par[7] = cell->GetDriv();
+      par[8] = cell->GetPrim();
+   }
+   return gDirectory->WriteObjectAny(&buffer, "TArrayD", name);
+}
+
+//_____________________________________________________________________________________
+Bool_t TFoam::ReadCells(const char *name)
+{
+// Alternative to Initialize for the MC generation with a foam already built:
+// it reads the cells written by WriteCells with the given name from the current
+// directory and prepares the MC generation, without any exploration.
+// As for Initialize, the r.n. generator and the distribution have to be set
+// before (the distribution is not used to build the cells, but it is still
+// needed by MakeEvent). The dimension kDim must be the same as the one of the
+// foam written.
+// Returns kFALSE if the cells cannot be read.
+
+   const Int_t kNPar = 9;
+   Int_t i;
+
+   if(fPseRan==0) Error("ReadCells", "Random number generator not set \n");
+   if(fRho==0 && fMethodCall==0 ) Error("ReadCells", "Distribution function not set \n");
+   if(fDim==0) Error("ReadCells", "Zero dimension not allowed \n");
+
+   TArrayD *buffer = 0;
+   if(gDirectory) gDirectory->GetObject(name, buffer);
+   if(buffer==0) {
+      Error("ReadCells", "Cells %s not found \n", name);
+      return kFALSE;
+   }
+   Int_t nCells = (buffer->GetSize()>=3) ? Int_t((*buffer)[2]) : -1;
+   if(nCells<1 || buffer->GetSize() != 3 +kNPar*nCells || Int_t((*buffer)[1]) < nCells) {
+      Error("ReadCells", "Wrong content of %s \n", name);
+      delete buffer;
+      return kFALSE;
+   }
+   if(Int_t((*buffer)[0]) != fDim) {
+      Error("ReadCells", "Cells of dimension %d instead of %d \n", Int_t((*buffer)[0]), fDim);
+      delete buffer;
+      return kFALSE;
+   }
+   const Double_t *par = buffer->GetArray() +3;
+   for(i=0; i<nCells; i++) {
+      for(Int_t k=1; k<=3; k++) {
+         if(par[kNPar*i+k] < -1 || par[kNPar*i+k] >= nCells) {
+            Error("ReadCells", "Wrong link of cell %d in %s \n", i, name);
+            delete buffer;
+            return kFALSE;
+         }
+      }
+   }
+
+   Bool_t addStatus = TH1::AddDirectoryStatus();
+   TH1::AddDirectory(kFALSE);
+
+   InitWorkSpace();
+
+   // allocate the cells as InitCells does, and fill them
+   if(fCells!= 0) {
+      for(i=0; i<fNCells; i++) delete fCells[i];
+      delete [] fCells;
+   }
+   fNCells = Int_t((*buffer)[1]);
+   fCells = new TFoamCell*[fNCells];
+   for(i=0;i<fNCells;i++){
+      fCells[i]= new TFoamCell(fDim);
+      fCells[i]->SetSerial(i);
+   }
+   fLastCe = nCells-1;
+   fNoAct  = 0;
+   for(i=0; i<nCells; i++, par += kNPar) {
+      Int_t status = Int_t(par[0]);
+      Int_t iPare = Int_t(par[1]);
+      Int_t iDau0 = Int_t(par[2]);
+      Int_t iDau1 = Int_t(par[3]);
+      fCells[i]->Fill(status, (iPare>=0) ? fCells[iPare] : 0,
+                      (iDau0>=0) ? fCells[iDau0] : 0, (iDau1>=0) ? fCells[iDau1] : 0);
+      fCells[i]->SetBest(Int_t(par[4]));
+      fCells[i]->SetXdiv(par[5]);
+      fCells[i]->SetIntg(par[6]);
+      fCells[i]->SetDriv(par[7]);
+      fCells[i]->SetPrim(par[8]);
+      if(status==1) fNoAct++;
+   }
+   delete buffer;
+   // the volumes need the complete tree of cells
+   for(i=0; i<nCells; i++) fCells[i]->CalcVolume();
+
+   InitGeneration();
+
+   if(fChat>0){
+      BXOPE;
+      BXTXT("***  TFoam::ReadCells FINISHED!!!  ***");
+      BX1I("    nCells",nCells,   "Number of cells read                   ");
+      BX1F("    XPrime",fPrime,   "Primary total integral                 ");
+      BX1F("  mcResult",fMCresult,"Estimate of the true MC Integral       ");
+      BXCLO;
+   }
+   TH1::AddDirectory(addStatus);
+   return kTRUE;
+}
+
 //_____________________________________________________________________________________
 void  TFoam::SetInhiDiv(Int_t iDim, Int_t InhiDiv)
 {
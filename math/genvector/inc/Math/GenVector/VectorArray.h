@@ -0,0 +1,452 @@
+// @(#)root/mathcore:$Id$
+// Authors: L. Moneta    2013
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2013 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for the classes LorentzVectorArray and PositionVector3DArray
+//
+// Collections of vectors stored as structure of arrays (one array per
+// Cartesian component), with functions computing a quantity for all the
+// vectors (or all the pairs of vectors) at once.
+//
+#ifndef ROOT_Math_GenVector_VectorArray
+#define ROOT_Math_GenVector_VectorArray  1
+
+#ifndef ROOT_Math_GenVector_LorentzVector
+#include "Math/GenVector/LorentzVector.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_PositionVector3D
+#include "Math/GenVector/PositionVector3D.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_Cartesian3D
+#include "Math/GenVector/Cartesian3D.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_Boost
+#include "Math/GenVector/Boost.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_BoostX
+#include "Math/GenVector/BoostX.h"
+#endif
+
+#ifndef ROOT_Math_GenVector_eta
+#include "Math/GenVector/eta.h"
+#endif
+
+#include <vector>
+#include <cmath>
+
+
+namespace ROOT {
+
+  namespace Math {
+
+     namespace Impl {
+
+        // functions used by the vector arrays, working on the component arrays
+
+        // azimuthal angle as in the Cartesian coordinate systems
+        template<typename Scalar>
+        inline void PhiArray(size_t n, const Scalar *x, const Scalar *y, Scalar *out) {
+           for (size_t i = 0; i < n; ++i)
+              out[i] = (x[i] == 0 && y[i] == 0) ? 0 : std::atan2(y[i], x[i]);
+        }
+
+        // pseudorapidity as in the Cartesian coordinate systems
+        template<typename Scalar>
+        inline void EtaArray(size_t n, const Scalar *x, const Scalar *y, const Scalar *z, Scalar *out) {
+           for (size_t i = 0; i < n; ++i)
+              out[i] = std::sqrt(x[i]*x[i] + y[i]*y[i]);
+           for (size_t i = 0; i < n; ++i)
+              out[i] = Eta_FromRhoZ(out[i], z[i]);
+        }
+
+        // DeltaR as in VectorUtil::DeltaR(v1,v2) for the vectors with the given eta and phi
+        template<typename Scalar>
+        inline Scalar DeltaR(Scalar eta1, Scalar phi1, Scalar eta2, Scalar phi2) {
+           Scalar dphi = phi2 - phi1;
+           dphi = (dphi > M_PI) ? dphi - 2.0*M_PI : ((dphi <= -M_PI) ? dphi + 2.0*M_PI : dphi);
+           Scalar deta = eta2 - eta1;
+           return std::sqrt(dphi*dphi + deta*deta);
+        }
+
+        // DeltaR of all the pairs (i,j) with i < j, in the order (0,1), (0,2), ... (1,2), ...
+        template<typename Scalar>
+        inline void PairDeltaRArray(const std::vector<Scalar> & eta, const std::vector<Scalar> & phi,
+                                    std::vector<Scalar> & out) {
+           const size_t n = eta.size();
+           out.resize(n > 1 ? n*(n-1)/2 : 0);
+           size_t k = 0;
+           for (size_t i = 0; i + 1 < n; ++i) {
+              const Scalar etai = eta[i];
+              const Scalar phii = phi[i];
+              for (size_t j = i+1; j < n; ++j, ++k)
+                 out[k] = DeltaR(etai, phii, eta[j], phi[j]);
+           }
+        }
+
+     } // end namespace Impl
+
+
+//__________________________________________________________________________________________
+    /**
+        Collection of LorentzVectors stored as a structure of arrays: the Px, Py,
+        Pz and E components of all the vectors are kept in four contiguous arrays.
+        Vectors in any coordinate system can be added and are returned as
+        LorentzVector<PxPyPzE4D<Scalar> >.
+        The member functions computing a quantity (M, Pt, Eta, ...) fill an output
+        array with its value for every vector, or for every pair or triplet of
+        vectors, in loops over contiguous arrays which can be vectorized by the
+        compiler (those calling sqrt only if the math functions do not set errno,
+        e.g. with -fno-math-errno). The results are
+        the same as the ones of the corresponding LorentzVector and VectorUtil
+        functions, except that M() of a vector with negative M2 returns -sqrt(-M2)
+        without calling GenVector::Throw.
+        When stored in a TTree the collection is split in one branch per component.
+
+	@ingroup GenVector
+    */
+    template< class ScalarType = double >
+    class LorentzVectorArray {
+
+    public:
+
+       typedef ScalarType Scalar;
+       typedef LorentzVector<PxPyPzE4D<Scalar> > Vector;
+
+       /**
+          default constructor of an empty collection
+       */
+       LorentzVectorArray() { }
+
+       /**
+          construct a collection of n null vectors
+       */
+       explicit LorentzVectorArray(size_t n) : fX(n), fY(n), fZ(n), fT(n) { }
+
+       /**
+          construct from a range of LorentzVectors (in any coordinate system)
+       */
+       template <class IT>
+       LorentzVectorArray(IT begin, IT end) {
+          for ( ; begin != end; ++begin) push_back(*begin);
+       }
+
+       // ------ size ------
+
+       size_t size() const { return fX.size(); }
+       bool empty() const { return fX.empty(); }
+       void clear() { fX.clear(); fY.clear(); fZ.clear(); fT.clear(); }
+       void reserve(size_t n) { fX.reserve(n); fY.reserve(n); fZ.reserve(n); fT.reserve(n); }
+       void resize(size_t n) { fX.resize(n); fY.resize(n); fZ.resize(n); fT.resize(n); }
+
+       // ------ access to the vectors ------
+
+       /**
+          add a vector at the end of the collection
+       */
+       template <class Coords>
+       void push_back(const LorentzVector<Coords> & v) {
+          fX.push_back(v.Px()); fY.push_back(v.Py()); fZ.push_back(v.Pz()); fT.push_back(v.E());
+       }
+
+       /**
+          return the vector i
+       */
+       Vector operator[](size_t i) const { return Vector(fX[i], fY[i], fZ[i], fT[i]); }
+       Vector At(size_t i) const { return operator[](i); }
+
+       /**
+          set the vector i
+       */
+       template <class Coords>
+       void Set(size_t i, const LorentzVector<Coords> & v) {
+          fX[i] = v.Px(); fY[i] = v.Py(); fZ[i] = v.Pz(); fT[i] = v.E();
+       }
+
+       /**
+          the component arrays
+       */
+       const std::vector<Scalar> & Px() const { return fX; }
+       const std::vector<Scalar> & Py() const { return fY; }
+       const std::vector<Scalar> & Pz() const { return fZ; }
+       const std::vector<Scalar> & E()  const { return fT; }
+
+       // ------ quantities computed for all the vectors ------
+
+       /**
+          invariant mass squared of every vector
+       */
+       void M2(std::vector<Scalar> & out) const {
+          const size_t n = size();
+          out.resize(n);
+          for (size_t i = 0; i < n; ++i)
+             out[i] = fT[i]*fT[i] - fX[i]*fX[i] - fY[i]*fY[i] - fZ[i]*fZ[i];
+       }
+
+       /**
+          invariant mass of every vector (-sqrt(-M2) if M2 < 0)
+       */
+       void M(std::vector<Scalar> & out) const {
+          M2(out);
+          const size_t n = size();
+          for (size_t i = 0; i < n; ++i) out[i] = SignedSqrt(out[i]);
+       }
+
+       /**
+          transverse momentum of every vector
+       */
+       void Pt(std::vector<Scalar> & out) const {
+          const size_t n = size();
+          out.resize(n);
+          for (size_t i = 0; i < n; ++i)
+             out[i] = std::sqrt(fX[i]*fX[i] + fY[i]*fY[i]);
+       }
+
+       /**
+          pseudorapidity of every vector
+       */
+       void Eta(std::vector<Scalar> & out) const {
+          out.resize(size());
+          if (!empty()) Impl::EtaArray(size(), &fX[0], &fY[0], &fZ[0], &out[0]);
+       }
+
+       /**
+          azimuthal angle of every vector
+       */
+       void Phi(std::vector<Scalar> & out) const {
+          out.resize(size());
+          if (!empty()) Impl::PhiArray(size(), &fX[0], &fY[0], &out[0]);
+       }
+
+       /**
+          DeltaR between every vector of this collection and the vector with the
+          same index in the collection v (as VectorUtil::DeltaR(this[i], v[i]))
+       */
+       void DeltaR(const LorentzVectorArray & v, std::vector<Scalar> & out) const {
+          std::vector<Scalar> eta1, phi1, eta2, phi2;
+          Eta(eta1); Phi(phi1); v.Eta(eta2); v.Phi(phi2);
+          const size_t n = size();
+          out.resize(n);
+          for (size_t i = 0; i < n; ++i)
+             out[i] = Impl::DeltaR(eta1[i], phi1[i], eta2[i], phi2[i]);
+       }
+
+       // ------ quantities computed for all the combinations ------
+
+       /**
+          invariant mass of the sum of every pair of vectors (i,j) with i < j,
+          in the order (0,1), (0,2), ... (0,n-1), (1,2), ...
+       */
+       void PairM(std::vector<Scalar> & out) const {
+          const size_t n = size();
+          out.resize(n > 1 ? n*(n-1)/2 : 0);
+          size_t k = 0;
+          for (size_t i = 0; i + 1 < n; ++i) {
+             const Scalar xi = fX[i], yi = fY[i], zi = fZ[i], ti = fT[i];
+             const Scalar *xj = &fX[i+1], *yj = &fY[i+1], *zj = &fZ[i+1], *tj = &fT[i+1];
+             Scalar *o = &out[k];
+             const size_t m = n-i-1;
+             for (size_t j = 0; j < m; ++j) {
+                const Scalar x = xi + xj[j], y = yi + yj[j], z = zi + zj[j], t = ti + tj[j];
+                o[j] = SignedSqrt(t*t - x*x - y*y - z*z);
+             }
+             k += m;
+          }
+       }
+
+       /**
+          DeltaR of every pair of vectors (i,j) with i < j, in the same order as PairM
+       */
+       void PairDeltaR(std::vector<Scalar> & out) const {
+          std::vector<Scalar> eta, phi;
+          Eta(eta); Phi(phi);
+          Impl::PairDeltaRArray(eta, phi, out);
+       }
+
+       /**
+          invariant mass of the sum of every triplet of vectors (i,j,k) with
+          i < j < k, in lexicographic order
+       */
+       void TripletM(std::vector<Scalar> & out) const {
+          const size_t n = size();
+          out.resize(n > 2 ? n*(n-1)*(n-2)/6 : 0);
+          size_t l = 0;
+          for (size_t i = 0; i + 2 < n; ++i) {
+             for (size_t j = i+1; j + 1 < n; ++j) {
+                const Scalar xij = fX[i] + fX[j], yij = fY[i] + fY[j];
+                const Scalar zij = fZ[i] + fZ[j], tij = fT[i] + fT[j];
+                Scalar *o = &out[l];
+                for (size_t k = j+1; k < n; ++k) {
+                   const Scalar x = xij + fX[k], y = yij + fY[k], z = zij + fZ[k], t = tij + fT[k];
+                   o[k-j-1] = SignedSqrt(t*t - x*x - y*y - z*z);
+                }
+                l += n-j-1;
+             }
+          }
+       }
+
+       // ------ transformations of all the vectors ------
+
+       /**
+          apply a boost to all the vectors (same result as Boost::operator())
+       */
+       void Apply(const Boost & b) {
+          Boost::Scalar m[16];
+          b.GetLorentzRotation(m);
+          const size_t n = size();
+          for (size_t i = 0; i < n; ++i) {
+             const Boost::Scalar x = fX[i], y = fY[i], z = fZ[i], t = fT[i];
+             fX[i] = m[Boost::kLXX]*x + m[Boost::kLXY]*y + m[Boost::kLXZ]*z + m[Boost::kLXT]*t;
+             fY[i] = m[Boost::kLYX]*x + m[Boost::kLYY]*y + m[Boost::kLYZ]*z + m[Boost::kLYT]*t;
+             fZ[i] = m[Boost::kLZX]*x + m[Boost::kLZY]*y + m[Boost::kLZZ]*z + m[Boost::kLZT]*t;
+             fT[i] = m[Boost::kLTX]*x + m[Boost::kLTY]*y + m[Boost::kLTZ]*z + m[Boost::kLTT]*t;
+          }
+       }
+
+       /**
+          apply a boost along X to all the vectors (same result as BoostX::operator())
+       */
+       void Apply(const BoostX & b) {
+          const BoostX::Scalar gamma = b.Gamma(), beta = b.Beta();
+          const size_t n = size();
+          for (size_t i = 0; i < n; ++i) {
+             const BoostX::Scalar x = fX[i], t = fT[i];
+             fX[i] = gamma*x + gamma*beta*t;
+             fT[i] = gamma*beta*x + gamma*t;
+          }
+       }
+
+    private:
+
+       // mass from M2 as in PxPyPzE4D::M(), without the call to GenVector::Throw
+       static Scalar SignedSqrt(Scalar mm) {
+          return (mm >= 0) ? std::sqrt(mm) : -std::sqrt(-mm);
+       }
+
+       std::vector<Scalar> fX;   // Px components
+       std::vector<Scalar> fY;   // Py components
+       std::vector<Scalar> fZ;   // Pz components
+       std::vector<Scalar> fT;   // E components
+
+    };
+
+
+//__________________________________________________________________________________________
+    /**
+        Collection of 3D points stored as a structure of arrays: the X, Y and Z
+        components of all the points are kept in three contiguous arrays.
+        Points in any coordinate system can be added and are returned as
+        PositionVector3D<Cartesian3D<Scalar> >. As for LorentzVectorArray, the
+        member functions compute a quantity for all the points at once.
+
+	@ingroup GenVector
+    */
+    template< class ScalarType = double >
+    class PositionVector3DArray {
+
+    public:
+
+       typedef ScalarType Scalar;
+       typedef PositionVector3D<Cartesian3D<Scalar>, DefaultCoordinateSystemTag> Point;
+
+       PositionVector3DArray() { }
+
+       explicit PositionVector3DArray(size_t n) : fX(n), fY(n), fZ(n) { }
+
+       template <class IT>
+       PositionVector3DArray(IT begin, IT end) {
+          for ( ; begin != end; ++begin) push_back(*begin);
+       }
+
+       // ------ size ------
+
+       size_t size() const { return fX.size(); }
+       bool empty() const { return fX.empty(); }
+       void clear() { fX.clear(); fY.clear(); fZ.clear(); }
+       void reserve(size_t n) { fX.reserve(n); fY.reserve(n); fZ.reserve(n); }
+       void resize(size_t n) { fX.resize(n); fY.resize(n); fZ.resize(n); }
+
+       // ------ access to the points ------
+
+       template <class Coords>
+       void push_back(const PositionVector3D<Coords, DefaultCoordinateSystemTag> & p) {
+          fX.push_back(p.X()); fY.push_back(p.Y()); fZ.push_back(p.Z());
+       }
+
+       Point operator[](size_t i) const { return Point(fX[i], fY[i], fZ[i]); }
+       Point At(size_t i) const { return operator[](i); }
+
+       template <class Coords>
+       void Set(size_t i, const PositionVector3D<Coords, DefaultCoordinateSystemTag> & p) {
+          fX[i] = p.X(); fY[i] = p.Y(); fZ[i] = p.Z();
+       }
+
+       const std::vector<Scalar> & X() const { return fX; }
+       const std::vector<Scalar> & Y() const { return fY; }
+       const std::vector<Scalar> & Z() const { return fZ; }
+
+       // ------ quantities computed for all the points ------
+
+       /**
+          distance from the origin of every point
+       */
+       void R(std::vector<Scalar> & out) const {
+          const size_t n = size();
+          out.resize(n);
+          for (size_t i = 0; i < n; ++i)
+             out[i] = std::sqrt(fX[i]*fX[i] + fY[i]*fY[i] + fZ[i]*fZ[i]);
+       }
+
+       /**
+          distance from the Z axis of every point
+       */
+       void Rho(std::vector<Scalar> & out) const {
+          const size_t n = size();
+          out.resize(n);
+          for (size_t i = 0; i < n; ++i)
+             out[i] = std::sqrt(fX[i]*fX[i] + fY[i]*fY[i]);
+       }
+
+       void Eta(std::vector<Scalar> & out) const {
+          out.resize(size());
+          if (!empty()) Impl::EtaArray(size(), &fX[0], &fY[0], &fZ[0], &out[0]);
+       }
+
+       void Phi(std::vector<Scalar> & out) const {
+          out.resize(size());
+          if (!empty()) Impl::PhiArray(size(), &fX[0], &fY[0], &out[0]);
+       }
+
+       /**
+          DeltaR of every pair of points (i,j) with i < j, in the order
+          (0,1), (0,2), ... (0,n-1), (1,2), ...
+       */
+       void PairDeltaR(std::vector<Scalar> & out) const {
+          std::vector<Scalar> eta, phi;
+          Eta(eta); Phi(phi);
+          Impl::PairDeltaRArray(eta, phi, out);
+       }
+
+    private:
+
+       std::vector<Scalar> fX;   // X components
+       std::vector<Scalar> fY;   // Y components
+       std::vector<Scalar> fZ;   // Z components
+
+    };
+
+  } // end namespace Math
+
+} // end namespace ROOT
+
+
+#endif
@@ -72,6 +72,9 @@
 #pragma link C++ class ROOT::Math::LorentzVector<ROOT::Math::PxPyPzM4D<double> >+;
 #pragma link C++ class ROOT::Math::LorentzVector<ROOT::Math::PtEtaPhiM4D<double> >+;
 
+#pragma link C++ class ROOT::Math::LorentzVectorArray<double>+;
+#pragma link C++ class ROOT::Math::PositionVector3DArray<double>+;
+
 // rotations
 //#ifdef LATER
 
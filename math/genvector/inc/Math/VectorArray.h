@@ -0,0 +1,11 @@
+// @(#)root/mathcore:$Id$
+// Authors: L. Moneta    2013
+
+#ifndef ROOT_Math_VectorArray
+#define ROOT_Math_VectorArray
+
+
+#include "Math/GenVector/VectorArray.h"
+
+
+#endif
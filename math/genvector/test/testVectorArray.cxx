@@ -0,0 +1,257 @@
+// test of the structure of arrays collections LorentzVectorArray and
+// PositionVector3DArray: the quantities computed for all the vectors at once
+// must be the same as the ones computed vector by vector.
+// The timing of the pair invariant masses is printed for both ways.
+
+#include "Math/Vector4D.h"
+#include "Math/Point3D.h"
+#include "Math/VectorUtil.h"
+#include "Math/VectorArray.h"
+#include "Math/Boost.h"
+#include "Math/BoostX.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace ROOT::Math;
+
+int compare(const char * name, const std::vector<double> & v1, const std::vector<double> & v2) {
+   int nfail = 0;
+   if (v1.size() != v2.size()) {
+      std::cout << name << " : size " << v1.size() << " instead of " << v2.size() << std::endl;
+      return 1;
+   }
+   for (unsigned int i = 0; i < v1.size(); ++i) {
+      if (v1[i] != v2[i]) {
+         if (nfail < 5)
+            std::cout << name << " : value " << i << " is " << v1[i] << " instead of " << v2[i] << std::endl;
+         nfail++;
+      }
+   }
+   std::cout << name << (nfail ? "\t FAILED" : "\t OK") << std::endl;
+   return nfail ? 1 : 0;
+}
+
+int testLorentzVectorArray(int n) {
+
+   TRandom3 r(111);
+   std::vector<XYZTVector> vecs;
+   std::vector<PtEtaPhiMVector> vecsPolar;
+   for (int i = 0; i < n; ++i) {
+      PtEtaPhiMVector v(r.Exp(10.), r.Gaus(0,2), r.Uniform(-M_PI,M_PI), r.Uniform(0.,1.));
+      vecsPolar.push_back(v);
+      vecs.push_back(XYZTVector(v));
+   }
+   // add a null vector and a vector along z
+   vecs.push_back(XYZTVector(0,0,0,0));
+   vecs.push_back(XYZTVector(0,0,3,5));
+
+   LorentzVectorArray<> va(vecs.begin(), vecs.end());
+   LorentzVectorArray<> vp;
+   for (int i = 0; i < n; ++i) vp.push_back(vecsPolar[i]);
+
+   int iret = 0;
+   const unsigned int nv = va.size();
+   std::vector<double> out, ref;
+
+   va.M(out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) ref.push_back(vecs[i].M());
+   iret |= compare("M", out, ref);
+
+   va.Pt(out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) ref.push_back(vecs[i].Pt());
+   iret |= compare("Pt", out, ref);
+
+   va.Eta(out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) ref.push_back(vecs[i].Eta());
+   iret |= compare("Eta", out, ref);
+
+   va.Phi(out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) ref.push_back(vecs[i].Phi());
+   iret |= compare("Phi", out, ref);
+
+   va.PairM(out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i)
+      for (unsigned int j = i+1; j < nv; ++j) ref.push_back( (vecs[i]+vecs[j]).M() );
+   iret |= compare("PairM", out, ref);
+
+   va.PairDeltaR(out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i)
+      for (unsigned int j = i+1; j < nv; ++j) ref.push_back( VectorUtil::DeltaR(vecs[i],vecs[j]) );
+   iret |= compare("PairDeltaR", out, ref);
+
+   LorentzVectorArray<> vsub(vecs.begin(), vecs.begin()+20);
+   vsub.TripletM(out);
+   ref.clear();
+   for (unsigned int i = 0; i < 20; ++i)
+      for (unsigned int j = i+1; j < 20; ++j)
+         for (unsigned int k = j+1; k < 20; ++k) ref.push_back( (vecs[i]+vecs[j]+vecs[k]).M() );
+   iret |= compare("TripletM", out, ref);
+
+   LorentzVectorArray<> va2(vecs.begin()+1, vecs.end());
+   va2.push_back(vecs[0]);
+   va.DeltaR(va2, out);
+   ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) ref.push_back( VectorUtil::DeltaR(vecs[i], va2[i]) );
+   iret |= compare("DeltaR", out, ref);
+
+   // vectors added in other coordinates are converted in PxPyPzE
+   ref.clear();
+   for (int i = 0; i < n; ++i) ref.push_back(vecs[i].E());
+   iret |= compare("E from PtEtaPhiM", vp.E(), ref);
+
+   Boost b(0.3, -0.2, 0.5);
+   LorentzVectorArray<> vb(va);
+   vb.Apply(b);
+   out.clear(); ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) {
+      XYZTVector v = b(vecs[i]);
+      out.push_back(vb[i].Px()); out.push_back(vb[i].Py()); out.push_back(vb[i].Pz()); out.push_back(vb[i].E());
+      ref.push_back(v.Px()); ref.push_back(v.Py()); ref.push_back(v.Pz()); ref.push_back(v.E());
+   }
+   iret |= compare("Boost", out, ref);
+
+   BoostX bx(0.8);
+   vb = va;
+   vb.Apply(bx);
+   out.clear(); ref.clear();
+   for (unsigned int i = 0; i < nv; ++i) {
+      XYZTVector v = bx(vecs[i]);
+      out.push_back(vb[i].Px()); out.push_back(vb[i].Py()); out.push_back(vb[i].Pz()); out.push_back(vb[i].E());
+      ref.push_back(v.Px()); ref.push_back(v.Py()); ref.push_back(v.Pz()); ref.push_back(v.E());
+   }
+   iret |= compare("BoostX", out, ref);
+
+   // timing of the pair masses
+   TStopwatch w;
+   const int ntimes = 20;
+   w.Start();
+   double s = 0;
+   for (int l = 0; l < ntimes; ++l) {
+      for (unsigned int i = 0; i < nv; ++i)
+         for (unsigned int j = i+1; j < nv; ++j) s += (vecs[i]+vecs[j]).M();
+   }
+   w.Stop();
+   std::cout << "Pair masses with XYZTVector         : time " << w.RealTime() << "  (" << s << ")" << std::endl;
+   w.Start();
+   s = 0;
+   for (int l = 0; l < ntimes; ++l) {
+      va.PairM(out);
+      for (unsigned int i = 0; i < out.size(); ++i) s += out[i];
+   }
+   w.Stop();
+   std::cout << "Pair masses with LorentzVectorArray : time " << w.RealTime() << "  (" << s << ")" << std::endl;
+
+   return iret;
+}
+
+int testPositionVector3DArray(int n) {
+
+   TRandom3 r(222);
+   std::vector<XYZPoint> points;
+   for (int i = 0; i < n; ++i)
+      points.push_back(XYZPoint(r.Gaus(0,10), r.Gaus(0,10), r.Gaus(0,30)));
+
+   PositionVector3DArray<> pa;
+   for (int i = 0; i < n; ++i) pa.push_back(Polar3DPoint(points[i]));
+   for (int i = 0; i < n; ++i) pa.Set(i, points[i]);
+
+   int iret = 0;
+   std::vector<double> out, ref;
+
+   pa.R(out);
+   ref.clear();
+   for (int i = 0; i < n; ++i) ref.push_back(points[i].R());
+   iret |= compare("Point R", out, ref);
+
+   pa.Rho(out);
+   ref.clear();
+   for (int i = 0; i < n; ++i) ref.push_back(points[i].Rho());
+   iret |= compare("Point Rho", out, ref);
+
+   pa.Eta(out);
+   ref.clear();
+   for (int i = 0; i < n; ++i) ref.push_back(points[i].Eta());
+   iret |= compare("Point Eta", out, ref);
+
+   pa.PairDeltaR(out);
+   ref.clear();
+   for (int i = 0; i < n; ++i)
+      for (int j = i+1; j < n; ++j) ref.push_back( VectorUtil::DeltaR(points[i],points[j]) );
+   iret |= compare("Point PairDeltaR", out, ref);
+
+   return iret;
+}
+
+// write the collections in a TTree (split by component) and read them back
+int testIO(int n) {
+
+   TRandom3 r(333);
+   LorentzVectorArray<> * va = new LorentzVectorArray<>;
+   PositionVector3DArray<> * pa = new PositionVector3DArray<>;
+   std::vector<double> px, z;
+   {
+      TFile f("vectorArray.root","RECREATE");
+      TTree t("t","vector arrays");
+      t.Branch("vectors.",&va,32000,99);
+      t.Branch("points.",&pa,32000,99);
+      for (int ievt = 0; ievt < 10; ++ievt) {
+         va->clear();
+         pa->clear();
+         for (int i = 0; i < n + ievt; ++i) {
+            va->push_back(XYZTVector(r.Gaus(0,10), r.Gaus(0,10), r.Gaus(0,10), r.Uniform(30,40)));
+            pa->push_back(XYZPoint(r.Gaus(0,1), r.Gaus(0,1), r.Gaus(0,1)));
+            px.push_back(va->Px().back());
+            z.push_back(pa->Z().back());
+         }
+         t.Fill();
+      }
+      t.Write();
+   }
+
+   int iret = 0;
+   TFile f("vectorArray.root");
+   TTree * t = (TTree*) f.Get("t");
+   if (!t || t->GetBranch("vectors.fX") == 0) {
+      std::cout << "IO : the collections are not split by component\t FAILED" << std::endl;
+      return 1;
+   }
+   LorentzVectorArray<> * vr = 0;
+   PositionVector3DArray<> * pr = 0;
+   t->SetBranchAddress("vectors.",&vr);
+   t->SetBranchAddress("points.",&pr);
+   std::vector<double> pxr, zr;
+   for (int ievt = 0; ievt < t->GetEntries(); ++ievt) {
+      t->GetEntry(ievt);
+      pxr.insert(pxr.end(), vr->Px().begin(), vr->Px().end());
+      zr.insert(zr.end(), pr->Z().begin(), pr->Z().end());
+   }
+   iret |= compare("IO Px", pxr, px);
+   iret |= compare("IO Z", zr, z);
+
+   delete va;
+   delete pa;
+   return iret;
+}
+
+int main() {
+
+   int iret = 0;
+   iret |= testLorentzVectorArray(500);
+   iret |= testPositionVector3DArray(200);
+   iret |= testIO(50);
+
+   if (iret != 0) std::cerr << "testVectorArray: test FAILED !!! " << std::endl;
+   else std::cout << "testVectorArray: all tests OK" << std::endl;
+   return iret;
+}
@@ -35,6 +35,7 @@ MATHCOREDH2  := $(MODDIRI)/TRandom.h \
                 $(MODDIRI)/TRandom1.h \
                 $(MODDIRI)/TRandom2.h \
 		$(MODDIRI)/TRandom3.h \
+                $(MODDIRI)/TRandomPhilox.h \
                 $(MODDIRI)/TStatistic.h \
                 $(MODDIRI)/TVirtualFitter.h \
                 $(MODDIRI)/TKDTree.h \
@@ -182,3 +183,16 @@ $(MATHCOREDO): CXXFLAGS += -DUSE_ROOT_ERROR
 $(MATHCOREDO1) : NOOPT = $(OPT)
 $(MATHCOREDO2) : NOOPT = $(OPT)
 $(MATHCOREDO3) : NOOPT = $(OPT)
+# allow gcc to vectorize the loops calling the functions of Math/FastMath.h
+ifneq ($(GCC_MAJOR),)
+$(call stripsrc,$(MATHCOREDIRS)/FastMath.o $(MATHCOREDIRS)/PdfFuncMathCore.o \
+   $(MATHCOREDIRS)/ProbFuncMathCore.o): CXXFLAGS += -ftree-vectorize -fno-trapping-math
+endif
+# for openMP (parallel evaluation of the fit method functions in FitUtil,
+# parallel build and queries of TKDTree, parallel AdaptiveIntegratorMultiDim)
+ifneq ($(USE_OPENMP),)
+$(call stripsrc,$(MATHCOREDIRS)/FitUtil.o): CXXFLAGS += -fopenmp
+$(call stripsrc,$(MATHCOREDIRS)/TKDTree.o): CXXFLAGS += -fopenmp
+$(call stripsrc,$(MATHCOREDIRS)/AdaptiveIntegratorMultiDim.o): CXXFLAGS += -fopenmp
+$(MATHCORELIB): LDFLAGS += -fopenmp
+endif
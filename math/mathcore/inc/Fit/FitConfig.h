@@ -182,6 +182,9 @@ public:
    ///Apply Weight correction for error matrix computation
    bool UseWeightCorrection() const { return fWeightCorr; }
 
+   /// number of threads used for evaluating the objective function on the data (0 = sequential evaluation)
+   unsigned int NThreads() const { return fNThreads; }
+
 
    /// return vector of parameter indeces for which the Minos Error will be computed
    const std::vector<unsigned int> & MinosParams() const { return fMinosParams; }
@@ -200,6 +203,16 @@ public:
    ///apply the weight correction for error matric computation
    void SetWeightCorrection(bool on = true) { fWeightCorr = on; }
 
+   /**
+      set the number of threads used for evaluating the chi2 and the likelihood functions (and their gradients).
+      When n > 0 the data points are evaluated in chunks of fixed size and the partial sums are reduced in a 
+      deterministic order, so the result does not depend on n. 
+      The threads are used only if the library is built with OpenMP support and the model function 
+      must be thread safe when evaluated passing the parameter values. 
+      n = 0 (default) means a sequential evaluation
+   */
+   void SetNThreads(unsigned int n) { fNThreads = n; }
+
    /// set parameter indeces for running Minos
    /// this can be used for running Minos on a subset of parameters - otherwise is run on all of them 
    /// if MinosErrors() is set 
@@ -230,6 +243,7 @@ private:
    bool fMinosErrors;      // do full error analysis using Minos
    bool fUpdateAfterFit;   // update the configuration after a fit using the result
    bool fWeightCorr;       // apply correction to errors for weights fits 
+   unsigned int fNThreads; // number of threads used in the evaluation of the objective function (0 = sequential)
 
    std::vector<ROOT::Fit::ParameterSettings> fSettings;  // vector with the parameter settings
    std::vector<unsigned int> fMinosParams;               // vector with the parameter indeces for running Minos
@@ -29,12 +29,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-#ifdef ROOT_FIT_PARALLEL
-#ifndef ROOT_Fit_FitUtilParallel
-#include "Fit/FitUtilParallel.h"
-#endif
-#endif
-
 namespace ROOT { 
 
    namespace Fit { 
@@ -64,11 +58,13 @@ public:
 
    /** 
       Constructor from unbin data set and model function (pdf)
+      If nThreads > 0 the data points are evaluated in parallel (see FitConfig::SetNThreads)
    */ 
-   LogLikelihoodFCN (const UnBinData & data, const IModelFunction & func, int weight = 0, bool extended = false) : 
+   LogLikelihoodFCN (const UnBinData & data, const IModelFunction & func, int weight = 0, bool extended = false, unsigned int nThreads = 0) : 
       BaseObjFunction(func.NPar(), data.Size() ),
       fIsExtended(extended),
       fWeight(weight),
+      fNThreads(nThreads),
       fData(data), 
       fFunc(func), 
       fNEffPoints(0),
@@ -97,7 +93,7 @@ private:
 public: 
 
    /// clone the function (need to return Base for Windows)
-   virtual BaseFunction * Clone() const { return  new LogLikelihoodFCN(fData,fFunc,fWeight,fIsExtended); }
+   virtual BaseFunction * Clone() const { return  new LogLikelihoodFCN(fData,fFunc,fWeight,fIsExtended,fNThreads); }
 
 
    //using BaseObjFunction::operator();
@@ -115,7 +111,7 @@ public:
    // need to be virtual to be instantited
    virtual void Gradient(const double *x, double *g) const { 
       // evaluate the chi2 gradient
-      FitUtil::EvaluateLogLGradient(fFunc, fData, x, g, fNEffPoints);
+      FitUtil::EvaluateLogLGradient(fFunc, fData, x, g, fNEffPoints, fNThreads);
    }
 
    /// get type of fit method function
@@ -146,11 +142,7 @@ private:
    virtual double DoEval (const double * x) const { 
       this->UpdateNCalls();
 
-#ifdef ROOT_FIT_PARALLEL
-      return FitUtilParallel::EvaluateLogL(fFunc, fData, x, fNEffPoints); 
-#else 
-      return FitUtil::EvaluateLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints); 
-#endif
+      return FitUtil::EvaluateLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints, fNThreads); 
    } 
 
    // for derivatives 
@@ -163,6 +155,7 @@ private:
       //data member
    bool fIsExtended;  // flag for indicating if likelihood is extended
    int  fWeight;  // flag to indicate if needs to evaluate using weight or weight squared (default weight = 0)
+   unsigned int fNThreads;  // number of threads used in the evaluation (0 = sequential)
 
    const UnBinData & fData; 
    const IModelFunction & fFunc; 
@@ -29,13 +29,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-//#define PARALLEL
-// #ifdef PARALLEL
-// #ifndef ROOT_Fit_FitUtilParallel
-// #include "Fit/FitUtilParallel.h"
-// #endif
-// #endif
-
 namespace ROOT {
 
    namespace Fit {
@@ -63,11 +56,13 @@ public:
 
    /**
       Constructor from unbin data set and model function (pdf)
+      If nThreads > 0 the data points are evaluated in parallel (see FitConfig::SetNThreads)
    */
-   PoissonLikelihoodFCN (const BinData & data, const IModelFunction & func, int weight = 0, bool extended = true ) :
+   PoissonLikelihoodFCN (const BinData & data, const IModelFunction & func, int weight = 0, bool extended = true, unsigned int nThreads = 0 ) :
       BaseObjFunction(func.NPar(), data.Size() ),
       fIsExtended(extended),
       fWeight(weight),
+      fNThreads(nThreads),
       fData(data),
       fFunc(func),
       fNEffPoints(0),
@@ -96,7 +91,7 @@ private:
 public:
 
    /// clone the function (need to return Base for Windows)
-   virtual BaseFunction * Clone() const { return new  PoissonLikelihoodFCN(fData,fFunc,fWeight,fIsExtended); }
+   virtual BaseFunction * Clone() const { return new  PoissonLikelihoodFCN(fData,fFunc,fWeight,fIsExtended,fNThreads); }
 
    // effective points used in the fit
    virtual unsigned int NFitPoints() const { return fNEffPoints; }
@@ -110,7 +105,7 @@ public:
    /// evaluate gradient
    virtual void Gradient(const double *x, double *g) const {
       // evaluate the chi2 gradient
-      FitUtil::EvaluatePoissonLogLGradient(fFunc, fData, x, g );
+      FitUtil::EvaluatePoissonLogLGradient(fFunc, fData, x, g, fNThreads );
    }
 
    /// get type of fit method function
@@ -148,7 +143,7 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-      return FitUtil::EvaluatePoissonLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluatePoissonLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints, fNThreads);
    }
 
    // for derivatives
@@ -162,6 +157,7 @@ private:
 
    bool fIsExtended; // flag to indicate if is extended (when false is a Multinomial lieklihood), default is true
    int fWeight;  // flag to indicate if needs to evaluate using weight or weight squared (default weight = 0)
+   unsigned int fNThreads;  // number of threads used in the evaluation (0 = sequential)
 
    const BinData & fData;
    const IModelFunction & fFunc;
@@ -33,6 +33,14 @@ namespace Math {
    Converted/adapted by R.Brun to C++ from Fortran CERNLIB routine RADMUL (D120)
    The new code features many changes compared to the Fortran version.
 
+   The integration can be parallelized (see SetNThreads and SetNRegions):
+   at each step several sub-regions can be divided, and the rule points of all the new
+   sub-regions are evaluated together, in chunks that can be distributed among threads.
+   Parametric functions (IParametricFunctionMultiDim) are evaluated on each chunk
+   with a single call to EvalParVec.
+   The result depends on the number of regions divided at each step but not on
+   the number of threads.
+
    @ingroup Integration
 
   
@@ -111,6 +119,25 @@ public:
    ///set max points
    void SetMaxPts(unsigned int n) { fMaxPts = n; }
 
+   /**
+      set the number of threads used to evaluate the function (0 or 1 means sequential).
+      Requires ROOT compiled with openMP; the function must be thread safe
+   */
+   void SetNThreads(unsigned int n) { fNThreads = n; }
+
+   /**
+      set the number of sub-regions (those with the largest errors) divided at each step (default is 1).
+      Larger values give more points to evaluate together at each step, at the price of
+      some more function evaluations
+   */
+   void SetNRegions(unsigned int n) { fNRegions = (n > 0) ? n : 1; }
+
+   /// return the number of threads used to evaluate the function
+   unsigned int NThreads() const { return fNThreads; }
+
+   /// return the number of sub-regions divided at each step
+   unsigned int NRegions() const { return fNRegions; }
+
    /// set the options 
    void SetOptions(const ROOT::Math::IntegratorMultiDimOptions & opt);
 
@@ -122,6 +149,12 @@ protected:
    // internal function to compute the integral (if absVal is true compute abs value of function integral
    double DoIntegral(const double* xmin, const double * xmax, bool absVal = false);
 
+   // internal function to compute the integral dividing fNRegions regions at each step
+   double DoIntegralNRegions(const double* xmin, const double * xmax, bool absVal);
+
+   // evaluate the function at npts points stored one after the other in x
+   void EvalPoints(unsigned int npts, const double * x, double * f, bool absVal) const;
+
  private:
 
    unsigned int fDim;     // dimentionality of integrand
@@ -136,6 +169,8 @@ protected:
    double fRelError;      // Relative error
    int    fNEval;        // number of function evaluation
    int fStatus;   // status of algorithm (error if not zero)
+   unsigned int fNThreads;  // number of threads used to evaluate the function (0 = sequential)
+   unsigned int fNRegions;  // number of regions divided at each step
 
    const IMultiGenFunction* fFun;   // pointer to integrand function 
 
@@ -0,0 +1,259 @@
+// @(#)root/mathcore:$Id$
+// Author: L. Moneta
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2012  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for the fast (vectorizable) mathematical functions
+//
+// The implementation is based on the rational approximations of the
+// Cephes library (see http://www.netlib.org/cephes),
+// Copyright 1985, 1987, 2000 by Stephen L. Moshier,
+// re-written without branches and table look-up so that the compiler
+// can auto-vectorize the loops calling them.
+
+#ifndef ROOT_Math_FastMath
+#define ROOT_Math_FastMath
+
+#include <limits>
+
+namespace ROOT {
+
+   namespace Math {
+
+/**
+   @defgroup FastMath Fast vectorizable mathematical functions
+
+   Inline versions of exp, expm1, log, erf and erfc which can be inlined in loops and
+   auto-vectorized by the compiler, together with versions working on arrays.
+   They are meant for the evaluation of the model functions on many data points
+   (e.g. in the fits). Accuracy, measured with respect to the standard library
+   functions over the full double precision range:
+
+   - fast_exp : relative error < 2 ulp (about 4.E-16) for |x| < 708,
+                returns 0 for x < -708 and +inf for x > 708
+   - fast_log : relative error < 2 ulp for normalized positive numbers,
+                returns -inf for 0 and NaN for negative values. Denormalized numbers are not supported
+   - fast_expm1 : relative error < 5.E-16
+   - fast_erf : absolute error < 4.E-16
+   - fast_erfc : relative difference < 6.E-16 with respect to ROOT::Math::erfc, which uses the same
+                 approximations. 0 is returned instead of the denormalized numbers for x > 26.6
+
+   With gcc the loops are vectorized only if the code is compiled with -fno-trapping-math
+   (and -ftree-vectorize or -O3), since the selections of the values would otherwise be
+   compiled as branches.
+
+   @ingroup SpecFunc
+*/
+
+namespace FastMathDetail {
+
+   // reinterpret the bits of a double as an integer and vice versa
+   union DoubleBits {
+      double fD;
+      unsigned long long fI;
+   };
+
+   inline double Bits2Double(unsigned long long i) {
+      DoubleBits b; b.fI = i; return b.fD;
+   }
+   inline unsigned long long Double2Bits(double d) {
+      DoubleBits b; b.fD = d; return b.fI;
+   }
+
+   // floor for values in the int range
+   inline double FloorInt(double x) {
+      int n = int(x);
+      return (x < n) ? n - 1 : n;
+   }
+
+   // Horner evaluation of the polynomials used by fast_erf (coefficients from Cephes)
+   inline double ErfSmallNum(double z) {
+      return (((( 9.60497373987051638749E0 * z + 9.00260197203842689217E1) * z
+                  + 2.23200534594684319226E3) * z + 7.00332514112805075473E3) * z
+                  + 5.55923013010394962768E4);
+   }
+   inline double ErfSmallDen(double z) {
+      return ((((( z + 3.35617141647503099647E1) * z + 5.21357949780152679795E2) * z
+                  + 4.59432382970980127987E3) * z + 2.26290000613890934246E4) * z
+                  + 4.92673942608635921086E4);
+   }
+   inline double ErfcNum(double x) {
+      return (((((((( 2.46196981473530512524E-10 * x + 5.64189564831068821977E-1) * x
+                      + 7.46321056442269912687E0) * x + 4.86371970985681366614E1) * x
+                      + 1.96520832956077098242E2) * x + 5.26445194995477358631E2) * x
+                      + 9.34528527171957607540E2) * x + 1.02755188689515710272E3) * x
+                      + 5.57535335369399327526E2);
+   }
+   inline double ErfcDen(double x) {
+      return (((((((( x + 1.32281951154744992508E1) * x + 8.67072140885989742329E1) * x
+                      + 3.54937778887819891062E2) * x + 9.75708501743205489753E2) * x
+                      + 1.82390916687909736289E3) * x + 2.24633760818710981792E3) * x
+                      + 1.65666309194161350182E3) * x + 5.57535340817727675546E2);
+   }
+
+   // rational approximation of erfc for x >= 8 (coefficients from Cephes)
+   inline double ErfcLargeNum(double x) {
+      return ((((( 5.64189583547755073984E-1 * x + 1.27536670759978104416E0) * x
+                   + 5.01905042251180477414E0) * x + 6.16021097993053585195E0) * x
+                   + 7.40974269950448939160E0) * x + 2.97886665372100240670E0);
+   }
+   inline double ErfcLargeDen(double x) {
+      return (((((( x + 2.26052863220117276590E0) * x + 9.39603524938001434673E0) * x
+                    + 1.20489539808096656605E1) * x + 1.70814450747565897222E1) * x
+                    + 9.60896809063285878198E0) * x + 3.36907645100081516050E0);
+   }
+
+} // end namespace FastMathDetail
+
+
+/**
+   fast exponential function.
+   e**x = 2**n * e**r with |r| < ln(2)/2, and e**r = 1 + 2r P(r**2)/( Q(r**2) - r P(r**2) )
+   @ingroup FastMath
+*/
+inline double fast_exp(double x) {
+   const double kLimit = 708.;
+   // clamp the argument to avoid integer overflow in building 2**n
+   double xx = (x > kLimit) ? kLimit : ( (x < -kLimit) ? -kLimit : x);
+   double n = FastMathDetail::FloorInt(1.4426950408889634073599 * xx + 0.5);
+   // r = x - n * ln(2) (ln(2) split in two parts for precision)
+   double r = xx - n * 6.93145751953125E-1;
+   r -= n * 1.42860682030941723212E-6;
+   double r2 = r * r;
+   double px = r * ( ( 1.26177193074810590878E-4 * r2 + 3.02994407707441961300E-2 ) * r2
+                     + 9.99999999999999999910E-1 );
+   double qx = ( ( 3.00198505138664455042E-6 * r2 + 2.52448340349684104192E-3 ) * r2
+                 + 2.27265548208155028766E-1 ) * r2 + 2.00000000000000000009E0;
+   double y = 1.0 + 2.0 * px / ( qx - px );
+   // multiply by 2**n building the exponent bits
+   y *= FastMathDetail::Bits2Double( ((unsigned long long)( int(n) + 1023 ) ) << 52 );
+   if (x > kLimit) y = std::numeric_limits<double>::infinity();
+   if (x < -kLimit) y = 0;
+   return y;
+}
+
+/**
+   fast natural logarithm.
+   x = m * 2**e with sqrt(1/2) < m < sqrt(2) and log(m) from a rational approximation
+   log(1+r) = r - r**2/2 + r**3 P(r)/Q(r)
+   @ingroup FastMath
+*/
+inline double fast_log(double x) {
+   // separate mantissa (in [0.5,1)) and exponent
+   unsigned long long bits = FastMathDetail::Double2Bits(x);
+   double e = int( (bits >> 52) & 0x7FF ) - 1022;
+   double m = FastMathDetail::Bits2Double( (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FE0000000000000ULL );
+   // move the mantissa in [sqrt(1/2), sqrt(2))
+   bool small = (m < 0.70710678118654752440);
+   m = small ? m + m : m;
+   e = small ? e - 1 : e;
+   double r = m - 1.0;
+   double r2 = r * r;
+   double px = ((((( 1.01875663804580931796E-4 * r + 4.97494994976747001425E-1) * r
+                   + 4.70579119878881725854E0) * r + 1.44989225341610930846E1) * r
+                   + 1.79368678507819816313E1) * r + 7.70838733755885391666E0);
+   double qx = ((((( r + 1.12873587189167450590E1) * r + 4.52279145837532221105E1) * r
+                   + 8.29875266912776603211E1) * r + 7.11544750618563894466E1) * r
+                   + 2.31251620126765340583E1);
+   double y = r * r2 * px / qx;
+   // log(2) split in two parts for precision
+   y -= e * 2.121944400546905827679E-4;
+   y -= 0.5 * r2;
+   y += r;
+   y += e * 0.693359375;
+   if (x > std::numeric_limits<double>::max() ) y = std::numeric_limits<double>::infinity();
+   if (x == 0) y = - std::numeric_limits<double>::infinity();
+   if (!(x >= 0)) y = std::numeric_limits<double>::quiet_NaN();
+   return y;
+}
+
+/**
+   fast error function.
+   For |x| < 1 erf(x) = x P(x**2)/Q(x**2), otherwise erf(x) = 1 - e**(-x**2) R(|x|)/S(|x|).
+   Both approximations are evaluated and the right one is selected, to avoid branches
+   @ingroup FastMath
+*/
+inline double fast_erf(double x) {
+   double ax = (x < 0) ? -x : x;
+   // erf(x) = 1 in double precision for |x| > 6
+   ax = (ax > 6.) ? 6. : ax;
+   double z = x * x;
+   double ysmall = x * FastMathDetail::ErfSmallNum(z) / FastMathDetail::ErfSmallDen(z);
+   double ylarge = 1.0 - fast_exp( - ax * ax) * FastMathDetail::ErfcNum(ax) / FastMathDetail::ErfcDen(ax);
+   ylarge = (x < 0) ? - ylarge : ylarge;
+   return ( ax < 1.0 ) ? ysmall : ylarge;
+}
+
+/**
+   fast complementary error function.
+   For |x| < 1 erfc(x) = 1 - erf(x), otherwise erfc(x) = e**(-x**2) R(|x|)/S(|x|) with
+   different approximations for |x| < 8 and |x| >= 8, as for ROOT::Math::erfc
+   @ingroup FastMath
+*/
+inline double fast_erfc(double x) {
+   double ax = (x < 0) ? -x : x;
+   // erfc(x) underflows for x > 26.6
+   ax = (ax > 27.) ? 27. : ax;
+   double z = ax * ax;
+   double ysmall = 1.0 - x * FastMathDetail::ErfSmallNum(z) / FastMathDetail::ErfSmallDen(z);
+   double ratio = (ax < 8.0) ? FastMathDetail::ErfcNum(ax) / FastMathDetail::ErfcDen(ax)
+                             : FastMathDetail::ErfcLargeNum(ax) / FastMathDetail::ErfcLargeDen(ax);
+   double ylarge = fast_exp( - z) * ratio;
+   ylarge = (x < 0) ? 2.0 - ylarge : ylarge;
+   return ( ax < 1.0 ) ? ysmall : ylarge;
+}
+
+/**
+   fast e**x - 1, accurate also for small x.
+   It uses e**x - 1 = (u - 1) x / log(u) with u = e**x rounded (W. Kahan)
+   @ingroup FastMath
+*/
+inline double fast_expm1(double x) {
+   double u = fast_exp(x);
+   double y = (u - 1.0) * x / fast_log(u);
+   y = (u == 1.0) ? x : y;
+   y = (u == 0.0) ? -1.0 : y;
+   // for large x u - 1 = u
+   return (x > 700.) ? u : y;
+}
+
+/**
+   fast exponential on an array : y[i] = exp(x[i]) for i = 0,..., n-1.
+   x and y can be the same array
+   @ingroup FastMath
+*/
+void fast_exp(unsigned int n, const double * x, double * y);
+
+/**
+   fast natural logarithm on an array : y[i] = log(x[i]) for i = 0,..., n-1.
+   x and y can be the same array
+   @ingroup FastMath
+*/
+void fast_log(unsigned int n, const double * x, double * y);
+
+/**
+   fast error function on an array : y[i] = erf(x[i]) for i = 0,..., n-1.
+   x and y can be the same array
+   @ingroup FastMath
+*/
+void fast_erf(unsigned int n, const double * x, double * y);
+
+/**
+   fast complementary error function on an array : y[i] = erfc(x[i]) for i = 0,..., n-1.
+   x and y can be the same array
+   @ingroup FastMath
+*/
+void fast_erfc(unsigned int n, const double * x, double * y);
+
+
+   } // end namespace Math
+
+} // end namespace ROOT
+
+
+#endif /* ROOT_Math_FastMath */
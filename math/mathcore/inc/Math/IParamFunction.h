@@ -127,6 +127,16 @@ public:
 
    using BaseFunc::operator();
 
+   /**
+      Evaluate the function for the given parameters p at the n points x, x + stride, ..., x + (n-1)*stride,
+      storing the values in the array f (of size at least n).
+      Derived classes can implement DoEvalParVec to provide a faster (e.g. vectorized) evaluation;
+      the default implementation calls DoEvalPar for each point
+   */
+   void EvalParVec(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      DoEvalParVec(n, x, stride, p, f); 
+   }
+
 
 private: 
 
@@ -143,6 +153,15 @@ private:
       return DoEvalPar( x, Parameters() );  
    }
 
+   /**
+      Implementation of the evaluation on a set of points. 
+      By default DoEvalPar is called for each point
+   */
+   virtual void DoEvalParVec(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      for (unsigned int i = 0; i < n; ++i) 
+         f[i] = DoEvalPar( x + i*stride, p); 
+   }
+
 }; 
 
 //___________________________________________________________________
@@ -186,6 +205,16 @@ public:
       return DoEvalPar(*x, p); 
    }
 
+   /**
+      Evaluate the function for the given parameters p at the n points x[0], x[stride], ..., x[(n-1)*stride],
+      storing the values in the array f (of size at least n).
+      Derived classes can implement DoEvalParVec to provide a faster (e.g. vectorized) evaluation;
+      the default implementation calls DoEvalPar for each point
+   */
+   void EvalParVec(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      DoEvalParVec(n, x, stride, p, f); 
+   }
+
 private:
 
    /**
@@ -201,6 +230,15 @@ private:
       return DoEvalPar( x, Parameters() );  
    }
 
+   /**
+      Implementation of the evaluation on a set of points. 
+      By default DoEvalPar is called for each point
+   */
+   virtual void DoEvalParVec(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const { 
+      for (unsigned int i = 0; i < n; ++i) 
+         f[i] = DoEvalPar( x[i*stride], p); 
+   }
+
 }; 
 
 
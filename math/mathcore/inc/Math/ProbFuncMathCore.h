@@ -605,6 +605,46 @@ namespace Math {
 
 
 
+   /** @name Cumulative Distribution Functions on arrays
+   *   Versions of some of the functions above computing the values for all the elements 
+   *   of an array with the same parameters, e.g.  y[i] = normal_cdf(x[i], sigma, x0) for 
+   *   i = 0,...,n-1 (x and y can be the same array). 
+   *   As the corresponding functions for the pdf's (see PdfFuncMathCore.h), they use the 
+   *   functions of Math/FastMath.h and their results agree with the ones of the functions above 
+   *   within a relative difference of a few 1.E-16 (a few 1.E-14 for the lognormal tails, 
+   *   because of the logarithm). The lognormal cdf's return 0 and 1 for x <= x0. 
+   */ 
+
+   //@{
+
+   /// breitwigner_cdf_c on an array
+   void breitwigner_cdf_c(unsigned int n, const double * x, double * y, double gamma, double x0 = 0);
+
+   /// breitwigner_cdf on an array
+   void breitwigner_cdf(unsigned int n, const double * x, double * y, double gamma, double x0 = 0);
+
+   /// exponential_cdf_c on an array
+   void exponential_cdf_c(unsigned int n, const double * x, double * y, double lambda, double x0 = 0);
+
+   /// exponential_cdf on an array
+   void exponential_cdf(unsigned int n, const double * x, double * y, double lambda, double x0 = 0);
+
+   /// lognormal_cdf_c on an array
+   void lognormal_cdf_c(unsigned int n, const double * x, double * y, double m, double s, double x0 = 0);
+
+   /// lognormal_cdf on an array
+   void lognormal_cdf(unsigned int n, const double * x, double * y, double m, double s, double x0 = 0);
+
+   /// normal_cdf_c on an array
+   void normal_cdf_c(unsigned int n, const double * x, double * y, double sigma = 1, double x0 = 0);
+
+   /// normal_cdf on an array
+   void normal_cdf(unsigned int n, const double * x, double * y, double sigma = 1, double x0 = 0);
+
+   //@}
+
+
+
 #ifdef HAVE_OLD_STAT_FUNC
 
    /** @name Backward compatible MathCore CDF functions */ 
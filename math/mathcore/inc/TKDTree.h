@@ -50,9 +50,11 @@ public:
    Index   GetBucketSize() {return fBucketSize;}
 
    void    FindNearestNeighbors(const Value *point, Int_t k, Index *ind, Value *dist);
+   void    FindNearestNeighbors(Index npoints, const Value *points, Int_t k, Index *ind, Value *dist);
    Index   FindNode(const Value * point) const;
    void    FindPoint(Value * point, Index &index, Int_t &iter);
-   void    FindInRange(Value *point, Value range, std::vector<Index> &res);
+   void    FindInRange(const Value *point, Value range, std::vector<Index> &res);
+   void    FindInRange(Index npoints, const Value *points, Value range, std::vector<std::vector<Index> > &res);
    void    FindBNodeA(Value * point, Value * delta, Int_t &inode);
 
    Bool_t  IsTerminal(Index inode) const {return (inode>=fNNodes);}
@@ -71,9 +73,12 @@ public:
    TKDTree(const TKDTree &); // not implemented
    TKDTree<Index, Value>& operator=(const TKDTree<Index, Value>&); // not implemented
    void CookBoundaries(const Int_t node, Bool_t left);
+   void BuildSubtree(Int_t node, Int_t row, Int_t pos, Int_t npoints);
+   Int_t DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints);
+   void SortByNode(Index npoints, const Value *points, Int_t *order) const;
 
    void UpdateNearestNeighbors(Index inode, const Value *point, Int_t kNN, Index *ind, Value *dist);
-   void UpdateRange(Index inode, Value *point, Value range, std::vector<Index> &res); 
+   void UpdateRange(Index inode, const Value *point, Value range, std::vector<Index> &res); 
 
  protected:
    Int_t   fDataOwner;  //! 0 - not owner, 2 - owner of the pointer array, 1 - owner of the whole 2-d array
@@ -32,6 +32,8 @@ private:
    UInt_t   fMt[624];
    Int_t    fCount624;
 
+   void     Twist();
+
 public:
    TRandom3(UInt_t seed=4357);
    virtual ~TRandom3();
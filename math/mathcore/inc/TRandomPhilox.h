@@ -0,0 +1,57 @@
+// @(#)root/mathcore:$Id$
+// Author: Lorenzo Moneta   2013
+
+/*************************************************************************
+ * Copyright (C) 1995-2013, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TRandomPhilox
+#define ROOT_TRandomPhilox
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TRandomPhilox                                                        //
+//                                                                      //
+// counter-based random number generator (Philox4x32-10) with           //
+// independent streams and skip-ahead                                   //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TRandom
+#include "TRandom.h"
+#endif
+
+class TRandomPhilox : public TRandom {
+
+private:
+   UInt_t    fStream;     //Stream number (second word of the key, the seed is the first)
+   ULong64_t fCounter;    //Counter of the next block of 4 numbers
+   UInt_t    fBlock[4];   //Current block of numbers
+   Int_t     fPos;        //Position of the next number in fBlock (4 if fBlock is used)
+
+public:
+   TRandomPhilox(UInt_t seed=4357, UInt_t stream=0);
+   virtual ~TRandomPhilox();
+   TRandomPhilox    *CreateStream(UInt_t stream) const;
+   ULong64_t         GetPosition() const;
+   UInt_t            GetStream() const {return fStream;}
+   virtual  Double_t Rndm(Int_t i=0);
+   virtual  void     RndmArray(Int_t n, Float_t *array);
+   virtual  void     RndmArray(Int_t n, Double_t *array);
+   virtual  void     SetSeed(UInt_t seed=0);
+   void              SetPosition(ULong64_t pos);
+   void              SetStream(UInt_t stream);
+   void              Skip(ULong64_t n) {SetPosition(GetPosition()+n);}
+
+   ClassDef(TRandomPhilox,1)  //Counter-based random number generator with independent streams
+};
+
+R__EXTERN TRandom *gRandom;
+
+#endif
@@ -2,10 +2,197 @@
 // AdaptiveIntegratorMultiDim
 //
 #include "Math/IFunction.h"
+#include "Math/IParamFunction.h"
 #include "Math/AdaptiveIntegratorMultiDim.h"
+#include "Math/GenAlgoOptions.h"
 #include "Math/Error.h"
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+   // constants of the integration rule of degree 7 (and of degree 5 for the error estimate)
+   const double xl2 = 0.358568582800318073;//lambda_2
+   const double xl4 = 0.948683298050513796;//lambda_4
+   const double xl5 = 0.688247201611685289;//lambda_5
+   const double w2  = 980./6561; //weights/2^n
+   const double w4  = 200./19683;
+   const double wp2 = 245./486;//error weights/2^n
+   const double wp4 = 25./729;
+
+   const double wn1[14] = {     -0.193872885230909911, -0.555606360818980835,
+                                -0.876695625666819078, -1.15714067977442459,  -1.39694152314179743,
+                                -1.59609815576893754,  -1.75461057765584494,  -1.87247878880251983,
+                                -1.94970278920896201,  -1.98628257887517146,  -1.98221815780114818,
+                                -1.93750952598689219,  -1.85215668343240347,  -1.72615963013768225};
+
+   const double wn3[14] = {     0.0518213686937966768,  0.0314992633236803330,
+                                0.0111771579535639891,-0.00914494741655235473,-0.0294670527866686986,
+                                -0.0497891581567850424,-0.0701112635269013768, -0.0904333688970177241,
+                                -0.110755474267134071, -0.131077579637250419,  -0.151399685007366752,
+                                -0.171721790377483099, -0.192043895747599447,  -0.212366001117715794};
+
+   const double wn5[14] = {         0.871183254585174982e-01,  0.435591627292587508e-01,
+                                    0.217795813646293754e-01,  0.108897906823146873e-01,  0.544489534115734364e-02,
+                                    0.272244767057867193e-02,  0.136122383528933596e-02,  0.680611917644667955e-03,
+                                    0.340305958822333977e-03,  0.170152979411166995e-03,  0.850764897055834977e-04,
+                                    0.425382448527917472e-04,  0.212691224263958736e-04,  0.106345612131979372e-04};
+
+   const double wpn1[14] = {   -1.33196159122085045, -2.29218106995884763,
+                               -3.11522633744855959, -3.80109739368998611, -4.34979423868312742,
+                               -4.76131687242798352, -5.03566529492455417, -5.17283950617283939,
+                               -5.17283950617283939, -5.03566529492455417, -4.76131687242798352,
+                               -4.34979423868312742, -3.80109739368998611, -3.11522633744855959};
+
+   const double wpn3[14] = {     0.0445816186556927292, -0.0240054869684499309,
+                                 -0.0925925925925925875, -0.161179698216735251,  -0.229766803840877915,
+                                 -0.298353909465020564,  -0.366941015089163228,  -0.435528120713305891,
+                                 -0.504115226337448555,  -0.572702331961591218,  -0.641289437585733882,
+                                 -0.709876543209876532,  -0.778463648834019195,  -0.847050754458161859};
+
+   // number of points evaluated together by one thread in EvalPoints
+   const unsigned int kChunkSize = 32;
+
+   // evaluate func (pfunc if it is a parametric function) at the npts points x of dimension n
+   void EvalFunction(const ROOT::Math::IMultiGenFunction & func, const ROOT::Math::IParametricFunctionMultiDim * pfunc,
+                     unsigned int n, unsigned int npts, const double * x, double * f)
+   {
+      if (pfunc)
+         pfunc->EvalParVec(npts, x, n, pfunc->Parameters(), f);
+      else
+         for (unsigned int i = 0; i < npts; ++i) f[i] = func(x + i*n);
+   }
+
+   inline double * AddPoint(unsigned int n, const double * z, double * x) {
+      for (unsigned int i = 0; i < n; ++i) x[i] = z[i];
+      return x + n;
+   }
+
+   // store in x the points of the rule for the region of center ctr and half widths wth,
+   // in the order in which their values are summed by RuleEstimate.
+   // Return the number of points (2^n + 2n(n+1) + 1 for a region with positive widths)
+   unsigned int RulePoints(unsigned int n, const double * ctr, const double * wth, double * x)
+   {
+      double z[15], wthl[15];
+      unsigned int j, j1, k, l, m;
+      double * x0 = x;
+
+      for (j=0; j<n; j++) z[j] = ctr[j];
+      x = AddPoint(n, z, x);
+
+      for (j=0; j<n; j++) {
+         z[j]    = ctr[j] - xl2*wth[j];
+         x = AddPoint(n, z, x);
+         z[j]    = ctr[j] + xl2*wth[j];
+         x = AddPoint(n, z, x);
+         wthl[j] = xl4*wth[j];
+         z[j]    = ctr[j] - wthl[j];
+         x = AddPoint(n, z, x);
+         z[j]    = ctr[j] + wthl[j];
+         x = AddPoint(n, z, x);
+         z[j]    = ctr[j];
+      }
+
+      for (j=1;j<n;j++) {
+         j1 = j-1;
+         for (k=j;k<n;k++) {
+            for (l=0;l<2;l++) {
+               wthl[j1] = -wthl[j1];
+               z[j1]    = ctr[j1] + wthl[j1];
+               for (m=0;m<2;m++) {
+                  wthl[k] = -wthl[k];
+                  z[k]    = ctr[k] + wthl[k];
+                  x = AddPoint(n, z, x);
+               }
+            }
+            z[k] = ctr[k];
+         }
+         z[j1] = ctr[j1];
+      }
+
+      for (j=0;j<n;j++) {
+         wthl[j] = -xl5*wth[j];
+         z[j] = ctr[j] + wthl[j];
+      }
+      // end nodes ~gray codes
+      do {
+         x = AddPoint(n, z, x);
+         for (j=0;j<n;j++) {
+            wthl[j] = -wthl[j];
+            z[j] = ctr[j] + wthl[j];
+            if (wthl[j] > 0) break;
+         }
+      } while (j < n);
+
+      return (x - x0)/n;
+   }
+
+   // compute from the function values f at the npts rule points of the region of
+   // half widths wth the integral (rgnval), its error (rgnerr) and the axis
+   // (from 1 to n) along which the region should be divided (idvaxn, unchanged if the
+   // differences are not defined). Return true if all the sums of values are zero
+   bool RuleEstimate(unsigned int n, const double * wth, const double * f, unsigned int npts,
+                     double & rgnval, double & rgnerr, unsigned int & idvaxn)
+   {
+      const double * fend = f + npts;
+      double rgnvol = std::pow(2.0,static_cast<int>(n));//=2^n
+      unsigned int j;
+      for (j=0; j<n; j++) rgnvol *= wth[j]; //region volume
+
+      double sum1 = *f++;
+      double difmax = 0;
+      double sum2   = 0;
+      double sum3   = 0;
+      double f2, f3, dif;
+      for (j=0; j<n; j++) {
+         f2  = f[0];
+         f2 += f[1];
+         f3  = f[2];
+         f3 += f[3];
+         f  += 4;
+         sum2   += f2;//sum func eval with different weights separately
+         sum3   += f3;//for a given region
+         dif     = std::abs(7*f2-f3-12*sum1);
+         //storing dimension with biggest error/difference (?)
+         if (dif >= difmax) {
+            difmax=dif;
+            idvaxn=j+1;
+         }
+      }
+
+      double sum4 = 0;
+      for (j=0; j<2*n*(n-1); j++) sum4 += *f++;
+
+      double sum5 = 0;
+      while (f < fend) sum5 += *f++;
+
+      double rgncmp  = rgnvol*(wpn1[n-2]*sum1+wp2*sum2+wpn3[n-2]*sum3+wp4*sum4);
+      rgnval  = wn1[n-2]*sum1+w2*sum2+wn3[n-2]*sum3+w4*sum4+wn5[n-2]*sum5;
+      rgnval *= rgnvol;
+      // avoid difference of too small numbers
+      //rgnerr  = TMath::Max( std::abs(rgnval-rgncmp), TMath::Max(std::abs(rgncmp), std::abs(rgnval) )*4.0E-16 );
+      rgnerr  = std::abs(rgnval-rgncmp);//compares estim error with expected error
+
+      return (sum1==0 && sum2==0 && sum3==0 && sum4==0 && sum5==0);
+   }
+
+   // order of the regions (identified by their position in the working array wk of
+   // records of size irgnst) in the heap: largest error first
+   struct CompareRegionError {
+      CompareRegionError(const double * wk, unsigned int irgnst) : fWk(wk), fSize(irgnst) {}
+      bool operator() (unsigned int i1, unsigned int i2) const {
+         double e1 = fWk[i1*fSize];
+         double e2 = fWk[i2*fSize];
+         if (e1 != e2) return e1 < e2;
+         return i1 > i2;
+      }
+      const double * fWk;
+      unsigned int fSize;
+   };
+
+}
 
 namespace ROOT {
 namespace Math {
@@ -23,6 +210,8 @@ AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim(double absTol, double rel
    fError(0), fRelError(0),
    fNEval(0),
    fStatus(-1),
+   fNThreads(0),
+   fNRegions(1),
    fFun(0)
 {
    // constructor - without passing a function
@@ -39,6 +228,8 @@ AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim( const IMultiGenFunction
    fError(0), fRelError(0),
    fNEval(0),
    fStatus(-1),
+   fNThreads(0),
+   fNRegions(1),
    fFun(&f)
 {
    // constructur passing a multi-dimensional function interface
@@ -84,45 +275,7 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
    double relerr; //an estimation of the relative accuracy of the result
 
 
-   double ctr[15], wth[15], wthl[15], z[15];
-
-   static const double xl2 = 0.358568582800318073;//lambda_2
-   static const double xl4 = 0.948683298050513796;//lambda_4
-   static const double xl5 = 0.688247201611685289;//lambda_5
-   static const double w2  = 980./6561; //weights/2^n
-   static const double w4  = 200./19683;
-   static const double wp2 = 245./486;//error weights/2^n
-   static const double wp4 = 25./729;
-
-   static const double wn1[14] = {     -0.193872885230909911, -0.555606360818980835,
-                                       -0.876695625666819078, -1.15714067977442459,  -1.39694152314179743,
-                                       -1.59609815576893754,  -1.75461057765584494,  -1.87247878880251983,
-                                       -1.94970278920896201,  -1.98628257887517146,  -1.98221815780114818,
-                                       -1.93750952598689219,  -1.85215668343240347,  -1.72615963013768225};
-
-   static const double wn3[14] = {     0.0518213686937966768,  0.0314992633236803330,
-                                       0.0111771579535639891,-0.00914494741655235473,-0.0294670527866686986,
-                                       -0.0497891581567850424,-0.0701112635269013768, -0.0904333688970177241,
-                                       -0.110755474267134071, -0.131077579637250419,  -0.151399685007366752,
-                                       -0.171721790377483099, -0.192043895747599447,  -0.212366001117715794};
-
-   static const double wn5[14] = {         0.871183254585174982e-01,  0.435591627292587508e-01,
-                                           0.217795813646293754e-01,  0.108897906823146873e-01,  0.544489534115734364e-02,
-                                           0.272244767057867193e-02,  0.136122383528933596e-02,  0.680611917644667955e-03,
-                                           0.340305958822333977e-03,  0.170152979411166995e-03,  0.850764897055834977e-04,
-                                           0.425382448527917472e-04,  0.212691224263958736e-04,  0.106345612131979372e-04};
-
-   static const double wpn1[14] = {   -1.33196159122085045, -2.29218106995884763,
-                                      -3.11522633744855959, -3.80109739368998611, -4.34979423868312742,
-                                      -4.76131687242798352, -5.03566529492455417, -5.17283950617283939,
-                                      -5.17283950617283939, -5.03566529492455417, -4.76131687242798352,
-                                      -4.34979423868312742, -3.80109739368998611, -3.11522633744855959};
-
-   static const double wpn3[14] = {     0.0445816186556927292, -0.0240054869684499309,
-                                        -0.0925925925925925875, -0.161179698216735251,  -0.229766803840877915,
-                                        -0.298353909465020564,  -0.366941015089163228,  -0.435528120713305891,
-                                        -0.504115226337448555,  -0.572702331961591218,  -0.641289437585733882,
-                                        -0.709876543209876532,  -0.778463648834019195,  -0.847050754458161859};
+   double ctr[15], wth[15];
 
    double result = 0;
    double abserr = 0;
@@ -135,6 +288,9 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
       return 0;
    }
 
+   // divide several regions at each step
+   if (fNRegions > 1) return DoIntegralNRegions(xmin, xmax, absValue);
+
    double twondm = std::pow(2.0,static_cast<int>(n));
    //unsigned int minpts = Int_t(twondm)+ 2*n*(n+1)+1;
 
@@ -165,92 +321,21 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
       wth[j] = (xmax[j] - xmin[j])*0.5;//its width
    }
 
-   double rgnvol, sum1, sum2, sum3, sum4, sum5, difmax, f2, f3, dif, aresult;
-   double rgncmp=0, rgnval, rgnerr;
-
-   unsigned int j1, k, l, m, idvaxn=0, idvax0=0, isbtmp, isbtpp;
- 
-   //InitArgs(z,fParams);
-
-L20:
-   rgnvol = twondm;//=2^n
-   for (j=0; j<n; j++) {
-      rgnvol *= wth[j]; //region volume
-      z[j]    = ctr[j]; //temporary node
-   }
-   sum1 = (*fFun)((const double*)z);//EvalPar(z,fParams); //evaluate function
-
-   difmax = 0;
-   sum2   = 0;
-   sum3   = 0;
-
-   //loop over coordinates
-   for (j=0; j<n; j++) {
-      z[j]    = ctr[j] - xl2*wth[j];
-      if (absValue) f2 = std::abs((*fFun)(z));
-      else          f2 = (*fFun)(z);
-      z[j]    = ctr[j] + xl2*wth[j];
-      if (absValue) f2 += std::abs((*fFun)(z));
-      else          f2 += (*fFun)(z);
-      wthl[j] = xl4*wth[j];
-      z[j]    = ctr[j] - wthl[j]; 
-      if (absValue) f3 = std::abs((*fFun)(z));
-      else          f3 = (*fFun)(z);
-      z[j]    = ctr[j] + wthl[j];
-      if (absValue) f3 += std::abs((*fFun)(z));
-      else          f3 += (*fFun)(z);
-      sum2   += f2;//sum func eval with different weights separately
-      sum3   += f3;//for a given region
-      dif     = std::abs(7*f2-f3-12*sum1);
-      //storing dimension with biggest error/difference (?)
-      if (dif >= difmax) {
-         difmax=dif;
-         idvaxn=j+1;
-      }
-      z[j]    = ctr[j];
-   }
-
-   sum4 = 0;
-   for (j=1;j<n;j++) {
-      j1 = j-1;
-      for (k=j;k<n;k++) {
-         for (l=0;l<2;l++) {
-            wthl[j1] = -wthl[j1];
-            z[j1]    = ctr[j1] + wthl[j1];
-            for (m=0;m<2;m++) {
-               wthl[k] = -wthl[k];
-               z[k]    = ctr[k] + wthl[k];
-               if (absValue) sum4 += std::abs((*fFun)(z));
-               else            sum4 += (*fFun)(z);
-            }
-         }
-         z[k] = ctr[k];
-      }
-      z[j1] = ctr[j1];
-   }
+   double aresult;
+   double rgnval, rgnerr;
+   bool allZero = false;
 
-   sum5 = 0;
+   unsigned int k, idvaxn=0, idvax0=0, isbtmp, isbtpp;
 
-   for (j=0;j<n;j++) {
-      wthl[j] = -xl5*wth[j];
-      z[j] = ctr[j] + wthl[j];
-   }
-L90: //sum over end nodes ~gray codes
-   if (absValue) sum5 += std::abs((*fFun)(z));
-   else          sum5 += (*fFun)(z);
-   for (j=0;j<n;j++) {
-      wthl[j] = -wthl[j];
-      z[j] = ctr[j] + wthl[j];
-      if (wthl[j] > 0) goto L90;
-   }
+   // points of the rule for a region and function values
+   std::vector<double> x(irlcls*n);
+   std::vector<double> fval(irlcls);
+   unsigned int npts;
 
-   rgncmp  = rgnvol*(wpn1[n-2]*sum1+wp2*sum2+wpn3[n-2]*sum3+wp4*sum4);
-   rgnval  = wn1[n-2]*sum1+w2*sum2+wn3[n-2]*sum3+w4*sum4+wn5[n-2]*sum5;
-   rgnval *= rgnvol;
-   // avoid difference of too small numbers
-   //rgnval = 1.0E-30;
-   //rgnerr  = TMath::Max( std::abs(rgnval-rgncmp), TMath::Max(std::abs(rgncmp), std::abs(rgnval) )*4.0E-16 );
-   rgnerr  = std::abs(rgnval-rgncmp);//compares estim error with expected error
+L20:
+   npts = RulePoints(n, ctr, wth, &x[0]);
+   EvalPoints(npts, &x[0], &fval[0], absValue);
+   allZero = RuleEstimate(n, wth, &fval[0], npts, rgnval, rgnerr, idvaxn);
 
    result += rgnval;
    abserr += rgnerr;
@@ -314,7 +399,7 @@ L160: //to divide or not
    if (relerr < 1e-5 && aresult < 1e-5)  fStatus = 0;
    if (isbrgs+irgnst > iwk) fStatus = 2;
    if (ifncls+2*irlcls > maxpts) {
-      if (sum1==0 && sum2==0 && sum3==0 && sum4==0 && sum5==0){
+      if (allZero){
          fStatus = 0;
          result = 0;
       }
@@ -350,7 +435,161 @@ L160: //to divide or not
 }
 
 
-  
+
+double AdaptiveIntegratorMultiDim::DoIntegralNRegions(const double* xmin, const double * xmax, bool absValue)
+{
+   // Same algorithm as DoIntegral, but at each step the fNRegions regions with the
+   // largest errors are divided instead of one, and the rule points of the
+   // 2*fNRegions new sub-regions are evaluated together (see EvalPoints).
+   // The regions are kept in a heap ordered by error (and by creation order for
+   // equal errors), so the result depends on fNRegions but not on the number of threads.
+
+   const unsigned int n = fDim;
+   const unsigned int nreg = fNRegions;
+   const double eps = fRelTol;
+
+   double twondm = std::pow(2.0,static_cast<int>(n));
+   // a region is stored as: error, value, division axis, center[n], half widths[n]
+   const unsigned int irgnst = 2*n+3;
+   const unsigned int irlcls = (unsigned int)(twondm) +2*n*(n+1)+1;//minimal number of nodes in n dim
+
+   unsigned int minpts = fMinPts;
+   unsigned int maxpts = std::max(fMaxPts, irlcls) ;//specified maximal number of function evaluations
+   if (minpts < 1)      minpts = irlcls;
+   if (maxpts < minpts) maxpts = 10*minpts;
+   // maximum number of regions, as for the working array of DoIntegral
+   const unsigned int maxrgn = std::max( fSize, irgnst*(1 +maxpts/irlcls)/2 ) / irgnst;
+
+   std::vector<double> wk;            // region records
+   std::vector<unsigned int> heap;    // indices of the records, largest error first
+   // points and function values of the new regions
+   std::vector<double> x(2*nreg*irlcls*n);
+   std::vector<double> fval(2*nreg*irlcls);
+   std::vector<unsigned int> npts(2*nreg);
+   std::vector<unsigned int> rgn(2*nreg);
+
+   double result = 0;
+   double abserr = 0;
+   double relerr = 0;
+   double aresult;
+   unsigned int ifncls = 0;
+   unsigned int idvaxn = 0;
+   bool allZero = false;
+   unsigned int i, j;
+
+   // start from the whole hypercube
+   wk.resize(irgnst);
+   for (j=0; j<n; j++) {
+      wk[3+j]   = (xmax[j] + xmin[j])*0.5;//center of a hypercube
+      wk[3+n+j] = (xmax[j] - xmin[j])*0.5;//its width
+   }
+   unsigned int nnew = 1;
+   rgn[0] = 0;
+
+   fStatus = 3;
+   while (fStatus == 3) {
+
+      // evaluate the rule on the new regions
+      unsigned int ntot = 0;
+      for (i=0; i<nnew; i++) {
+         const double * r = &wk[rgn[i]*irgnst];
+         npts[i] = RulePoints(n, r+3, r+3+n, &x[ntot*n]);
+         ntot += npts[i];
+      }
+      EvalPoints(ntot, &x[0], &fval[0], absValue);
+      ntot = 0;
+      for (i=0; i<nnew; i++) {
+         double * r = &wk[rgn[i]*irgnst];
+         allZero = RuleEstimate(n, r+3+n, &fval[ntot], npts[i], r[1], r[0], idvaxn);
+         r[2] = double(idvaxn);
+         ntot += npts[i];
+         result += r[1];
+         abserr += r[0];
+         ifncls += irlcls;
+         heap.push_back(rgn[i]);
+         std::push_heap(heap.begin(), heap.end(), CompareRegionError(&wk[0], irgnst));
+      }
+      aresult = std::abs(result);
+      relerr = abserr;
+      if (aresult != 0)  relerr = abserr/aresult;
+
+      if (relerr < 1e-1 && aresult < 1e-20) fStatus = 0;
+      if (relerr < 1e-3 && aresult < 1e-10) fStatus = 0;
+      if (relerr < 1e-5 && aresult < 1e-5)  fStatus = 0;
+      if (heap.size()+nreg > maxrgn) fStatus = 2;
+      if (ifncls+2*nreg*irlcls > maxpts) {
+         if (allZero){
+            fStatus = 0;
+            result = 0;
+         }
+         else
+            fStatus = 1;
+      }
+      if (relerr < eps && ifncls >= minpts) fStatus = 0;  // We do not use the absolute error.
+      if (fStatus != 3) break;
+
+      // divide the regions with the largest errors in two along their chosen axis
+      const unsigned int ndiv = std::min<unsigned int>(nreg, heap.size());
+      nnew = 0;
+      for (i=0; i<ndiv; i++) {
+         std::pop_heap(heap.begin(), heap.end(), CompareRegionError(&wk[0], irgnst));
+         const unsigned int ir1 = heap.back();
+         heap.pop_back();
+         const unsigned int ir2 = wk.size()/irgnst;
+         wk.resize(wk.size()+irgnst);
+         double * r1 = &wk[ir1*irgnst];
+         double * r2 = &wk[ir2*irgnst];
+         abserr -= r1[0];
+         result -= r1[1];
+         unsigned int iax = (unsigned int)(r1[2]);
+         iax = (iax > 0 && iax <= n) ? iax-1 : 0;
+         r1[3+n+iax]  = 0.5*r1[3+n+iax];
+         r1[3+iax]   -= r1[3+n+iax];
+         std::copy(r1, r1+irgnst, r2);
+         r2[3+iax]   += 2*r2[3+n+iax];
+         rgn[nnew++] = ir1;
+         rgn[nnew++] = ir2;
+      }
+   }
+
+   fResult = result;
+   fError = abserr;
+   fRelError = relerr;
+   fNEval = ifncls;
+
+   return result;
+}
+
+void AdaptiveIntegratorMultiDim::EvalPoints(unsigned int npts, const double * x, double * f, bool absValue) const
+{
+   // Evaluate the function at the npts points x (of fDim coordinates each, stored one
+   // after the other) and store the values in f.
+   // Parametric functions are evaluated with a single call to EvalParVec.
+   // If fNThreads > 1 the points are split in chunks evaluated concurrently (when
+   // compiled with openMP): the function must then be thread safe.
+
+   const IParametricFunctionMultiDim * pfunc = dynamic_cast<const IParametricFunctionMultiDim *>(fFun);
+   const unsigned int n = fDim;
+   const int nChunks = (npts + kChunkSize - 1)/kChunkSize;
+   if (fNThreads > 1 && nChunks > 1) {
+#ifdef _OPENMP
+      const int nThreads = fNThreads;
+#pragma omp parallel for num_threads(nThreads) schedule(dynamic)
+#endif
+      for (int ichunk = 0; ichunk < nChunks; ++ichunk) {
+         const unsigned int i1 = ichunk*kChunkSize;
+         const unsigned int i2 = std::min(npts, i1 + kChunkSize);
+         EvalFunction(*fFun, pfunc, n, i2-i1, x + i1*n, f + i1);
+      }
+   }
+   else
+      EvalFunction(*fFun, pfunc, n, npts, x, f);
+
+   if (absValue)
+      for (unsigned int i = 0; i < npts; ++i) f[i] = std::abs(f[i]);
+}
+
+
 double AdaptiveIntegratorMultiDim::Integral(const IMultiGenFunction &f, const double* xmin, const double * xmax)
 {
    // calculate integral passing a function object
@@ -367,6 +606,12 @@ ROOT::Math::IntegratorMultiDimOptions  AdaptiveIntegratorMultiDim::Options() con
    opt.SetNCalls(fMaxPts); 
    opt.SetWKSize(fSize); 
    opt.SetIntegrator("ADAPTIVE");
+   if (fNThreads > 0 || fNRegions > 1) {
+      ROOT::Math::GenAlgoOptions extraOpt;
+      extraOpt.SetIntValue("NThreads", fNThreads);
+      extraOpt.SetIntValue("NRegions", fNRegions);
+      opt.SetExtraOptions(extraOpt);
+   }
    return opt; 
 }
 
@@ -381,6 +626,13 @@ void AdaptiveIntegratorMultiDim::SetOptions(const ROOT::Math::IntegratorMultiDim
    SetRelTolerance( opt.RelTolerance() );
    SetMaxPts( opt.NCalls() );
    SetSize( opt.WKSize() );
+   // parallel evaluation
+   ROOT::Math::IOptions * extraOpt = opt.ExtraOptions();
+   if (extraOpt) {
+      int ival = 0;
+      if (extraOpt->GetIntValue("NThreads", ival) ) SetNThreads(std::max(ival, 0) );
+      if (extraOpt->GetIntValue("NRegions", ival) ) SetNRegions(std::max(ival, 1) );
+   }
 }
 
 } // namespace Math
@@ -0,0 +1,43 @@
+// @(#)root/mathcore:$Id$
+// Author: L. Moneta
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2012  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Implementation of the array versions of the fast mathematical functions 
+// The loops are written without dependencies between iterations, so they 
+// can be auto-vectorized by the compiler
+
+#include "Math/FastMath.h"
+
+namespace ROOT { 
+
+   namespace Math { 
+
+void fast_exp(unsigned int n, const double * x, double * y) { 
+   for (unsigned int i = 0; i < n; ++i) 
+      y[i] = fast_exp(x[i]); 
+}
+
+void fast_log(unsigned int n, const double * x, double * y) { 
+   for (unsigned int i = 0; i < n; ++i) 
+      y[i] = fast_log(x[i]); 
+}
+
+void fast_erf(unsigned int n, const double * x, double * y) { 
+   for (unsigned int i = 0; i < n; ++i) 
+      y[i] = fast_erf(x[i]); 
+}
+
+void fast_erfc(unsigned int n, const double * x, double * y) { 
+   for (unsigned int i = 0; i < n; ++i) 
+      y[i] = fast_erfc(x[i]); 
+}
+
+   } // end namespace Math
+
+} // end namespace ROOT
@@ -29,6 +29,7 @@
 #include <limits>
 #include <cmath>
 #include <cassert> 
+#include <algorithm>
 //#include <memory>
 
 //#define DEBUG
@@ -319,6 +320,658 @@ namespace ROOT {
 
 
 
+
+         // accumulator used in the sequential evaluation (plain summation)
+         class SimpleSum { 
+         public: 
+            SimpleSum() : fSum(0) {}
+            void Add(double x) { fSum += x; }
+            double Sum() const { return fSum; }
+         private: 
+            double fSum; 
+         };
+
+         // accumulator using the Kahan compensated summation 
+         // used when the data points are evaluated in chunks
+         class KahanSum { 
+         public: 
+            KahanSum() : fSum(0), fCarry(0) {}
+            void Add(double x) { 
+               double y = x - fCarry; 
+               double t = fSum + y; 
+               fCarry = (t - fSum) - y; 
+               fSum = t; 
+            }
+            double Sum() const { return fSum; }
+         private: 
+            double fSum; 
+            double fCarry;  // running compensation of the lost low-order bits 
+         };
+
+         // pairwise summation of the n values v[0], v[stride], ..., v[(n-1)*stride]
+         double PairwiseSum(const double * v, unsigned int n, unsigned int stride) { 
+            if (n == 0) return 0; 
+            if (n == 1) return v[0]; 
+            unsigned int n1 = n/2; 
+            return PairwiseSum(v, n1, stride) + PairwiseSum(v + n1*stride, n - n1, stride); 
+         }
+
+         // size of the chunks of data points used in the parallel evaluation. 
+         // It does not depend on the number of threads, so the result is reproducible 
+         const unsigned int kChunkSize = 1024; 
+
+         // evaluate the functor eval, which returns m values for a given range of points [i1,i2), 
+         // on all the n data points. The points are split in chunks of fixed size, which are evaluated 
+         // concurrently when OpenMP is available, and the chunk results are then reduced in a fixed order 
+         // using pairwise summation 
+         template <class Eval> 
+         void EvaluateInChunks(const Eval & eval, unsigned int n, unsigned int m, unsigned int nThreads, double * result) { 
+            int nChunks = (n + kChunkSize - 1)/kChunkSize; 
+            std::vector<double> partial(nChunks*m); 
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nThreads) schedule(dynamic)
+#else
+            (void) nThreads; 
+#endif
+            for (int ichunk = 0; ichunk < nChunks; ++ichunk) { 
+               unsigned int i1 = ichunk*kChunkSize; 
+               unsigned int i2 = std::min(n, i1 + kChunkSize); 
+               eval(i1, i2, &partial[ichunk*m]); 
+            }
+            for (unsigned int j = 0; j < m; ++j) 
+               result[j] = (nChunks > 0) ? PairwiseSum(&partial[j], nChunks, m) : 0; 
+         }
+
+         // evaluate the model function on the data points [i1,i2) with a single call to 
+         // IParamMultiFunction::EvalParVec, which can be vectorized by the function implementation. 
+         // The coordinates are copied in the contiguous work array xbuf, since the data 
+         // points are not necessarily stored with a fixed stride 
+         template <class Data> 
+         void EvaluateModelOnPoints(const IModelFunction & func, const Data & data, const double * p, 
+                                    unsigned int i1, unsigned int i2, std::vector<double> & xbuf, double * fval) { 
+            unsigned int ndim = data.NDim(); 
+            xbuf.resize( (i2-i1)*ndim ); 
+            for (unsigned int i = i1; i < i2; ++i) { 
+               const double * x = data.Coords(i); 
+               std::copy(x, x + ndim, xbuf.begin() + (i-i1)*ndim ); 
+            }
+            func.EvalParVec(i2-i1, &xbuf.front(), ndim, p, fval); 
+         }
+
+         // the evaluator classes below compute the contribution of the data points in a range [i1,i2) 
+         // to the various fit method functions. They are templated on the accumulator type. 
+         // Integral evaluator and work arrays are created in each call, so that different 
+         // ranges can be evaluated concurrently
+
+         // evaluator of the chi2 (returns 1 value) 
+         template <class Acc> 
+         class Chi2Evaluator { 
+
+         public: 
+
+            Chi2Evaluator(const IModelFunction & func, const BinData & data, const double * p) : 
+               fFunc(func), 
+               fData(data), 
+               fParams(p)
+            {
+               const DataOptions & fitOpt = data.Opt();
+               fUseBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
+               fUseBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
+               fWrefVolume = 1.0; 
+               if (fUseBinVolume) fWrefVolume /= data.RefVolume();
+               fMaxResValue = std::numeric_limits<double>::max() / data.Size();
+            }
+
+            void operator() (unsigned int i1, unsigned int i2, double * result) const { 
+
+               IntegralEvaluator<> igEval( fFunc, fParams, fUseBinIntegral); 
+               std::vector<double> xc; 
+               if (fUseBinVolume) xc.resize(fData.NDim() );
+
+               // evaluate the function values in blocks when no bin integral or volume is needed
+               bool useBlock = !fUseBinIntegral && !fUseBinVolume; 
+               std::vector<double> xbuf; 
+               std::vector<double> fvalues; 
+               if (useBlock) fvalues.resize( std::min(i2-i1, kChunkSize) ); 
+               unsigned int iblock = i1; 
+
+               Acc chi2; 
+               for (unsigned int i = i1; i < i2; ++ i) { 
+
+                  if (useBlock && i == iblock) { 
+                     unsigned int iend = std::min(i2, i + kChunkSize); 
+                     EvaluateModelOnPoints(fFunc, fData, fParams, i, iend, xbuf, &fvalues.front() ); 
+                     iblock = iend; 
+                  }
+
+                  double y, invError; 
+                  // in case of no error in y invError=1 is returned
+                  const double * x1 = fData.GetPoint(i,y, invError);
+
+                  double fval = 0;
+
+                  double binVolume = 1.0; 
+                  if (fUseBinVolume) { 
+                     unsigned int ndim = fData.NDim(); 
+                     const double * x2 = fData.BinUpEdge(i);  
+                     for (unsigned int j = 0; j < ndim; ++j) {
+                        binVolume *= std::abs( x2[j]-x1[j] );
+                        xc[j] = 0.5*(x2[j]+ x1[j]);
+                     }
+                     // normalize the bin volume using a reference value
+                     binVolume *= fWrefVolume;
+                  }
+
+                  const double * x = (fUseBinVolume) ? &xc.front() : x1;
+
+                  if (useBlock) { 
+                     fval = fvalues[ (i-i1) % kChunkSize ]; 
+                  }
+                  else if (!fUseBinIntegral) {
+                     fval = fFunc ( x, fParams );
+                  }
+                  else {
+                     // calculate integral normalized by bin volume
+                     fval = igEval( x1, fData.BinUpEdge(i)) ; 
+                  }
+                  // normalize result if requested according to bin volume
+                  if (fUseBinVolume) fval *= binVolume;
+
+#ifdef DEBUG      
+                  std::cout << x[0] << "  " << y << "  " << 1./invError << "\tfval = " << fval 
+                            << " bin volume " << binVolume << " ref " << fWrefVolume << std::endl; 
+#endif
+
+                  if (invError > 0) { 
+
+                     double tmp = ( y -fval )* invError;  	  
+                     double resval = tmp * tmp;
+
+                     // avoid inifinity or nan in chi2 values due to wrong function values 
+                     if ( resval < fMaxResValue )  
+                        chi2.Add(resval); 
+                     else 
+                        chi2.Add(fMaxResValue);
+                  }
+               }
+               result[0] = chi2.Sum();
+            }
+
+         private: 
+
+            const IModelFunction & fFunc; 
+            const BinData & fData; 
+            const double * fParams; 
+            bool fUseBinIntegral; 
+            bool fUseBinVolume; 
+            double fWrefVolume; 
+            double fMaxResValue; 
+         };
+
+         // evaluator of the chi2 gradient 
+         // (returns npar + 1 values: the gradient components and the number of rejected points)
+         template <class Acc> 
+         class Chi2GradientEvaluator { 
+
+         public: 
+
+            Chi2GradientEvaluator(const IGradModelFunction & func, const BinData & data, const double * p) : 
+               fFunc(func), 
+               fData(data), 
+               fParams(p)
+            {
+               const DataOptions & fitOpt = data.Opt();
+               fUseBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
+               fUseBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
+               fWrefVolume = 1.0; 
+               if (fUseBinVolume) fWrefVolume /= data.RefVolume();
+            }
+
+            void operator() (unsigned int i1, unsigned int i2, double * result) const { 
+
+               IntegralEvaluator<> igEval( fFunc, fParams, fUseBinIntegral); 
+               std::vector<double> xc; 
+               if (fUseBinVolume) xc.resize(fData.NDim() );
+
+               unsigned int npar = fFunc.NPar(); 
+               std::vector<double> gradFunc( npar ); 
+               std::vector<Acc> g( npar); 
+               unsigned int nRejected = 0; 
+
+               for (unsigned int i = i1; i < i2; ++ i) { 
+
+                  double y, invError = 0; 
+                  const double * x1 = fData.GetPoint(i,y, invError);
+
+                  double fval = 0; 
+                  const double * x2 = 0; 
+
+                  double binVolume = 1; 
+                  if (fUseBinVolume) { 
+                     unsigned int ndim = fData.NDim(); 
+                     x2 = fData.BinUpEdge(i);  
+                     for (unsigned int j = 0; j < ndim; ++j) {
+                        binVolume *= std::abs( x2[j]-x1[j] );
+                        xc[j] = 0.5*(x2[j]+ x1[j]);
+                     }
+                     // normalize the bin volume using a reference value
+                     binVolume *= fWrefVolume;
+                  }
+
+                  const double * x = (fUseBinVolume) ? &xc.front() : x1;
+
+                  if (!fUseBinIntegral ) {
+                     fval = fFunc ( x, fParams ); 
+                     fFunc.ParameterGradient(  x , fParams, &gradFunc[0] ); 
+                  }
+                  else { 
+                     x2 = fData.BinUpEdge(i); 
+                     // calculate normalized integral and gradient (divided by bin volume)
+                     fval = igEval( x1, x2 ) ; 
+                     CalculateGradientIntegral( fFunc, x1, x2, fParams, &gradFunc[0]); 
+                  }
+                  if (fUseBinVolume) fval *= binVolume;
+
+                  if ( !CheckValue(fval) ) { 
+                     nRejected++; 
+                     continue;
+                  } 
+
+                  // loop on the parameters
+                  unsigned int ipar = 0; 
+                  for ( ; ipar < npar ; ++ipar) { 
+
+                     // correct gradient for bin volumes
+                     if (fUseBinVolume) gradFunc[ipar] *= binVolume;
+
+                     // avoid singularity in the function (infinity and nan ) in the chi2 sum 
+                     // eventually add possibility of excluding some points (like singularity) 
+                     double dfval = gradFunc[ipar];
+                     if ( !CheckValue(dfval) ) { 
+                        break; // exit loop on parameters
+                     } 
+ 
+                     // calculate derivative point contribution
+                     double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];  	  
+                     g[ipar].Add(tmp);
+                  }
+
+                  if ( ipar < npar ) { 
+                     // case loop was broken for an overflow in the gradient calculation  
+                     nRejected++; 
+                     continue;
+                  } 
+               }
+
+               for (unsigned int ipar = 0; ipar < npar; ++ipar) 
+                  result[ipar] = g[ipar].Sum(); 
+               result[npar] = nRejected; 
+            }
+
+         private: 
+
+            const IGradModelFunction & fFunc; 
+            const BinData & fData; 
+            const double * fParams; 
+            bool fUseBinIntegral; 
+            bool fUseBinVolume; 
+            double fWrefVolume; 
+         };
+
+         // evaluator of the log-likelihood 
+         // (returns 3 values: the log-likelihood, the sum of weights and the sum of weight squares) 
+         template <class Acc> 
+         class LogLEvaluator { 
+
+         public: 
+
+            LogLEvaluator(const IModelFunction & func, const UnBinData & data, const double * p, 
+                          int iWeight, bool extended, bool normalizeFunc, double norm) : 
+               fFunc(func), 
+               fData(data), 
+               fParams(p), 
+               fWeight(iWeight), 
+               fIsExtended(extended), 
+               fNormalizeFunc(normalizeFunc), 
+               fNorm(norm)
+            {}
+
+            void operator() (unsigned int i1, unsigned int i2, double * result) const { 
+
+               Acc logl; 
+               Acc sumW; 
+               Acc sumW2; 
+
+               // the function values are evaluated in blocks of points
+               std::vector<double> xbuf; 
+               std::vector<double> fvalues( std::min(i2-i1, kChunkSize) ); 
+               unsigned int iblock = i1; 
+
+               for (unsigned int i = i1; i < i2; ++ i) { 
+                  if (i == iblock) { 
+                     unsigned int iend = std::min(i2, i + kChunkSize); 
+                     EvaluateModelOnPoints(fFunc, fData, fParams, i, iend, xbuf, &fvalues.front() ); 
+                     iblock = iend; 
+                  }
+#ifdef DEBUG      
+                  const double * x = fData.Coords(i);
+#endif
+                  double fval = fvalues[ (i-i1) % kChunkSize ]; 
+                  if (fNormalizeFunc) fval = fval / fNorm;
+
+#ifdef DEBUG      
+                  std::cout << "x [ " << fData.NDim() << " ] = "; 
+                  for (unsigned int j = 0; j < fData.NDim(); ++j)
+                     std::cout << x[j] << "\t"; 
+                  std::cout << "\tfval = " << fval << std::endl; 
+#endif
+                  // function EvalLog protects against negative or too small values of fval
+                  double logval =  ROOT::Math::Util::EvalLog( fval);       
+                  if (fWeight > 0) { 
+                     double weight = fData.Weight(i); 
+                     logval *= weight; 
+                     if (fWeight ==2) { 
+                        logval *= weight; // use square of weights in likelihood
+                        if (fIsExtended) { 
+                           // needed sum of weights and sum of weight square if likelkihood is extended
+                           sumW.Add(weight); 
+                           sumW2.Add(weight*weight); 
+                        }
+                     }
+                  }
+                  logl.Add(logval);
+               }
+               result[0] = logl.Sum(); 
+               result[1] = sumW.Sum(); 
+               result[2] = sumW2.Sum(); 
+            }
+
+         private: 
+
+            const IModelFunction & fFunc; 
+            const UnBinData & fData; 
+            const double * fParams; 
+            int fWeight; 
+            bool fIsExtended; 
+            bool fNormalizeFunc; 
+            double fNorm; 
+         };
+
+         // evaluator of the log-likelihood gradient (returns npar values)
+         template <class Acc> 
+         class LogLGradientEvaluator { 
+
+         public: 
+
+            LogLGradientEvaluator(const IGradModelFunction & func, const UnBinData & data, const double * p) : 
+               fFunc(func), 
+               fData(data), 
+               fParams(p)
+            {}
+
+            void operator() (unsigned int i1, unsigned int i2, double * result) const { 
+
+               unsigned int n = fData.Size();
+               unsigned int npar = fFunc.NPar(); 
+               std::vector<double> gradFunc( npar ); 
+               std::vector<Acc> g( npar); 
+
+               for (unsigned int i = i1; i < i2; ++ i) { 
+                  const double * x = fData.Coords(i);
+                  double fval = fFunc ( x , fParams); 
+                  fFunc.ParameterGradient( x, fParams, &gradFunc[0] );
+                  for (unsigned int kpar = 0; kpar < npar; ++ kpar) { 
+                     if (fval > 0)  
+                        g[kpar].Add( - 1./fval * gradFunc[ kpar ] ); 
+                     else if (gradFunc [ kpar] != 0) { 
+                        const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+                        const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+                        double gg = kdmax1 * gradFunc[ kpar ];  
+                        if ( gg > 0) gg = std::min( gg, kdmax2);
+                        else gg = std::max(gg, - kdmax2);
+                        g[kpar].Add( - gg );
+                     }
+                     // if func derivative is zero term is also zero so do not add in g[kpar]
+                  }
+               }
+               for (unsigned int kpar = 0; kpar < npar; ++kpar) 
+                  result[kpar] = g[kpar].Sum(); 
+            }
+
+         private: 
+
+            const IGradModelFunction & fFunc; 
+            const UnBinData & fData; 
+            const double * fParams; 
+         };
+
+         // evaluator of the Poisson log-likelihood 
+         // (returns 2 values: the negative log-likelihood and the number of non-empty bins)
+         template <class Acc> 
+         class PoissonLogLEvaluator { 
+
+         public: 
+
+            PoissonLogLEvaluator(const IModelFunction & func, const BinData & data, const double * p, 
+                                 int iWeight, bool extended) : 
+               fFunc(func), 
+               fData(data), 
+               fParams(p), 
+               fIsExtended(extended)
+            {
+               const DataOptions & fitOpt = data.Opt();
+               fUseIntegral = fitOpt.fIntegral; 
+               fUseBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
+               fUseBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
+               fUseW2 = (iWeight == 2);
+               fWrefVolume = 1.0; 
+               if (fUseBinVolume) fWrefVolume /= data.RefVolume();
+            }
+
+            void operator() (unsigned int i1, unsigned int i2, double * result) const { 
+
+               IntegralEvaluator<> igEval( fFunc, fParams, fUseIntegral); 
+               std::vector<double> xc; 
+               if (fUseBinVolume) xc.resize(fData.NDim() );
+
+               // evaluate the function values in blocks when no bin integral or volume is needed
+               bool useBlock = !fUseBinIntegral && !fUseBinVolume; 
+               std::vector<double> xbuf; 
+               std::vector<double> fvalues; 
+               if (useBlock) fvalues.resize( std::min(i2-i1, kChunkSize) ); 
+               unsigned int iblock = i1; 
+
+               Acc nloglike;  // negative loglikelihood 
+               unsigned int nPoints = 0; 
+
+               for (unsigned int i = i1; i < i2; ++ i) { 
+
+                  if (useBlock && i == iblock) { 
+                     unsigned int iend = std::min(i2, i + kChunkSize); 
+                     EvaluateModelOnPoints(fFunc, fData, fParams, i, iend, xbuf, &fvalues.front() ); 
+                     iblock = iend; 
+                  }
+                  const double * x1 = fData.Coords(i);
+                  double y = fData.Value(i);
+      
+                  double fval = 0;   
+                  double binVolume = 1.0; 
+
+                  if (fUseBinVolume) { 
+                     unsigned int ndim = fData.NDim(); 
+                     const double * x2 = fData.BinUpEdge(i);  
+                     for (unsigned int j = 0; j < ndim; ++j) {
+                        binVolume *= std::abs( x2[j]-x1[j] );
+                        xc[j] = 0.5*(x2[j]+ x1[j]);
+                     }
+                     // normalize the bin volume using a reference value
+                     binVolume *= fWrefVolume;
+                  }
+
+                  const double * x = (fUseBinVolume) ? &xc.front() : x1;
+
+                  if (useBlock) { 
+                     fval = fvalues[ (i-i1) % kChunkSize ]; 
+                  }
+                  else if (!fUseBinIntegral) {
+                     fval = fFunc ( x, fParams );
+                  }
+                  else {
+                     // calculate integral (normalized by bin volume) 
+                     fval = igEval( x1, fData.BinUpEdge(i)) ; 
+                  }
+                  if (fUseBinVolume) fval *= binVolume;
+
+#ifdef DEBUG
+                  std::cout << "evt " << i << " x1 = " << x[0] << "  y = " << y << " fval = " << fval << std::endl;
+#endif
+
+                  // EvalLog protects against 0 values of fval but don't want to add in the -log sum 
+                  // negative values of fval 
+                  fval = std::max(fval, 0.0);
+
+                  double tmp = 0; 
+                  if (fUseW2) { 
+                     // apply weight correction . Effective weight is error^2/ y
+                     // and expected events in bins is fval/weight
+                     // can apply correction only when y is not zero otherwise weight is undefined
+                     // (in case of weighted likelihood I don't care about the constant term due to 
+                     // the saturated model)
+                     if (y != 0) { 
+                        double error = fData.Error(i);
+                        double weight = (error*error)/y;  // this is the bin effective weight
+                        if (fIsExtended) { 
+                           tmp = fval * weight;
+                        }
+                        tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
+                     }
+                  }
+                  else {
+                     // standard case no weights or iWeight=1 
+                     // this is needed for Poisson likelihood (which are extened and not for multinomial) 
+                     // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
+                     // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
+                     if (fIsExtended) tmp = fval -y ;
+                     if (y >  0) { 
+                        tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));  
+                        nPoints++;
+                     }
+                  }
+
+                  nloglike.Add(tmp);  
+               }
+               result[0] = nloglike.Sum(); 
+               result[1] = nPoints; 
+            }
+
+         private: 
+
+            const IModelFunction & fFunc; 
+            const BinData & fData; 
+            const double * fParams; 
+            bool fIsExtended; 
+            bool fUseIntegral; 
+            bool fUseBinIntegral; 
+            bool fUseBinVolume; 
+            bool fUseW2; 
+            double fWrefVolume; 
+         };
+
+         // evaluator of the Poisson log-likelihood gradient (returns npar values) 
+         template <class Acc> 
+         class PoissonLogLGradientEvaluator { 
+
+         public: 
+
+            PoissonLogLGradientEvaluator(const IGradModelFunction & func, const BinData & data, const double * p) : 
+               fFunc(func), 
+               fData(data), 
+               fParams(p)
+            {
+               const DataOptions & fitOpt = data.Opt();
+               fUseBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
+               fUseBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
+               fWrefVolume = 1.0; 
+               if (fUseBinVolume) fWrefVolume /= data.RefVolume();
+            }
+
+            void operator() (unsigned int i1, unsigned int i2, double * result) const { 
+
+               IntegralEvaluator<> igEval( fFunc, fParams, fUseBinIntegral); 
+               std::vector<double> xc; 
+               if (fUseBinVolume) xc.resize(fData.NDim() );
+
+               unsigned int n = fData.Size();
+               unsigned int npar = fFunc.NPar(); 
+               std::vector<double> gradFunc( npar ); 
+               std::vector<Acc> g( npar); 
+
+               for (unsigned int i = i1; i < i2; ++ i) { 
+                  const double * x1 = fData.Coords(i);
+                  double y = fData.Value(i);
+                  double fval = 0; 
+                  const double * x2 = 0; 
+
+                  double binVolume = 1.0; 
+                  if (fUseBinVolume) { 
+                     x2 = fData.BinUpEdge(i);  
+                     unsigned int ndim = fData.NDim(); 
+                     for (unsigned int j = 0; j < ndim; ++j) { 
+                        binVolume *= std::abs( x2[j]-x1[j] );
+                        xc[j] = 0.5*(x2[j]+ x1[j]);
+                     }
+                     // normalize the bin volume using a reference value
+                     binVolume *= fWrefVolume;
+                  }
+
+                  const double * x = (fUseBinVolume) ? &xc.front() : x1;
+
+                  if (!fUseBinIntegral) {
+                     fval = fFunc ( x, fParams );
+                     fFunc.ParameterGradient(  x , fParams, &gradFunc[0] ); 
+                  }
+                  else {
+                     // calculate integral (normalized by bin volume) 
+                     x2 = fData.BinUpEdge(i);
+                     fval = igEval( x1, x2) ; 
+                     CalculateGradientIntegral( fFunc, x1, x2, fParams, &gradFunc[0]); 
+                  }
+                  if (fUseBinVolume) fval *= binVolume;
+      
+                  // correct the gradient
+                  for (unsigned int kpar = 0; kpar < npar; ++ kpar) { 
+
+                     // correct gradient for bin volumes
+                     if (fUseBinVolume) gradFunc[kpar] *= binVolume; 
+
+                     // df/dp * (1.  - y/f )
+                     if (fval > 0)  
+                        g[kpar].Add( gradFunc[ kpar ] * ( 1. - y/fval ) ); 
+                     else if (gradFunc [ kpar] != 0) { 
+                        const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
+                        const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
+                        double gg = kdmax1 * gradFunc[ kpar ];  
+                        if ( gg > 0) gg = std::min( gg, kdmax2);
+                        else gg = std::max(gg, - kdmax2);
+                        g[kpar].Add( - gg );
+                     }
+                  }            
+               }
+               for (unsigned int kpar = 0; kpar < npar; ++kpar) 
+                  result[kpar] = g[kpar].Sum(); 
+            }
+
+         private: 
+
+            const IGradModelFunction & fFunc; 
+            const BinData & fData; 
+            const double * fParams; 
+            bool fUseBinIntegral; 
+            bool fUseBinVolume; 
+            double fWrefVolume; 
+         };
+
+
       } // end namespace  FitUtil      
 
 
@@ -327,27 +980,20 @@ namespace ROOT {
 // for chi2 functions
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {  
+double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints, unsigned int nThreads) {  
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints 
    // the actual number of used points
    // normal chi2 using only error on values (from fitting histogram)
    // optionally the integral of function in the bin is used 
+   // if nThreads > 0 the points are evaluated in chunks (in parallel when OpenMP is available)
    
    unsigned int n = data.Size();
 
-   double chi2 = 0;
-   nPoints = 0; // count the effective non-zero points
-   
    // do not cache parameter values (it is not thread safe)
    //func.SetParameters(p); 
 
-   
-   // get fit option and check case if using integral of bins
-   const DataOptions & fitOpt = data.Opt();
-   bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
-   bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
-
 #ifdef DEBUG
+   const DataOptions & fitOpt = data.Opt();
    std::cout << "\n\nFit data size = " << n << std::endl;
    std::cout << "evaluate chi2 using function " << &func << "  " << p << std::endl; 
    std::cout << "use empty bins  " << fitOpt.fUseEmpty << std::endl;
@@ -355,85 +1001,21 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    std::cout << "use all error=1 " << fitOpt.fErrors1 << std::endl;
 #endif
 
-
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-
-   double maxResValue = std::numeric_limits<double>::max() /n;
-   double wrefVolume = 1.0; 
-   std::vector<double> xc; 
-   if (useBinVolume) { 
-      wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
+   double chi2 = 0;
+   if (nThreads == 0) { 
+      Chi2Evaluator<SimpleSum> eval(func, data, p); 
+      eval(0, n, &chi2); 
    }
-
-   for (unsigned int i = 0; i < n; ++ i) { 
-
-
-      double y, invError; 
-      // in case of no error in y invError=1 is returned
-      const double * x1 = data.GetPoint(i,y, invError);
-
-      double fval = 0;
-
-      double binVolume = 1.0; 
-      if (useBinVolume) { 
-         unsigned int ndim = data.NDim(); 
-         const double * x2 = data.BinUpEdge(i);  
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
-         }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
-
-      const double * x = (useBinVolume) ? &xc.front() : x1;
-
-      if (!useBinIntegral) {
-         fval = func ( x, p );
-      }
-      else {
-         // calculate integral normalized by bin volume
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ; 
-      }
-      // normalize result if requested according to bin volume
-      if (useBinVolume) fval *= binVolume;
-
-//#define DEBUG
-#ifdef DEBUG      
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : "; 
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar) 
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl; 
-#endif
-//#undef DEBUG
-
-      if (invError > 0) { 
-         nPoints++;
-
-         double tmp = ( y -fval )* invError;  	  
-         double resval = tmp * tmp;
-         
-
-         // avoid inifinity or nan in chi2 values due to wrong function values 
-         if ( resval < maxResValue )  
-            chi2 += resval; 
-         else {  
-            //nRejected++; 
-            chi2 += maxResValue;
-         }
-      }
-
-      
+   else { 
+      Chi2Evaluator<KahanSum> eval(func, data, p); 
+      EvaluateInChunks(eval, n, 1, nThreads, &chi2); 
    }
    nPoints=n;
 
 #ifdef DEBUG
-   std::cout << "chi2 = " << chi2 << " n = " << nPoints  /*<< " rejected = " << nRejected */ << std::endl;
+   std::cout << "chi2 = " << chi2 << " n = " << nPoints << std::endl;
 #endif
 
-
    return chi2;
 }
 
@@ -653,7 +1235,7 @@ double FitUtil::EvaluateChi2Residual(const IModelFunction & func, const BinData
 
 }
 
-void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints) { 
+void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints, unsigned int nThreads) { 
    // evaluate the gradient of the chi2 function
    // this function is used when the model function knows how to calculate the derivative and we can  
    // avoid that the minimizer re-computes them 
@@ -664,8 +1246,6 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
       MATH_ERROR_MSG("FitUtil::EvaluateChi2Residual","Error on the coordinates are not used in calculating Chi2 gradient");            return; // it will assert otherwise later in GetPoint
    }
 
-   unsigned int nRejected = 0; 
-
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f); 
    assert (fg != 0); // must be called by a gradient function
 
@@ -678,103 +1258,20 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    std::cout << "evaluate chi2 using function gradient " << &func << "  " << p << std::endl; 
 #endif
 
-   const DataOptions & fitOpt = data.Opt();
-   bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
-   bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
-
-   double wrefVolume = 1.0; 
-   std::vector<double> xc; 
-   if (useBinVolume) { 
-      wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
-   }
-
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-
-   //int nRejected = 0; 
-   // set values of parameters 
-
    unsigned int npar = func.NPar(); 
    //   assert (npar == NDim() );  // npar MUST be  Chi2 dimension
-   std::vector<double> gradFunc( npar ); 
-   // set all vector values to zero
-   std::vector<double> g( npar); 
-
-   for (unsigned int i = 0; i < n; ++ i) { 
-
-
-      double y, invError = 0; 
-      const double * x1 = data.GetPoint(i,y, invError);
+   // result contains the gradient and (as last element) the number of rejected points 
+   std::vector<double> g( npar + 1); 
 
-      double fval = 0; 
-      const double * x2 = 0; 
-
-      double binVolume = 1; 
-      if (useBinVolume) { 
-         unsigned int ndim = data.NDim(); 
-         x2 = data.BinUpEdge(i);  
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
-         }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
-
-      const double * x = (useBinVolume) ? &xc.front() : x1;
-
-      if (!useBinIntegral ) {
-         fval = func ( x, p ); 
-         func.ParameterGradient(  x , p, &gradFunc[0] ); 
-      }
-      else { 
-         x2 = data.BinUpEdge(i); 
-         // calculate normalized integral and gradient (divided by bin volume)
-         // need to set function and parameters here in case loop is parallelized 
-         fval = igEval( x1, x2 ) ; 
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]); 
-      }
-      if (useBinVolume) fval *= binVolume;
-
-#ifdef DEBUG      
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : "; 
-      for (unsigned int ipar = 0; ipar < npar; ++ipar) 
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl; 
-#endif
-      if ( !CheckValue(fval) ) { 
-         nRejected++; 
-         continue;
-      } 
-
-      // loop on the parameters
-      unsigned int ipar = 0; 
-      for ( ; ipar < npar ; ++ipar) { 
-
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[ipar] *= binVolume;
-
-         // avoid singularity in the function (infinity and nan ) in the chi2 sum 
-         // eventually add possibility of excluding some points (like singularity) 
-         double dfval = gradFunc[ipar];
-         if ( !CheckValue(dfval) ) { 
-               break; // exit loop on parameters
-         } 
- 
-         // calculate derivative point contribution
-         double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];  	  
-         g[ipar] += tmp;
-      
-      }
-
-      if ( ipar < npar ) { 
-          // case loop was broken for an overflow in the gradient calculation  
-         nRejected++; 
-         continue;
-      } 
-
-
-   } 
+   if (nThreads == 0) { 
+      Chi2GradientEvaluator<SimpleSum> eval(func, data, p); 
+      eval(0, n, &g[0]); 
+   }
+   else { 
+      Chi2GradientEvaluator<KahanSum> eval(func, data, p); 
+      EvaluateInChunks(eval, n, npar + 1, nThreads, &g[0]); 
+   }
+   unsigned int nRejected = (unsigned int) g[npar]; 
 
    // correct the number of points
    nPoints = n; 
@@ -785,7 +1282,7 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    } 
 
    // copy result 
-   std::copy(g.begin(), g.end(), grad);
+   std::copy(g.begin(), g.begin() + npar, grad);
 
 }
 
@@ -846,8 +1343,9 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
 }
 
 double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
-                                   int iWeight,  bool extended, unsigned int &nPoints) {  
+                                   int iWeight,  bool extended, unsigned int &nPoints, unsigned int nThreads) {  
    // evaluate the LogLikelihood 
+   // if nThreads > 0 the points are evaluated in chunks (in parallel when OpenMP is available)
 
    unsigned int n = data.Size();
 
@@ -856,7 +1354,6 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    std::cout << "func pointer is " << typeid(func).name() << std::endl;
 #endif
 
-   double logl = 0;
    //unsigned int nRejected = 0; 
 
    // this is needed if function must be normalized 
@@ -871,40 +1368,20 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
       norm = igEval.Integral(&xmin[0],&xmax[0]);
    }
 
-   // needed to compue effective global weight in case of extended likelihood 
-   double sumW = 0;
-   double sumW2 = 0;
-
-   for (unsigned int i = 0; i < n; ++ i) { 
-      const double * x = data.Coords(i);
-      double fval = func ( x, p ); 
-      if (normalizeFunc) fval = fval / norm;
-
-#ifdef DEBUG      
-      std::cout << "x [ " << data.NDim() << " ] = "; 
-      for (unsigned int j = 0; j < data.NDim(); ++j)
-         std::cout << x[j] << "\t"; 
-      std::cout << "\tpar = [ " << func.NPar() << " ] =  "; 
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar) 
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << std::endl; 
-#endif
-      // function EvalLog protects against negative or too small values of fval
-      double logval =  ROOT::Math::Util::EvalLog( fval);       
-      if (iWeight > 0) { 
-         double weight = data.Weight(i); 
-         logval *= weight; 
-         if (iWeight ==2) { 
-            logval *= weight; // use square of weights in likelihood
-            if (extended) { 
-               // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight; 
-               sumW2 += weight*weight; 
-            }
-         }
-      }
-      logl += logval;
+   // result contains the log-likelihood and the sum of weights and weight squares
+   // (needed to compute effective global weight in case of extended likelihood)
+   double sums[3] = { 0, 0, 0 }; 
+   if (nThreads == 0) { 
+      LogLEvaluator<SimpleSum> eval(func, data, p, iWeight, extended, normalizeFunc, norm); 
+      eval(0, n, sums); 
+   }
+   else { 
+      LogLEvaluator<KahanSum> eval(func, data, p, iWeight, extended, normalizeFunc, norm); 
+      EvaluateInChunks(eval, n, 3, nThreads, sums); 
    }
+   double logl = sums[0];
+   double sumW = sums[1];
+   double sumW2 = sums[2];
 
    if (extended) { 
       // add Poisson extended term
@@ -961,7 +1438,7 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    return -logl;
 }
 
-void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int & ) { 
+void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int &, unsigned int nThreads) { 
    // evaluate the gradient of the log likelihood function
 
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f); 
@@ -972,30 +1449,19 @@ void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & d
    //int nRejected = 0; 
 
    unsigned int npar = func.NPar(); 
-   std::vector<double> gradFunc( npar ); 
    std::vector<double> g( npar); 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
-      const double * x = data.Coords(i);
-      double fval = func ( x , p); 
-      func.ParameterGradient( x, p, &gradFunc[0] );
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) { 
-         if (fval > 0)  
-            g[kpar] -= 1./fval * gradFunc[ kpar ]; 
-         else if (gradFunc [ kpar] != 0) { 
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];  
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
-         }
-         // if func derivative is zero term is also zero so do not add in g[kpar]
-      }
-            
-    // copy result 
-   std::copy(g.begin(), g.end(), grad);
+   if (nThreads == 0) { 
+      LogLGradientEvaluator<SimpleSum> eval(func, data, p); 
+      eval(0, n, &g[0]); 
    }
+   else { 
+      LogLGradientEvaluator<KahanSum> eval(func, data, p); 
+      EvaluateInChunks(eval, n, npar, nThreads, &g[0]); 
+   }
+
+   // copy result 
+   std::copy(g.begin(), g.end(), grad);
 }
 //_________________________________________________________________________________________________
 // for binned log likelihood functions      
@@ -1107,7 +1573,7 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
 }
 
 double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, 
-                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints ) {  
+                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints, unsigned int nThreads ) {  
    // evaluate the Poisson Log Likelihood
    // for binned likelihood fits
    // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
@@ -1123,6 +1589,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    // iWeight = 2 ==> logL = Sum( w*w * f(x_i) )
    //
    // nPoints returns the points where bin content is not zero
+   // if nThreads > 0 the points are evaluated in chunks (in parallel when OpenMP is available)
          
 
    unsigned int n = data.Size();
@@ -1132,123 +1599,19 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    std::cout << "]  - data size = " << n << std::endl;
 #endif
    
-   double nloglike = 0;  // negative loglikelihood 
-   nPoints = 0;  // npoints
-
-
-   // get fit option and check case of using integral of bins
-   const DataOptions & fitOpt = data.Opt();
-   bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
-   bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
-   bool useW2 = (iWeight == 2);
-
-   double wrefVolume = 1.0; 
-   std::vector<double> xc; 
-   if (useBinVolume) { 
-      wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
+   // result contains the negative log-likelihood and the number of used points
+   double result[2] = { 0, 0 }; 
+   if (nThreads == 0) { 
+      PoissonLogLEvaluator<SimpleSum> eval(func, data, p, iWeight, extended); 
+      eval(0, n, result); 
    }
-
-   IntegralEvaluator<> igEval( func, p, fitOpt.fIntegral); 
-
-   // double nuTot = 0; // total number of expected events (needed for non-extended fits) 
-   // double wTot = 0; // sum of all weights  
-   // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
-
-
-   for (unsigned int i = 0; i < n; ++ i) { 
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-      
-      double fval = 0;   
-      double binVolume = 1.0; 
-
-      if (useBinVolume) { 
-         unsigned int ndim = data.NDim(); 
-         const double * x2 = data.BinUpEdge(i);  
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
-         }
-         // normalize the bin volume using a reefrence value
-         binVolume *= wrefVolume;
-      }
-
-      const double * x = (useBinVolume) ? &xc.front() : x1;
-
-      if (!useBinIntegral) {
-         fval = func ( x, p );
-      }
-      else {
-         // calculate integral (normalized by bin volume) 
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ; 
-      }
-      if (useBinVolume) fval *= binVolume;
-
-
-
-#ifdef DEBUG
-      int NSAMPLE = 100;
-      if (i%NSAMPLE == 0) { 
-         std::cout << "evt " << i << " x1 = [ "; 
-         for (unsigned int j=0; j < func.NDim(); ++j) std::cout << x[j] << " , ";
-         std::cout << "]  ";
-         if (fitOpt.fIntegral) { 
-            std::cout << "x2 = [ "; 
-            for (unsigned int j=0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
-            std::cout << "] ";
-         }
-         std::cout << "  y = " << y << " fval = " << fval << std::endl;
-      }
-#endif
-
-
-      // EvalLog protects against 0 values of fval but don't want to add in the -log sum 
-      // negative values of fval 
-      fval = std::max(fval, 0.0);
-
-
-      double tmp = 0; 
-      if (useW2) { 
-         // apply weight correction . Effective weight is error^2/ y
-         // and expected events in bins is fval/weight
-         // can apply correction only when y is not zero otherwise weight is undefined
-         // (in case of weighted likelihood I don't care about the constant term due to 
-         // the saturated model)
-         if (y != 0) { 
-            double error = data.Error(i);
-            double weight = (error*error)/y;  // this is the bin effective weight
-            if (extended) { 
-               tmp = fval * weight;
-               // wTot  += weight; 
-               // w2Tot += weight*weight; 
-            }
-            tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
-         }
-         
-         //  need to compute total weight and weight-square
-         // if (extended ) { 
-         //    nuTot += fval;
-         // }
-
-      }
-      else {
-         // standard case no weights or iWeight=1 
-         // this is needed for Poisson likelihood (which are extened and not for multinomial) 
-         // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
-         // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
-         if (extended) tmp = fval -y ;
-         if (y >  0) { 
-            tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));  
-            nPoints++;
-         }
-      }
-
-
-      nloglike +=  tmp;  
+   else { 
+      PoissonLogLEvaluator<KahanSum> eval(func, data, p, iWeight, extended); 
+      EvaluateInChunks(eval, n, 2, nThreads, result); 
    }
-   
+   double nloglike = result[0];  // negative loglikelihood 
+   nPoints = (unsigned int) result[1];  // npoints
+
    // if (notExtended) { 
    //    // not extended : remove from the Likelihood the global Poisson term
    //    if (!useW2)  
@@ -1273,7 +1636,7 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    return nloglike;  
 }
 
-void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad ) { 
+void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int nThreads ) { 
    // evaluate the gradient of the Poisson log likelihood function
 
    const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f); 
@@ -1282,78 +1645,20 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
 
    unsigned int n = data.Size();
 
-   const DataOptions & fitOpt = data.Opt();
-   bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges(); 
-   bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
-
-   double wrefVolume = 1.0;
-   std::vector<double> xc;  
-   if (useBinVolume) {
-      wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
-   }
-
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-
    unsigned int npar = func.NPar(); 
-   std::vector<double> gradFunc( npar ); 
    std::vector<double> g( npar); 
 
-   for (unsigned int i = 0; i < n; ++ i) { 
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-      double fval = 0; 
-      const double * x2 = 0; 
-
-      double binVolume = 1.0; 
-      if (useBinVolume) { 
-         x2 = data.BinUpEdge(i);  
-         unsigned int ndim = data.NDim(); 
-         for (unsigned int j = 0; j < ndim; ++j) { 
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
-         }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
-
-      const double * x = (useBinVolume) ? &xc.front() : x1;
-
-      if (!useBinIntegral) {
-         fval = func ( x, p );
-         func.ParameterGradient(  x , p, &gradFunc[0] ); 
-      }
-      else {
-         // calculate integral (normalized by bin volume) 
-         // need to set function and parameters here in case loop is parallelized
-         x2 = data.BinUpEdge(i);
-         fval = igEval( x1, x2) ; 
-         CalculateGradientIntegral( func, x1, x2, p, &gradFunc[0]); 
-      }
-      if (useBinVolume) fval *= binVolume;
-      
-      // correct the gradient
-      for (unsigned int kpar = 0; kpar < npar; ++ kpar) { 
-
-         // correct gradient for bin volumes
-         if (useBinVolume) gradFunc[kpar] *= binVolume; 
-
-         // df/dp * (1.  - y/f )
-         if (fval > 0)  
-            g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval ); 
-         else if (gradFunc [ kpar] != 0) { 
-            const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
-            const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
-            double gg = kdmax1 * gradFunc[ kpar ];  
-            if ( gg > 0) gg = std::min( gg, kdmax2);
-            else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
-         }
-      }            
-
-      // copy result 
-      std::copy(g.begin(), g.end(), grad);
+   if (nThreads == 0) { 
+      PoissonLogLGradientEvaluator<SimpleSum> eval(func, data, p); 
+      eval(0, n, &g[0]); 
    }
+   else { 
+      PoissonLogLGradientEvaluator<KahanSum> eval(func, data, p); 
+      EvaluateInChunks(eval, n, npar, nThreads, &g[0]); 
+   }
+
+   // copy result 
+   std::copy(g.begin(), g.end(), grad);
 }
    
 }
@@ -326,7 +326,7 @@ bool Fitter::DoLeastSquareFit(const BinData & data) {
    // check if fFunc provides gradient
    if (!fUseGradient) { 
       // do minimzation without using the gradient
-      Chi2FCN<BaseFunc> chi2(data,*fFunc); 
+      Chi2FCN<BaseFunc> chi2(data,*fFunc,fConfig.NThreads()); 
       fFitType = chi2.Type();
       return DoMinimization (chi2); 
    } 
@@ -336,7 +336,7 @@ bool Fitter::DoLeastSquareFit(const BinData & data) {
          MATH_INFO_MSG("Fitter::DoLeastSquareFit","use gradient from model function");        
       IGradModelFunction * gradFun = dynamic_cast<IGradModelFunction *>(fFunc); 
       if (gradFun != 0) { 
-         Chi2FCN<BaseGradFunc> chi2(data,*gradFun); 
+         Chi2FCN<BaseGradFunc> chi2(data,*gradFun,fConfig.NThreads()); 
          fFitType = chi2.Type();
          return DoMinimization (chi2); 
       }
@@ -366,11 +366,11 @@ bool Fitter::DoLikelihoodFit(const BinData & data, bool extended) {
    fDataSize = data.Size();
 
    // create a chi2 function to be used for the equivalent chi-square
-   Chi2FCN<BaseFunc> chi2(data,*fFunc); 
+   Chi2FCN<BaseFunc> chi2(data,*fFunc,fConfig.NThreads()); 
 
    if (!fUseGradient) { 
       // do minimization without using the gradient
-      PoissonLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended); 
+      PoissonLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended, fConfig.NThreads()); 
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false; 
@@ -393,7 +393,7 @@ bool Fitter::DoLikelihoodFit(const BinData & data, bool extended) {
       if (!extended) {  
          MATH_WARN_MSG("Fitter::DoLikelihoodFit","Not-extended binned fit with gradient not yet supported - do an extended fit");        
       }
-      PoissonLikelihoodFCN<BaseGradFunc> logl(data,*gradFun, useWeight, true); 
+      PoissonLikelihoodFCN<BaseGradFunc> logl(data,*gradFun, useWeight, true, fConfig.NThreads()); 
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false;
@@ -431,7 +431,7 @@ bool Fitter::DoLikelihoodFit(const UnBinData & data, bool extended) {
 
    if (!fUseGradient) { 
       // do minimization without using the gradient
-      LogLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended); 
+      LogLikelihoodFCN<BaseFunc> logl(data,*fFunc, useWeight, extended, fConfig.NThreads()); 
       fFitType = logl.Type();
       if (!DoMinimization (logl) ) return false;
       if (useWeight) { 
@@ -449,7 +449,7 @@ bool Fitter::DoLikelihoodFit(const UnBinData & data, bool extended) {
          if (extended) {  
             MATH_WARN_MSG("Fitter::DoLikelihoodFit","Extended unbinned fit with gradient not yet supported - do a not-extended fit");        
          }
-         LogLikelihoodFCN<BaseGradFunc> logl(data,*gradFun,useWeight, extended); 
+         LogLikelihoodFCN<BaseGradFunc> logl(data,*gradFun,useWeight, extended, fConfig.NThreads()); 
          fFitType = logl.Type();
          if (!DoMinimization (logl) ) return false;
          if (useWeight) { 
@@ -9,6 +9,7 @@
  **********************************************************************/
 
 #include "Math/GaussIntegrator.h"
+#include "Math/IParamFunction.h"
 #include <cmath>
 
 namespace ROOT {
@@ -75,8 +76,10 @@ double GaussIntegrator::DoIntegral(double a, double b, const IGenFunction* funct
                       0.14959598881657673,  0.16915651939500254,
                       0.18260341504492359,  0.18945061045506850};
 
-   double h, aconst, bb, aa, c1, c2, u, s8, s16, f1, f2;
-   double xx[1];
+   double h, aconst, bb, aa, c1, c2, u, s8, s16;
+   // abscissas and function values of the 24 points of each step
+   double xx[24];
+   double ff[24];
    int i;
 
    if ( fFunction == 0 )
@@ -85,6 +88,9 @@ double GaussIntegrator::DoIntegral(double a, double b, const IGenFunction* funct
       return 0.0;
    }
 
+   // parametric functions are evaluated on all the points of a step in a single call
+   const IParametricFunctionOneDim * pfunc = dynamic_cast<const IParametricFunctionOneDim *>(function);
+
    h = 0;
    fUsedOnce = true;
    if (b == a) return h;
@@ -96,28 +102,25 @@ CASE1:
 CASE2:
    c1 = kHF*(bb+aa);
    c2 = kHF*(bb-aa);
-   s8 = 0;
-   for (i=0;i<4;i++) {
-      u     = c2*x[i];
-      xx[0] = c1+u;
-      f1    = (*function)(xx);
-      if (fgAbsValue) f1 = std::abs(f1);
-      xx[0] = c1-u;
-      f2    = (*function) (xx);
-      if (fgAbsValue) f2 = std::abs(f2);
-      s8   += w[i]*(f1 + f2);
+   for (i=0;i<12;i++) {
+      u         = c2*x[i];
+      xx[2*i]   = c1+u;
+      xx[2*i+1] = c1-u;
    }
-   s16 = 0;
-   for (i=4;i<12;i++) {
-      u     = c2*x[i];
-      xx[0] = c1+u;
-      f1    = (*function) (xx);
-      if (fgAbsValue) f1 = std::abs(f1);
-      xx[0] = c1-u;
-      f2    = (*function) (xx);
-      if (fgAbsValue) f2 = std::abs(f2);
-      s16  += w[i]*(f1 + f2);
+   if (pfunc)
+      pfunc->EvalParVec(24, xx, 1, pfunc->Parameters(), ff);
+   else {
+      for (i=0;i<24;i++) ff[i] = (*function)(xx[i]);
    }
+   if (fgAbsValue) {
+      for (i=0;i<24;i++) ff[i] = std::abs(ff[i]);
+   }
+   s8 = 0;
+   for (i=0;i<4;i++)
+      s8   += w[i]*(ff[2*i] + ff[2*i+1]);
+   s16 = 0;
+   for (i=4;i<12;i++)
+      s16  += w[i]*(ff[2*i] + ff[2*i+1]);
    s16 = c2*s16;
    if (std::abs(s16-c2*s8) <= fEpsilon*(1. + std::abs(s16))) {
       h += s16;
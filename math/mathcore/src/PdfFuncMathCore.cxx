@@ -12,6 +12,7 @@
 
 #include "Math/Math.h"
 #include "Math/SpecFuncMathCore.h"
+#include "Math/FastMath.h"
 #include <limits>
 
 
@@ -93,6 +94,24 @@ namespace Math {
    
    
    
+   double crystalball_function(double x, double alpha, double n, double sigma, double x0) {
+      // same definition as RooCBShape
+      
+      double t = (x-x0)/sigma;
+      if (alpha < 0) t = -t;
+      double absAlpha = std::fabs(alpha);
+      if (t >= -absAlpha) {
+         return std::exp(-0.5*t*t);
+      } else {
+         double a = std::pow(n/absAlpha, n) * std::exp(-0.5*absAlpha*absAlpha);
+         double b = n/absAlpha - absAlpha;
+         return a/std::pow(b - t, n);
+      }
+      
+   }
+   
+   
+   
    double exponential_pdf(double x, double lambda, double x0) {
       
       if ((x-x0) < 0) {
@@ -279,6 +298,109 @@ namespace Math {
    }
    
    
+   // versions on arrays: the loops have no branches and call only the inline
+   // functions of FastMath.h, so that they can be vectorized by the compiler
+
+   void breitwigner_pdf(unsigned int n, const double * x, double * y, double gamma, double x0) {
+      
+      double gammahalf = gamma/2.0;
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] = gammahalf/(M_PI * ((x[i]-x0)*(x[i]-x0) + gammahalf*gammahalf));
+      
+   }
+   
+   
+   
+   void crystalball_function(unsigned int n, const double * x, double * y, double alpha, double nexp, double sigma, double x0) {
+      
+      // for alpha < 0 use t = -(x-x0)/sigma
+      double invSigma = (alpha < 0) ? -1./sigma : 1./sigma;
+      double absAlpha = std::fabs(alpha);
+      double loga = nexp * std::log(nexp/absAlpha) - 0.5*absAlpha*absAlpha;
+      double b = nexp/absAlpha - absAlpha;
+      for (unsigned int i = 0; i < n; ++i) {
+         double t = (x[i]-x0)*invSigma;
+         double core = fast_exp(-0.5*t*t);
+         double tail = fast_exp(loga - nexp * fast_log(b - t));
+         y[i] = (t >= -absAlpha) ? core : tail;
+      }
+      
+   }
+   
+   
+   
+   void exponential_pdf(unsigned int n, const double * x, double * y, double lambda, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) {
+         double v = lambda * fast_exp(-lambda * (x[i]-x0));
+         y[i] = ((x[i]-x0) < 0) ? 0.0 : v;
+      }
+      
+   }
+   
+   
+   
+   void gamma_pdf(unsigned int n, const double * x, double * y, double alpha, double theta, double x0) {
+      
+      if (alpha == 1) { 
+         for (unsigned int i = 0; i < n; ++i) {
+            double v = fast_exp(-(x[i]-x0)/theta)/theta;
+            y[i] = ((x[i]-x0) < 0) ? 0.0 : v;
+         }
+         return;
+      }
+      double lga = ROOT::Math::lgamma(alpha);
+      for (unsigned int i = 0; i < n; ++i) {
+         double xt = (x[i]-x0)/theta;
+         double v = fast_exp((alpha - 1) * fast_log(xt) - xt - lga)/theta;
+         y[i] = ((x[i]-x0) <= 0) ? 0.0 : v;
+      }
+      
+   }
+   
+   
+   
+   void lognormal_pdf(unsigned int n, const double * x, double * y, double m, double s, double x0) {
+      
+      double c = 1.0 / (std::fabs(s) * std::sqrt(2 * M_PI));
+      for (unsigned int i = 0; i < n; ++i) {
+         double tmp = (fast_log((x[i]-x0)) - m)/s;
+         double v = c / (x[i]-x0) * fast_exp(-(tmp * tmp) /2);
+         y[i] = ((x[i]-x0) <= 0) ? 0.0 : v;
+      }
+      
+   }
+   
+   
+   
+   void normal_pdf(unsigned int n, const double * x, double * y, double sigma, double x0) {
+      
+      double c = 1.0/(std::sqrt(2 * M_PI) * std::fabs(sigma));
+      for (unsigned int i = 0; i < n; ++i) {
+         double tmp = (x[i]-x0)/sigma;
+         y[i] = c * fast_exp(-tmp*tmp/2);
+      }
+      
+   }
+   
+   
+   
+   void poisson_pdf(unsigned int n, const unsigned int * k, const double * mu, double * y) {
+      
+      // the log of the factorials are computed first in y (this loop is not vectorized) 
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] = ROOT::Math::lgamma(k[i]+1);
+      for (unsigned int i = 0; i < n; ++i) {
+         double logmu = fast_log(mu[i]);
+         double v = fast_exp(double(k[i])*logmu - y[i] - mu[i]);
+         // for k = 0 return exp(-mu) (1 for mu = 0) and a nan for mu < 0
+         double v0 = (mu[i] >= 0) ? fast_exp(-mu[i]) : logmu;
+         y[i] = (k[i] > 0) ? v : v0;
+      }
+      
+   }
+   
+   
 } // namespace Math
 } // namespace ROOT
 
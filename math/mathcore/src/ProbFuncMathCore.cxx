@@ -5,6 +5,7 @@
 #include "Math/Math.h"
 #include "Math/ProbFuncMathCore.h"
 #include "Math/SpecFuncMathCore.h"
+#include "Math/FastMath.h"
 
 #include <limits>
 
@@ -530,6 +531,105 @@ namespace Math {
       return xm2lan*xi*xi + (2*xm1lan-x0)*x0;
    }
 
+   // versions on arrays, using the functions of FastMath.h so that the loops
+   // can be vectorized by the compiler. For the normal and lognormal cdf's,  
+   // 0.5*erfc(-z) is used on the full range since fast_erfc uses 1 - erf for |z| < 1.
+   // The array version of fast_erfc is called on the z values, since the inline 
+   // fast_erfc is too large to be always inlined in the loops
+
+   void breitwigner_cdf_c(unsigned int n, const double * x, double * y, double gamma, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] = 0.5 - std::atan(2.0 * (x[i]-x0) / gamma) / M_PI;
+      
+   }
+   
+   
+   
+   void breitwigner_cdf(unsigned int n, const double * x, double * y, double gamma, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] = 0.5 + std::atan(2.0 * (x[i]-x0) / gamma) / M_PI;
+      
+   }
+   
+   
+   
+   void exponential_cdf_c(unsigned int n, const double * x, double * y, double lambda, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) {
+         double v = fast_exp(- lambda * (x[i]-x0));
+         y[i] = ((x[i]-x0) < 0) ? 1.0 : v;
+      }
+      
+   }
+   
+   
+   
+   void exponential_cdf(unsigned int n, const double * x, double * y, double lambda, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) {
+         double v = - fast_expm1( - lambda * (x[i]-x0) );
+         y[i] = ((x[i]-x0) < 0) ? 0.0 : v;
+      }
+      
+   }
+   
+   
+   
+   void lognormal_cdf_c(unsigned int n, const double * x, double * y, double m, double s, double x0) {
+      
+      // for x <= x0 the argument of erfc is set to -30 (erfc = 2), since fast_log 
+      // does not return -inf for negative values
+      for (unsigned int i = 0; i < n; ++i) {
+         double z = (fast_log((x[i]-x0))-m)/(s*kSqrt2);
+         y[i] = ((x[i]-x0) <= 0) ? -30. : z;
+      }
+      fast_erfc(n, y, y);
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] *= 0.5;
+      
+   }
+   
+   
+   
+   void lognormal_cdf(unsigned int n, const double * x, double * y, double m, double s, double x0) {
+      
+      // for x <= x0 the argument of erfc is set to 30 (erfc = 0)
+      for (unsigned int i = 0; i < n; ++i) {
+         double z = - (fast_log((x[i]-x0))-m)/(s*kSqrt2);
+         y[i] = ((x[i]-x0) <= 0) ? 30. : z;
+      }
+      fast_erfc(n, y, y);
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] *= 0.5;
+      
+   }
+   
+   
+   
+   void normal_cdf_c(unsigned int n, const double * x, double * y, double sigma, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] = (x[i]-x0)/(sigma*kSqrt2);
+      fast_erfc(n, y, y);
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] *= 0.5;
+      
+   }
+   
+   
+   
+   void normal_cdf(unsigned int n, const double * x, double * y, double sigma, double x0) {
+      
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] = - (x[i]-x0)/(sigma*kSqrt2);
+      fast_erfc(n, y, y);
+      for (unsigned int i = 0; i < n; ++i) 
+         y[i] *= 0.5;
+      
+   }
+
 } // namespace Math
 } // namespace ROOT
 
@@ -16,6 +16,10 @@
 #include <string.h>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #ifndef R__ALPHA
 templateClassImp(TKDTree)
 #endif
@@ -156,6 +160,19 @@ templateClassImp(TKDTree)
 //     part of the index array. To find the number of point in the node
 //     (not only terminal), call TKDTree::GetNpointsNode(Index inode).
 //
+// 3c. Queries for many points and multithreading
+//
+//     FindNearestNeighbors and FindInRange have versions taking an array of npoints points
+//     (the coordinates of each point being contiguous). They give the same results as the
+//     queries point by point, but the points are processed in the order of the terminal
+//     nodes containing them, so that consecutive queries visit the same part of the tree,
+//     and in parallel if ROOT is compiled with openMP (USE_OPENMP). Build() then also divides
+//     the independent subtrees in parallel, the resulting tree being the same.
+//
+//     The queries don't modify the tree, except for the node boundaries computed the first
+//     time by MakeBoundariesExact(). Several threads can therefore query the same tree at
+//     the same time once MakeBoundariesExact() (or one of the queries) has been called.
+//
 // 4.  TKDtree implementation details - internal information, not needed to use the kd-tree.
 //     4a. Order of nodes in the node information arrays:
 //
@@ -433,76 +450,79 @@ void TKDTree<Index, Value>::Build()
    //
    //
    //4.
+   // The nodes are divided depth first by BuildSubtree. With openMP, the top rows
+   // of the tree are first divided one row at a time, the nodes of a row in
+   // parallel, until there are enough independent subtrees to be built in parallel.
+   // A node only reorders its own range of fIndPoints, so that the tree does not
+   // depend on the number of threads.
+#ifdef _OPENMP
+   const Int_t nthreads = omp_get_max_threads();
+   if (nthreads > 1 && fNPoints > 64*fBucketSize) {
+      std::vector<Int_t> nodes(1, 0), rows(1, 0), pos(1, 0), npts(1, fNPoints);
+      while (!nodes.empty() && Int_t(nodes.size()) < 4*nthreads) {
+         const Int_t n = nodes.size();
+         std::vector<Int_t> nleft(n, -1);
+#pragma omp parallel for schedule(dynamic,1)
+         for (Int_t i = 0; i < n; i++) {
+            if (npts[i] > Int_t(fBucketSize)) nleft[i] = DivideNode(nodes[i], rows[i], pos[i], npts[i]);
+         }
+         std::vector<Int_t> nodes2, rows2, pos2, npts2;
+         for (Int_t i = 0; i < n; i++) {
+            if (nleft[i] < 0) continue; // terminal node
+            nodes2.push_back(nodes[i]*2+1);
+            rows2.push_back(rows[i]+1);
+            pos2.push_back(pos[i]);
+            npts2.push_back(nleft[i]);
+            nodes2.push_back(nodes[i]*2+2);
+            rows2.push_back(rows[i]+1);
+            pos2.push_back(pos[i]+nleft[i]);
+            npts2.push_back(npts[i]-nleft[i]);
+         }
+         nodes.swap(nodes2);
+         rows.swap(rows2);
+         pos.swap(pos2);
+         npts.swap(npts2);
+      }
+      const Int_t nsub = nodes.size();
+#pragma omp parallel for schedule(dynamic,1)
+      for (Int_t i = 0; i < nsub; i++) BuildSubtree(nodes[i], rows[i], pos[i], npts[i]);
+      return;
+   }
+#endif
+   BuildSubtree(0, 0, 0, fNPoints);
+}
+
+//_________________________________________________________________
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::BuildSubtree(Int_t node, Int_t row, Int_t pos, Int_t npoints)
+{
+   // Non recursive building of the subtree starting at the node node, in the
+   // row row, containing the npoints points starting at pos in fIndPoints
+
    //    stack for non recursive build - size 128 bytes enough
    Int_t rowStack[128];
    Int_t nodeStack[128];
    Int_t npointStack[128];
    Int_t posStack[128];
    Int_t currentIndex = 0;
-   Int_t iter =0;
-   rowStack[0]    = 0;
-   nodeStack[0]   = 0;
-   npointStack[0] = fNPoints;
-   posStack[0]   = 0;
+   rowStack[0]    = row;
+   nodeStack[0]   = node;
+   npointStack[0] = npoints;
+   posStack[0]    = pos;
    //
-   Int_t nbucketsall =0;
    while (currentIndex>=0){
-      iter++;
       //
-      Int_t npoints  = npointStack[currentIndex];
-      if (npoints<=fBucketSize) {
-         //printf("terminal node : index %d iter %d\n", currentIndex, iter);
+      Int_t cpoints  = npointStack[currentIndex];
+      if (cpoints<=fBucketSize) {
          currentIndex--;
-         nbucketsall++;
          continue; // terminal node
       }
       Int_t crow     = rowStack[currentIndex];
       Int_t cpos     = posStack[currentIndex];
       Int_t cnode    = nodeStack[currentIndex];
-      //printf("currentIndex %d npoints %d node %d\n", currentIndex, npoints, cnode);
-      //
-      // divide points
-      Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
-      if (npoints%fBucketSize) nbuckets0++;            //
-      Int_t restRows = fRowT0-rowStack[currentIndex];  // rest of fully occupied node row
-      if (restRows<0) restRows =0;
-      for (;nbuckets0>(2<<restRows); restRows++) {}
-      Int_t nfull = 1<<restRows;
-      Int_t nrest = nbuckets0-nfull;
-      Int_t nleft =0, nright =0;
-      //
-      if (nrest>(nfull/2)){
-         nleft  = nfull*fBucketSize;
-         nright = npoints-nleft;
-      }else{
-         nright = nfull*fBucketSize/2;
-         nleft  = npoints-nright;
-      }
-
-      //
-      //find the axis with biggest spread
-      Value maxspread=0;
-      Value tempspread, min, max;
-      Index axspread=0;
-      Value *array;
-      for (Int_t idim=0; idim<fNDim; idim++){
-         array = fData[idim];
-         Spread(npoints, array, fIndPoints+cpos, min, max);
-         tempspread = max - min;
-         if (maxspread < tempspread) {
-            maxspread=tempspread;
-            axspread = idim;
-         }
-         if(cnode) continue;
-         //printf("set %d %6.3f %6.3f\n", idim, min, max);
-         fRange[2*idim] = min; fRange[2*idim+1] = max;
-      }
-      array = fData[axspread];
-      KOrdStat(npoints, array, nleft, fIndPoints+cpos);
-      fAxis[cnode]  = axspread;
-      fValue[cnode] = array[fIndPoints[cpos+nleft]];
-      //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
       //
+      Int_t nleft  = DivideNode(cnode, crow, cpos, cpoints);
+      Int_t nright = cpoints-nleft;
       //
       npointStack[currentIndex] = nleft;
       rowStack[currentIndex]    = crow+1;
@@ -513,14 +533,66 @@ void TKDTree<Index, Value>::Build()
       rowStack[currentIndex]    = crow+1;
       posStack[currentIndex]    = cpos+nleft;
       nodeStack[currentIndex]   = (cnode*2)+2;
-      //
-      if (0){
-         // consistency check
-         Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
-         if (nleft<nright) Warning("Build", "Problem Left-Right");
-         if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
+   }
+}
+
+//_________________________________________________________________
+template <typename  Index, typename Value>
+Int_t TKDTree<Index, Value>::DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints)
+{
+   // Divide the node cnode, in the row crow, containing the npoints points
+   // starting at cpos in fIndPoints, and return the number of points going
+   // to the left daughter (see class description, section 4b).
+   // Only the part [cpos, cpos+npoints[ of fIndPoints is reordered.
+
+   Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
+   if (npoints%fBucketSize) nbuckets0++;            //
+   Int_t restRows = fRowT0-crow;                    // rest of fully occupied node row
+   if (restRows<0) restRows =0;
+   for (;nbuckets0>(2<<restRows); restRows++) {}
+   Int_t nfull = 1<<restRows;
+   Int_t nrest = nbuckets0-nfull;
+   Int_t nleft =0, nright =0;
+   //
+   if (nrest>(nfull/2)){
+      nleft  = nfull*fBucketSize;
+      nright = npoints-nleft;
+   }else{
+      nright = nfull*fBucketSize/2;
+      nleft  = npoints-nright;
+   }
+
+   //
+   //find the axis with biggest spread
+   Value maxspread=0;
+   Value tempspread, min, max;
+   Index axspread=0;
+   Value *array;
+   for (Int_t idim=0; idim<fNDim; idim++){
+      array = fData[idim];
+      Spread(npoints, array, fIndPoints+cpos, min, max);
+      tempspread = max - min;
+      if (maxspread < tempspread) {
+         maxspread=tempspread;
+         axspread = idim;
       }
+      if(cnode) continue;
+      //printf("set %d %6.3f %6.3f\n", idim, min, max);
+      fRange[2*idim] = min; fRange[2*idim+1] = max;
+   }
+   array = fData[axspread];
+   KOrdStat(npoints, array, nleft, fIndPoints+cpos);
+   fAxis[cnode]  = axspread;
+   fValue[cnode] = array[fIndPoints[cpos+nleft]];
+   //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
+   //
+   if (0){
+      // consistency check
+      Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
+      if (nleft<nright) Warning("Build", "Problem Left-Right");
+      if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
    }
+   return nleft;
 }
 
 //_________________________________________________________________
@@ -545,6 +617,54 @@ void TKDTree<Index, Value>::FindNearestNeighbors(const Value *point, const Int_t
 
 }
 
+//_________________________________________________________________
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::FindNearestNeighbors(Index npoints, const Value *points, const Int_t kNN, Index *ind, Value *dist)
+{
+   //Find the kNN nearest neighbors of each of the npoints points given in the array
+   //points (the coordinates of the point i start at points[i*fNDim]).
+   //The neighbors of the point i are returned in ind[i*kNN] and dist[i*kNN], as
+   //returned by FindNearestNeighbors(points+i*fNDim, kNN, ind+i*kNN, dist+i*kNN).
+   //The points are processed in the order of the terminal nodes containing them, so that
+   //consecutive queries visit the same nodes and data, and in parallel when openMP is
+   //available.
+
+   if (!ind || !dist) {
+      Error("FindNearestNeighbors", "Working arrays must be allocated by the user!");
+      return;
+   }
+   if (npoints <= 0) return;
+   MakeBoundariesExact();
+
+   std::vector<Int_t> order(npoints);
+   SortByNode(npoints, points, &order[0]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+   for (Int_t j=0; j<Int_t(npoints); j++){
+      const Int_t i = order[j];
+      Index *indi = ind + i*kNN;
+      Value *disti = dist + i*kNN;
+      for (Int_t k=0; k<kNN; k++){
+         disti[k]=std::numeric_limits<Value>::max();
+         indi[k]=-1;
+      }
+      UpdateNearestNeighbors(0, points + i*fNDim, kNN, indi, disti);
+   }
+}
+
+//_________________________________________________________________
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::SortByNode(Index npoints, const Value *points, Int_t *order) const
+{
+   //Fill order with the indices of the npoints points (stored as in
+   //FindNearestNeighbors(Index, const Value*, ...)) sorted by terminal node
+
+   std::vector<Int_t> nodes(npoints);
+   for (Index i=0; i<npoints; i++) nodes[i] = FindNode(points + i*fNDim);
+   TMath::Sort(Int_t(npoints), &nodes[0], order, kFALSE);
+}
+
 //_________________________________________________________________
 template <typename Index, typename Value>
 void TKDTree<Index, Value>::UpdateNearestNeighbors(Index inode, const Value *point, Int_t kNN, Index *ind, Value *dist)
@@ -730,7 +850,7 @@ void TKDTree<Index, Value>::FindPoint(Value * point, Index &index, Int_t &iter){
 
 //_________________________________________________________________
 template <typename  Index, typename Value>
-void TKDTree<Index, Value>::FindInRange(Value * point, Value range, std::vector<Index> &res)
+void TKDTree<Index, Value>::FindInRange(const Value * point, Value range, std::vector<Index> &res)
 {
 //Find all points in the sphere of a given radius "range" around the given point
 //1st argument - the point
@@ -743,7 +863,32 @@ void TKDTree<Index, Value>::FindInRange(Value * point, Value range, std::vector<
 
 //_________________________________________________________________
 template <typename  Index, typename Value>
-void TKDTree<Index, Value>::UpdateRange(Index inode, Value* point, Value range, std::vector<Index> &res)
+void TKDTree<Index, Value>::FindInRange(Index npoints, const Value *points, Value range, std::vector<std::vector<Index> > &res)
+{
+//Find all points in the sphere of radius "range" around each of the npoints points given
+//in the array points (the coordinates of the point i start at points[i*fNDim]).
+//res[i] contains the points found for the point i, as returned by FindInRange(points+i*fNDim, ...)
+//The points are processed as in FindNearestNeighbors(Index, const Value*, ...).
+
+   res.resize(npoints);
+   if (npoints <= 0) return;
+   MakeBoundariesExact();
+
+   std::vector<Int_t> order(npoints);
+   SortByNode(npoints, points, &order[0]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic,64)
+#endif
+   for (Int_t j=0; j<Int_t(npoints); j++){
+      const Int_t i = order[j];
+      res[i].clear();
+      UpdateRange(0, points + i*fNDim, range, res[i]);
+   }
+}
+
+//_________________________________________________________________
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::UpdateRange(Index inode, const Value* point, Value range, std::vector<Index> &res)
 {
 //Internal recursive function with the implementation of range searches
 
@@ -24,6 +24,9 @@
 // and a period of about 10**171. It is however slower than the others.
 // TRandom2, is based on the Tausworthe generator of L'Ecuyer, and it has the advantage
 // of being fast and using only 3 words (of 32 bits) for the state. The period is 10**26.
+// TRandomPhilox, a counter-based generator (Philox4x32-10), provides independent
+// and reproducible streams, created by index, for parallel jobs (one generator
+// object per thread or worker) and can skip ahead in a stream in constant time.
 //
 // The following table shows some timings (in nanoseconds/call)
 // for the random numbers obtained using an Intel Pentium 3.0 GHz running Linux
@@ -46,6 +49,13 @@
 //   -Poisson(mean)
 //   -Binomial(ntot,prob)
 //
+// Arrays of random numbers can be generated at once, which is faster than
+// calling the functions above in a loop:
+//   -RndmArray(n,array)
+//   -ExpArray(n,array,tau)
+//   -GausArray(n,array,mean,sigma)
+//   -PoissonArray(n,array,mean)
+//
 // Random numbers distributed according to 1-d, 2-d or 3-d distributions
 // =====================================================================
 // contained in TF1, TF2 or TF3 objects.
@@ -133,6 +143,175 @@
 
 ClassImp(TRandom)
 
+namespace {
+
+   // Uniform numbers from TRandom::Rndm
+   class TRandomRndm {
+   public:
+      TRandomRndm(TRandom *r) : fRandom(r) {}
+      Double_t operator()() { return fRandom->Rndm(); }
+   private:
+      TRandom *fRandom;
+   };
+
+   // Uniform numbers generated in blocks with TRandom::RndmArray, used by the
+   // array methods
+   class TRandomBlock {
+   public:
+      enum { kSize = 256 };
+      TRandomBlock(TRandom *r) : fRandom(r), fPos(kSize) {}
+      Double_t operator()() {
+         if (fPos == kSize) {
+            fRandom->RndmArray(kSize,fBuffer);
+            fPos = 0;
+         }
+         return fBuffer[fPos++];
+      }
+   private:
+      TRandom *fRandom;
+      Int_t    fPos;
+      Double_t fBuffer[kSize];
+   };
+
+   template<class Uniform>
+   Double_t GausACR(Uniform &rndm)
+   {
+      // Standard normal number with the acceptance-complement ratio method
+      // (see TRandom::Gaus), from the uniform numbers returned by rndm()
+
+      const Double_t kC1 = 1.448242853;
+      const Double_t kC2 = 3.307147487;
+      const Double_t kC3 = 1.46754004;
+      const Double_t kD1 = 1.036467755;
+      const Double_t kD2 = 5.295844968;
+      const Double_t kD3 = 3.631288474;
+      const Double_t kHm = 0.483941449;
+      const Double_t kZm = 0.107981933;
+      const Double_t kHp = 4.132731354;
+      const Double_t kZp = 18.52161694;
+      const Double_t kPhln = 0.4515827053;
+      const Double_t kHm1 = 0.516058551;
+      const Double_t kHp1 = 3.132731354;
+      const Double_t kHzm = 0.375959516;
+      const Double_t kHzmp = 0.591923442;
+      /*zhm 0.967882898*/
+
+      const Double_t kAs = 0.8853395638;
+      const Double_t kBs = 0.2452635696;
+      const Double_t kCs = 0.2770276848;
+      const Double_t kB  = 0.5029324303;
+      const Double_t kX0 = 0.4571828819;
+      const Double_t kYm = 0.187308492 ;
+      const Double_t kS  = 0.7270572718 ;
+      const Double_t kT  = 0.03895759111;
+
+      Double_t result;
+      Double_t rn,x,y,z;
+
+      do {
+         y = rndm();
+
+         if (y>kHm1) {
+            result = kHp*y-kHp1; break; }
+
+         else if (y<kZm) {  
+            rn = kZp*y-1;
+            result = (rn>0) ? (1+rn) : (-1+rn);
+            break;
+         } 
+
+         else if (y<kHm) {  
+            rn = rndm();
+            rn = rn-1+rn;
+            z = (rn>0) ? 2-rn : -2-rn;
+            if ((kC1-y)*(kC3+TMath::Abs(z))<kC2) {
+               result = z; break; }
+            else {  
+               x = rn*rn;
+               if ((y+kD1)*(kD3+x)<kD2) {
+                  result = rn; break; }
+               else if (kHzmp-y<exp(-(z*z+kPhln)/2)) {
+                  result = z; break; }
+               else if (y+kHzm<exp(-(x+kPhln)/2)) {
+                  result = rn; break; }
+            }
+         }
+
+         while (1) {
+            x = rndm();
+            y = kYm * rndm();
+            z = kX0 - kS*x - y;
+            if (z>0) 
+               rn = 2+y/x;
+            else {
+               x = 1-x;
+               y = kYm-y;
+               rn = -(2+y/x);
+            }
+            if ((y-kAs+x)*(kCs+x)+kBs<0) {
+               result = rn; break; }
+            else if (y<x+kT)
+               if (rn*rn<4*(kB-log(x))) {
+                  result = rn; break; }
+         }
+      } while(0);
+
+      return result;
+   }
+
+   // Poisson numbers for mean < 1E9 (see TRandom::Poisson), with the constants
+   // depending on the mean computed once
+   class TRandomPoisson {
+   public:
+      TRandomPoisson(Double_t mean) : fMean(mean), fExpMean(0), fSq(0), fAlxm(0), fG(0) {
+         if (mean < 25)
+            fExpMean = TMath::Exp(-mean);
+         else {
+            fSq = TMath::Sqrt(2.0*mean);
+            fAlxm = TMath::Log(mean);
+            fG = mean*fAlxm - TMath::LnGamma(mean + 1.0);
+         }
+      }
+
+      template<class Uniform>
+      Double_t operator()(Uniform &rndm) const {
+         if (fMean < 25) {
+            // rejection method based on the exponential
+            Double_t pir = 1;
+            Int_t n = -1;
+            while(1) {
+               n++;
+               pir *= rndm();
+               if (pir <= fExpMean) break;
+            }
+            return static_cast<Double_t>(n);
+         }
+         // rejection method comparing with a Lorentzian
+         Double_t em, t, y;
+         Double_t pi = TMath::Pi();
+         do {
+            do {
+               y = TMath::Tan(pi*rndm());
+               em = fSq*y + fMean;
+            } while( em < 0.0 );
+
+            em = TMath::Floor(em);
+            t = 0.9*(1.0 + y*y)* TMath::Exp(em*fAlxm - TMath::LnGamma(em + 1.0) - fG);
+         } while( rndm() > t );
+         return em;
+      }
+
+   private:
+      Double_t fMean;
+      Double_t fExpMean;   // exp(-mean)
+      Double_t fSq;        // sqrt(2*mean)
+      Double_t fAlxm;      // log(mean)
+      Double_t fG;         // mean*log(mean) - log(Gamma(mean+1))
+   };
+
+}
+
+
 //______________________________________________________________________________
 TRandom::TRandom(UInt_t seed): TNamed("Random","Default Random number generator")
 {
@@ -208,6 +387,18 @@ Double_t TRandom::Exp(Double_t tau)
    return t;
 }
 
+//______________________________________________________________________________
+void TRandom::ExpArray(Int_t n, Double_t *array, Double_t tau)
+{
+   // Fill array with n exponential deviates (see Exp).
+   // The uniform numbers are generated at once with RndmArray, so, for the
+   // ROOT generators, the result is the same as calling n times Exp(tau).
+
+   RndmArray(n, array);
+   for (Int_t i = 0; i < n; i++)
+      array[i] = -tau * TMath::Log( array[i] );
+}
+
 //______________________________________________________________________________
 Double_t TRandom::Gaus(Double_t mean, Double_t sigma)
 {
@@ -226,84 +417,23 @@ Double_t TRandom::Gaus(Double_t mean, Double_t sigma)
    // Implementation taken from 
    // UNURAN (c) 2000  W. Hoermann & J. Leydold, Institut f. Statistik, WU Wien 
 
-   const Double_t kC1 = 1.448242853;
-   const Double_t kC2 = 3.307147487;
-   const Double_t kC3 = 1.46754004;
-   const Double_t kD1 = 1.036467755;
-   const Double_t kD2 = 5.295844968;
-   const Double_t kD3 = 3.631288474;
-   const Double_t kHm = 0.483941449;
-   const Double_t kZm = 0.107981933;
-   const Double_t kHp = 4.132731354;
-   const Double_t kZp = 18.52161694;
-   const Double_t kPhln = 0.4515827053;
-   const Double_t kHm1 = 0.516058551;
-   const Double_t kHp1 = 3.132731354;
-   const Double_t kHzm = 0.375959516;
-   const Double_t kHzmp = 0.591923442;
-   /*zhm 0.967882898*/
-
-   const Double_t kAs = 0.8853395638;
-   const Double_t kBs = 0.2452635696;
-   const Double_t kCs = 0.2770276848;
-   const Double_t kB  = 0.5029324303;
-   const Double_t kX0 = 0.4571828819;
-   const Double_t kYm = 0.187308492 ;
-   const Double_t kS  = 0.7270572718 ;
-   const Double_t kT  = 0.03895759111;
-
-   Double_t result;
-   Double_t rn,x,y,z;
-
-   do {
-      y = Rndm();
-
-      if (y>kHm1) {
-         result = kHp*y-kHp1; break; }
-  
-      else if (y<kZm) {  
-         rn = kZp*y-1;
-         result = (rn>0) ? (1+rn) : (-1+rn);
-         break;
-      } 
-
-      else if (y<kHm) {  
-         rn = Rndm();
-         rn = rn-1+rn;
-         z = (rn>0) ? 2-rn : -2-rn;
-         if ((kC1-y)*(kC3+TMath::Abs(z))<kC2) {
-            result = z; break; }
-         else {  
-            x = rn*rn;
-            if ((y+kD1)*(kD3+x)<kD2) {
-               result = rn; break; }
-            else if (kHzmp-y<exp(-(z*z+kPhln)/2)) {
-               result = z; break; }
-            else if (y+kHzm<exp(-(x+kPhln)/2)) {
-               result = rn; break; }
-         }
-      }
+   TRandomRndm rndm(this);
+   return mean + sigma * GausACR(rndm);
+}
 
-      while (1) {
-         x = Rndm();
-         y = kYm * Rndm();
-         z = kX0 - kS*x - y;
-         if (z>0) 
-            rn = 2+y/x;
-         else {
-            x = 1-x;
-            y = kYm-y;
-            rn = -(2+y/x);
-         }
-         if ((y-kAs+x)*(kCs+x)+kBs<0) {
-            result = rn; break; }
-         else if (y<x+kT)
-            if (rn*rn<4*(kB-log(x))) {
-               result = rn; break; }
-      }
-   } while(0);
-   
-   return mean + sigma * result;
+//______________________________________________________________________________
+void TRandom::GausArray(Int_t n, Double_t *array, Double_t mean, Double_t sigma)
+{
+   // Fill array with n numbers following the Normal (Gaussian) distribution
+   // with the given mean and sigma, using the same algorithm as Gaus.
+   // The uniform numbers needed are generated in blocks with RndmArray, which
+   // is much faster than calling Gaus n times. Note that the sequence is
+   // then different from the one obtained calling Gaus, and that some of the
+   // uniform numbers of the last block are not used.
+
+   TRandomBlock rndm(this);
+   for (Int_t i = 0; i < n; i++)
+      array[i] = mean + sigma * GausACR(rndm);
 }
 
 //______________________________________________________________________________
@@ -347,45 +477,14 @@ Int_t TRandom::Poisson(Double_t mean)
    // larger than 2*10**9.
    // One should then use the Trandom::PoissonD for such large values.
 
-   Int_t n;
    if (mean <= 0) return 0;
-   if (mean < 25) {
-      Double_t expmean = TMath::Exp(-mean);
-      Double_t pir = 1;
-      n = -1;
-      while(1) {
-         n++;
-         pir *= Rndm();
-         if (pir <= expmean) break;
-      }
-      return n;
-   }
-   // for large value we use inversion method
-   else if (mean < 1E9) {
-      Double_t em, t, y;
-      Double_t sq, alxm, g;
-      Double_t pi = TMath::Pi();
-
-      sq = TMath::Sqrt(2.0*mean);
-      alxm = TMath::Log(mean);
-      g = mean*alxm - TMath::LnGamma(mean + 1.0);
-
-      do {
-         do {
-            y = TMath::Tan(pi*Rndm());
-            em = sq*y + mean;
-         } while( em < 0.0 );
-
-         em = TMath::Floor(em);
-         t = 0.9*(1.0 + y*y)* TMath::Exp(em*alxm - TMath::LnGamma(em + 1.0) - g);
-      } while( Rndm() > t );
-
-      return static_cast<Int_t> (em);
-
+   if (mean < 1E9) {
+      TRandomRndm rndm(this);
+      return static_cast<Int_t> (TRandomPoisson(mean)(rndm));
    }
    else {
       // use Gaussian approximation vor very large values
-      n = Int_t(Gaus(0,1)*TMath::Sqrt(mean) + mean +0.5);
+      Int_t n = Int_t(Gaus(0,1)*TMath::Sqrt(mean) + mean +0.5);
       return n;
    }
 }
@@ -399,44 +498,38 @@ Double_t TRandom::PoissonD(Double_t mean)
    // This function is a variant of TRandom::Poisson returning a double
    // instead of an integer.
 
-   Int_t n;
    if (mean <= 0) return 0;
-   if (mean < 25) {
-      Double_t expmean = TMath::Exp(-mean);
-      Double_t pir = 1;
-      n = -1;
-      while(1) {
-         n++;
-         pir *= Rndm();
-         if (pir <= expmean) break;
-      }
-      return static_cast<Double_t>(n);
+   if (mean < 1E9) {
+      TRandomRndm rndm(this);
+      return TRandomPoisson(mean)(rndm);
+   } else {
+      // use Gaussian approximation vor very large values
+      return Gaus(0,1)*TMath::Sqrt(mean) + mean +0.5;
    }
-   // for large value we use inversion method
-   else if (mean < 1E9) {
-      Double_t em, t, y;
-      Double_t sq, alxm, g;
-      Double_t pi = TMath::Pi();
-
-      sq = TMath::Sqrt(2.0*mean);
-      alxm = TMath::Log(mean);
-      g = mean*alxm - TMath::LnGamma(mean + 1.0);
-
-      do {
-         do {
-            y = TMath::Tan(pi*Rndm());
-            em = sq*y + mean;
-         } while( em < 0.0 );
-
-         em = TMath::Floor(em);
-         t = 0.9*(1.0 + y*y)* TMath::Exp(em*alxm - TMath::LnGamma(em + 1.0) - g);
-      } while( Rndm() > t );
-
-      return em;
+}
 
+//______________________________________________________________________________
+void TRandom::PoissonArray(Int_t n, Int_t *array, Double_t mean)
+{
+   // Fill array with n random integers following a Poisson law (see Poisson).
+   // The constants depending on the mean are computed only once and the uniform
+   // numbers needed are generated in blocks with RndmArray, as in GausArray.
+   // The sequence is then different from the one obtained calling Poisson.
+
+   if (mean <= 0) {
+      for (Int_t i = 0; i < n; i++) array[i] = 0;
+      return;
+   }
+   TRandomBlock rndm(this);
+   if (mean < 1E9) {
+      const TRandomPoisson poisson(mean);
+      for (Int_t i = 0; i < n; i++)
+         array[i] = static_cast<Int_t> (poisson(rndm));
    } else {
       // use Gaussian approximation vor very large values
-      return Gaus(0,1)*TMath::Sqrt(mean) + mean +0.5;
+      const Double_t sq = TMath::Sqrt(mean);
+      for (Int_t i = 0; i < n; i++)
+         array[i] = Int_t(GausACR(rndm)*sq + mean +0.5);
    }
 }
 
@@ -46,6 +46,7 @@
 #include "TRandom3.h"
 #include "TClass.h"
 #include "TUUID.h"
+#include "TMath.h"
 
 TRandom *gRandom = new TRandom3();
 #ifdef R__COMPLETE_MEM_TERMINATION
@@ -88,31 +89,10 @@ Double_t TRandom3::Rndm(Int_t)
 
    UInt_t y;
 
-   const Int_t  kM = 397;
-   const Int_t  kN = 624;
    const UInt_t kTemperingMaskB =  0x9d2c5680;
    const UInt_t kTemperingMaskC =  0xefc60000;
-   const UInt_t kUpperMask =       0x80000000;
-   const UInt_t kLowerMask =       0x7fffffff;
-   const UInt_t kMatrixA =         0x9908b0df;
-
-   if (fCount624 >= kN) {
-      register Int_t i;
-
-      for (i=0; i < kN-kM; i++) {
-         y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
-         fMt[i] = fMt[i+kM] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-      }
 
-      for (   ; i < kN-1    ; i++) {
-         y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
-         fMt[i] = fMt[i+kM-kN] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-      }
-
-      y = (fMt[kN-1] & kUpperMask) | (fMt[0] & kLowerMask);
-      fMt[kN-1] = fMt[kM-1] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-      fCount624 = 0;
-   }
+   if (fCount624 >= 624) Twist();
 
    y = fMt[fCount624++];
    y ^=  (y >> 11);
@@ -128,57 +108,87 @@ Double_t TRandom3::Rndm(Int_t)
 void TRandom3::RndmArray(Int_t n, Float_t *array)
 {
   // Return an array of n random numbers uniformly distributed in ]0,1]
-
-  for(Int_t i=0; i<n; i++) array[i]=(Float_t)Rndm();
+  // (the same sequence as calling n times Rndm)
+
+   const Int_t kBuf = 624;
+   Double_t buffer[kBuf];
+   for (Int_t k = 0; k < n; k += kBuf) {
+      const Int_t m = TMath::Min(kBuf, n-k);
+      RndmArray(m, buffer);
+      for (Int_t i = 0; i < m; i++) array[k+i] = (Float_t)buffer[i];
+   }
 }
 
 //______________________________________________________________________________
 void TRandom3::RndmArray(Int_t n, Double_t *array)
 {
   // Return an array of n random numbers uniformly distributed in ]0,1]
+  // The numbers are the same as calling n times Rndm, but the state is
+  // regenerated and tempered a whole block at a time, in loops without
+  // branches which can be vectorized by the compiler.
+
+   const UInt_t kTemperingMaskB =  0x9d2c5680;
+   const UInt_t kTemperingMaskC =  0xefc60000;
 
    Int_t k = 0;
+   while (k < n) {
+      if (fCount624 >= 624) Twist();
+
+      const Int_t m = TMath::Min(624-fCount624, n-k);
+      const UInt_t *mt = fMt+fCount624;
+      Double_t *out = array+k;
+      Int_t nzero = 0;
+      for (Int_t i = 0; i < m; i++) {
+         UInt_t y = mt[i];
+         y ^=  (y >> 11);
+         y ^= ((y << 7 ) & kTemperingMaskB );
+         y ^= ((y << 15) & kTemperingMaskC );
+         y ^=  (y >> 18);
+         nzero += (y == 0);
+         out[i] = Double_t( y * 2.3283064365386963e-10); // * Power(2,-32)
+      }
+      fCount624 += m;
+      k += m;
+
+      // zero is rejected, as in Rndm (probability 2**-32)
+      if (nzero) {
+         Int_t j = 0;
+         for (Int_t i = 0; i < m; i++)
+            if (out[i] != 0) out[j++] = out[i];
+         k -= m-j;
+      }
+   }
+}
 
-   UInt_t y;
+//______________________________________________________________________________
+void TRandom3::Twist()
+{
+   // Generate the next 624 words of the state of the generator.
+   // The original conditional XOR with the matrix A is computed without
+   // branches, so that the loops can be vectorized.
 
    const Int_t  kM = 397;
    const Int_t  kN = 624;
-   const UInt_t kTemperingMaskB =  0x9d2c5680;
-   const UInt_t kTemperingMaskC =  0xefc60000;
    const UInt_t kUpperMask =       0x80000000;
    const UInt_t kLowerMask =       0x7fffffff;
    const UInt_t kMatrixA =         0x9908b0df;
 
-   while (k < n) {
-      if (fCount624 >= kN) {
-         register Int_t i;
-
-         for (i=0; i < kN-kM; i++) {
-            y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
-            fMt[i] = fMt[i+kM] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-         }
-
-         for (   ; i < kN-1    ; i++) {
-            y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
-            fMt[i] = fMt[i+kM-kN] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-         }
-
-         y = (fMt[kN-1] & kUpperMask) | (fMt[0] & kLowerMask);
-         fMt[kN-1] = fMt[kM-1] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-         fCount624 = 0;
-      }
+   UInt_t y;
+   Int_t i;
 
-      y = fMt[fCount624++];
-      y ^=  (y >> 11);
-      y ^= ((y << 7 ) & kTemperingMaskB );
-      y ^= ((y << 15) & kTemperingMaskC );
-      y ^=  (y >> 18);
+   for (i=0; i < kN-kM; i++) {
+      y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
+      fMt[i] = fMt[i+kM] ^ (y >> 1) ^ ((0u - (y & 0x1)) & kMatrixA);
+   }
 
-      if (y) {
-         array[k] = Double_t( y * 2.3283064365386963e-10); // * Power(2,-32)
-         k++;
-      }
+   for (   ; i < kN-1    ; i++) {
+      y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
+      fMt[i] = fMt[i+kM-kN] ^ (y >> 1) ^ ((0u - (y & 0x1)) & kMatrixA);
    }
+
+   y = (fMt[kN-1] & kUpperMask) | (fMt[0] & kLowerMask);
+   fMt[kN-1] = fMt[kM-1] ^ (y >> 1) ^ ((0u - (y & 0x1)) & kMatrixA);
+   fCount624 = 0;
 }
 
 //______________________________________________________________________________
@@ -0,0 +1,225 @@
+// @(#)root/mathcore:$Id$
+// Author: Lorenzo Moneta   2013
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TRandomPhilox
+//
+// Counter-based random number generator Philox4x32-10 from
+//   J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw,
+//   Parallel Random Numbers: As Easy as 1, 2, 3,
+//   Proceedings of the International Conference for High Performance
+//   Computing, Networking, Storage and Analysis (SC11), 2011.
+//
+// The n-th block of 4 numbers is obtained by applying 10 rounds of a keyed
+// bijection to the counter n, the key being made by the seed and by a
+// stream number. The generator state is therefore just (seed, stream,
+// position) and:
+//
+//   - the streams with different numbers are statistically independent and
+//     each of them has a period of 2**66 numbers. They can be given to
+//     different threads or PROOF workers, one TRandomPhilox object for each
+//     (the objects, as gRandom, must not be shared between threads without
+//     locking):
+//
+//        TRandomPhilox master(seed);
+//        ...
+//        // in the job (or the thread) number i
+//        TRandomPhilox *r = master.CreateStream(i);
+//
+//     If the stream number is bound to the work item rather than to the
+//     thread processing it, the result does not depend on how the work is
+//     scheduled.
+//
+//   - any position in the stream can be reached in constant time with
+//     SetPosition or Skip, e.g. to split a stream in sub-sequences.
+//
+//   - RndmArray generates the blocks directly in the output array.
+//
+// The numbers are uniformly distributed in ]0,1[ with 32 bits of precision
+// (the value 0 is never returned, as for the other ROOT generators).
+//////////////////////////////////////////////////////////////////////////
+
+#include "TRandomPhilox.h"
+#include "TRandom3.h"
+#include "TMath.h"
+
+
+ClassImp(TRandomPhilox)
+
+namespace {
+
+   const Double_t kScale = 2.3283064365386963e-10;    // 1/(2**32)
+
+   // Philox4x32-10: compute the block of 4 words for the counter ctr (whose
+   // two upper words are zero) and the key (k0,k1)
+   inline void Philox(ULong64_t ctr, UInt_t k0, UInt_t k1, UInt_t *out)
+   {
+      const UInt_t kM0 = 0xD2511F53;
+      const UInt_t kM1 = 0xCD9E8D57;
+      const UInt_t kW0 = 0x9E3779B9;
+      const UInt_t kW1 = 0xBB67AE85;
+
+      UInt_t c0 = UInt_t(ctr);
+      UInt_t c1 = UInt_t(ctr >> 32);
+      UInt_t c2 = 0;
+      UInt_t c3 = 0;
+      for (Int_t r = 0; r < 10; r++) {
+         if (r > 0) {
+            k0 += kW0;
+            k1 += kW1;
+         }
+         const ULong64_t p0 = ULong64_t(kM0)*c0;
+         const ULong64_t p1 = ULong64_t(kM1)*c2;
+         const UInt_t hi0 = UInt_t(p0 >> 32);
+         const UInt_t hi1 = UInt_t(p1 >> 32);
+         c0 = hi1 ^ c1 ^ k0;
+         c1 = UInt_t(p1);
+         c2 = hi0 ^ c3 ^ k1;
+         c3 = UInt_t(p0);
+      }
+      out[0] = c0;
+      out[1] = c1;
+      out[2] = c2;
+      out[3] = c3;
+   }
+
+   // convert to ]0,1[ : adding half a step avoids 0 without rejection, so
+   // that the position in the stream is always known
+   inline Double_t ToDouble(UInt_t y)
+   {
+      return (Double_t(y) + 0.5)*kScale;
+   }
+
+}
+
+//______________________________________________________________________________
+TRandomPhilox::TRandomPhilox(UInt_t seed, UInt_t stream)
+{
+//*-*-*-*-*-*-*-*-*-*-*default constructor*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+//*-*                  ===================
+
+   SetName("RandomPhilox");
+   SetTitle("Counter-based random number generator: Philox4x32-10");
+   fStream = stream;
+   SetSeed(seed);
+}
+
+//______________________________________________________________________________
+TRandomPhilox::~TRandomPhilox()
+{
+//*-*-*-*-*-*-*-*-*-*-*default destructor*-*-*-*-*-*-*-*-*-*-*-*-*-*-*
+//*-*                  ==================
+
+}
+
+//______________________________________________________________________________
+TRandomPhilox *TRandomPhilox::CreateStream(UInt_t stream) const
+{
+   // Return a new generator with the same seed as this one and the given
+   // stream number, positioned at the beginning of the stream.
+   // The returned object is owned by the caller.
+
+   TRandomPhilox *r = new TRandomPhilox(1, stream);
+   r->fSeed = fSeed;
+   return r;
+}
+
+//______________________________________________________________________________
+ULong64_t TRandomPhilox::GetPosition() const
+{
+   // Return the number of random numbers generated since the beginning of
+   // the stream.
+
+   if (fPos < 4) return 4*(fCounter-1) + fPos;
+   return 4*fCounter;
+}
+
+//______________________________________________________________________________
+Double_t TRandomPhilox::Rndm(Int_t)
+{
+   // Return a random number uniformly distributed in ]0,1[
+
+   if (fPos >= 4) {
+      Philox(fCounter++, fSeed, fStream, fBlock);
+      fPos = 0;
+   }
+   return ToDouble(fBlock[fPos++]);
+}
+
+//______________________________________________________________________________
+void TRandomPhilox::RndmArray(Int_t n, Float_t *array)
+{
+   // Return an array of n random numbers uniformly distributed in ]0,1]
+   // (the same numbers as calling n times Rndm)
+
+   const Int_t kBuf = 256;
+   Double_t buffer[kBuf];
+   for (Int_t k = 0; k < n; k += kBuf) {
+      const Int_t m = TMath::Min(kBuf, n-k);
+      RndmArray(m, buffer);
+      for (Int_t i = 0; i < m; i++) array[k+i] = (Float_t)buffer[i];
+   }
+}
+
+//______________________________________________________________________________
+void TRandomPhilox::RndmArray(Int_t n, Double_t *array)
+{
+   // Return an array of n random numbers uniformly distributed in ]0,1[
+   // (the same numbers as calling n times Rndm). The complete blocks are
+   // generated directly in the array.
+
+   Int_t i = 0;
+   while (i < n && fPos < 4) array[i++] = ToDouble(fBlock[fPos++]);
+
+   UInt_t block[4];
+   for ( ; i + 4 <= n; i += 4) {
+      Philox(fCounter++, fSeed, fStream, block);
+      array[i]   = ToDouble(block[0]);
+      array[i+1] = ToDouble(block[1]);
+      array[i+2] = ToDouble(block[2]);
+      array[i+3] = ToDouble(block[3]);
+   }
+
+   while (i < n) array[i++] = Rndm();
+}
+
+//______________________________________________________________________________
+void TRandomPhilox::SetPosition(ULong64_t pos)
+{
+   // Set the position in the stream: the next number returned is the number
+   // pos (starting from 0) of the stream.
+
+   fCounter = pos/4;
+   fPos = 4;
+   const Int_t rest = Int_t(pos%4);
+   if (rest) {
+      Philox(fCounter++, fSeed, fStream, fBlock);
+      fPos = rest;
+   }
+}
+
+//______________________________________________________________________________
+void TRandomPhilox::SetSeed(UInt_t seed)
+{
+   // Set the generator seed and go back to the beginning of the stream.
+   // If the seed given is zero, generate automatically a seed value which
+   // is different every time by using TRandom3 and TUUID.
+
+   if (seed > 0) {
+      fSeed = seed;
+   } else {
+      TRandom3 r3(0);
+      fSeed = static_cast<UInt_t> (4294967296.*r3.Rndm());
+   }
+   SetPosition(0);
+}
+
+//______________________________________________________________________________
+void TRandomPhilox::SetStream(UInt_t stream)
+{
+   // Set the stream number and go back to the beginning of the stream.
+
+   fStream = stream;
+   SetPosition(0);
+}
@@ -14,10 +14,14 @@
 #include "Fit/UnBinData.h"
 #include "HFitInterface.h"
 #include "Fit/Fitter.h"
+#include "Fit/Chi2FCN.h"
+#include "Fit/LogLikelihoodFCN.h"
+#include "Fit/PoissonLikelihoodFCN.h"
 
 #include "Math/WrappedMultiTF1.h"
 #include "Math/WrappedParamFunction.h"
 #include "Math/WrappedTF1.h"
+#include "Math/PdfFuncMathCore.h"
 //#include "Math/Polynomial.h"
 #include "RConfigure.h"
 
@@ -914,6 +918,78 @@ int testGraphFit() {
 }
 
 
+// normalized gaussian pdf: p[0] is the mean and p[1] the sigma 
+// (thread safe since the parameters are passed explicitly)
+double gausPdf(const double * x, const double * p) { 
+   return ROOT::Math::normal_pdf(x[0], p[1], p[0]); 
+}
+
+// gaussian with a normalization parameter p[2]
+double gausFunc(const double * x, const double * p) { 
+   return p[2] * ROOT::Math::normal_pdf(x[0], p[1], p[0]); 
+}
+
+int testParallelEval() { 
+   // compare the sequential evaluation of the fit method functions with the 
+   // evaluation in chunks used with FitConfig::SetNThreads
+
+   int iret = 0; 
+
+   TRandom3 rndm;
+   int n = 20000;
+   ROOT::Fit::UnBinData d(n); 
+   TH1D h1("h1par","h1par",100,-5,5);
+   for (int i = 0; i <n; ++i) {
+      double x = rndm.Gaus(0.5,1.5); 
+      d.Add( x );
+      h1.Fill( x ); 
+   }
+
+   double p[3] = {0.3,1.2,n*0.1}; 
+
+   ROOT::Math::WrappedParamFunction<> pdf(&gausPdf,1,p,p+2); 
+   ROOT::Fit::LogLikelihoodFunction logl1(d, pdf); 
+   ROOT::Fit::LogLikelihoodFunction logl2(d, pdf, 0, false, 4); 
+   iret |= compareResult(logl2(p), logl1(p),"parallel unbinned likelihood",1.E-10);
+
+   ROOT::Fit::BinData bd; 
+   ROOT::Fit::FillData(bd,&h1);
+   ROOT::Math::WrappedParamFunction<> func(&gausFunc,1,p,p+3); 
+   ROOT::Fit::Chi2Function chi2a(bd, func); 
+   ROOT::Fit::Chi2Function chi2b(bd, func, 4); 
+   iret |= compareResult(chi2b(p), chi2a(p),"parallel chi2",1.E-10);
+
+   ROOT::Fit::PoissonLLFunction pll1(bd, func); 
+   ROOT::Fit::PoissonLLFunction pll2(bd, func, 0, true, 4); 
+   iret |= compareResult(pll2(p), pll1(p),"parallel binned likelihood",1.E-10);
+
+   // the parallel fit must give the same result as the sequential one
+   ROOT::Fit::Fitter fitter; 
+   fitter.SetFunction(pdf);
+   fitter.Config().SetMinimizer("Minuit2");
+   bool ret = fitter.Fit(d);
+   if (!ret) { 
+      std::cout << "Unbinned Likelihood Fit Failed " << std::endl; 
+      return -1; 
+   }
+   double lref = fitter.Result().MinFcnValue(); 
+   double muref = fitter.Result().Parameter(0); 
+
+   fitter.SetFunction(pdf);
+   fitter.Config().SetNThreads(4);
+   ret = fitter.Fit(d);
+   if (ret)  
+      fitter.Result().Print(std::cout); 
+   else {
+      std::cout << "Parallel Unbinned Likelihood Fit Failed " << std::endl; 
+      return -1; 
+   }
+   iret |= compareResult(fitter.Result().MinFcnValue(), lref,"parallel unbin fit",1.E-8);
+   iret |= compareResult(fitter.Result().Parameter(0), muref,"parallel unbin fit mean",1.E-4);
+
+   return iret; 
+}
+
 template<typename Test> 
 int testFit(Test t, std::string name) { 
    std::cout << name << "\n\t\t";  
@@ -934,6 +1010,7 @@ int main() {
    iret |= testFit( testHisto2DFit, "Histogram2D Gradient Fit");
    iret |= testFit( testUnBin1DFit, "Unbin 1D Fit");
    iret |= testFit( testGraphFit, "Graph 1D Fit");
+   iret |= testFit( testParallelEval, "Parallel Evaluation");
 
    std::cout << "\n******************************\n";
    if (iret) std::cerr << "\n\t testFit FAILED !!!!!!!!!!!!!!!! \n";
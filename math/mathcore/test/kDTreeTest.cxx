@@ -5,6 +5,7 @@
   TestSpeed();       // test the CPU consumption to build kdTree
   TestkdtreeIF();    // test functionality of the kdTree
   TestSizeIF();      // test the size of kdtree - search application - Alice TPC tracker situation
+  TestBatch();       // test the queries for many points at once
   //
 */
 
@@ -22,6 +23,7 @@
 void TestBuild(const Int_t npoints = 1000000, const Int_t bsize = 100);
 void TestConstr(const Int_t npoints = 1000000, const Int_t bsize = 100);
 void TestSpeed(Int_t npower2 = 20, Int_t bsize = 10);
+void TestBatch(Int_t npoints = 100000, Int_t nquery = 10000, Int_t bsize = 10);
 
 //void TestkdtreeIF(Int_t npoints=1000, Int_t bsize=9, Int_t nloop=1000, Int_t mode = 2);
 //void TestSizeIF(Int_t nsec=36, Int_t nrows=159, Int_t npoints=1000,  Int_t bsize=10, Int_t mode=1);
@@ -46,6 +48,8 @@ void kDTreeTest()
   TestBuild();  
   printf("\n\tTesting kDTree speed ...\n");
   TestSpeed();
+  printf("\n\tTesting kDTree queries for many points ...\n");
+  TestBatch();
 }
 
 //______________________________________________________________________
@@ -538,6 +542,75 @@ void TestRange()
 }
 
 
+//______________________________________________________________________
+void TestBatch(Int_t npoints, Int_t nquery, Int_t bsize)
+{
+//Test the versions of TKDTree::FindNearestNeighbors() and TKDTree::FindInRange()
+//for many points: the results must be the same as the ones of the queries point by point
+
+   const Int_t ndim = 3;
+   const Int_t nn = 10;
+   const Double_t range = 2;
+   Double_t *x = new Double_t[npoints];
+   Double_t *y = new Double_t[npoints];
+   Double_t *z = new Double_t[npoints];
+   for (Int_t i=0; i<npoints; i++){
+      x[i] = gRandom->Uniform(-100, 100);
+      y[i] = gRandom->Uniform(-100, 100);
+      z[i] = gRandom->Uniform(-100, 100);
+   }
+   TStopwatch timer;
+   TKDTreeID *kdtree = new TKDTreeID(npoints, ndim, bsize);
+   kdtree->SetData(0, x);
+   kdtree->SetData(1, y);
+   kdtree->SetData(2, z);
+   timer.Start();
+   kdtree->Build();
+   timer.Stop();
+   printf("Build of the tree for %d points: %f s\n", npoints, timer.CpuTime());
+
+   Double_t *points = new Double_t[nquery*ndim];
+   for (Int_t i=0; i<nquery*ndim; i++) points[i] = gRandom->Uniform(-100, 100);
+
+   Int_t *index = new Int_t[nquery*nn];
+   Double_t *dist = new Double_t[nquery*nn];
+   Int_t *index1 = new Int_t[nn];
+   Double_t *dist1 = new Double_t[nn];
+   std::vector<std::vector<Int_t> > res;
+   std::vector<Int_t> res1;
+
+   timer.Start();
+   for (Int_t i=0; i<nquery; i++) kdtree->FindNearestNeighbors(points + i*ndim, nn, index1, dist1);
+   timer.Stop();
+   printf("Nearest neighbors point by point: %f s\n", timer.RealTime());
+   timer.Start();
+   kdtree->FindNearestNeighbors(nquery, points, nn, index, dist);
+   timer.Stop();
+   printf("Nearest neighbors for all points: %f s\n", timer.RealTime());
+   kdtree->FindInRange(nquery, points, range, res);
+
+   Int_t ndiff = 0;
+   for (Int_t i=0; i<nquery; i++){
+      kdtree->FindNearestNeighbors(points + i*ndim, nn, index1, dist1);
+      for (Int_t inn=0; inn<nn; inn++){
+         if (index1[inn] != index[i*nn+inn] || dist1[inn] != dist[i*nn+inn]) ndiff++;
+      }
+      res1.clear();
+      kdtree->FindInRange(points + i*ndim, range, res1);
+      if (res1 != res[i]) ndiff++;
+   }
+   printf("%d differences found between the queries for all points and point by point\n", ndiff);
+
+   delete [] x;
+   delete [] y;
+   delete [] z;
+   delete [] points;
+   delete [] index;
+   delete [] dist;
+   delete [] index1;
+   delete [] dist1;
+   delete kdtree;
+}
 
 
 //______________________________________________________________________
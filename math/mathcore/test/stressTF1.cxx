@@ -210,6 +210,59 @@ int TestIntegral(TF1* f1)
    return status;
 }
 
+int TestEvalParVec()
+{
+   // compare the evaluation on a set of points with EvalPar for the built-in functions
+   // and for formulas combining them, which must not use the fast built-in path
+   int status = 0;
+   TStopwatch w;
+
+   cout << "EvalParVec TEST\n" 
+        << "---------------------------------------------------------"
+        << endl;
+
+   const int nform = 8;
+   const char * formulas[nform] = { "gaus", "gausn", "expo", "pol3", "landau", "[0]*sin(x)+[1]",
+                                    "2*landau", "gaus+pol0" };
+   double par[4] = { 2., 0.5, 1.5, 0.3 };
+   double par2[4] = { 3., -0.5, -0.2, 0.1 };
+
+   const int n = 1000;
+   double x[n];
+   double fvec[n];
+   for (int i = 0; i < n; ++i) x[i] = -5. + 10.*i/n;
+
+   for (int k = 0; k < nform; ++k) {
+      TF1 f1("fvec", formulas[k], -5, 5);
+      f1.SetParameters(par);
+      w.Start(kTRUE);
+      for ( int j = 0; j < REP/n; ++j )
+         f1.EvalParVec(n, x, 1, fvec, (j%2 == 0) ? 0 : par2);
+      w.Stop();
+      // the last call (j = REP/n - 1, odd) is done with par2
+      double maxdiff = 0;
+      for (int i = 0; i < n; ++i) {
+         double fval = f1.EvalPar(&x[i], par2);
+         double diff = std::abs(fvec[i] - fval)/std::max(std::abs(fval), 1.E-300);
+         if (fval == 0) diff = std::abs(fvec[i]);
+         maxdiff = std::max(maxdiff, diff);
+      }
+      cout << formulas[k] << "\t";
+      status += PrintStatus("EvalParVec", maxdiff*1.E6, 0, w.RealTime()/ TNORM );
+   }
+
+   // the integral of the normalized gaussian uses the vectorized evaluation
+   TF1 f2("fgausn", "gausn", -10, 10);
+   double pgaus[3] = { 1., 0., 1. };
+   f2.SetParameters(pgaus);
+   w.Start(kTRUE);
+   double integral = f2.Integral(-10, 10);
+   w.Stop();
+   status += PrintStatus("Integral gausn", integral, 1., w.RealTime()/ TNORM );
+
+   return status;
+}
+
 double func(double * x, double * p) { 
    double xx = *x; 
    ncall++;
@@ -233,6 +286,7 @@ int stressTF1()
    status += TestMaxMin(f1);
    status += TestDerivative(f1);
    status += TestIntegral(f1);
+   status += TestEvalParVec();
 
    cout << "End of Tests..." << endl;
    cout << "Total time for all tests: " << sumTime << endl;
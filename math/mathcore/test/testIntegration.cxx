@@ -3,6 +3,8 @@
 #include "Math/AllIntegrationTypes.h"
 #include "Math/Functor.h"
 #include "Math/GaussIntegrator.h"
+#include "Math/AdaptiveIntegratorMultiDim.h"
+#include "Math/SpecFuncMathCore.h"
 
 #include <cmath>
 
@@ -17,6 +19,13 @@ double f2(const double * x) {
    return x[0] + x[1]; 
 } 
 
+// product of 5 normal densities with sigma = 0.5
+double f5(const double * x) { 
+   double s = 0; 
+   for (int i = 0; i < 5; ++i) s += x[i]*x[i]; 
+   return std::exp(-2*s) * std::pow(2/M_PI, 2.5); 
+} 
+
 void printTestResult(std::ostream & os, const char * type, int status) { 
    os << "Test of " << type  << "\t: \t"; 
    if (!status)       os << "OK" << std::endl;
@@ -97,6 +106,21 @@ int testIntegrationMultiDim() {
    std::cout << "GSL MISER integral result is       " << val << std::endl;
    status += std::fabs(val-RESULT) > ERRORLIMIT;
 
+   // adaptive integration dividing several regions at each step: 
+   // the result must not depend on the number of threads
+   ROOT::Math::Functor wf5(&f5,5);
+   double a5[5] = {-1,-1,-1,-1,-1};
+   double b5[5] = {1,1,1,1,1};
+   const double RESULT5 = std::pow(ROOT::Math::erf(std::sqrt(2.)), 5);
+   ROOT::Math::AdaptiveIntegratorMultiDim ig5(wf5, 1.E-9, 1.E-6, 1000000);
+   ig5.SetNRegions(8);
+   double val5 = ig5.Integral(a5,b5);
+   ig5.SetNThreads(4);
+   val = ig5.Integral(a5,b5);
+   std::cout << "Cernlib Adaptive 5-dim integral result is " << val << " (8 regions per step, 4 threads)" << std::endl;
+   status += std::fabs(val-RESULT5) > ERRORLIMIT;
+   status += (val != val5);
+
    printTestResult(std::cerr,"multi-dimensional integration",status);
 
    return status;
@@ -0,0 +1,197 @@
+// test and benchmark of the versions on arrays of the pdf and cdf functions
+// (e.g. ROOT::Math::normal_pdf(n, x, y, sigma, x0)) :
+// the values are compared with the ones of the scalar functions and the time to evaluate
+// them on an array of n values is compared with the time of the loop calling the scalar
+// functions
+
+#include "Math/PdfFuncMathCore.h"
+#include "Math/ProbFuncMathCore.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TMath.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace ROOT::Math;
+
+const int kN = 100000;     // size of the arrays
+const int kNTimes = 100;   // number of repetitions for the timing
+bool gVerbose = true;
+
+std::vector<double> gX(kN);
+std::vector<double> gY(kN);
+std::vector<double> gRef(kN);
+
+// scalar and array evaluation of a function
+struct Normal {
+   static const char * Name() { return "normal_pdf"; }
+   double operator() (double x) const { return normal_pdf(x, 1.3, 0.2); }
+   void operator() (int n, const double * x, double * y) const { normal_pdf(n, x, y, 1.3, 0.2); }
+};
+struct LogNormal {
+   static const char * Name() { return "lognormal_pdf"; }
+   double operator() (double x) const { return lognormal_pdf(x, 1., 0.7); }
+   void operator() (int n, const double * x, double * y) const { lognormal_pdf(n, x, y, 1., 0.7); }
+};
+struct Exponential {
+   static const char * Name() { return "exponential_pdf"; }
+   double operator() (double x) const { return exponential_pdf(x, 0.3); }
+   void operator() (int n, const double * x, double * y) const { exponential_pdf(n, x, y, 0.3); }
+};
+struct Gamma {
+   static const char * Name() { return "gamma_pdf"; }
+   double operator() (double x) const { return gamma_pdf(x, 3.5, 2.); }
+   void operator() (int n, const double * x, double * y) const { gamma_pdf(n, x, y, 3.5, 2.); }
+};
+struct BreitWigner {
+   static const char * Name() { return "breitwigner_pdf"; }
+   double operator() (double x) const { return breitwigner_pdf(x, 1.5, 0.3); }
+   void operator() (int n, const double * x, double * y) const { breitwigner_pdf(n, x, y, 1.5, 0.3); }
+};
+struct CrystalBall {
+   static const char * Name() { return "crystalball_function"; }
+   double operator() (double x) const { return crystalball_function(x, 1.5, 3., 1.2, 0.1); }
+   void operator() (int n, const double * x, double * y) const { crystalball_function(n, x, y, 1.5, 3., 1.2, 0.1); }
+};
+struct NormalCdf {
+   static const char * Name() { return "normal_cdf"; }
+   double operator() (double x) const { return normal_cdf(x, 1.3, 0.2); }
+   void operator() (int n, const double * x, double * y) const { normal_cdf(n, x, y, 1.3, 0.2); }
+};
+struct NormalCdfC {
+   static const char * Name() { return "normal_cdf_c"; }
+   double operator() (double x) const { return normal_cdf_c(x, 1.3, 0.2); }
+   void operator() (int n, const double * x, double * y) const { normal_cdf_c(n, x, y, 1.3, 0.2); }
+};
+struct LogNormalCdf {
+   static const char * Name() { return "lognormal_cdf"; }
+   double operator() (double x) const { return lognormal_cdf(x, 1., 0.7); }
+   void operator() (int n, const double * x, double * y) const { lognormal_cdf(n, x, y, 1., 0.7); }
+};
+struct ExponentialCdf {
+   static const char * Name() { return "exponential_cdf"; }
+   double operator() (double x) const { return exponential_cdf(x, 0.3); }
+   void operator() (int n, const double * x, double * y) const { exponential_cdf(n, x, y, 0.3); }
+};
+
+// compare the array and the scalar versions on values uniform in [xmin,xmax]
+// and print the time of both
+template <class Func>
+int testFunc(double xmin, double xmax, double tol) {
+
+   Func f;
+   TRandom3 r(111);
+   for (int i = 0; i < kN; ++i) gX[i] = r.Uniform(xmin, xmax);
+
+   TStopwatch w;
+   double s = 0;
+   w.Start();
+   for (int itime = 0; itime < kNTimes; ++itime) {
+      for (int i = 0; i < kN; ++i) gRef[i] = f(gX[i]);
+      s += gRef[itime];
+   }
+   w.Stop();
+   double tScalar = w.RealTime();
+   w.Start();
+   for (int itime = 0; itime < kNTimes; ++itime) {
+      f(kN, &gX[0], &gY[0]);
+      s += gY[itime];
+   }
+   w.Stop();
+   double tArray = w.RealTime();
+
+   double maxDiff = 0;
+   for (int i = 0; i < kN; ++i) {
+      if (gY[i] == gRef[i]) continue;
+      double diff = TMath::Abs(gY[i] - gRef[i]);
+      if (gRef[i] != 0) diff /= TMath::Abs(gRef[i]);
+      // values which are not equal must differ also for nan's
+      if (!(diff <= maxDiff)) maxDiff = diff;
+   }
+   bool ok = (maxDiff <= tol);
+
+   if (gVerbose)
+      std::cout << std::setw(22) << std::left << Func::Name()
+                << " max rel. diff " << std::setw(12) << maxDiff
+                << " time scalar " << std::setw(8) << tScalar
+                << " array " << std::setw(8) << tArray
+                << "  (" << ((tArray > 0) ? tScalar/tArray : 0) << ")"
+                << (ok ? "\t OK" : "\t FAILED") << std::endl;
+   return ok ? 0 : 1;
+}
+
+int testPoisson(double tol) {
+
+   TRandom3 r(222);
+   std::vector<unsigned int> k(kN);
+   std::vector<double> mu(kN);
+   for (int i = 0; i < kN; ++i) {
+      mu[i] = r.Uniform(0, 30);
+      k[i] = r.Poisson(mu[i]);
+   }
+   // special values
+   k[0] = 0; mu[0] = 0;
+   k[1] = 3; mu[1] = 0;
+
+   TStopwatch w;
+   double s = 0;
+   w.Start();
+   for (int itime = 0; itime < kNTimes; ++itime) {
+      for (int i = 0; i < kN; ++i) gRef[i] = poisson_pdf(k[i], mu[i]);
+      s += gRef[itime];
+   }
+   w.Stop();
+   double tScalar = w.RealTime();
+   w.Start();
+   for (int itime = 0; itime < kNTimes; ++itime) {
+      poisson_pdf(kN, &k[0], &mu[0], &gY[0]);
+      s += gY[itime];
+   }
+   w.Stop();
+   double tArray = w.RealTime();
+
+   double maxDiff = 0;
+   for (int i = 0; i < kN; ++i) {
+      if (gY[i] == gRef[i]) continue;
+      double diff = TMath::Abs(gY[i] - gRef[i])/TMath::Abs(gRef[i]);
+      if (!(diff <= maxDiff)) maxDiff = diff;
+   }
+   bool ok = (maxDiff <= tol);
+
+   if (gVerbose)
+      std::cout << std::setw(22) << std::left << "poisson_pdf"
+                << " max rel. diff " << std::setw(12) << maxDiff
+                << " time scalar " << std::setw(8) << tScalar
+                << " array " << std::setw(8) << tArray
+                << "  (" << ((tArray > 0) ? tScalar/tArray : 0) << ")"
+                << (ok ? "\t OK" : "\t FAILED") << std::endl;
+   return ok ? 0 : 1;
+}
+
+int testPdfFuncArray() {
+
+   int iret = 0;
+   std::cout << "Evaluation of " << kNTimes << " times " << kN << " values (time in s, speed-up in parenthesis)" << std::endl;
+   iret |= testFunc<Normal>(-10, 10, 1.E-15);
+   iret |= testFunc<LogNormal>(0, 50, 1.E-13);
+   iret |= testFunc<Exponential>(-1, 100, 1.E-15);
+   iret |= testFunc<Gamma>(-1, 50, 1.E-14);
+   iret |= testFunc<BreitWigner>(-10, 10, 1.E-15);
+   iret |= testFunc<CrystalBall>(-20, 5, 1.E-14);
+   iret |= testFunc<NormalCdf>(-20, 10, 1.E-15);
+   iret |= testFunc<NormalCdfC>(-10, 20, 1.E-15);
+   iret |= testFunc<LogNormalCdf>(0, 50, 1.E-13);
+   iret |= testFunc<ExponentialCdf>(-1, 100, 1.E-15);
+   iret |= testPoisson(1.E-13);
+
+   if (iret != 0) std::cerr << "testPdfFuncArray: test FAILED !!! " << std::endl;
+   else std::cout << "testPdfFuncArray: all tests OK" << std::endl;
+   return iret;
+}
+
+int main(int argc, char **) {
+   if (argc > 1) gVerbose = false;
+   return testPdfFuncArray();
+}
@@ -66,3 +66,10 @@ distclean-$(MODNAME): clean-$(MODNAME)
 		@rm -f $(MATRIXDEP) $(MATRIXDS) $(MATRIXDH) $(MATRIXLIB) $(MATRIXMAP)
 
 distclean::     distclean-$(MODNAME)
+
+# for openMP (parallel matrix multiplication and decompositions)
+ifneq ($(USE_OPENMP),)
+$(call stripsrc,$(MATRIXDIRS)/TMatrixT.o $(MATRIXDIRS)/TDecompLU.o \
+   $(MATRIXDIRS)/TDecompChol.o): CXXFLAGS += -fopenmp
+$(MATRIXLIB): LDFLAGS += -fopenmp
+endif
@@ -61,6 +61,7 @@ protected :
    };
 
    enum {kWorkMax = 100}; // size of work array's in several routines
+   enum {kBlockSize = 32}; // number of rows/columns per block in the blocked decompositions
 
 public :
    TDecompBase();
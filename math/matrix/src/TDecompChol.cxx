@@ -115,31 +115,62 @@ Bool_t TDecompChol::Decompose()
    Int_t i,j,icol,irow;
    const Int_t     n  = fU.GetNrows();
          Double_t *pU = fU.GetMatrixArray();
-   for (icol = 0; icol < n; icol++) {
-      const Int_t rowOff = icol*n;
-
-      //Compute fU(j,j) and test for non-positive-definiteness.
-      Double_t ujj = pU[rowOff+icol];
-      for (irow = 0; irow < icol; irow++) {
-         const Int_t pos_ij = irow*n+icol;
-         ujj -= pU[pos_ij]*pU[pos_ij];
-      }
-      if (ujj <= 0) {
-         Error("Decompose()","matrix not positive definite");
-         return kFALSE;
+
+   // The rows of fU are computed in blocks of kBlockSize. Before a block is
+   // factorized, the contributions of all the rows above it are subtracted at
+   // once, in parallel over chunks of columns when compiled with OpenMP. Each
+   // element gets the terms subtracted in the same order as in the unblocked
+   // algorithm, so the result is identical.
+   const Int_t colChunk = 8*kBlockSize;
+   for (Int_t icol0 = 0; icol0 < n; icol0 += kBlockSize) {
+      const Int_t icol1 = TMath::Min(icol0+kBlockSize,n);
+
+      if (icol0 > 0) {
+         const Int_t nchunk = (n-icol0+colChunk-1)/colChunk;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (nchunk > 1)
+#endif
+         for (Int_t ichunk = 0; ichunk < nchunk; ichunk++) {
+            const Int_t j0 = icol0+ichunk*colChunk;
+            const Int_t j1 = TMath::Min(j0+colChunk,n);
+            for (Int_t k = 0; k < icol0; k++) {
+               const Double_t * const pUk = pU+k*n;
+               for (Int_t r = icol0; r < icol1 && r < j1; r++) {
+                  const Double_t ukr = pUk[r];
+                  Double_t * const pUr = pU+r*n;
+                  for (Int_t jj = TMath::Max(j0,r); jj < j1; jj++)
+                     pUr[jj] -= pUk[jj]*ukr;
+               }
+            }
+         }
       }
-      ujj = TMath::Sqrt(ujj);
-      pU[rowOff+icol] = ujj;
 
-      if (icol < n-1) {
-         for (j = icol+1; j < n; j++) {
-            for (i = 0; i < icol; i++) {
+      for (icol = icol0; icol < icol1; icol++) {
+         const Int_t rowOff = icol*n;
+
+         //Compute fU(j,j) and test for non-positive-definiteness.
+         Double_t ujj = pU[rowOff+icol];
+         for (irow = icol0; irow < icol; irow++) {
+            const Int_t pos_ij = irow*n+icol;
+            ujj -= pU[pos_ij]*pU[pos_ij];
+         }
+         if (ujj <= 0) {
+            Error("Decompose()","matrix not positive definite");
+            return kFALSE;
+         }
+         ujj = TMath::Sqrt(ujj);
+         pU[rowOff+icol] = ujj;
+
+         if (icol < n-1) {
+            for (i = icol0; i < icol; i++) {
                const Int_t rowOff2 = i*n;
-               pU[rowOff+j] -= pU[rowOff2+j]*pU[rowOff2+icol];
+               const Double_t uic = pU[rowOff2+icol];
+               for (j = icol+1; j < n; j++)
+                  pU[rowOff+j] -= pU[rowOff2+j]*uic;
             }
+            for (j = icol+1; j < n; j++)
+               pU[rowOff+j] /= ujj;
          }
-         for (j = icol+1; j < n; j++)
-            pU[rowOff+j] /= ujj;
       }
    }
 
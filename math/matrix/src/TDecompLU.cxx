@@ -587,6 +587,45 @@ TDecompLU &TDecompLU::operator=(const TDecompLU &source)
    return *this;
 }
 
+//______________________________________________________________________________
+static void UpdateRightOfPanel(Double_t *pLU,Int_t n,Int_t j0,Int_t j1)
+{
+// Apply the elimination steps of the columns [j0,j1) (the panel) of the LU
+// decomposition in pLU (n x n) to the columns right of the panel: first to
+// the rows of U, then, at once, to the trailing sub-matrix, in parallel over
+// its rows when compiled with OpenMP. The columns right of the panel are
+// processed in chunks so that the rows of U used stay in the cache.
+
+   if (j1 >= n) return;
+
+   for (Int_t i = j0+1; i < j1; i++) {
+      const Int_t off_i = i*n;
+      for (Int_t j = j0; j < i; j++) {
+         const Double_t mLUij = pLU[off_i+j];
+         const Double_t * const pUj = pLU+j*n;
+         for (Int_t k = j1; k < n; k++)
+            pLU[off_i+k] -= mLUij*pUj[k];
+      }
+   }
+
+   const Int_t kChunk = 256;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (n-j1 > j1-j0)
+#endif
+   for (Int_t i = j1; i < n; i++) {
+      const Int_t off_i = i*n;
+      for (Int_t k0 = j1; k0 < n; k0 += kChunk) {
+         const Int_t k1 = TMath::Min(k0+kChunk,n);
+         for (Int_t j = j0; j < j1; j++) {
+            const Double_t mLUij = pLU[off_i+j];
+            const Double_t * const pUj = pLU+j*n;
+            for (Int_t k = k0; k < k1; k++)
+               pLU[off_i+k] -= mLUij*pUj[k];
+         }
+      }
+   }
+}
+
 //______________________________________________________________________________
 Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
                                    Double_t tol,Int_t &nrZeros)
@@ -622,70 +661,68 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
       scale[i] = (max == 0.0 ? 0.0 : 1.0/max);
    }
 
-   for (Int_t j = 0; j < n; j++) {
-      const Int_t off_j = j*n;
-      // Run down jth column from top to diag, to form the elements of U.
-      for (Int_t i = 0; i < j; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < i; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-      }
+   // The elimination is done in panels of kBlockSize columns, with the updates
+   // outside of the panel delayed (see UpdateRightOfPanel). Each element gets the
+   // terms subtracted in the same order as in the column-wise Crout algorithm, so
+   // the result is identical.
+   for (Int_t j0 = 0; j0 < n; j0 += kBlockSize) {
+      const Int_t j1 = TMath::Min(j0+kBlockSize,n);
 
-      // Run down jth subdiag to form the residuals after the elimination of
-      // the first j-1 subdiags.  These residuals divided by the appropriate
-      // diagonal term will become the multipliers in the elimination of the jth.
-      // subdiag. Find fIndex of largest scaled term in imax.
+      for (Int_t j = j0; j < j1; j++) {
+         const Int_t off_j = j*n;
 
-      Double_t max = 0.0;
-      Int_t imax = 0;
-      for (Int_t i = j; i < n; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < j; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-         const Double_t tmp = scale[i]*TMath::Abs(r);
-         if (tmp >= max) {
-            max = tmp;
-            imax = i;
+         // The jth column, from top to diag, holds the elements of U. Run down
+         // the jth subdiag holding the residuals after the elimination of the
+         // first j-1 subdiags.  These residuals divided by the appropriate
+         // diagonal term will become the multipliers in the elimination of the jth.
+         // subdiag. Find fIndex of largest scaled term in imax.
+
+         Double_t max = 0.0;
+         Int_t imax = 0;
+         for (Int_t i = j; i < n; i++) {
+            const Double_t tmp = scale[i]*TMath::Abs(pLU[i*n+j]);
+            if (tmp >= max) {
+               max = tmp;
+               imax = i;
+            }
          }
-      }
 
-      // Permute current row with imax
-      if (j != imax) {
-         const Int_t off_imax = imax*n;
-         for (Int_t k = 0; k < n; k++ ) {
-            const Double_t tmp = pLU[off_imax+k];
-            pLU[off_imax+k] = pLU[off_j+k];
-            pLU[off_j+k]    = tmp;
+         // Permute current row with imax
+         if (j != imax) {
+            const Int_t off_imax = imax*n;
+            for (Int_t k = 0; k < n; k++ ) {
+               const Double_t tmp = pLU[off_imax+k];
+               pLU[off_imax+k] = pLU[off_j+k];
+               pLU[off_j+k]    = tmp;
+            }
+            sign = -sign;
+            scale[imax] = scale[j];
          }
-         sign = -sign;
-         scale[imax] = scale[j];
-      }
-      index[j] = imax;
-
-      // If diag term is not zero divide subdiag to form multipliers.
-      if (pLU[off_j+j] != 0.0) {
-         if (TMath::Abs(pLU[off_j+j]) < tol)
-            nrZeros++;
-         if (j != n-1) {
-            const Double_t tmp = 1.0/pLU[off_j+j];
-            for (Int_t i = j+1; i < n; i++) {
-               const Int_t off_i = i*n;
-               pLU[off_i+j] *= tmp;
+         index[j] = imax;
+
+         // If diag term is not zero divide subdiag to form multipliers.
+         if (pLU[off_j+j] != 0.0) {
+            if (TMath::Abs(pLU[off_j+j]) < tol)
+               nrZeros++;
+            if (j != n-1) {
+               const Double_t tmp = 1.0/pLU[off_j+j];
+               for (Int_t i = j+1; i < n; i++) {
+                  const Int_t off_i = i*n;
+                  pLU[off_i+j] *= tmp;
+                  // eliminate in the rest of the panel
+                  const Double_t mLUij = pLU[off_i+j];
+                  for (Int_t k = j+1; k < j1; k++)
+                     pLU[off_i+k] -= mLUij*pLU[off_j+k];
+               }
             }
+         } else {
+            ::Error("TDecompLU::DecomposeLUCrout","matrix is singular");
+            if (isAllocated)  delete [] scale;
+            return kFALSE;
          }
-      } else {
-         ::Error("TDecompLU::DecomposeLUCrout","matrix is singular");
-         if (isAllocated)  delete [] scale;
-         return kFALSE;
       }
+
+      UpdateRightOfPanel(pLU,n,j0,j1);
    }
 
    if (isAllocated)
@@ -712,56 +749,66 @@ Bool_t TDecompLU::DecomposeLUGauss(TMatrixD &lu,Int_t *index,Double_t &sign,
    sign    = 1.0;
    nrZeros = 0;
 
+   // The elimination is done in panels of kBlockSize columns, with the updates
+   // outside of the panel delayed (see UpdateRightOfPanel). Each element gets the
+   // updates in the same order as in the unblocked algorithm, so the result is
+   // identical.
    index[n-1] = n-1;
-   for (Int_t j = 0; j < n-1; j++) {
-      const Int_t off_j = j*n;
+   for (Int_t j0 = 0; j0 < n-1; j0 += kBlockSize) {
+      const Int_t j1 = TMath::Min(j0+kBlockSize,n);
 
-      // Find maximum in the j-th column
+      for (Int_t j = j0; j < j1 && j < n-1; j++) {
+         const Int_t off_j = j*n;
 
-      Double_t max = TMath::Abs(pLU[off_j+j]);
-      Int_t i_pivot = j;
+         // Find maximum in the j-th column
 
-      for (Int_t i = j+1; i < n; i++) {
-         const Int_t off_i = i*n;
-         const Double_t mLUij = TMath::Abs(pLU[off_i+j]);
+         Double_t max = TMath::Abs(pLU[off_j+j]);
+         Int_t i_pivot = j;
 
-         if (mLUij > max) {
-            max = mLUij;
-            i_pivot = i;
-         }
-      }
-  
-      if (i_pivot != j) {
-         const Int_t off_ipov = i_pivot*n;
-         for (Int_t k = 0; k < n; k++ ) {
-            const Double_t tmp = pLU[off_ipov+k];
-            pLU[off_ipov+k] = pLU[off_j+k];
-            pLU[off_j+k]    = tmp;
+         for (Int_t i = j+1; i < n; i++) {
+            const Int_t off_i = i*n;
+            const Double_t mLUij = TMath::Abs(pLU[off_i+j]);
+
+            if (mLUij > max) {
+               max = mLUij;
+               i_pivot = i;
+            }
          }
-         sign = -sign;
-      }
-      index[j] = i_pivot;
 
-      const Double_t mLUjj = pLU[off_j+j];
+         if (i_pivot != j) {
+            const Int_t off_ipov = i_pivot*n;
+            for (Int_t k = 0; k < n; k++ ) {
+               const Double_t tmp = pLU[off_ipov+k];
+               pLU[off_ipov+k] = pLU[off_j+k];
+               pLU[off_j+k]    = tmp;
+            }
+            sign = -sign;
+         }
+         index[j] = i_pivot;
 
-      if (mLUjj != 0.0) {
-         if (TMath::Abs(mLUjj) < tol)
-            nrZeros++;
-         for (Int_t i = j+1; i < n; i++) {
-            const Int_t off_i = i*n;
-            const Double_t mLUij = pLU[off_i+j]/mLUjj;
-            pLU[off_i+j] = mLUij;
+         const Double_t mLUjj = pLU[off_j+j];
 
-            for (Int_t k = j+1; k < n; k++) {
-               const Double_t mLUik = pLU[off_i+k];
-               const Double_t mLUjk = pLU[off_j+k];
-               pLU[off_i+k] = mLUik-mLUij*mLUjk;
+         if (mLUjj != 0.0) {
+            if (TMath::Abs(mLUjj) < tol)
+               nrZeros++;
+            for (Int_t i = j+1; i < n; i++) {
+               const Int_t off_i = i*n;
+               const Double_t mLUij = pLU[off_i+j]/mLUjj;
+               pLU[off_i+j] = mLUij;
+
+               for (Int_t k = j+1; k < j1; k++) {
+                  const Double_t mLUik = pLU[off_i+k];
+                  const Double_t mLUjk = pLU[off_j+k];
+                  pLU[off_i+k] = mLUik-mLUij*mLUjk;
+               }
             }
+         } else {
+            ::Error("TDecompLU::DecomposeLUGauss","matrix is singular");
+            return kFALSE;
          }
-      } else {
-         ::Error("TDecompLU::DecomposeLUGauss","matrix is singular");
-         return kFALSE;
       }
+
+      UpdateRightOfPanel(pLU,n,j0,j1);
    }
 
    return kTRUE;
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <typeinfo>
+#include <vector>
 
 #include "TMatrixT.h"
 #include "TMatrixTSym.h"
@@ -3071,12 +3072,75 @@ TMatrixT<Element> &ElementDiv(TMatrixT<Element> &target,const TMatrixTSym<Elemen
    return target;
 }
 
+namespace {
+
+   // Block sizes of the cache-blocked matrix multiplication: C is computed in
+   // blocks of kMultRowBlock rows (one block per thread), kMultColBlock columns
+   // and kMultInnerBlock terms at a time, so that the block of B fits in the cache
+   const Int_t kMultRowBlock   = 32;
+   const Int_t kMultColBlock   = 256;
+   const Int_t kMultInnerBlock = 128;
+
+   // products with less multiply-adds are computed with the simple loops
+   const Double_t kMultMinBlocked = 32.*32.*32.;
+
+//______________________________________________________________________________
+template<class Element>
+void BlockedMult(const Element * const ap,Int_t inca_row,Int_t inca_col,
+                 const Element * const bp,Int_t nrowsc,Int_t ncolsc,Int_t ninner,Element *cp)
+{
+// Cache-blocked matrix multiplication C = A * B, with B (ninner x ncolsc) and
+// C (nrowsc x ncolsc) stored row-wise and A[i,k] = ap[i*inca_row+k*inca_col] .
+// Each element of C is summed in the same order (k = 0,..,ninner-1) as in the
+// simple loops, so the result is identical to them. The inner loop runs over
+// contiguous elements of B and C and can be vectorized by the compiler.
+// The blocks of rows of C are computed in parallel when compiled with OpenMP.
+
+   const Int_t nrowblocks = (nrowsc+kMultRowBlock-1)/kMultRowBlock;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (nrowblocks > 1)
+#endif
+   for (Int_t iblock = 0; iblock < nrowblocks; iblock++) {
+      const Int_t irow0 = iblock*kMultRowBlock;
+      const Int_t irow1 = TMath::Min(irow0+kMultRowBlock,nrowsc);
+      Element * const cbp = cp+irow0*ncolsc;
+      const Int_t nc = (irow1-irow0)*ncolsc;
+      for (Int_t i = 0; i < nc; i++)
+         cbp[i] = 0;
+      for (Int_t jcol0 = 0; jcol0 < ncolsc; jcol0 += kMultColBlock) {
+         const Int_t jcol1 = TMath::Min(jcol0+kMultColBlock,ncolsc);
+         for (Int_t k0 = 0; k0 < ninner; k0 += kMultInnerBlock) {
+            const Int_t k1 = TMath::Min(k0+kMultInnerBlock,ninner);
+            for (Int_t irow = irow0; irow < irow1; irow++) {
+               Element * const crp = cp+irow*ncolsc;
+               const Element * const arp = ap+irow*inca_row;
+               for (Int_t k = k0; k < k1; k++) {
+                  const Element aik = arp[k*inca_col];
+                  const Element * const brp = bp+k*ncolsc;
+                  for (Int_t j = jcol0; j < jcol1; j++)
+                     crp[j] += aik*brp[j];
+               }
+            }
+         }
+      }
+   }
+}
+
+}
+
 //______________________________________________________________________________
 template<class Element>
 void AMultB(const Element * const ap,Int_t na,Int_t ncolsa,
             const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
 // Elementary routine to calculate matrix multiplication A*B
+// Large matrices are multiplied block-wise (see BlockedMult), with identical result.
+
+   if (ncolsa > 0 && Double_t(na)*ncolsb >= kMultMinBlocked) {
+      BlockedMult(ap,ncolsa,1,bp,na/ncolsa,ncolsb,ncolsa,cp);
+      return;
+   }
 
    const Element *arp0 = ap;                     // Pointer to  A[i,0];
    while (arp0 < ap+na) {
@@ -3100,6 +3164,12 @@ void AtMultB(const Element * const ap,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
 // Elementary routine to calculate matrix multiplication A^T*B
+// Large matrices are multiplied block-wise (see BlockedMult), with identical result.
+
+   if (ncolsb > 0 && Double_t(nb)*ncolsa >= kMultMinBlocked) {
+      BlockedMult(ap,1,ncolsa,bp,ncolsa,ncolsb,nb/ncolsb,cp);
+      return;
+   }
 
    const Element *acp0 = ap;           // Pointer to  A[i,0];
    while (acp0 < ap+ncolsa) {
@@ -3124,6 +3194,20 @@ void AMultBt(const Element * const ap,Int_t na,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
 // Elementary routine to calculate matrix multiplication A*B^T
+// For large matrices B is transposed in a work array and the product is computed
+// block-wise (see BlockedMult), with identical result.
+
+   if (ncolsa > 0 && ncolsb > 0 && Double_t(na)*(nb/ncolsb) >= kMultMinBlocked) {
+      const Int_t nrowsb = nb/ncolsb;
+      std::vector<Element> bt(nb);
+      for (Int_t irow = 0; irow < nrowsb; irow++) {
+         const Element * const brp = bp+irow*ncolsb;
+         for (Int_t icol = 0; icol < ncolsb; icol++)
+            bt[icol*nrowsb+irow] = brp[icol];
+      }
+      BlockedMult(ap,ncolsa,1,&bt[0],na/ncolsa,nrowsb,ncolsa,cp);
+      return;
+   }
 
    const Element *arp0 = ap;                    // Pointer to  A[i,0];
    while (arp0 < ap+na) {
@@ -122,6 +122,13 @@ $(MINUIT2O): CXXFLAGS += -DWARNINGMSG -DUSE_ROOT_ERROR
 $(MINUIT2DO): CXXFLAGS += -DWARNINGMSG -DUSE_ROOT_ERROR
 #for thread -safet
 #$(MINUIT2O): CXXFLAGS += -DMINUIT2_THREAD_SAFE
+# for openMP (threaded numerical gradient and Hessian, see MnStrategy::SetNumberOfThreads)
+ifneq ($(USE_OPENMP),)
+MINUIT2OMPO := $(call stripsrc,$(addprefix $(MINUIT2DIRS)/,MnFcn.o MnUserFcn.o \
+                  Numerical2PGradientCalculator.o HessianGradientCalculator.o MnHesse.o))
+$(MINUIT2OMPO): CXXFLAGS += -fopenmp
+$(MINUIT2LIB): LDFLAGS += -fopenmp
+endif
 # for openMP 
 ifneq ($(USE_PARALLEL_MINUIT2),)
 ifneq ($(USE_OPENMP),)
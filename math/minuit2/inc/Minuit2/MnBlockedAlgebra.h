@@ -0,0 +1,56 @@
+// @(#)root/minuit2:$Id$
+// Author: L. Moneta    2013
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2013 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnBlockedAlgebra
+#define ROOT_Minuit2_MnBlockedAlgebra
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+/**
+   Switch for the cache-friendly kernels used for the large symmetric
+   matrices (fits with many hundreds of parameters):
+
+   - Invert (used by MnHesse, MnUserParameterState, ...) uses a blocked
+     Cholesky factorization and inversion instead of mnvert. A matrix which
+     is not positive definite is still inverted by mnvert.
+   - DavidonErrorUpdator makes the rank-2 (or rank-3) update of the error
+     matrix and the sums of its elements in one pass over the matrix,
+     instead of one pass for each outer product and each sum.
+
+   The results agree with the standard ones within the rounding errors.
+   The kernels are used for matrices of size at least MinSize(); by default
+   they are not used (MinSize() == 0).
+ */
+
+class MnBlockedAlgebra {
+
+public:
+
+   /// set the minimum matrix size for using the blocked kernels (0 = never)
+   /// and return the previous one
+   static unsigned int SetMinSize(unsigned int n);
+
+   /// return the minimum matrix size for using the blocked kernels
+   static unsigned int MinSize();
+
+   /// return true if the blocked kernels are used for a matrix of size n
+   static bool Use(unsigned int n) {
+      unsigned int nmin = MinSize();
+      return nmin > 0 && n >= nmin;
+   }
+
+};
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnBlockedAlgebra
@@ -22,6 +22,9 @@ namespace ROOT {
              Minos (lowers strategy by 1 for Minos-own minimization), 
 	     Hesse (iterations), 
 	     Numerical2PDerivative (iterations)
+    The loops over the parameters in the numerical gradient and Hessian can
+    run in parallel threads (see SetNumberOfThreads), when compiled with OpenMP,
+    giving the same results as the serial ones.
  */
 
 class MnStrategy {
@@ -46,6 +49,10 @@ public:
    double HessianStepTolerance() const {return fHessTlrStp;}
    double HessianG2Tolerance() const {return fHessTlrG2;}
    unsigned int HessianGradientNCycles() const {return fHessGradNCyc;}
+
+   // number of threads used for the numerical gradient and Hessian
+   // (1 = serial, 0 = OpenMP default). Requires a thread-safe FCN
+   unsigned int NumberOfThreads() const {return fNThreads;}
   
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
@@ -63,6 +70,8 @@ public:
    void SetHessianStepTolerance(double stp) {fHessTlrStp = stp;}
    void SetHessianG2Tolerance(double toler) {fHessTlrG2 = toler;}
    void SetHessianGradientNCycles(unsigned int n) {fHessGradNCyc = n;}
+
+   void SetNumberOfThreads(unsigned int n) {fNThreads = n;}
   
 private:
 
@@ -75,6 +84,7 @@ private:
    double fHessTlrStp;
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
+   unsigned int fNThreads;
 };
 
   }  // namespace Minuit2
@@ -11,6 +11,7 @@
 #include "Minuit2/MinimumState.h"
 #include "Minuit2/LaSum.h"
 #include "Minuit2/LaProd.h"
+#include "Minuit2/MnBlockedAlgebra.h"
 
 //#define DEBUG 
 
@@ -28,6 +29,8 @@ namespace ROOT {
 double inner_product(const LAVector&, const LAVector&);
 double similarity(const LAVector&, const LASymMatrix&);
 double sum_of_elements(const LASymMatrix&);
+void Davidon_update(unsigned int, const double*, const double*, double, const double*, double,
+                    const double*, double*, double&, double&);
 
 MinimumError DavidonErrorUpdator::Update(const MinimumState& s0, 
                                          const MinimumParameters& p1,
@@ -42,7 +45,9 @@ MinimumError DavidonErrorUpdator::Update(const MinimumState& s0,
    MnAlgebraicVector dg = g1.Vec() - s0.Gradient().Vec();
   
    double delgam = inner_product(dx, dg);
-   double gvg = similarity(dg, v0);
+   // same as similarity(dg, v0), without computing v0*dg twice
+   MnAlgebraicVector vg = v0*dg;
+   double gvg = inner_product(dg, vg);
 
 
 #ifdef DEBUG
@@ -69,8 +74,20 @@ MinimumError DavidonErrorUpdator::Update(const MinimumState& s0,
       return s0.Error();
    }
 
-
-   MnAlgebraicVector vg = v0*dg;
+   if (MnBlockedAlgebra::Use(v0.Nrow())) {
+      // whole update in one pass over the matrix
+      MnAlgebraicSymMatrix v1(v0.Nrow());
+      double sum_upd = 0;
+      double sum_v1 = 0;
+      if (delgam > gvg) {
+         MnAlgebraicVector flnu = dx/delgam - vg/gvg;
+         Davidon_update(v0.Nrow(), v0.Data(), dx.Data(), delgam, vg.Data(), gvg, flnu.Data(), v1.Data(), sum_upd, sum_v1);
+      }
+      else
+         Davidon_update(v0.Nrow(), v0.Data(), dx.Data(), delgam, vg.Data(), gvg, 0, v1.Data(), sum_upd, sum_v1);
+      double dcov = 0.5*(s0.Error().Dcovar() + sum_upd/sum_v1);
+      return MinimumError(v1, dcov);
+   }
 
    MnAlgebraicSymMatrix vUpd = Outer_product(dx)/delgam - Outer_product(vg)/gvg;
 
@@ -25,6 +25,7 @@
 #endif
 
 #include "Minuit2/MPIProcess.h"
+#include "MnThreads.h"
 
 namespace ROOT {
 
@@ -70,7 +71,6 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    // calculate gradient for Hessian
    assert(par.IsValid());
    
-   MnAlgebraicVector x = par.Vec();
    MnAlgebraicVector grd = Gradient.Grad();
    const MnAlgebraicVector& g2 = Gradient.G2();
    //const MnAlgebraicVector& gstep = Gradient.Gstep();
@@ -82,7 +82,7 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    
    double dfmin = 4.*Precision().Eps2()*(fabs(fcnmin)+Fcn().Up());
    
-   unsigned int n = x.size();
+   unsigned int n = par.Vec().size();
    MnAlgebraicVector dgrd(n);
    
    MPIProcess mpiproc(n,0);
@@ -90,7 +90,19 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
    unsigned int startElementIndex = mpiproc.StartElementIndex();
    unsigned int endElementIndex = mpiproc.EndElementIndex();
 
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
+   // loop on the parameters, in parallel threads if requested
+   // (see MnStrategy::SetNumberOfThreads), each one with its own copy of x
+#ifdef _OPENMP
+   int nthreads = NumberOfThreads(Strategy(), mpiproc.GetMPISize());
+#pragma omp parallel num_threads(nthreads)
+#endif
+   {
+   MnAlgebraicVector x = par.Vec();
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+   for(int i = int(startElementIndex); i < int(endElementIndex); i++) {
       double xtf = x(i);
       double dmin = 4.*Precision().Eps2()*(xtf + Precision().Eps2());
       double epspri = Precision().Eps2() + fabs(grd(i)*Precision().Eps2());
@@ -136,6 +148,7 @@ std::pair<FunctionGradient, MnAlgebraicVector> HessianGradientCalculator::DeltaG
 #endif
 
    }
+   }
    
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(gstep);
@@ -9,6 +9,7 @@
 
 #include "Minuit2/LaInverse.h"
 #include "Minuit2/LASymMatrix.h"
+#include "Minuit2/MnBlockedAlgebra.h"
 
 namespace ROOT {
 
@@ -16,12 +17,14 @@ namespace ROOT {
 
 
 int mnvert(LASymMatrix& t);
+int Invert_blocked(LASymMatrix& t);
 
 // symmetric matrix (positive definite only)
 
 int Invert(LASymMatrix& t) {
    // function for inversion of symmetric matrices using  mnvert function 
-   // (from Fortran Minuit)
+   // (from Fortran Minuit) or, for large matrices when enabled with
+   // MnBlockedAlgebra::SetMinSize, the blocked Cholesky inversion
    
    int ifail = 0;
    
@@ -29,7 +32,10 @@ int Invert(LASymMatrix& t) {
       double tmp = t.Data()[0];
       if(!(tmp > 0.)) ifail = 1;
       else t.Data()[0] = 1./tmp;
+   } else if (MnBlockedAlgebra::Use(t.Nrow()) && Invert_blocked(t) == 0) {
+      ifail = 0;
    } else {
+      // matrices not positive definite are also inverted here
       ifail = mnvert(t);
    }
    
@@ -349,6 +349,7 @@ bool Minuit2Minimizer::Minimize() {
       int nGradCycles = strategy.GradientNCycles();
       int nHessCycles = strategy.HessianNCycles();
       int nHessGradCycles = strategy.HessianGradientNCycles();
+      int nThreads = strategy.NumberOfThreads();
 
       double gradTol =  strategy.GradientTolerance();
       double gradStepTol = strategy.GradientStepTolerance();
@@ -358,6 +359,7 @@ bool Minuit2Minimizer::Minimize() {
       minuit2Opt->GetValue("GradientNCycles",nGradCycles);
       minuit2Opt->GetValue("HessianNCycles",nHessCycles);
       minuit2Opt->GetValue("HessianGradientNCycles",nHessGradCycles);
+      minuit2Opt->GetValue("NumberOfThreads",nThreads);
 
       minuit2Opt->GetValue("GradientTolerance",gradTol);
       minuit2Opt->GetValue("GradientStepTolerance",gradStepTol);
@@ -367,6 +369,7 @@ bool Minuit2Minimizer::Minimize() {
       strategy.SetGradientNCycles(nGradCycles);      
       strategy.SetHessianNCycles(nHessCycles);
       strategy.SetHessianGradientNCycles(nHessGradCycles);
+      strategy.SetNumberOfThreads(nThreads);
 
       strategy.SetGradientTolerance(gradTol);
       strategy.SetGradientStepTolerance(gradStepTol);
@@ -896,7 +899,16 @@ bool Minuit2Minimizer::Hesse( ) {
    // set the precision if needed
    if (Precision() > 0) fState.SetPrecision(Precision());
 
-   ROOT::Minuit2::MnHesse hesse( strategy );
+   // threads for the numerical derivatives (see MnStrategy::SetNumberOfThreads)
+   ROOT::Minuit2::MnStrategy mnStrategy(strategy);
+   ROOT::Math::IOptions * minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
+   if (minuit2Opt) {
+      int nThreads = mnStrategy.NumberOfThreads();
+      minuit2Opt->GetValue("NumberOfThreads",nThreads);
+      mnStrategy.SetNumberOfThreads(nThreads);
+   }
+
+   ROOT::Minuit2::MnHesse hesse( mnStrategy );
 
    // case when function minimum exists
    if (fMinimum  ) { 
@@ -0,0 +1,227 @@
+// @(#)root/minuit2:$Id$
+// Author: L. Moneta    2013
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2013 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#include "Minuit2/MnBlockedAlgebra.h"
+#include "Minuit2/LASymMatrix.h"
+
+#include <vector>
+#include <cmath>
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+
+unsigned int gBlockedAlgebraMinSize = 0;
+
+unsigned int MnBlockedAlgebra::SetMinSize(unsigned int n) {
+   unsigned int prevSize = gBlockedAlgebraMinSize;
+   gBlockedAlgebraMinSize = n;
+   return prevSize;
+}
+
+unsigned int MnBlockedAlgebra::MinSize() {
+   return gBlockedAlgebraMinSize;
+}
+
+
+// The symmetric matrices are stored packed: the element (i,j) with j <= i is
+// at i*(i+1)/2 + j, so that the rows of the lower triangle are contiguous.
+// The blocked algorithms below work on these rows with blocks of kBlock rows
+// (the tiles of kBlock x kBlock elements used in the inner loops fit in the
+// L1/L2 caches).
+
+namespace {
+
+   const unsigned int kBlock = 64;
+
+   inline unsigned int RowOffset(unsigned int i) { return i*(i+1)/2; }
+
+   inline unsigned int Min(unsigned int a, unsigned int b) { return a < b ? a : b; }
+
+   // Cholesky factorization A = L L^T in place (right-looking, blocked):
+   // return false if the matrix is not positive definite
+   bool Cholesky(unsigned int n, double * a) {
+      for (unsigned int kb = 0; kb < n; kb += kBlock) {
+         const unsigned int ke = Min(kb + kBlock, n);
+         // columns kb..ke-1 (diagonal block and panel below), the contributions
+         // of the columns before kb have already been subtracted
+         for (unsigned int i = kb; i < n; ++i) {
+            double * ri = a + RowOffset(i);
+            const unsigned int je = Min(i+1, ke);
+            for (unsigned int j = kb; j < je; ++j) {
+               const double * rj = a + RowOffset(j);
+               double s = ri[j];
+               for (unsigned int k = kb; k < j; ++k) s -= ri[k]*rj[k];
+               if (j < i)
+                  ri[j] = s/rj[j];
+               else {
+                  if (!(s > 0)) return false;
+                  ri[i] = std::sqrt(s);
+               }
+            }
+         }
+         // update of the trailing matrix with the panel, tile by tile
+         for (unsigned int ib = ke; ib < n; ib += kBlock) {
+            const unsigned int ie = Min(ib + kBlock, n);
+            for (unsigned int jb = ke; jb <= ib; jb += kBlock) {
+               for (unsigned int i = ib; i < ie; ++i) {
+                  double * ri = a + RowOffset(i);
+                  const unsigned int je = Min(jb + kBlock, i+1);
+                  for (unsigned int j = jb; j < je; ++j) {
+                     const double * rj = a + RowOffset(j);
+                     double s = 0;
+                     for (unsigned int k = kb; k < ke; ++k) s += ri[k]*rj[k];
+                     ri[j] -= s;
+                  }
+               }
+            }
+         }
+      }
+      return true;
+   }
+
+   // add c * row k of the (inverted) triangle to the first k+1 elements of ri
+   inline void AddRow(double * ri, const double * rk, double c, unsigned int k) {
+      for (unsigned int j = 0; j <= k; ++j) ri[j] += c*rk[j];
+   }
+
+   // inversion in place of the lower triangular matrix L, row by row: the row i
+   // of L^-1 is -1/L(i,i) * sum_k<i L(i,k) * (row k of L^-1) for the elements
+   // before the diagonal. The rows are done in blocks, so that each completed
+   // row k is used for all the rows of the block at once.
+   void InvertLower(unsigned int n, double * a) {
+      for (unsigned int ib = 0; ib < n; ib += kBlock) {
+         const unsigned int ie = Min(ib + kBlock, n);
+         // contributions of the rows before the block
+         for (unsigned int k = 0; k < ib; ++k) {
+            const double * rk = a + RowOffset(k);
+            for (unsigned int i = ib; i < ie; ++i) {
+               double * ri = a + RowOffset(i);
+               const double c = ri[k];
+               ri[k] = 0;
+               AddRow(ri, rk, c, k);
+            }
+         }
+         // rows of the block, in order
+         for (unsigned int i = ib; i < ie; ++i) {
+            double * ri = a + RowOffset(i);
+            for (unsigned int k = ib; k < i; ++k) {
+               const double c = ri[k];
+               ri[k] = 0;
+               AddRow(ri, a + RowOffset(k), c, k);
+            }
+            const double dinv = 1./ri[i];
+            for (unsigned int j = 0; j < i; ++j) ri[j] *= -dinv;
+            ri[i] = dinv;
+         }
+      }
+   }
+
+   // c = L^-T L^-1 (lower triangle), with c(i,j) = sum_k>=i Linv(k,i)*Linv(k,j),
+   // computed tile by tile
+   void ProductLowerTransposed(unsigned int n, const double * linv, double * c) {
+      for (unsigned int ib = 0; ib < n; ib += kBlock) {
+         const unsigned int ie = Min(ib + kBlock, n);
+         for (unsigned int jb = 0; jb <= ib; jb += kBlock) {
+            for (unsigned int k = ib; k < n; ++k) {
+               const double * rk = linv + RowOffset(k);
+               const unsigned int iend = Min(ie, k+1);
+               for (unsigned int i = ib; i < iend; ++i) {
+                  const double a = rk[i];
+                  double * ci = c + RowOffset(i);
+                  const unsigned int je = Min(jb + kBlock, i+1);
+                  for (unsigned int j = jb; j < je; ++j) ci[j] += a*rk[j];
+               }
+            }
+         }
+      }
+   }
+
+}
+
+
+int Invert_blocked(LASymMatrix& t) {
+   // inversion of a positive definite symmetric matrix with the blocked
+   // Cholesky factorization: as in mnvert the matrix is first scaled to have
+   // ones on the diagonal. The matrix is not modified and 1 is returned if
+   // it is not positive definite.
+
+   const unsigned int n = t.Nrow();
+   const unsigned int size = t.size();
+   const double * data = t.Data();
+
+   std::vector<double> s(n);
+   for (unsigned int i = 0; i < n; ++i) {
+      double si = data[RowOffset(i)+i];
+      if (!(si > 0)) return 1;
+      s[i] = 1./std::sqrt(si);
+   }
+
+   std::vector<double> work(size);
+   for (unsigned int i = 0; i < n; ++i) {
+      const unsigned int off = RowOffset(i);
+      for (unsigned int j = 0; j <= i; ++j) work[off+j] = data[off+j]*(s[i]*s[j]);
+   }
+
+   if (!Cholesky(n, &work[0])) return 1;
+   InvertLower(n, &work[0]);
+
+   double * result = t.Data();
+   for (unsigned int l = 0; l < size; ++l) result[l] = 0;
+   ProductLowerTransposed(n, &work[0], result);
+
+   for (unsigned int i = 0; i < n; ++i) {
+      const unsigned int off = RowOffset(i);
+      for (unsigned int j = 0; j <= i; ++j) result[off+j] *= (s[i]*s[j]);
+   }
+   return 0;
+}
+
+void Davidon_update(unsigned int n, const double * v0, const double * dx, double delgam,
+                    const double * vg, double gvg, const double * flnu,
+                    double * v1, double & sumUpd, double & sumV1) {
+   // update of the error matrix v1 = v0 + dx*dx^T/delgam - vg*vg^T/gvg
+   // ( + gvg*flnu*flnu^T if flnu is not zero) made in one pass over the
+   // matrices, computing also the sums of the absolute values of the elements
+   // of the update (sumUpd) and of v1 (sumV1)
+
+   double su = 0;
+   double sv = 0;
+   for (unsigned int i = 0; i < n; ++i) {
+      const unsigned int off = RowOffset(i);
+      const double a = dx[i]/delgam;
+      const double b = vg[i]/gvg;
+      if (flnu) {
+         const double c = gvg*flnu[i];
+         for (unsigned int j = 0; j <= i; ++j) {
+            const double u = a*dx[j] - b*vg[j] + c*flnu[j];
+            const double v = v0[off+j] + u;
+            su += std::fabs(u);
+            sv += std::fabs(v);
+            v1[off+j] = v;
+         }
+      }
+      else {
+         for (unsigned int j = 0; j <= i; ++j) {
+            const double u = a*dx[j] - b*vg[j];
+            const double v = v0[off+j] + u;
+            su += std::fabs(u);
+            sv += std::fabs(v);
+            v1[off+j] = v;
+         }
+      }
+   }
+   sumUpd = su;
+   sumV1 = sv;
+}
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
@@ -22,6 +22,10 @@ MnFcn::~MnFcn() {
 
 double MnFcn::operator()(const MnAlgebraicVector& v) const {
    // evaluate FCN converting from from MnAlgebraicVector to std::vector
+   // (the function can be called from parallel threads, see MnStrategy::SetNumberOfThreads)
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
    fNumCall++;
    return fFCN(MnVectorTransform()(v));
 }
@@ -26,6 +26,9 @@
 #endif
 
 #include "Minuit2/MPIProcess.h"
+#include "MnThreads.h"
+
+#include <vector>
 
 namespace ROOT {
 
@@ -127,12 +130,53 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
 #endif
 
    
-   for(unsigned int i = 0; i < n; i++) {
-      
-      double xtf = x(i);
+   // the diagonal elements of the different parameters are independent: they
+   // are computed in parallel threads if requested (see MnStrategy::SetNumberOfThreads),
+   // each one with its own copy of x, and then taken in the order of the
+   // parameters, so that the result is the same as for the serial loop
+   std::vector<double> g2new(n), grdnew(n), gstnew(n), yynew(n);
+   std::vector<int> status(n, -1);  // -1 not computed, 0 ok, 1 2nd derivative zero
+   std::vector<int> ncalls(n, 0);
+   // the serial loop stops after the first parameter which fails or after which the
+   // number of calls exceeds maxcalls: stopIndex is the lowest parameter known to
+   // stop it, and the parameters above it are not computed. The number of calls is
+   // summed in the order of the parameters over the first nPrefix finished ones.
+   int stopIndex = n;
+   unsigned int nPrefix = 0;
+   int ncallsStart = mfcn.NumOfCalls();
+   int ncallsPrefix = ncallsStart;
+
+#ifdef _OPENMP
+   int nthreads = NumberOfThreads(fStrategy, 1);
+#pragma omp parallel num_threads(nthreads)
+#endif
+   {
+   MnAlgebraicVector xp = x;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+   for(int i = 0; i < int(n); i++) {
+
+      // skip the parameters after the one where the serial loop stops; a lower
+      // parameter which has not finished yet may still lower stopIndex
+      bool skip = false;
+#ifdef _OPENMP
+#pragma omp critical (MnHesseDiagonal)
+#endif
+      skip = (i > stopIndex);
+      if (skip) continue;
+
+      double xtf = xp(i);
       double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
       double d = fabs(gst(i));
       if(d < dmin) d = dmin;
+      double g2i = g2(i);
+      double grdi = grd(i);
+      double gsti = gst(i);
+      double yyi = yy(i);
+      int nc = 0;
+      int ifail = 0;
 
 #ifdef DEBUG
       std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
@@ -144,28 +188,86 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
          double fs1 = 0.;
          double fs2 = 0.;
          for(unsigned int multpy = 0; multpy < 5; multpy++) {
-            x(i) = xtf + d;
-            fs1 = mfcn(x);
-            x(i) = xtf - d;
-            fs2 = mfcn(x);
-            x(i) = xtf;
+            xp(i) = xtf + d;
+            fs1 = mfcn(xp);
+            xp(i) = xtf - d;
+            fs2 = mfcn(xp);
+            xp(i) = xtf;
+            nc += 2;
             sag = 0.5*(fs1+fs2-2.*amin);
 
 #ifdef DEBUG
             std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl; 
 #endif
             //  Now as F77 Minuit - check taht sag is not zero
-            if (sag != 0) goto L30; // break
+            if (sag != 0) break;
             if(trafo.Parameter(i).HasLimits()) {
-               if(d > 0.5) goto L26;
+               if(d > 0.5) break;
                d *= 10.;
                if(d > 0.5) d = 0.51;
                continue;
             }
             d *= 10.;
          }
+
+         if (sag == 0) {
+            ifail = 1;
+            break;
+         }
+         
+         double g2bfor = g2i;
+         g2i = 2.*sag/(d*d);
+         grdi = (fs1-fs2)/(2.*d);
+         gsti = d;
+         yyi = fs1;
+         double dlast = d;
+         d = sqrt(2.*aimsag/fabs(g2i));
+         if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
+         if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+         std::cout << "\t g1 = " << grdi << " g2 = " << g2i << " step = " << gsti << " d = " << d 
+                   << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(g2i-g2bfor)/g2i << std::endl;
+#endif
+
          
-L26:  
+         // see if converged
+         if(fabs((d-dlast)/d) < Tolerstp()) break;
+         if(fabs((g2i-g2bfor)/g2i) < TolerG2()) break; 
+         d = std::min(d, 10.*dlast);
+         d = std::max(d, 0.1*dlast);   
+      }
+
+      g2new[i] = g2i;
+      grdnew[i] = grdi;
+      gstnew[i] = gsti;
+      yynew[i] = yyi;
+#ifdef _OPENMP
+#pragma omp critical (MnHesseDiagonal)
+#endif
+      {
+         ncalls[i] = nc;
+         status[i] = ifail;
+         if (ifail != 0 && i < stopIndex) stopIndex = i;
+         while (nPrefix < n && status[nPrefix] >= 0) {
+            ncallsPrefix += ncalls[nPrefix];
+            if (ncallsPrefix > int(maxcalls) && int(nPrefix) < stopIndex) stopIndex = nPrefix;
+            nPrefix++;
+         }
+      }
+   }
+   }
+
+   // take the results in the order of the parameters: all the parameters up to
+   // the one where the serial loop stops have been computed
+   int ncallsDone = ncallsStart;
+   for(unsigned int i = 0; i < n; i++) {
+
+      assert(status[i] >= 0);
+      g2(i) = g2new[i];
+      ncallsDone += ncalls[i];
+
+      if (status[i] != 0) {
 #ifdef WARNINGMSG
 
          // get parameter name for i
@@ -183,33 +285,14 @@ L26:
          }
          
          return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
-         
-L30:      
-            double g2bfor = g2(i);
-         g2(i) = 2.*sag/(d*d);
-         grd(i) = (fs1-fs2)/(2.*d);
-         gst(i) = d;
-         dirin(i) = d;
-         yy(i) = fs1;
-         double dlast = d;
-         d = sqrt(2.*aimsag/fabs(g2(i)));
-         if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
-         if(d < dmin) d = dmin;
-
-#ifdef DEBUG
-         std::cout << "\t g1 = " << grd(i) << " g2 = " << g2(i) << " step = " << gst(i) << " d = " << d 
-                   << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(g2(i)-g2bfor)/g2(i) << std::endl;
-#endif
-
-         
-         // see if converged
-         if(fabs((d-dlast)/d) < Tolerstp()) break;
-         if(fabs((g2(i)-g2bfor)/g2(i)) < TolerG2()) break; 
-         d = std::min(d, 10.*dlast);
-         d = std::max(d, 0.1*dlast);   
       }
+
+      grd(i) = grdnew[i];
+      gst(i) = gstnew[i];
+      dirin(i) = gstnew[i];
+      yy(i) = yynew[i];
       vhmat(i,i) = g2(i);
-      if(mfcn.NumOfCalls()  > maxcalls) {
+      if(ncallsDone  > int(maxcalls)) {
          
 #ifdef WARNINGMSG
          //std::cout<<"maxcalls " << maxcalls << " " << mfcn.NumOfCalls() << "  " <<   st.NFcn() << std::endl;
@@ -246,33 +329,66 @@ L30:
    unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
    unsigned int endParIndexOffDiagonal = mpiprocOffDiagonal.EndElementIndex();
 
-   unsigned int offsetVect = 0;
-   for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
-      if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
+   if (mpiprocOffDiagonal.GetMPISize() == 1) {
+      // loop on the rows, in parallel threads if requested (see
+      // MnStrategy::SetNumberOfThreads): each element is computed with a
+      // copy of x displaced only along i and j, so the result does not
+      // depend on the order
+#ifdef _OPENMP
+      int nthreadsOffDiagonal = NumberOfThreads(fStrategy, 1);
+#pragma omp parallel num_threads(nthreadsOffDiagonal)
+#endif
+      {
+      MnAlgebraicVector xp = x;
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+      for (int i = 0; i < int(n) - 1; i++) {
+         double xi = xp(i);
+         xp(i) = xi + dirin(i);
+         for (unsigned int j = i + 1; j < n; j++) {
+            double xj = xp(j);
+            xp(j) = xj + dirin(j);
+            double fs1 = mfcn(xp);
+            double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+            vhmat(i,j) = elem;
+            xp(j) = xj;
+         }
+         xp(i) = xi;
+      }
+      }
+   }
+   else {
+      unsigned int offsetVect = 0;
+      for (unsigned int in = 0; in<startParIndexOffDiagonal; in++)
+         if ((in+offsetVect)%(n-1)==0) offsetVect += (in+offsetVect)/(n-1);
 
-   for (unsigned int in = startParIndexOffDiagonal;
-        in<endParIndexOffDiagonal; in++) {
+      for (unsigned int in = startParIndexOffDiagonal;
+           in<endParIndexOffDiagonal; in++) {
 
-      int i = (in+offsetVect)/(n-1);
-      if ((in+offsetVect)%(n-1)==0) offsetVect += i;
-      int j = (in+offsetVect)%(n-1)+1;
+         int i = (in+offsetVect)/(n-1);
+         if ((in+offsetVect)%(n-1)==0) offsetVect += i;
+         int j = (in+offsetVect)%(n-1)+1;
 
-      if ((i+1)==j || in==startParIndexOffDiagonal)
-         x(i) += dirin(i);
+         if ((i+1)==j || in==startParIndexOffDiagonal)
+            x(i) += dirin(i);
       
-      x(j) += dirin(j);
+         x(j) += dirin(j);
       
-      double fs1 = mfcn(x);
-      double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
-      vhmat(i,j) = elem;
+         double fs1 = mfcn(x);
+         double elem = (fs1 + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+         vhmat(i,j) = elem;
       
-      x(j) -= dirin(j);
+         x(j) -= dirin(j);
       
-      if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
-         x(i) -= dirin(i);
+         if (j%(n-1)==0 || in==endParIndexOffDiagonal-1)
+            x(i) -= dirin(i);
       
-   }
+      }
    
+   }
+
    mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
 
    //verify if matrix pos-def (still 2nd derivative)
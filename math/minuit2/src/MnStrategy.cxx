@@ -15,13 +15,13 @@ namespace ROOT {
 
 
 
-MnStrategy::MnStrategy() {
+MnStrategy::MnStrategy() : fNThreads(1) {
    //default strategy
    SetMediumStrategy();
 }
 
 
-MnStrategy::MnStrategy(unsigned int stra) {
+MnStrategy::MnStrategy(unsigned int stra) : fNThreads(1) {
    //user defined strategy (0, 1, >=2)
    if(stra == 0) SetLowStrategy();
    else if(stra == 1) SetMediumStrategy();
@@ -0,0 +1,52 @@
+// @(#)root/minuit2:$Id$
+// Author: L. Moneta    2013
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2013 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnThreads
+#define ROOT_Minuit2_MnThreads
+
+#include "Minuit2/MnStrategy.h"
+#include "Minuit2/StackAllocator.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/// utility used internally by the numerical derivative calculators
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+/**
+   Return the number of threads to use for the loops over the parameters
+   in the numerical gradient and Hessian, given the number requested in
+   the strategy (0 means the OpenMP default).
+   Return 1 when the code is not compiled with OpenMP, when the work is
+   distributed on more than one MPI process (nproc) or when the (not thread
+   safe) stack allocator is used.
+   Note that the FCN must be thread safe when more than one thread is used.
+ */
+static inline int NumberOfThreads(const MnStrategy & strategy, unsigned int nproc) {
+#if defined(_OPENMP) && !defined(_MN_NO_THREAD_SAVE_)
+   if (nproc > 1) return 1;
+   int nthreads = strategy.NumberOfThreads();
+   if (nthreads == 0) nthreads = omp_get_max_threads();
+   return nthreads;
+#else
+   (void) strategy;
+   (void) nproc;
+   return 1;
+#endif
+}
+
+   }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnThreads
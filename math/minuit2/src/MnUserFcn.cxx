@@ -18,6 +18,10 @@ namespace ROOT {
 
 double MnUserFcn::operator()(const MnAlgebraicVector& v) const {
    // call Fcn function transforming from a MnAlgebraicVector of internal values to a std::vector of external ones 
+   // (the function can be called from parallel threads, see MnStrategy::SetNumberOfThreads)
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
    fNumCall++;
 
    // calling fTransform() like here was not thread safe because it was using a cached vector
@@ -32,6 +32,7 @@
 #include <math.h>
 
 #include "Minuit2/MPIProcess.h"
+#include "MnThreads.h"
 
 namespace ROOT {
 
@@ -100,45 +101,35 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    MnAlgebraicVector g2 = Gradient.G2();
    MnAlgebraicVector gstep = Gradient.Gstep();
 
-#ifndef _OPENMP
    MPIProcess mpiproc(n,0);
-#endif
 
 #ifdef DEBUG
    std::cout << "Calculating Gradient at x =   " << par.Vec() << std::endl;
 #endif
 
-#ifndef _OPENMP
-   // for serial execution this can be outside the loop
-   MnAlgebraicVector x = par.Vec();
-
    unsigned int startElementIndex = mpiproc.StartElementIndex();
    unsigned int endElementIndex = mpiproc.EndElementIndex();
 
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
-
-#else
-
- // parallelize this loop using OpenMP
-//#define N_PARALLEL_PAR 5
-#pragma omp parallel
-#pragma omp for 
-//#pragma omp for schedule (static, N_PARALLEL_PAR)
-
-   for(int i = 0; i < int(n); i++) {
+   // the parameters are independent: the loop can run in parallel threads
+   // (see MnStrategy::SetNumberOfThreads), each one with its own copy of
+   // the parameter vector, giving the same result as the serial loop
+#ifdef _OPENMP
+   int nthreads = NumberOfThreads(Strategy(), mpiproc.GetMPISize());
+#pragma omp parallel num_threads(nthreads)
+#endif
+   {
+   MnAlgebraicVector x = par.Vec();
 
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
 #endif
+   for(int i = int(startElementIndex); i < int(endElementIndex); i++) {
 
 #ifdef DEBUG_MP
       int ith = omp_get_thread_num();
       //std::cout << "Thread number " << ith << "  " << i << std::endl;
 #endif
 
-#ifdef _OPENMP
-       // create in loop since each thread will use its own copy
-      MnAlgebraicVector x = par.Vec();
-#endif
-
       double xtf = x(i);
       double epspri = eps2 + fabs(grd(i)*eps2);
       double stepb4 = 0.;
@@ -200,6 +191,7 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
       //     vgrd2(i) = g2;
       //     vgstp(i) = gstep;
    }  
+   }
 
 #ifdef DEBUG
    std::cout << "Gradient =   " << grd << std::endl;
@@ -208,11 +200,9 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    //   std::cout<<"final grd: "<<grd<<std::endl;
    //   std::cout<<"########### return from Numerical2PDerivative"<<std::endl;
 
-#ifndef _OPENMP
    mpiproc.SyncVector(grd);
    mpiproc.SyncVector(g2);
    mpiproc.SyncVector(gstep);
-#endif
 
    return FunctionGradient(grd, g2, gstep);
 }
@@ -0,0 +1,207 @@
+// @(#)root/minuit2:$Id$
+// Author: L. Moneta    2013
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2013 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+// test and benchmark of the blocked kernels for the large symmetric matrices
+// (see MnBlockedAlgebra::SetMinSize):
+// - the inverse of random positive definite matrices of increasing size is
+//   compared with the one of the standard inversion (mnvert)
+// - a quadratic function with correlated parameters is minimized with Migrad
+//   using the analytical gradient with and without the blocked kernels: the
+//   minimum and the errors must agree
+// The times of the inversion and of the fit are printed as function of the
+// number of parameters.
+// One can change the maximum number of parameters of the fits by doing:
+// ./test_Minuit2_BlockedAlgebra  nmax
+
+#include "Minuit2/FunctionMinimum.h"
+#include "Minuit2/MnUserParameterState.h"
+#include "Minuit2/MnMigrad.h"
+#include "Minuit2/FCNGradientBase.h"
+#include "Minuit2/MnBlockedAlgebra.h"
+#include "Minuit2/LASymMatrix.h"
+#include "Minuit2/LaInverse.h"
+#include <cmath>
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+using namespace ROOT::Minuit2;
+
+const int default_nmax = 500;
+
+// simple linear congruential generator to have the same matrices everywhere
+struct Random {
+   Random(unsigned int seed) : fState(seed) {}
+   double Uniform() {
+      fState = 1664525u*fState + 1013904223u;
+      return (fState >> 8)*(1./16777216.);
+   }
+   unsigned int fState;
+};
+
+double CpuTime(clock_t t0) { return double(clock() - t0)/CLOCKS_PER_SEC; }
+
+// positive definite matrix A = B B^T/n + diag, with B uniform in [-1,1]
+void MakeMatrix(unsigned int n, Random & r, LASymMatrix & a) {
+   std::vector<double> b(n*n);
+   for (unsigned int l = 0; l < n*n; ++l) b[l] = 2*r.Uniform() - 1;
+   for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int j = 0; j <= i; ++j) {
+         double s = 0;
+         for (unsigned int k = 0; k < n; ++k) s += b[i*n+k]*b[j*n+k];
+         a(i,j) = s/n;
+      }
+      // different scales for the parameters
+      a(i,i) += 0.1;
+   }
+}
+
+double MaxRelDiff(const LASymMatrix & a, const LASymMatrix & b) {
+   double maxDiff = 0;
+   double norm = 0;
+   for (unsigned int l = 0; l < a.size(); ++l) {
+      if (std::fabs(b.Data()[l]) > norm) norm = std::fabs(b.Data()[l]);
+   }
+   for (unsigned int l = 0; l < a.size(); ++l) {
+      double diff = std::fabs(a.Data()[l] - b.Data()[l])/norm;
+      if (!(diff <= maxDiff)) maxDiff = diff;
+   }
+   return maxDiff;
+}
+
+int testInversion(unsigned int n) {
+
+   Random r(111+n);
+   LASymMatrix a(n);
+   MakeMatrix(n, r, a);
+
+   LASymMatrix ref(a);
+   LASymMatrix res(a);
+
+   MnBlockedAlgebra::SetMinSize(0);
+   clock_t t0 = clock();
+   int iret1 = Invert(ref);
+   double tStandard = CpuTime(t0);
+
+   MnBlockedAlgebra::SetMinSize(1);
+   t0 = clock();
+   int iret2 = Invert(res);
+   double tBlocked = CpuTime(t0);
+   MnBlockedAlgebra::SetMinSize(0);
+
+   double maxDiff = MaxRelDiff(res, ref);
+   bool ok = (iret1 == 0 && iret2 == 0 && maxDiff < 1.E-8);
+
+   std::cout << "Inversion  n = " << std::setw(5) << n
+             << "  max rel. diff " << std::setw(12) << maxDiff
+             << "  time standard " << std::setw(8) << tStandard
+             << " blocked " << std::setw(8) << tBlocked
+             << (ok ? "\t OK" : "\t FAILED") << std::endl;
+   return ok ? 0 : 1;
+}
+
+// f(x) = 1/2 (x-x0)^T A (x-x0)  with its gradient A (x-x0)
+struct QuadraticFCN : public FCNGradientBase {
+
+   QuadraticFCN(const LASymMatrix & a, const std::vector<double> & x0) :
+      fA(a), fX0(x0) {}
+
+   double operator() (const std::vector<double> & x) const {
+      std::vector<double> g = Gradient(x);
+      double f = 0;
+      for (unsigned int i = 0; i < x.size(); ++i) f += 0.5*(x[i] - fX0[i])*g[i];
+      return f;
+   }
+   std::vector<double> Gradient(const std::vector<double> & x) const {
+      const unsigned int n = x.size();
+      std::vector<double> g(n);
+      for (unsigned int i = 0; i < n; ++i) {
+         double s = 0;
+         for (unsigned int j = 0; j < n; ++j) s += fA(i,j)*(x[j] - fX0[j]);
+         g[i] = s;
+      }
+      return g;
+   }
+   double Up() const { return 0.5; }
+
+   const LASymMatrix & fA;
+   std::vector<double> fX0;
+};
+
+int testFit(unsigned int n) {
+
+   Random r(222+n);
+   LASymMatrix a(n);
+   MakeMatrix(n, r, a);
+   std::vector<double> x0(n);
+   for (unsigned int i = 0; i < n; ++i) x0[i] = 2*r.Uniform() - 1;
+
+   QuadraticFCN fcn(a, x0);
+   MnUserParameters upar;
+   for (unsigned int i = 0; i < n; ++i) {
+      char name[20];
+      sprintf(name,"x%d",i);
+      upar.Add(name, 0., 0.1);
+   }
+
+   MnBlockedAlgebra::SetMinSize(0);
+   clock_t t0 = clock();
+   MnMigrad migrad1(fcn, upar, 1);
+   FunctionMinimum min1 = migrad1();
+   double tStandard = CpuTime(t0);
+
+   MnBlockedAlgebra::SetMinSize(1);
+   t0 = clock();
+   MnMigrad migrad2(fcn, upar, 1);
+   FunctionMinimum min2 = migrad2();
+   double tBlocked = CpuTime(t0);
+   MnBlockedAlgebra::SetMinSize(0);
+
+   // the steps are the same up to the rounding errors: compare the results
+   // with a tolerance relative to the errors
+   double maxDiff = 0;
+   for (unsigned int i = 0; i < n; ++i) {
+      double err = min1.UserState().Error(i);
+      double diff = std::fabs(min1.UserState().Value(i) - min2.UserState().Value(i))/err;
+      if (!(diff <= maxDiff)) maxDiff = diff;
+      diff = std::fabs(min2.UserState().Error(i) - err)/err;
+      if (!(diff <= maxDiff)) maxDiff = diff;
+   }
+   bool ok = (min1.IsValid() && min2.IsValid() && maxDiff < 1.E-3);
+
+   std::cout << "Migrad fit n = " << std::setw(5) << n
+             << "  nfcn " << min1.NFcn() << " / " << min2.NFcn()
+             << "  max diff/error " << std::setw(12) << maxDiff
+             << "  time standard " << std::setw(8) << tStandard
+             << " blocked " << std::setw(8) << tBlocked
+             << (ok ? "\t OK" : "\t FAILED") << std::endl;
+   return ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+
+   unsigned int nmax = default_nmax;
+   if (argc > 1) nmax = atoi(argv[1]);
+
+   std::cout << "Standard and blocked kernels (time in s)" << std::endl;
+   int iret = 0;
+   const unsigned int nInv[] = { 10, 63, 100, 250, 500, 1000, 1500 };
+   for (unsigned int i = 0; i < sizeof(nInv)/sizeof(nInv[0]); ++i)
+      iret |= testInversion(nInv[i]);
+
+   for (unsigned int n = 50; n <= nmax; n *= 2)
+      iret |= testFit(n);
+
+   if (iret != 0) std::cerr << "BlockedAlgebraTest: test FAILED !!! " << std::endl;
+   else std::cout << "BlockedAlgebraTest: all tests OK" << std::endl;
+   return iret;
+}
@@ -17,11 +17,19 @@
 #include "Minuit2/MnPlot.h"
 #include "Minuit2/MinosError.h"
 #include "Minuit2/FCNBase.h"
+#include "Minuit2/MnStrategy.h"
+#include "Minuit2/MnUserParameters.h"
+#include "Minuit2/VariableMetricMinimizer.h"
+#include "Minuit2/MnHesse.h"
 #include <cmath>
+#include <cstdio>
 #include <iostream>
 
 // example of a multi dimensional fit where parallelization can be used
 // to speed up the result
+// The numerical derivatives are computed in parallel threads when Minuit2 is
+// built with OpenMP (see MnStrategy::SetNumberOfThreads): the result is
+// checked to be identical to the serial one
 // define the environment variable OMP_NUM_THREADS to the number of desired threads
 // By default it will have thenumber of core of the machine
 // The default number of dimension is 20 (fit in 40 parameters) on 1000 data events. 
@@ -70,6 +78,53 @@ struct LogLikeFCN  : public FCNBase {
    const Data & fData; 
 };
 
+// quadratic function in which one parameter has no effect: its 2nd derivative 
+// is zero and MnHesse fails for it
+struct FlatParFCN  : public FCNBase { 
+
+   FlatParFCN(unsigned int flat) : fFlat(flat) {}
+
+   double operator() (const std::vector<double> & p ) const { 
+      double f = 0; 
+      for (unsigned int k = 0; k < p.size(); ++k) { 
+         if (k != fFlat) f += (k+1)*(p[k]-k)*(p[k]-k);
+      }
+      return f; 
+   }
+   double Up() const { return 1.; }
+   unsigned int fFlat; 
+};
+
+int doHesseFail(unsigned int npar, unsigned int maxcalls) {
+
+  // Hesse must stop at the same parameter in the threaded and in the serial
+  // calculation of the diagonal, when a parameter in the middle fails or when
+  // the maximum number of calls is reached
+
+  FlatParFCN fcn(npar/2);
+  MnUserParameters upar;
+  for (unsigned int k = 0; k < npar; ++k) {
+     char name[16];
+     sprintf(name, "x%d", k);
+     upar.Add(name, 0.5*k, 0.1);
+  }
+
+  MnStrategy strategy(1);
+  strategy.SetNumberOfThreads(0);
+  MnUserParameterState st = MnHesse(strategy)(fcn, upar, maxcalls);
+  MnUserParameterState st0 = MnHesse(MnStrategy(1))(fcn, upar, maxcalls);
+
+  bool same = (st.IsValid() == st0.IsValid()) && (st.HasCovariance() == st0.HasCovariance()); 
+  same &= (st.Covariance().Nrow() == st0.Covariance().Nrow());
+  for (unsigned int i = 0; same && i < st.Covariance().Nrow(); ++i) {
+     for (unsigned int j = 0; j <= i; ++j) 
+        same &= (st.Covariance()(i,j) == st0.Covariance()(i,j));
+  }
+  std::cout << "Hesse with failing parameter " << npar/2 << " and maxcalls " << maxcalls 
+            << ": threaded and serial results are " << (same ? "identical" : "DIFFERENT") << std::endl;
+  return same ? 0 : 1;
+}
+
 int doFit(int ndim, int ndata) {
 
   // generate the data (1000 data points) in 100 dimension
@@ -110,12 +165,25 @@ int doFit(int ndim, int ndata) {
   // create minimizer (default constructor)
   VariableMetricMinimizer fMinimizer;
   
-  // Minimize
-  FunctionMinimum min = fMinimizer.Minimize(fcn, init_par, init_err);
+  // Minimize (the FCN is thread safe: use all the threads for the derivatives)
+  MnUserParameters upar(init_par, init_err);
+  MnStrategy strategy(1);
+  strategy.SetNumberOfThreads(0);
+  FunctionMinimum min = fMinimizer.Minimize(fcn, upar, strategy);
 
   // output
   std::cout<<"minimum: "<<min<<std::endl;
 
+  // compare with the serial minimization
+  FunctionMinimum min0 = fMinimizer.Minimize(fcn, upar, MnStrategy(1));
+  bool same = (min.Fval() == min0.Fval());
+  for (unsigned int k = 0; k < init_par.size(); ++k) {
+     same &= (min.UserState().Value(k) == min0.UserState().Value(k));
+     same &= (min.UserState().Error(k) == min0.UserState().Error(k));
+  }
+  std::cout << "threaded and serial results are " << (same ? "identical" : "DIFFERENT") << std::endl;
+  if (!same) return 1;
+
 
 //     // create MINOS Error factory
 //     MnMinos Minos(fFCN, min);
@@ -154,5 +222,8 @@ int main(int argc, char **argv) {
       ndata = atoi(argv[2] ); 
    }
    std::cout << "do fit of " << ndim << " dimensional data on " << ndata << " events " << std::endl;
-   doFit(ndim,ndata);
+   int ret = doFit(ndim,ndata);
+   ret += doHesseFail(40, 0);
+   ret += doHesseFail(40, 300);
+   return ret;
 }
@@ -0,0 +1,114 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+
+#ifndef HISTFACTORYNLL
+#define HISTFACTORYNLL
+
+#include "RooAbsReal.h"
+#include "RooSetProxy.h"
+#include <vector>
+
+class RooAbsPdf ;
+class RooAbsData ;
+class RooArgSet ;
+class RooRealVar ;
+class PiecewiseInterpolation ;
+
+namespace RooStats{
+  namespace HistFactory{
+
+class HistFactoryNLL : public RooAbsReal {
+public:
+
+  HistFactoryNLL() ;
+  HistFactoryNLL(const char *name, const char *title, RooAbsPdf& pdf, RooAbsData& data, Bool_t extended=kTRUE) ;
+  HistFactoryNLL(const HistFactoryNLL& other, const char* name=0) ;
+  virtual TObject* clone(const char* newname) const { return new HistFactoryNLL(*this,newname); }
+  virtual ~HistFactoryNLL() ;
+
+  static RooAbsReal* createNLL(RooAbsPdf& pdf, RooAbsData& data, const RooArgSet* constrainedParams=0,
+			       const RooArgSet* globalObs=0) ;
+
+  virtual Double_t defaultErrorLevel() const {
+    // Error level for MINUIT error analysis
+    return 0.5 ;
+  }
+
+  Int_t numChannels() const ;
+  Int_t numBins() const ;
+  Int_t numGenericFactors() const ;
+
+  // A single sample of a channel: its coefficient in the RooRealSumPdf
+  // and its factors, sorted by how they depend on the observables
+  class SampleCache {
+  public:
+    SampleCache() : coef(0), nInterpParams(0) {}
+    RooAbsReal* coef ;                     // Coefficient, zero for the last sample of a sum without last coefficient
+    std::vector<RooAbsReal*> scalars ;     // Factors that do not depend on the observables
+    std::vector<Double_t> fixed ;          // Product of the factors that only depend on the observables, per bin
+    std::vector<PiecewiseInterpolation*> interp ; // Interpolations of parameter-independent histograms
+    std::vector< std::vector<Double_t> > nominal ; // Nominal histogram of each interpolation, per bin
+    std::vector< std::vector<Double_t> > low ;     // Low variations of each interpolation, per parameter and bin
+    std::vector< std::vector<Double_t> > high ;    // High variations of each interpolation, per parameter and bin
+    std::vector< std::vector<RooAbsReal*> > binParams ; // Parameter of each ParamHistFunc, per bin
+    std::vector<RooAbsReal*> generic ;     // Other factors, evaluated bin by bin
+    Int_t nInterpParams ;
+  };
+
+  // The flattened representation of a single channel
+  class ChannelCache {
+  public:
+    ChannelCache() : sumPdf(0), observables(0), binned(kFALSE), nBins(0), sumW(0), haveLastCoef(kTRUE) {}
+    RooAbsPdf* sumPdf ;                    // RooRealSumPdf of the channel
+    RooArgSet* observables ;               // Observables of the channel
+    std::vector<RooRealVar*> obsVars ;     // Observables of the channel, in fixed order
+    Bool_t binned ;                        // Bins are the cells of the binning of the model, rather than the data points
+    Int_t nBins ;                          // Number of bins
+    std::vector< std::vector<Double_t> > x ; // Coordinates of the bin centers (data points), per observable
+    std::vector<Double_t> volume ;         // Bin volume (binned mode only)
+    std::vector<Double_t> weight ;         // Sum of the weights of the data in each bin
+    Double_t sumW ;                        // Sum of all data weights
+    Bool_t haveLastCoef ;
+    std::vector<SampleCache> samples ;
+    mutable std::vector<Double_t> yield ;  //! Work space for expected yields
+    mutable std::vector<Double_t> work ;   //! Work space for sample yields
+    mutable std::vector<Double_t> work2 ;  //! Work space for interpolations
+  };
+
+protected:
+
+  RooSetProxy _paramSet ;  // Parameters of the likelihood
+  RooAbsPdf* _pdf ;        // Input p.d.f.
+  RooAbsData* _data ;      // Input data
+  Bool_t _extended ;       // Include extended term
+
+  mutable Bool_t _init ;   //! Flattened model is up to date
+  mutable Int_t _simCount ; //! Number of channels included in likelihood
+  mutable std::vector<ChannelCache*> _channels ; //! Flattened channels
+
+  Bool_t initialize() const ;
+  void clearChannels() const ;
+  Bool_t addChannel(RooAbsPdf* channelPdf, RooAbsData* data) const ;
+  Bool_t addFactor(ChannelCache& ch, SampleCache& sample, RooAbsReal* factor) const ;
+  void loadBin(const ChannelCache& ch, Int_t bin) const ;
+  Double_t channelNLL(const ChannelCache& ch) const ;
+
+  Double_t evaluate() const ;
+
+private:
+
+  ClassDef(RooStats::HistFactory::HistFactoryNLL,1) // Fast -log(L) of a HistFactory model
+};
+
+  }
+}
+
+#endif
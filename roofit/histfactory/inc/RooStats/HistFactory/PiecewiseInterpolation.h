@@ -42,6 +42,7 @@ public:
   const RooArgList& lowList() const { return _lowSet ; }
   const RooArgList& highList() const { return _highSet ; }
   const RooArgList& paramList() const { return _paramSet ; }
+  const RooAbsReal& nominalHist() const { return _nominal.arg() ; }
 
   virtual Bool_t forceAnalyticalInt(const RooAbsArg&) const { return kTRUE ; }
   Bool_t setBinIntegrator(RooArgSet& allVars) ;
@@ -59,6 +60,8 @@ public:
   virtual std::list<Double_t>* plotSamplingHint(RooAbsRealLValue& obs, Double_t xlo, Double_t xhi) const ; 
   virtual Bool_t isBinnedDistribution(const RooArgSet& obs) const ;
 
+  void evaluateArray(Int_t n, const Double_t* nominal, const Double_t* low, const Double_t* high, Double_t* output) const ;
+
 protected:
 
   class CacheElem : public RooAbsCacheElement {
@@ -89,6 +92,7 @@ protected:
   std::vector<int> _interpCode;
 
   Double_t evaluate() const;
+  static Bool_t interpolate(Int_t code, Double_t x, Double_t nominal, Double_t low, Double_t high, Double_t& sum) ;
 
   ClassDef(PiecewiseInterpolation,3) // Sum of RooAbsReal objects
 };
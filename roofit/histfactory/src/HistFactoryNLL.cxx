@@ -0,0 +1,708 @@
+/*****************************************************************************
+  * Project: RooFit                                                           *
+  *                                                                           *
+  * Copyright (c) 2000-2005, Regents of the University of California          *
+  *                          and Stanford University. All rights reserved.    *
+  *                                                                           *
+  * Redistribution and use in source and binary forms,                        *
+  * with or without modification, are permitted according to the terms        *
+  * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+  *****************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// BEGIN_HTML
+// Class HistFactoryNLL calculates the -log(L) of a HistFactory model, i.e.
+// the same quantity as the RooNLLVar that RooAbsPdf::createNLL() makes for
+// the model, without going through the generic RooFit evaluation of every
+// node of the model for every bin.
+// <p>
+// At the first evaluation the model is flattened: for every channel (state
+// of the RooSimultaneous), the samples of its RooRealSumPdf are split into
+// their factors. Factors that depend only on the observables (the nominal
+// histograms) are tabulated per bin once, the histograms of a
+// PiecewiseInterpolation are stored in contiguous arrays and interpolated
+// for all bins at once, and ParamHistFunc factors are replaced by the
+// parameter of every bin. Factors that do not depend on the observables
+// (FlexibleInterpVar, normalization factors, luminosity) are evaluated once
+// per evaluation. Other factors are still evaluated bin by bin.
+// <p>
+// If the model is binned in all observables, the bins are the cells of the
+// model binning and the normalization and expected number of events are
+// summed directly from the expected yields, as the RooBinIntegrator that
+// HistToWorkspaceFactoryFast configures for the RooRealSumPdf does.
+// Otherwise the data points are used and the normalization is taken from
+// the RooRealSumPdf.
+// <p>
+// The constraint terms are not included. Use the static createNLL()
+// function to get the sum of the likelihood and the constraint terms, as
+// RooAbsPdf::createNLL() would make it.
+// END_HTML
+//
+
+#include <stdexcept>
+#include <algorithm>
+#include <math.h>
+
+#include "Riostream.h"
+
+#include "RooFit.h"
+#include "RooStats/HistFactory/HistFactoryNLL.h"
+#include "RooAbsReal.h"
+#include "RooAbsPdf.h"
+#include "RooAbsData.h"
+#include "RooMsgService.h"
+#include "RooRealVar.h"
+#include "RooArgList.h"
+#include "RooProdPdf.h"
+#include "RooRealSumPdf.h"
+#include "RooProduct.h"
+#include "RooCategory.h"
+#include "RooSimultaneous.h"
+#include "RooAbsCategoryLValue.h"
+#include "RooAddition.h"
+#include "RooConstraintSum.h"
+#include "TList.h"
+#include "TMath.h"
+
+#include "RooStats/HistFactory/ParamHistFunc.h"
+#include "RooStats/HistFactory/PiecewiseInterpolation.h"
+#include "RooStats/HistFactory/HistFactoryModelUtils.h"
+
+using namespace std ;
+
+ClassImp(RooStats::HistFactory::HistFactoryNLL)
+
+
+//_____________________________________________________________________________
+RooStats::HistFactory::HistFactoryNLL::HistFactoryNLL() :
+  _pdf(0), _data(0), _extended(kFALSE), _init(kFALSE), _simCount(1)
+{
+  // Default constructor
+}
+
+
+//_____________________________________________________________________________
+RooStats::HistFactory::HistFactoryNLL::HistFactoryNLL(const char *name, const char *title,
+						      RooAbsPdf& pdf, RooAbsData& data, Bool_t extended) :
+  RooAbsReal(name,title),
+  _paramSet("paramSet","Set of parameters",this),
+  _pdf(&pdf), _data(&data), _extended(extended), _init(kFALSE), _simCount(1)
+{
+  // Constructor of the -log(L) of HistFactory model pdf, which is either a
+  // RooSimultaneous of channel p.d.f.s or a single channel p.d.f., with
+  // respect to the given data. If extended is true the extended term is
+  // included for every channel. The model and the data are not copied and
+  // must remain alive as long as this object is used
+
+  RooArgSet* params = pdf.getParameters(data) ;
+  _paramSet.add(*params) ;
+  delete params ;
+}
+
+
+//_____________________________________________________________________________
+RooStats::HistFactory::HistFactoryNLL::HistFactoryNLL(const HistFactoryNLL& other, const char* name) :
+  RooAbsReal(other,name),
+  _paramSet("paramSet",this,other._paramSet),
+  _pdf(other._pdf), _data(other._data), _extended(other._extended), _init(kFALSE), _simCount(1)
+{
+  // Copy constructor. The flattened model is rebuilt at the first evaluation
+}
+
+
+//_____________________________________________________________________________
+RooStats::HistFactory::HistFactoryNLL::~HistFactoryNLL()
+{
+  // Destructor
+
+  clearChannels() ;
+}
+
+
+
+//_____________________________________________________________________________
+RooAbsReal* RooStats::HistFactory::HistFactoryNLL::createNLL(RooAbsPdf& pdf, RooAbsData& data,
+							      const RooArgSet* constrainedParams, const RooArgSet* globalObs)
+{
+  // Return -log(L) of the HistFactory model pdf and the data, including
+  // the constraint terms of the constrained parameters, as
+  // pdf.createNLL(data,Constrain(*constrainedParams),GlobalObservables(*globalObs))
+  // does. If no constrained parameters are given, all parameters of the
+  // model are constrained. The extended term is included if the model
+  // provides the expected number of events. The caller takes ownership of
+  // the returned object
+
+  Bool_t ext = (pdf.extendMode()==RooAbsPdf::CanBeExtended || pdf.extendMode()==RooAbsPdf::MustBeExtended) ;
+  RooAbsReal* nll = new HistFactoryNLL(Form("nll_%s_%s",pdf.GetName(),data.GetName()),"-log(likelihood)",pdf,data,ext) ;
+
+  RooArgSet* cPars = constrainedParams ? new RooArgSet(*constrainedParams) : pdf.getParameters(data,kFALSE) ;
+  RooArgSet allConstraints ;
+  if (cPars->getSize()>0) {
+    RooArgSet* constraints = pdf.getAllConstraints(*data.get(),*cPars,constrainedParams==0) ;
+    allConstraints.add(*constraints) ;
+    delete constraints ;
+  }
+
+  if (allConstraints.getSize()>0) {
+    RooAbsReal* nllCons = new RooConstraintSum(Form("%s_constr",nll->GetName()),"nllCons",allConstraints,
+					       globalObs ? *globalObs : *cPars) ;
+    nllCons->setOperMode(ADirty) ;
+    RooAbsReal* orignll = nll ;
+
+    nll = new RooAddition(Form("%s_with_constr",orignll->GetName()),"nllWithCons",RooArgSet(*orignll,*nllCons)) ;
+    nll->addOwnedComponents(RooArgSet(*orignll,*nllCons)) ;
+  }
+  delete cPars ;
+
+  return nll ;
+}
+
+
+
+//_____________________________________________________________________________
+Int_t RooStats::HistFactory::HistFactoryNLL::numChannels() const
+{
+  // Return the number of channels included in the likelihood
+
+  if (!_init) initialize() ;
+  return _channels.size() ;
+}
+
+
+//_____________________________________________________________________________
+Int_t RooStats::HistFactory::HistFactoryNLL::numBins() const
+{
+  // Return the total number of bins (or data points) of all channels
+
+  if (!_init) initialize() ;
+  Int_t n(0) ;
+  for (UInt_t i=0 ; i<_channels.size() ; i++) {
+    n += _channels[i]->nBins ;
+  }
+  return n ;
+}
+
+
+//_____________________________________________________________________________
+Int_t RooStats::HistFactory::HistFactoryNLL::numGenericFactors() const
+{
+  // Return the number of factors of all samples that could not be
+  // flattened and are evaluated bin by bin through RooFit
+
+  if (!_init) initialize() ;
+  Int_t n(0) ;
+  for (UInt_t i=0 ; i<_channels.size() ; i++) {
+    for (UInt_t j=0 ; j<_channels[i]->samples.size() ; j++) {
+      n += _channels[i]->samples[j].generic.size() ;
+    }
+  }
+  return n ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooStats::HistFactory::HistFactoryNLL::clearChannels() const
+{
+  // Delete the flattened representation of the model
+
+  for (UInt_t i=0 ; i<_channels.size() ; i++) {
+    delete _channels[i]->observables ;
+    delete _channels[i] ;
+  }
+  _channels.clear() ;
+  _init = kFALSE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooStats::HistFactory::HistFactoryNLL::initialize() const
+{
+  // Build the flattened representation of the model. The channels of a
+  // RooSimultaneous are included if they have data, or, for an extended
+  // likelihood, always, as RooNLLVar does
+
+  clearChannels() ;
+
+  RooSimultaneous* simPdf = dynamic_cast<RooSimultaneous*>(_pdf) ;
+  if (!simPdf) {
+    if (!addChannel(_pdf,_data)) {
+      clearChannels() ;
+      throw std::runtime_error("HistFactoryNLL: model is not supported") ;
+    }
+    _simCount = 1 ;
+    _init = kTRUE ;
+    return kTRUE ;
+  }
+
+  RooAbsCategoryLValue& simCat = (RooAbsCategoryLValue&) simPdf->indexCat() ;
+  TList* dsetList = _data->split(simCat,_extended) ;
+  if (!dsetList) {
+    coutE(InputArguments) << "HistFactoryNLL::initialize(" << GetName() << ") ERROR: index category of simultaneous pdf is missing in dataset" << endl ;
+    throw std::runtime_error("HistFactoryNLL: index category of simultaneous pdf is missing in dataset") ;
+  }
+
+  Bool_t ok(kTRUE) ;
+  RooCatType* type ;
+  TIterator* catIter = simCat.typeIterator() ;
+  while((type=(RooCatType*)catIter->Next())) {
+    RooAbsPdf* pdf = simPdf->getPdf(type->GetName()) ;
+    RooAbsData* dset = (RooAbsData*) dsetList->FindObject(type->GetName()) ;
+    if (pdf && dset && (dset->sumEntries()!=0. || _extended)) {
+      ok &= addChannel(pdf,dset) ;
+    }
+  }
+  delete catIter ;
+
+  // Delete datasets by hand as TList::Delete() doesn't see our datasets as 'on the heap'...
+  TIterator* iter = dsetList->MakeIterator() ;
+  TObject* ds ;
+  while((ds=iter->Next())) {
+    delete ds ;
+  }
+  delete iter ;
+  delete dsetList ;
+
+  if (!ok) {
+    clearChannels() ;
+    throw std::runtime_error("HistFactoryNLL: model is not supported") ;
+  }
+
+  _simCount = _channels.size() ;
+  _init = kTRUE ;
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooStats::HistFactory::HistFactoryNLL::addChannel(RooAbsPdf* channelPdf, RooAbsData* data) const
+{
+  // Flatten a single channel p.d.f. and tabulate the given data. The channel
+  // must be a RooRealSumPdf, or a RooProdPdf of a RooRealSumPdf and terms
+  // that do not depend on the observables (the constraint terms)
+
+  RooAbsPdf* sumPdf = dynamic_cast<RooRealSumPdf*>(channelPdf) ? channelPdf : getSumPdfFromChannel(channelPdf) ;
+  if (!sumPdf) {
+    coutE(InputArguments) << "HistFactoryNLL::addChannel(" << GetName() << ") ERROR: no RooRealSumPdf found in channel "
+			  << channelPdf->GetName() << endl ;
+    return kFALSE ;
+  }
+
+  RooArgSet* obs = channelPdf->getObservables(*data) ;
+
+  // Only the sum p.d.f. may depend on the observables
+  if (channelPdf!=sumPdf) {
+    RooProdPdf* prodPdf = dynamic_cast<RooProdPdf*>(channelPdf) ;
+    Bool_t ok(prodPdf!=0) ;
+    if (prodPdf) {
+      RooFIter iter = prodPdf->pdfList().fwdIterator() ;
+      RooAbsArg* term ;
+      while((term=iter.next())) {
+	if (term!=sumPdf && term->dependsOn(*obs)) ok = kFALSE ;
+      }
+    }
+    if (!ok) {
+      coutE(InputArguments) << "HistFactoryNLL::addChannel(" << GetName() << ") ERROR: channel " << channelPdf->GetName()
+			    << " has observable dependent terms other than " << sumPdf->GetName() << endl ;
+      delete obs ;
+      return kFALSE ;
+    }
+  }
+
+  ChannelCache* ch = new ChannelCache ;
+  ch->sumPdf = sumPdf ;
+  ch->observables = obs ;
+  _channels.push_back(ch) ;
+
+  // All observables must be real-valued and present in the data
+  std::vector<RooRealVar*> dataVars ;
+  RooFIter oiter = obs->fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg=oiter.next())) {
+    RooRealVar* var = dynamic_cast<RooRealVar*>(arg) ;
+    RooRealVar* dvar = dynamic_cast<RooRealVar*>(data->get()->find(arg->GetName())) ;
+    if (!var || !dvar) {
+      coutE(InputArguments) << "HistFactoryNLL::addChannel(" << GetName() << ") ERROR: observable " << arg->GetName()
+			    << " of channel " << channelPdf->GetName() << " is not a real-valued variable of the data" << endl ;
+      return kFALSE ;
+    }
+    ch->obsVars.push_back(var) ;
+    dataVars.push_back(dvar) ;
+  }
+  UInt_t nObs = ch->obsVars.size() ;
+
+  // Collect the data points with non-zero weight
+  std::vector< std::vector<Double_t> > evtX(nObs) ;
+  std::vector<Double_t> evtW ;
+  for (Int_t i=0 ; i<data->numEntries() ; i++) {
+    data->get(i) ;
+    Double_t w = data->weight() ;
+    if (w==0) continue ;
+    for (UInt_t d=0 ; d<nObs ; d++) {
+      evtX[d].push_back(dataVars[d]->getVal()) ;
+    }
+    evtW.push_back(w) ;
+  }
+  ch->sumW = data->sumEntries() ;
+
+  // Use the cells of the model binning as bins if the model is binned in
+  // all observables and all data points fall in a cell
+  Bool_t binned = nObs>0 && sumPdf->isBinnedDistribution(*obs) ;
+  std::vector< std::vector<Double_t> > bounds ;
+  for (UInt_t d=0 ; binned && d<nObs ; d++) {
+    RooRealVar* var = ch->obsVars[d] ;
+    std::list<Double_t>* binb = sumPdf->binBoundaries(*var,var->getMin(),var->getMax()) ;
+    if (!binb || binb->size()<2) {
+      binned = kFALSE ;
+    } else {
+      bounds.push_back(std::vector<Double_t>(binb->begin(),binb->end())) ;
+    }
+    delete binb ;
+  }
+
+  std::vector<Double_t> cellW ;
+  if (binned) {
+    Int_t nCells(1) ;
+    for (UInt_t d=0 ; d<nObs ; d++) nCells *= bounds[d].size()-1 ;
+    cellW.resize(nCells,0.) ;
+    for (UInt_t i=0 ; binned && i<evtW.size() ; i++) {
+      Int_t idx(0) ;
+      for (UInt_t d=0 ; d<nObs ; d++) {
+	const std::vector<Double_t>& b = bounds[d] ;
+	Int_t nb = b.size()-1 ;
+	Int_t k = (std::upper_bound(b.begin(),b.end(),evtX[d][i]) - b.begin()) - 1 ;
+	if (evtX[d][i]==b.back()) k = nb-1 ;
+	if (k<0 || k>=nb) {
+	  binned = kFALSE ;
+	  break ;
+	}
+	idx = idx*nb + k ;
+      }
+      if (binned) cellW[idx] += evtW[i] ;
+    }
+  }
+
+  if (binned) {
+    Int_t nCells = cellW.size() ;
+    ch->binned = kTRUE ;
+    ch->nBins = nCells ;
+    ch->x.resize(nObs) ;
+    ch->volume.resize(nCells) ;
+    std::vector<Int_t> cell(nObs) ;
+    for (Int_t c=0 ; c<nCells ; c++) {
+      Int_t rem(c) ;
+      for (Int_t d=nObs-1 ; d>=0 ; d--) {
+	Int_t nb = bounds[d].size()-1 ;
+	cell[d] = rem % nb ;
+	rem /= nb ;
+      }
+      Double_t vol(1) ;
+      for (UInt_t d=0 ; d<nObs ; d++) {
+	const std::vector<Double_t>& b = bounds[d] ;
+	Int_t k = cell[d] ;
+	ch->x[d].push_back((b[k+1]+b[k])/2) ;
+	vol *= (b[k+1]-b[k]) ;
+      }
+      ch->volume[c] = vol ;
+    }
+    ch->weight = cellW ;
+  } else {
+    ch->binned = kFALSE ;
+    ch->nBins = evtW.size() ;
+    ch->x = evtX ;
+    ch->weight = evtW ;
+  }
+  ch->yield.resize(ch->nBins) ;
+  ch->work.resize(ch->nBins) ;
+  ch->work2.resize(ch->nBins) ;
+
+  // Flatten the samples
+  RooArgSet* savedObs = (RooArgSet*) obs->snapshot(kFALSE) ;
+  RooRealSumPdf* realSumPdf = (RooRealSumPdf*) sumPdf ;
+  const RooArgList& funcList = realSumPdf->funcList() ;
+  const RooArgList& coefList = realSumPdf->coefList() ;
+  ch->haveLastCoef = (funcList.getSize()==coefList.getSize()) ;
+  Bool_t ok(kTRUE) ;
+  for (Int_t i=0 ; i<funcList.getSize() ; i++) {
+    ch->samples.push_back(SampleCache()) ;
+    SampleCache& sample = ch->samples.back() ;
+    sample.coef = i<coefList.getSize() ? (RooAbsReal*) coefList.at(i) : 0 ;
+    ok &= addFactor(*ch,sample,(RooAbsReal*)funcList.at(i)) ;
+  }
+  *obs = *savedObs ;
+  delete savedObs ;
+
+  coutI(Fitting) << "HistFactoryNLL::addChannel(" << GetName() << ") channel " << channelPdf->GetName() << " with "
+		 << ch->samples.size() << " samples and " << ch->nBins << (ch->binned ? " bins" : " data points") << endl ;
+
+  return ok ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooStats::HistFactory::HistFactoryNLL::addFactor(ChannelCache& ch, SampleCache& sample, RooAbsReal* factor) const
+{
+  // Add a factor of the given sample to its flattened representation.
+  // Products are split in their components, unless they contain categories
+  // or p.d.f.s that would be evaluated with a normalization set
+
+  RooProduct* prod = dynamic_cast<RooProduct*>(factor) ;
+  if (prod) {
+    RooArgSet comps = prod->components() ;
+    Bool_t split(kTRUE) ;
+    RooFIter iter = comps.fwdIterator() ;
+    RooAbsArg* comp ;
+    while((comp=iter.next())) {
+      if (!dynamic_cast<RooAbsReal*>(comp) || dynamic_cast<RooAbsPdf*>(comp)) split = kFALSE ;
+    }
+    if (split) {
+      Bool_t ok(kTRUE) ;
+      iter = comps.fwdIterator() ;
+      while((comp=iter.next())) {
+	ok &= addFactor(ch,sample,(RooAbsReal*)comp) ;
+      }
+      return ok ;
+    }
+  }
+
+  const RooArgSet& obs = *ch.observables ;
+  Int_t n = ch.nBins ;
+
+  // Factors that do not depend on the observables
+  if (!factor->dependsOn(obs)) {
+    sample.scalars.push_back(factor) ;
+    return kTRUE ;
+  }
+
+  // Factors that only depend on the observables
+  RooArgSet* params = factor->getParameters(obs) ;
+  Bool_t noParams = (params->getSize()==0) ;
+  delete params ;
+  if (noParams) {
+    if (sample.fixed.empty()) sample.fixed.resize(n,1.) ;
+    for (Int_t j=0 ; j<n ; j++) {
+      loadBin(ch,j) ;
+      sample.fixed[j] *= factor->getVal() ;
+    }
+    return kTRUE ;
+  }
+
+  // Interpolation of histograms that only depend on the observables
+  PiecewiseInterpolation* pi = dynamic_cast<PiecewiseInterpolation*>(factor) ;
+  if (pi) {
+    Bool_t tabulate(kTRUE) ;
+    RooArgList hists(pi->nominalHist()) ;
+    hists.add(pi->lowList()) ;
+    hists.add(pi->highList()) ;
+    RooFIter hiter = hists.fwdIterator() ;
+    RooAbsArg* hist ;
+    while((hist=hiter.next())) {
+      RooArgSet* hparams = hist->getParameters(obs) ;
+      if (hparams->getSize()>0) tabulate = kFALSE ;
+      delete hparams ;
+    }
+    RooFIter piter = pi->paramList().fwdIterator() ;
+    RooAbsArg* param ;
+    while((param=piter.next())) {
+      if (param->dependsOn(obs)) tabulate = kFALSE ;
+    }
+
+    if (tabulate) {
+      Int_t np = pi->paramList().getSize() ;
+      std::vector<Double_t> nom(n), lo(np*n), hi(np*n) ;
+      for (Int_t j=0 ; j<n ; j++) {
+	loadBin(ch,j) ;
+	nom[j] = pi->nominalHist().getVal() ;
+	for (Int_t k=0 ; k<np ; k++) {
+	  lo[k*n+j] = ((RooAbsReal*)pi->lowList().at(k))->getVal() ;
+	  hi[k*n+j] = ((RooAbsReal*)pi->highList().at(k))->getVal() ;
+	}
+      }
+      sample.interp.push_back(pi) ;
+      sample.nominal.push_back(nom) ;
+      sample.low.push_back(lo) ;
+      sample.high.push_back(hi) ;
+      sample.nInterpParams += np ;
+      return kTRUE ;
+    }
+  }
+
+  // Bin-wise parameters
+  ParamHistFunc* phf = dynamic_cast<ParamHistFunc*>(factor) ;
+  if (phf) {
+    std::vector<RooAbsReal*> binPars(n) ;
+    for (Int_t j=0 ; j<n ; j++) {
+      loadBin(ch,j) ;
+      binPars[j] = &phf->getParameter() ;
+    }
+    sample.binParams.push_back(binPars) ;
+    return kTRUE ;
+  }
+
+  coutI(Fitting) << "HistFactoryNLL::addFactor(" << GetName() << ") factor " << factor->GetName() << " of class "
+		 << factor->ClassName() << " is evaluated bin by bin" << endl ;
+  sample.generic.push_back(factor) ;
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooStats::HistFactory::HistFactoryNLL::loadBin(const ChannelCache& ch, Int_t bin) const
+{
+  // Set the observables of the channel to the center of the given bin (data point)
+
+  for (UInt_t d=0 ; d<ch.obsVars.size() ; d++) {
+    ch.obsVars[d]->setVal(ch.x[d][bin]) ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+Double_t RooStats::HistFactory::HistFactoryNLL::channelNLL(const ChannelCache& ch) const
+{
+  // Calculate the -log(L) of a single channel. The expected yields of all
+  // bins are the sum of the sample yields, the sample yields are the
+  // product of the tabulated and interpolated factors. The handling of the
+  // coefficients, of negative and zero probabilities and of the extended
+  // term follows RooRealSumPdf, RooAbsPdf and RooNLLVar
+
+  Int_t n = ch.nBins ;
+  Double_t* yield = n>0 ? &ch.yield[0] : 0 ;
+  Double_t* work = n>0 ? &ch.work[0] : 0 ;
+  Double_t* work2 = n>0 ? &ch.work2[0] : 0 ;
+  Int_t j ;
+
+  for (j=0 ; j<n ; j++) yield[j] = 0 ;
+
+  RooArgSet* savedObs(0) ;
+  Double_t lastCoef(1) ;
+  for (UInt_t i=0 ; i<ch.samples.size() ; i++) {
+    const SampleCache& sample = ch.samples[i] ;
+
+    Double_t coefVal ;
+    if (sample.coef) {
+      coefVal = sample.coef->getVal() ;
+      if (coefVal==0) continue ;
+      lastCoef -= coefVal ;
+    } else {
+      coefVal = lastCoef ;
+    }
+
+    Double_t scale(coefVal) ;
+    for (UInt_t k=0 ; k<sample.scalars.size() ; k++) {
+      scale *= sample.scalars[k]->getVal() ;
+    }
+
+    if (sample.fixed.empty()) {
+      for (j=0 ; j<n ; j++) work[j] = scale ;
+    } else {
+      const Double_t* fixed = &sample.fixed[0] ;
+      for (j=0 ; j<n ; j++) work[j] = scale*fixed[j] ;
+    }
+
+    for (UInt_t k=0 ; k<sample.interp.size() ; k++) {
+      const std::vector<Double_t>& lo = sample.low[k] ;
+      const std::vector<Double_t>& hi = sample.high[k] ;
+      const std::vector<Double_t>& nom = sample.nominal[k] ;
+      sample.interp[k]->evaluateArray(n,nom.empty()?0:&nom[0],lo.empty()?0:&lo[0],hi.empty()?0:&hi[0],work2) ;
+      for (j=0 ; j<n ; j++) work[j] *= work2[j] ;
+    }
+
+    for (UInt_t k=0 ; k<sample.binParams.size() ; k++) {
+      const std::vector<RooAbsReal*>& pars = sample.binParams[k] ;
+      for (j=0 ; j<n ; j++) work[j] *= pars[j]->getVal() ;
+    }
+
+    if (!sample.generic.empty()) {
+      if (!savedObs) savedObs = (RooArgSet*) ch.observables->snapshot(kFALSE) ;
+      for (j=0 ; j<n ; j++) {
+	loadBin(ch,j) ;
+	for (UInt_t k=0 ; k<sample.generic.size() ; k++) {
+	  work[j] *= sample.generic[k]->getVal() ;
+	}
+      }
+    }
+
+    for (j=0 ; j<n ; j++) yield[j] += work[j] ;
+  }
+
+  if (savedObs) {
+    *ch.observables = *savedObs ;
+    delete savedObs ;
+  }
+
+  // Normalization integral, which is also the expected number of events
+  Double_t norm(0) ;
+  if (ch.binned) {
+    for (j=0 ; j<n ; j++) norm += yield[j]*ch.volume[j] ;
+  } else {
+    norm = ch.sumPdf->getNorm(ch.observables) ;
+  }
+  if (norm<=0.) {
+    logEvalError("p.d.f normalization integral is zero or negative") ;
+  }
+
+  Double_t result(0), sumWeight(0) ;
+  for (j=0 ; j<n ; j++) {
+    Double_t w = ch.weight[j] ;
+    if (w==0) continue ;
+
+    Double_t prob = (yield[j]<0 || TMath::IsNaN(yield[j]) || norm<=0.) ? 0 : yield[j]/norm ;
+    Double_t logProb ;
+    if (prob==0 || TMath::IsNaN(prob)) {
+      logEvalError("p.d.f evaluates to zero, negative or NaN") ;
+      logProb = log((double)0) ;
+    } else {
+      logProb = log(prob) ;
+    }
+
+    result -= w*logProb ;
+    sumWeight += w ;
+  }
+
+  // Extended term, as in RooAbsPdf::extendedTerm()
+  if (_extended) {
+    Double_t observed = ch.sumW ;
+    if (!ch.sumPdf->canBeExtended()) {
+      coutE(InputArguments) << ch.sumPdf->GetName() << ": this PDF does not support extended maximum likelihood" << endl ;
+    } else if (norm<0) {
+      coutE(InputArguments) << ch.sumPdf->GetName() << ": calculated negative expected events: " << norm << endl ;
+    } else if (fabs(norm)<1e-10 && fabs(observed)<1e-10) {
+      // Nobs=Nexp=0
+    } else if (TMath::IsNaN(norm)) {
+      logEvalError("extendedTerm #expected events is <0 or NaN") ;
+    } else {
+      result += norm - observed*log(norm) ;
+    }
+  }
+
+  // Normalize probability over number of channels: -sum(log(p/n)) = -sum(log(p)) + N*log(n)
+  if (_simCount>1) {
+    result += sumWeight*log(1.0*_simCount) ;
+  }
+
+  return result ;
+}
+
+
+
+//_____________________________________________________________________________
+Double_t RooStats::HistFactory::HistFactoryNLL::evaluate() const
+{
+  // Calculate and return the -log(L) as the sum of the -log(L) of all channels
+
+  if (!_init) initialize() ;
+
+  Double_t result(0) ;
+  for (UInt_t i=0 ; i<_channels.size() ; i++) {
+    result += channelNLL(*_channels[i]) ;
+  }
+
+  return result ;
+}
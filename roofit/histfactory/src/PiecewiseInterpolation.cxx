@@ -166,118 +166,8 @@ Double_t PiecewiseInterpolation::evaluate() const
     low = (RooAbsReal*)lowIter.next() ;
     high = (RooAbsReal*)highIter.next() ;
 
-    /* // MB : old bit of interpolation code
-    if(param->getVal()>0)
-      sum += param->getVal()*(high->getVal() - nominal );
-    else
-      sum += param->getVal()*(nominal - low->getVal());
-    */
-    //cout << "interp code is " << _interpCode.at(i) << endl;
-    if(_interpCode.empty() || _interpCode.at(i)==0){
-      // piece-wise linear
-      if(param->getVal()>0)
-	sum +=  param->getVal()*(high->getVal() - nominal );
-      else
-	sum += param->getVal()*(nominal - low->getVal());
-    } else if(_interpCode.at(i)==1){
-      // pice-wise log
-      if(param->getVal()>=0)
-	sum *= pow(high->getVal()/nominal, +param->getVal());
-      else
-	sum *= pow(low->getVal()/nominal,  -param->getVal());
-    } else if(_interpCode.at(i)==2){
-      // parabolic with linear
-      double a = 0.5*(high->getVal()+low->getVal())-nominal;
-      double b = 0.5*(high->getVal()-low->getVal());
-      double c = 0;
-      if(param->getVal()>1 ){
-	sum += (2*a+b)*(param->getVal()-1)+high->getVal()-nominal;
-      } else if(param->getVal()<-1 ) {
-	sum += -1*(2*a-b)*(param->getVal()+1)+low->getVal()-nominal;
-      } else {
-	sum +=  a*pow(param->getVal(),2) + b*param->getVal()+c;
-      }
-    } else if(_interpCode.at(i)==3){
-      //parabolic version of log-normal
-      double a = 0.5*(high->getVal()+low->getVal())-nominal;
-      double b = 0.5*(high->getVal()-low->getVal());
-      double c = 0;
-      if(param->getVal()>1 ){
-	sum += (2*a+b)*(param->getVal()-1)+high->getVal()-nominal;
-      } else if(param->getVal()<-1 ) {
-	sum += -1*(2*a-b)*(param->getVal()+1)+low->getVal()-nominal;
-      } else {
-	sum +=  a*pow(param->getVal(),2) + b*param->getVal()+c;
-      }
-	
-    } else if (_interpCode.at(i) == 4){ // AA - 6th order poly interp + linear extrap
-      
-      double x0 = 1.0;//boundary;
-      double x  = param->getVal();
-
-      if (x > x0 || x < -x0)
-      {
-	if(x>0)
-	  sum += x*(high->getVal() - nominal );
-	else
-	  sum += x*(nominal - low->getVal());
-      }
-      else
-      {
-	double eps_plus = high->getVal() - nominal;
-	double eps_minus = nominal - low->getVal();
-	double S = (eps_plus + eps_minus)/2;
-	double A = (eps_plus - eps_minus)/2;
-
-//fcns+der+2nd_der are eq at bd
-	double a = S;
-	double b = 15*A/(8*x0);
-	//double c = 0;
-	double d = -10*A/(8*x0*x0*x0);
-	//double e = 0;
-	double f = 3*A/(8*x0*x0*x0*x0*x0);
-
-	double val = nominal + a*x + b*pow(x, 2) + 0/*c*pow(x, 3)*/ + d*pow(x, 4) + 0/*e*pow(x, 5)*/ + f*pow(x, 6);
-	if (val < 0) val = 0;
-	//cout << "Using interp code 4, val = " << val << endl;
-	sum += val-nominal;
-      }
-	
-    } else if (_interpCode.at(i) == 5){ // AA - 4th order poly interp + linear extrap
-      
-      double x0 = 1.0;//boundary;
-      double x  = param->getVal();
-
-      if (x > x0 || x < -x0)
-      {
-	if(x>0)
-	  sum += x*(high->getVal() - nominal );
-	else
-	  sum += x*(nominal - low->getVal());
-      }
-      else if (nominal != 0)
-      {
-	double eps_plus = high->getVal() - nominal;
-	double eps_minus = nominal - low->getVal();
-	double S = (eps_plus + eps_minus)/2;
-	double A = (eps_plus - eps_minus)/2;
-
-//fcns+der are eq at bd
-	double a = S;
-	double b = 3*A/(2*x0);
-	//double c = 0;
-	double d = -A/(2*x0*x0*x0);
-
-	double val = nominal + a*x + b*pow(x, 2) + 0/*c*pow(x, 3)*/ + d*pow(x, 4);
-	if (val < 0) val = 0;
-
-	//cout << "Using interp code 5, val = " << val << endl;
-
-	sum += val-nominal;
-      }
-
-
-    } else {
+    Int_t code = _interpCode.empty() ? 0 : _interpCode.at(i) ;
+    if (!interpolate(code,param->getVal(),nominal,low->getVal(),high->getVal(),sum)) {
       coutE(InputArguments) << "PiecewiseInterpolation::evaluate ERROR:  " << param->GetName() 
 			    << " with unknown interpolation code" << endl ;
     }
@@ -286,12 +176,7 @@ Double_t PiecewiseInterpolation::evaluate() const
   }
 
   if(_positiveDefinite && (sum<0)){
-    sum = 1e-6;
     sum = 0;
-    //     cout <<"sum < 0 forcing  positive definite"<<endl;
-     //     int code = 1;
-     //     RooArgSet* myset = new RooArgSet();
-     //     cout << "integral = " << analyticalIntegralWN(code, myset) << endl;
   } else if(sum<0){
      cout <<"sum < 0, not forcing positive definite"<<endl;
   }
@@ -300,6 +185,153 @@ Double_t PiecewiseInterpolation::evaluate() const
 }
 
 
+
+//_____________________________________________________________________________
+void PiecewiseInterpolation::evaluateArray(Int_t n, const Double_t* nominal, const Double_t* low, 
+					   const Double_t* high, Double_t* output) const
+{
+  // Evaluate the interpolation for n bins at once, for the current values 
+  // of the interpolation parameters. The nominal values of the bins are 
+  // given in nominal[j], the low and high variations of parameter k in
+  // low[k*n+j] and high[k*n+j]. This is the same calculation as evaluate(),
+  // but the parameters are looped over only once for all bins
+
+  Int_t j ;
+  for (j=0 ; j<n ; j++) {
+    output[j] = nominal[j] ;
+  }
+
+  RooAbsReal* param ;
+  RooFIter paramIter(_paramSet.fwdIterator()) ;
+  Int_t k(0) ;
+  while((param=(RooAbsReal*)paramIter.next())) {
+    Int_t code = _interpCode.empty() ? 0 : _interpCode.at(k) ;
+    Double_t x = param->getVal() ;
+    const Double_t* lo = low + k*n ;
+    const Double_t* hi = high + k*n ;
+    Bool_t ok(kTRUE) ;
+    for (j=0 ; j<n ; j++) {
+      ok = interpolate(code,x,nominal[j],lo[j],hi[j],output[j]) ;
+    }
+    if (!ok) {
+      coutE(InputArguments) << "PiecewiseInterpolation::evaluateArray ERROR:  " << param->GetName() 
+			    << " with unknown interpolation code" << endl ;
+    }
+    ++k ;
+  }
+
+  for (j=0 ; j<n ; j++) {
+    if(_positiveDefinite && (output[j]<0)){
+      output[j] = 0;
+    } else if(output[j]<0){
+      cout <<"sum < 0, not forcing positive definite"<<endl;
+    }
+  }
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t PiecewiseInterpolation::interpolate(Int_t code, Double_t x, Double_t nominal, Double_t low, Double_t high, Double_t& sum) 
+{
+  // Apply the variation of a single interpolation parameter with value x
+  // to the running value sum of a bin with the given nominal, low and high
+  // values. Code 1 (piece-wise log) scales the sum, all other codes add to it.
+  // Return false if the interpolation code is unknown
+
+  if(code==0){
+    // piece-wise linear
+    if(x>0)
+      sum +=  x*(high - nominal );
+    else
+      sum += x*(nominal - low);
+  } else if(code==1){
+    // pice-wise log
+    if(x>=0)
+      sum *= pow(high/nominal, +x);
+    else
+      sum *= pow(low/nominal,  -x);
+  } else if(code==2 || code==3){
+    // parabolic with linear (code 3 is the parabolic version of log-normal)
+    double a = 0.5*(high+low)-nominal;
+    double b = 0.5*(high-low);
+    double c = 0;
+    if(x>1 ){
+      sum += (2*a+b)*(x-1)+high-nominal;
+    } else if(x<-1 ) {
+      sum += -1*(2*a-b)*(x+1)+low-nominal;
+    } else {
+      sum +=  a*pow(x,2) + b*x+c;
+    }
+  } else if (code == 4){ // AA - 6th order poly interp + linear extrap
+    
+    double x0 = 1.0;//boundary;
+
+    if (x > x0 || x < -x0)
+    {
+      if(x>0)
+	sum += x*(high - nominal );
+      else
+	sum += x*(nominal - low);
+    }
+    else
+    {
+      double eps_plus = high - nominal;
+      double eps_minus = nominal - low;
+      double S = (eps_plus + eps_minus)/2;
+      double A = (eps_plus - eps_minus)/2;
+
+//fcns+der+2nd_der are eq at bd
+      double a = S;
+      double b = 15*A/(8*x0);
+      //double c = 0;
+      double d = -10*A/(8*x0*x0*x0);
+      //double e = 0;
+      double f = 3*A/(8*x0*x0*x0*x0*x0);
+
+      double val = nominal + a*x + b*pow(x, 2) + 0/*c*pow(x, 3)*/ + d*pow(x, 4) + 0/*e*pow(x, 5)*/ + f*pow(x, 6);
+      if (val < 0) val = 0;
+      sum += val-nominal;
+    }
+      
+  } else if (code == 5){ // AA - 4th order poly interp + linear extrap
+    
+    double x0 = 1.0;//boundary;
+
+    if (x > x0 || x < -x0)
+    {
+      if(x>0)
+	sum += x*(high - nominal );
+      else
+	sum += x*(nominal - low);
+    }
+    else if (nominal != 0)
+    {
+      double eps_plus = high - nominal;
+      double eps_minus = nominal - low;
+      double S = (eps_plus + eps_minus)/2;
+      double A = (eps_plus - eps_minus)/2;
+
+//fcns+der are eq at bd
+      double a = S;
+      double b = 3*A/(2*x0);
+      //double c = 0;
+      double d = -A/(2*x0*x0*x0);
+
+      double val = nominal + a*x + b*pow(x, 2) + 0/*c*pow(x, 3)*/ + d*pow(x, 4);
+      if (val < 0) val = 0;
+
+      sum += val-nominal;
+    }
+
+  } else {
+    return kFALSE ;
+  }
+
+  return kTRUE ;
+}
+
+
 //_____________________________________________________________________________
 Bool_t PiecewiseInterpolation::setBinIntegrator(RooArgSet& allVars) 
 {
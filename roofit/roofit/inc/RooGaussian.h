@@ -43,6 +43,8 @@ protected:
   RooRealProxy sigma ;
   
   Double_t evaluate() const ;
+  virtual Bool_t evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
 
 private:
 
@@ -46,6 +46,8 @@ protected:
   TIterator* _coefIter ;  //! do not persist
 
   Double_t evaluate() const;
+  virtual Bool_t evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
 
   ClassDef(RooPolynomial,1) // Polynomial PDF
 };
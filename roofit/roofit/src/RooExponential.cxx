@@ -29,6 +29,7 @@
 
 #include "RooExponential.h"
 #include "RooRealVar.h"
+#include "RooVectorDataStore.h"
 
 using namespace std;
 
@@ -59,6 +60,55 @@ Double_t RooExponential::evaluate() const{
 }
 
 
+
+//_____________________________________________________________________________
+Bool_t RooExponential::evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* /*normSet*/) const
+{
+  // Batch version of evaluate()
+  std::vector<Double_t> xBuf, cBuf ;
+  const Double_t* xVal = batchValues(x.arg(),begin,end,xBuf,data,x.nset()) ;
+  const Double_t* cVal = batchValues(c.arg(),begin,end,cBuf,data,c.nset()) ;
+
+  const Int_t n = end-begin ;
+  for (Int_t i=0 ; i<n ; i++) {
+    output[i] = exp(cVal[i]*xVal[i]) ;
+  }
+  return kTRUE ;
+}
+
+
+//_____________________________________________________________________________
+Bool_t RooExponential::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const
+{
+  // Analytical gradient of the exponential, normalized over x if x is in normSet
+
+  Int_t xNorm = gradientNormCode(x.arg(),normSet) ;
+  if (xNorm<0 || gradientNormCode(c.arg(),normSet)!=0) return kFALSE ;
+
+  Double_t val = exp(c*x) ;
+  Double_t dx = c*val ;
+  Double_t dc = x*val ;
+
+  if (xNorm) {
+    Double_t norm = getNorm(normSet) ;
+    Double_t xmin = x.min(normRange()) ;
+    Double_t xmax = x.max(normRange()) ;
+    Double_t dNormdc ;
+    if (c == 0.0) {
+      dNormdc = 0.5*(xmax*xmax - xmin*xmin) ;
+    } else {
+      dNormdc = (xmax*exp(c*xmax) - xmin*exp(c*xmin))/c - norm/c ;
+    }
+    dx /= norm ;
+    dc = dc/norm - val*dNormdc/(norm*norm) ;
+  }
+
+  if (!addGradient(x.arg(),dx,params,grad,normSet)) return kFALSE ;
+  return addGradient(c.arg(),dc,params,grad,normSet) ;
+}
+
+
+
 //_____________________________________________________________________________
 Int_t RooExponential::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
 {
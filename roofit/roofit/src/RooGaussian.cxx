@@ -32,6 +32,7 @@
 #include "RooRealVar.h"
 #include "RooRandom.h"
 #include "RooMath.h"
+#include "RooVectorDataStore.h"
 
 using namespace std;
 
@@ -72,6 +73,80 @@ Double_t RooGaussian::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooGaussian::evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* /*normSet*/) const
+{
+  // Batch version of evaluate()
+  std::vector<Double_t> xBuf, meanBuf, sigmaBuf ;
+  const Double_t* xVal = batchValues(x.arg(),begin,end,xBuf,data,x.nset()) ;
+  const Double_t* meanVal = batchValues(mean.arg(),begin,end,meanBuf,data,mean.nset()) ;
+  const Double_t* sigmaVal = batchValues(sigma.arg(),begin,end,sigmaBuf,data,sigma.nset()) ;
+
+  const Int_t n = end-begin ;
+  for (Int_t i=0 ; i<n ; i++) {
+    Double_t arg = xVal[i] - meanVal[i] ;
+    Double_t sig = sigmaVal[i] ;
+    output[i] = exp(-0.5*arg*arg/(sig*sig)) ;
+  }
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooGaussian::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const
+{
+  // Analytical gradient of the Gaussian. If it is normalized over x (or over 
+  // mean) the derivatives of the normalization integral with respect to mean
+  // (or x) and sigma are calculated from the values at the boundaries of the
+  // normalization range. When normalized over both x and mean the derivative
+  // with respect to sigma is not calculated.
+
+  Int_t xNorm = gradientNormCode(x.arg(),normSet) ;
+  Int_t mNorm = gradientNormCode(mean.arg(),normSet) ;
+  if (xNorm<0 || mNorm<0 || gradientNormCode(sigma.arg(),normSet)!=0) return kFALSE ;
+  if (xNorm && mNorm && sigma.arg().dependsOnValue(params)) return kFALSE ;
+
+  Double_t sig = sigma ;
+  Double_t arg = x - mean ;
+  Double_t val = exp(-0.5*arg*arg/(sig*sig)) ;
+  Double_t dx = -arg/(sig*sig)*val ;
+  Double_t dm = -dx ;
+  Double_t ds = arg*arg/(sig*sig*sig)*val ;
+
+  if (xNorm || mNorm) {
+    Double_t norm = getNorm(normSet) ;
+    dx /= norm ; 
+    dm /= norm ;
+    ds /= norm ;
+    if (!(xNorm && mNorm)) {
+      // Integral of exp(-0.5*((t-c)/sigma)^2) over t in [tmin,tmax], with t=x and c=mean or vice versa 
+      const RooRealProxy& t = xNorm ? x : mean ;
+      Double_t c = xNorm ? mean : x ;
+      Double_t ua = (t.min(normRange())-c)/sig ;
+      Double_t ub = (t.max(normRange())-c)/sig ;
+      Double_t ga = exp(-0.5*ua*ua) ;
+      Double_t gb = exp(-0.5*ub*ub) ;
+      Double_t dNormdc = ga - gb ;
+      Double_t dNormds = norm/sig - (ub*gb - ua*ga) ;
+      Double_t f = val/norm ;
+      if (xNorm) {
+	dm -= f*dNormdc/norm ;
+      } else {
+	dx -= f*dNormdc/norm ;
+      }
+      ds -= f*dNormds/norm ;
+    }
+  }
+
+  if (!addGradient(x.arg(),dx,params,grad,normSet)) return kFALSE ;
+  if (!addGradient(mean.arg(),dm,params,grad,normSet)) return kFALSE ;
+  if (!(xNorm && mNorm) && !addGradient(sigma.arg(),ds,params,grad,normSet)) return kFALSE ;
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 Int_t RooGaussian::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
 {
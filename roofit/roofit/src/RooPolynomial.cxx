@@ -37,6 +37,7 @@
 #include "RooAbsReal.h"
 #include "RooRealVar.h"
 #include "RooArgList.h"
+#include "RooVectorDataStore.h"
 
 using namespace std;
 
@@ -144,6 +145,68 @@ Double_t RooPolynomial::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooPolynomial::evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* /*normSet*/) const
+{
+  // Batch version of evaluate()
+  std::vector<Double_t> xBuf, coefBuf ;
+  const Double_t* xVal = batchValues(_x.arg(),begin,end,xBuf,data,_x.nset()) ;
+
+  const Int_t n = end-begin ;
+  Int_t order(_lowestOrder) ;
+  for (Int_t i=0 ; i<n ; i++) output[i] = (order<1 ? 0 : 1) ;
+
+  RooFIter iter = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  const RooArgSet* nset = _coefList.nset() ;
+  while((coef=(RooAbsReal*)iter.next())) {
+    const Double_t* coefVal = batchValues(*coef,begin,end,coefBuf,data,nset) ;
+    for (Int_t i=0 ; i<n ; i++) output[i] += coefVal[i]*TMath::Power(xVal[i],order) ;
+    order++ ;
+  }
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooPolynomial::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const
+{
+  // Analytical gradient of the polynomial, normalized over x if x is in normSet
+
+  Int_t xNorm = gradientNormCode(_x.arg(),normSet) ;
+  if (xNorm<0) return kFALSE ;
+
+  Double_t val = evaluate() ;
+  Double_t norm(1), xmin(0), xmax(0) ;
+  if (xNorm) {
+    norm = getNorm(normSet) ;
+    xmin = _x.min(normRange()) ;
+    xmax = _x.max(normRange()) ;
+  }
+
+  Int_t order(_lowestOrder) ;
+  Double_t dx(0) ;
+  RooFIter iter = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  while((coef=(RooAbsReal*)iter.next())) {
+    if (gradientNormCode(*coef,normSet)!=0) return kFALSE ;
+    Double_t cval = coef->getVal() ;
+    if (order>0) dx += cval*order*TMath::Power(_x,order-1) ;
+    Double_t dc = TMath::Power(_x,order)/norm ;
+    if (xNorm) {
+      Double_t dNormdc = (TMath::Power(xmax,order+1)-TMath::Power(xmin,order+1))/(order+1) ;
+      dc -= val*dNormdc/(norm*norm) ;
+    }
+    if (!addGradient(*coef,dc,params,grad,normSet)) return kFALSE ;
+    order++ ;
+  }
+
+  return addGradient(_x.arg(),dx/norm,params,grad,normSet) ;
+}
+
+
+
 //_____________________________________________________________________________
 Int_t RooPolynomial::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
 {
@@ -160,3 +160,18 @@ distclean::     distclean-$(MODNAME)
 $(ROOFITCOREDO1): NOOPT = $(OPT)
 $(ROOFITCOREDO2): NOOPT = $(OPT)
 $(ROOFITCOREDO3): NOOPT = $(OPT)
+
+# for openMP (calculation of the partitions of the test statistics in threads,
+# see RooAbsTestStatistic::setThreadMode, and of the slices of the FFT 
+# convolutions, see RooFFTConvPdf::setNumThreads, and the locks of the state
+# shared by those threads)
+ifneq ($(USE_OPENMP),)
+$(call stripsrc,$(ROOFITCOREDIRS)/RooAbsTestStatistic.o \
+   $(ROOFITCOREDIRS)/RooAbsReal.o \
+   $(ROOFITCOREDIRS)/RooArgSet.o \
+   $(ROOFITCOREDIRS)/RooRealIntegral.o \
+   $(ROOFITCOREDIRS)/RooAbsCachedPdf.o \
+   $(ROOFITCOREDIRS)/RooNameReg.o \
+   $(ROOFITCOREDIRS)/RooFFTConvPdf.o): CXXFLAGS += -fopenmp
+$(ROOFITCORELIB): LDFLAGS += -fopenmp
+endif
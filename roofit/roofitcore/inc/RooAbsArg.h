@@ -546,6 +546,8 @@ public:
   mutable RooExpensiveObjectCache* _eocache ; // Pointer to global cache manager for any expensive components created by this object
 
   mutable TNamed* _namePtr ; //! Do not persist. Pointer to global instance of string that matches object named
+
+  std::set<RooAbsCollection*> _hashedCollections ; //! Collections that contain this object in a hash table by name
   
   ClassDef(RooAbsArg,5) // Abstract variable
 };
@@ -53,12 +53,16 @@ public:
   void setHashTableSize(Int_t i) { 
     // Set size of internal hash table to i (should be a prime number)
     _list.setHashTableSize(i) ; 
+    syncRenameTracking() ;
   }
   Int_t getHashTableSize() const { 
     // Return size of internal hash table
     return _list.getHashTableSize() ; 
   }
 
+  static void setDefaultHashThreshold(Int_t thresh) ;
+  static Int_t defaultHashThreshold() ;
+
   // List content management
   virtual Bool_t add(const RooAbsArg& var, Bool_t silent=kFALSE) ;
   virtual Bool_t addOwned(RooAbsArg& var, Bool_t silent=kFALSE);
@@ -155,11 +159,14 @@ public:
   void releaseOwnership() { _ownCont = kFALSE ; }
   void takeOwnership() { _ownCont = kTRUE ; }
 
-  void sort(Bool_t ascend=kTRUE) { _list.Sort(ascend) ; }
+  void sort(Bool_t ascend=kTRUE) { _list.Sort(ascend) ; _contentsTag = 0 ; }
+
+  ULong_t contentsTag() const ;
 
 protected:
 
   friend class RooMultiCatIter ;
+  friend class RooAbsArg ;
 
   RooLinkedList _list ; // Actual object store
 
@@ -169,6 +176,17 @@ protected:
 
   void safeDeleteList() ;
 
+  static Int_t _defaultHashThreshold ; // Size above which new collections index their contents in a hash table
+  Bool_t _trackRenames ; //! Contents are registered to update the hash table of the list when renamed
+  std::set<RooAbsArg*> _renameTracked ; //! Registered contents that still exist
+  void trackRename(RooAbsArg& var) ;
+  void untrackRename(RooAbsArg& var) ;
+  void untrackAllRenames() ;
+  void syncRenameTracking() ;
+
+  mutable ULong_t _contentsTag ; //! Tag of the current contents and their order, zero if not assigned yet
+  static ULong_t _lastContentsTag ; // Last assigned contents tag
+
   // Support for snapshot method 
   Bool_t addServerClonesToList(const RooAbsArg& var) ;
 
@@ -103,6 +103,10 @@ public:
   const RooArgSet& cachedVars() const { return _cachedVars ; }
   virtual void resetCache() = 0 ;
   virtual void recalculateCache(const RooArgSet* /*proj*/, Int_t /*firstEvent*/, Int_t /*lastEvent*/, Int_t /*stepSize*/) {} ;
+  virtual Bool_t recalculateCachedArgs(const RooArgSet& /*args*/, const RooArgSet* /*nset*/=0) { 
+    // Recalculate the values of the given cached arguments, return false if not supported by the store
+    return kFALSE ; 
+  }
 
   virtual void setDirtyProp(Bool_t flag) { _doDirtyProp = flag ; }
   Bool_t dirtyProp() const { return _doDirtyProp ; }
@@ -72,6 +72,7 @@ protected:
   virtual RooArgSet requiredExtraObservables() const { return RooArgSet() ; }
   void optimizeCaching() ;
   void optimizeConstantTerms(Bool_t,Bool_t=kTRUE) ;
+  Bool_t updateConstantTerms() ;
 
   RooArgSet*  _normSet ; // Pointer to set with observables used for normalization
   RooArgSet*  _funcCloneSet ; // Set owning all components of internal clone of input function
@@ -83,6 +84,8 @@ protected:
   TString     _sealNotice ; // User-defined notice shown when reading a sealed likelihood 
   RooArgSet*  _funcObsSet ; // List of observables in the pdf expression
   RooArgSet   _cachedNodes ; //! List of nodes that are cached as constant expressions
+  RooArgSet   _cachedConstNodes ; //! Subset of cached nodes that depend only on constant parameters
+  RooArgSet*  _optParamSnap ; //! Parameters (values and constant state) at the time of the constant term optimization
   
   RooAbsReal* _origFunc ; // Original function 
   RooAbsData* _origData ; // Original data 
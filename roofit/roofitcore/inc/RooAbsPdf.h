@@ -230,6 +230,7 @@ public:
     // Return expecteded number of p.d.fs to be used in calculated of extended likelihood
     return expectedEvents(&nset) ; 
   }
+  virtual Bool_t expectedEventsGradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const ;
 
   // Printing interface (human readable)
   virtual void printValue(std::ostream& os) const ;
@@ -293,6 +294,9 @@ protected:
 					   Bool_t verbose=kFALSE, Bool_t autoBinned=kTRUE, const char* binnedTag="") const ;
 
 
+  // Helper for the analytical gradients
+  static Int_t gradientNormCode(const RooAbsReal& arg, const RooArgSet* normSet) ;
+
   friend class RooExtendPdf ;
   // This also forces the definition of a copy ctor in derived classes 
   RooAbsPdf(const RooAbsPdf& other, const char* name = 0);
@@ -302,6 +306,8 @@ protected:
 
   virtual Bool_t syncNormalization(const RooArgSet* dset, Bool_t adjustProxies=kTRUE) const ;
 
+  virtual void computeBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+
   friend class RooAbsAnaConvPdf ;
   mutable Double_t _rawValue ;
   mutable RooAbsReal* _norm   ;      //! Normalization integral (owned by _normMgr)
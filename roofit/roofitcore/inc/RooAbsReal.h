@@ -48,6 +48,7 @@ class TH3F;
 
 #include <list>
 #include <string>
+#include <vector>
 #include <iostream>
 
 class RooAbsReal : public RooAbsArg {
@@ -73,6 +74,13 @@ public:
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
 
+  // Batch evaluation on a range of events of a vector data store
+  void getValBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet=0) const ;
+
+  // Analytical gradient with respect to a list of parameters
+  Bool_t getGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet=0) const ;
+  const std::vector<Int_t>& gradientIndex(const RooArgList& params) const ;
+
   Double_t getPropagatedError(const RooFitResult& fr) ;
 
   Bool_t operator==(Double_t value) const ;
@@ -364,6 +372,17 @@ protected:
   }
   virtual Double_t evaluate() const = 0 ;
 
+  // Batch evaluation interface, see getValBatch()
+  virtual void computeBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  void getValEventByEvent(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  static const Double_t* batchValues(const RooAbsReal& arg, Int_t begin, Int_t end, std::vector<Double_t>& buf, 
+				     const RooVectorDataStore& data, const RooArgSet* normSet=0) ;
+
+  // Analytical gradient interface, see getGradient()
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
+  static Bool_t addGradient(const RooAbsReal& arg, Double_t coef, const RooArgList& params, Double_t* grad, const RooArgSet* normSet=0) ;
+
   // Hooks for RooDataSet interface
   friend class RooRealIntegral ;
   friend class RooVectorDataStore ;
@@ -464,6 +483,12 @@ protected:
 
   mutable RooArgSet* _lastNSet ; //!
 
+  mutable const RooArgList* _gradParams ; //! Parameter list of the cached gradient index
+  mutable ULong_t _gradParamsTag ;        //! Contents tag of _gradParams when the index was determined
+  mutable Int_t _gradSelf ;               //! Index of this object in _gradParams, or -1
+  mutable std::vector<Int_t> _gradIndex ; //! Indices in _gradParams of the parameters this object depends on
+  mutable std::vector<Double_t> _gradBuf ; //! Scratch buffer for the gradient with respect to _gradParams
+
 
   ClassDef(RooAbsReal,2) // Abstract real-valued variable
 };
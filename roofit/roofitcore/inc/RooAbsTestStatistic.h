@@ -57,6 +57,12 @@ public:
 
   Bool_t setData(RooAbsData& data, Bool_t cloneData=kTRUE) ;
 
+  void setThreadMode(Bool_t flag=kTRUE) ;
+  Bool_t threadMode() const { 
+    // Return true if the parallel calculation uses threads rather than processes
+    return _mpThreads ; 
+  }
+
 protected:
 
   virtual void printCompactTreeHook(std::ostream& os, const char* indent="") ;
@@ -65,6 +71,12 @@ protected:
   virtual Double_t evaluate() const ;
 
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const = 0 ;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluatePartitionGradient(Int_t /*firstEvent*/, Int_t /*lastEvent*/, Int_t /*stepSize*/, 
+					   const RooArgList& /*params*/, Double_t* /*grad*/) const { 
+    // Analytical gradient of evaluatePartition(), not available by default
+    return kFALSE ; 
+  }
 
   void setMPSet(Int_t setNum, Int_t numSets) ; 
   void setSimCount(Int_t simCount) { 
@@ -114,6 +126,8 @@ protected:
   Bool_t initialize() ;
   void initSimMode(RooSimultaneous* pdf, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;    
   void initMPMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void syncThreadParams() const ;
 
   mutable Bool_t _init ;          //! Is object initialized  
   GOFOpMode   _gofOpMode ;        // Operation mode of test statistic instance 
@@ -132,7 +146,17 @@ protected:
 
   Bool_t         _mpinterl ; // Use interleaving strategy rather than N-wise split for partioning of dataset for multiprocessor-split
 
-  ClassDef(RooAbsTestStatistic,1) // Abstract base class for real-valued test statistics
+  // Multi-thread mode data
+  Bool_t         _mpThreads ;   // Calculate the partitions in threads rather than in processes
+  pRooAbsTestStatistic* _mtArray ; //! Array of test statistics calculating the partitions in threads
+  RooArgSet**    _mtParamArray ;   //! Parameters of each thread test statistic
+  mutable Bool_t _mtSerial ;    //! Next evaluation of the thread test statistics is made serially
+  RooArgList*    _mtGradParams ;   //! Parameters of the gradient of each thread test statistic
+  mutable const RooArgList* _mtGradList ; //! Parameter list of the gradient that _mtGradParams correspond to
+  mutable ULong_t _mtGradListTag ; //! Contents tag of _mtGradList when _mtGradParams were made
+  mutable std::vector<Int_t> _mtGradPos ; //! Index in _mtGradList of each element of _mtGradParams
+
+  ClassDef(RooAbsTestStatistic,2) // Abstract base class for real-valued test statistics
 };
 
 #endif
@@ -28,7 +28,7 @@ class RooNumGenFactory ;
 
 class RooAcceptReject : public RooAbsNumGenerator {
 public:
-  RooAcceptReject() : _nextCatVar(0), _nextRealVar(0) {
+  RooAcceptReject() : _nextCatVar(0), _nextRealVar(0), _batchSize(1) {
     // coverity[UNINIT_CTOR]
   } ; 
   RooAcceptReject(const RooAbsReal &func, const RooArgSet &genVars, const RooNumGenConfig& config, Bool_t verbose=kFALSE, const RooAbsReal* maxFuncVal=0);
@@ -53,6 +53,7 @@ protected:
   static void registerSampler(RooNumGenFactory& fact) ;	
 
   void addEventToCache();
+  void addEventsToCache(UInt_t nEvents);
   const RooArgSet *nextAcceptedEvent();
 
   Double_t _maxFuncVal, _funcSum;      // Maximum function value found, and sum of all samples made
@@ -64,6 +65,7 @@ protected:
   TIterator *_nextRealVar;             // Iterator over variables to be generated
 
   UInt_t _minTrialsArray[4];           // Minimum number of trials samples for 1,2,3 dimensional problems
+  UInt_t _batchSize;                   // Number of trial samples evaluated at once (1: one by one)
 
   ClassDef(RooAcceptReject,0) // Context for generating a dataset from a PDF
 };
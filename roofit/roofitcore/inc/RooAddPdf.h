@@ -41,6 +41,8 @@ public:
   virtual ~RooAddPdf() ;
 
   Double_t evaluate() const ;
+  virtual Bool_t evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
   virtual Bool_t checkObservables(const RooArgSet* nset) const ;	
 
   virtual Bool_t forceAnalyticalInt(const RooAbsArg& /*dep*/) const { 
@@ -64,6 +66,7 @@ public:
     // which is the sum of all coefficients
     return expectedEvents(&nset) ; 
   }
+  virtual Bool_t expectedEventsGradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const ;
 
   const RooArgList& pdfList() const { 
     // Return list of component p.d.fs
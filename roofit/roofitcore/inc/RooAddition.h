@@ -70,6 +70,7 @@ protected:
   mutable RooObjCacheManager _cacheMgr ; // The cache manager
 
   Double_t evaluate() const;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
 
   ClassDef(RooAddition,2) // Sum of RooAbsReal objects
 };
@@ -73,6 +73,7 @@ public:
   inline void sort(Bool_t reverse=kFALSE) { 
     // Sort list in requested order
     _list.Sort(!reverse) ; 
+    _contentsTag = 0 ;
   }
   inline Int_t index(const RooAbsArg* arg) const { 
     // Returns index of given arg, or -1 if arg is not in list
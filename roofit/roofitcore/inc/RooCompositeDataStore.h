@@ -91,6 +91,7 @@ public:
   virtual void resetCache() ;
 
   virtual void recalculateCache(const RooArgSet* /*proj*/, Int_t /*firstEvent*/, Int_t /*lastEvent*/, Int_t /*stepSize*/) ;
+  virtual Bool_t recalculateCachedArgs(const RooArgSet& args, const RooArgSet* nset=0) ;
   
   void loadValues(const RooAbsDataStore *tds, const RooFormulaVar* select=0, const char* rangeName=0, Int_t nStart=0, Int_t nStop=2000000000) ;
   
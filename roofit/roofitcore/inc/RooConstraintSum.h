@@ -40,6 +40,7 @@ protected:
   TIterator* _setIter1 ;  //! do not persist
 
   Double_t evaluate() const;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
 
   ClassDef(RooConstraintSum,2) // sum of -log of set of RooAbsPdf representing parameter constraints
 };
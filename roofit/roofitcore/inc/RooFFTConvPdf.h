@@ -21,11 +21,12 @@
 class RooRealVar ;
 
 #include <map>
+#include <vector>
  
 class RooFFTConvPdf : public RooAbsCachedPdf {
 public:
 
-  RooFFTConvPdf() {
+  RooFFTConvPdf() : _nThreads(1) {
     // coverity[UNINIT_CTOR]
   } ;
   RooFFTConvPdf(const char *name, const char *title, RooRealVar& convVar, RooAbsPdf& pdf1, RooAbsPdf& pdf2, Int_t ipOrder=2);
@@ -34,7 +35,7 @@ public:
   virtual TObject* clone(const char* newname) const { return new RooFFTConvPdf(*this,newname); }
   virtual ~RooFFTConvPdf() ;
 
-  void setShift(Double_t val1, Double_t val2) { _shift1 = val1 ; _shift2 = val2 ; }
+  void setShift(Double_t val1, Double_t val2) ;
   void setCacheObservables(const RooArgSet& obs) { _cacheObs.removeAll() ; _cacheObs.add(obs) ; }
   const RooArgSet& cacheObservables() const { return _cacheObs ; }
   
@@ -55,6 +56,12 @@ public:
   void setBufferStrategy(BufStrat bs) ;
   void setBufferFraction(Double_t frac) ;
 
+  void setNumThreads(Int_t nThreads) ;
+  Int_t numThreads() const { 
+    // Return maximum number of threads used to calculate the FFTs of the cache slices
+    return _nThreads ; 
+  }
+
   void printMetaArgs(std::ostream& os) const ;
 
   // Propagate maximum value estimate of pdf1 as convolution can only result in lower max values
@@ -82,9 +89,11 @@ protected:
 
     virtual RooArgList containedArgs(Action) ;
 
-    TVirtualFFT* fftr2c1 ;
-    TVirtualFFT* fftr2c2 ;
-    TVirtualFFT* fftc2r ;
+    Bool_t updateParamValues(const RooArgSet& params, std::vector<Double_t>& vals) ;
+    void clearPlans() ;
+
+    std::vector<TVirtualFFT*> fftr2c ; // Real->Complex transformation plan of each thread
+    std::vector<TVirtualFFT*> fftc2r ; // Complex->Real transformation plan of each thread
 
     RooAbsPdf* pdf1Clone ;
     RooAbsPdf* pdf2Clone ;
@@ -92,6 +101,21 @@ protected:
     RooAbsBinning* histBinning ;
     RooAbsBinning* scanBinning ;
 
+    RooArgSet* pdf1Params ;  // Parameters of pdf1Clone
+    RooArgSet* pdf2Params ;  // Parameters of pdf2Clone
+    std::vector<Double_t> pdf1ParamVals ; // Values of pdf1Params when spec1 was calculated
+    std::vector<Double_t> pdf2ParamVals ; // Values of pdf2Params when spec2 was calculated
+    Bool_t pdf1SliceDep ;    // pdf1 depends on the other cache observables
+    Bool_t pdf2SliceDep ;    // pdf2 depends on the other cache observables
+
+    Int_t N2 ;               // Size of the FFT arrays of the cached spectra
+    Int_t bufStrat ;         // Buffer strategy of the cached spectra
+    Int_t zeroBin1 ;         // Position of zero in the sampling of pdf1
+    std::vector< std::vector<Double_t> > spec1 ;  // Fourier transform of pdf1 (re,im pairs), per slice
+    std::vector< std::vector<Double_t> > spec2 ;  // Fourier transform of pdf2 (re,im pairs), per slice
+    std::vector< std::vector<Double_t> > input1 ; // Sampling of pdf1 waiting to be transformed, per slice
+    std::vector< std::vector<Double_t> > input2 ; // Sampling of pdf2 waiting to be transformed, per slice
+
   };
 
   friend class FFTCacheElem ;  
@@ -102,7 +126,8 @@ protected:
   virtual RooArgSet* actualParameters(const RooArgSet& nset) const ;
   virtual RooAbsArg& pdfObservable(RooAbsArg& histObservable) const ;
   virtual void fillCacheObject(PdfCacheElem& cache) const ;
-  void fillCacheSlice(FFTCacheElem& cache, const RooArgSet& slicePosition) const ;
+  void fillCacheSlice(FFTCacheElem& cache, Int_t slice, Int_t thread, Int_t N, Double_t* output) const ;
+  void transformInput(FFTCacheElem& cache, Int_t thread, const std::vector<Double_t>& input, std::vector<Double_t>& spec) const ;
 
   virtual PdfCacheElem* createCache(const RooArgSet* nset) const ;
   virtual TString histNameSuffix() const ;
@@ -120,9 +145,11 @@ protected:
   friend class RooConvGenContext ;
   RooSetProxy  _cacheObs ; // Non-convolution observables that are also cached
 
+  Int_t _nThreads ; // Maximum number of threads used to calculate the slices of the cache
+
 private:
 
-  ClassDef(RooFFTConvPdf,1) // Convolution operator p.d.f based on numeric Fourier transforms
+  ClassDef(RooFFTConvPdf,2) // Convolution operator p.d.f based on numeric Fourier transforms
 };
  
 #endif
@@ -61,6 +61,7 @@ protected:
 
   // Function evaluation
   virtual Double_t evaluate() const ;
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const ;
   RooFormula& formula() const ;
 
   // Post-processing of server redirection
@@ -45,6 +45,7 @@ public:
   RooLinkedListElem* findLinkTo(const TObject* arg) const ;
   RooSetPair* findSetPair(const RooArgSet* set1, const RooArgSet* set2) const ;  
   Bool_t replace(const TObject* oldArg, const TObject* newArg, const TObject* oldHashArg=0) ;
+  Bool_t rehashName(TObject* arg, const char* oldName) ;
   Int_t size() const { return _size ; }
   Int_t entries() const { return _entries ; }
   Double_t avgCollisions() const ;
@@ -60,11 +61,18 @@ protected:
     return 0 ;
   }
 
+  Int_t findSlot(const TObject* arg, ULong_t hashVal) const ;
+  void insert(TObject* arg, ULong_t hashVal) ;
+  void removeSlot(Int_t slot) ;
+  void rehash(Int_t newCapacity) ;
+
   HashMethod _hashMethod ; // Hashing method
   Int_t _usedSlots ;       // Number of used slots
   Int_t _entries ;         // Number of entries stored
   Int_t _size ;            // Total number of slots
-  RooLinkedList** _arr ;   //! Array of linked lists storing elements in each slot
+  Int_t _capacity ;        //! Number of buckets in open addressing table (power of two, at least 2*_size)
+  TObject** _arr ;         //! Object stored in each bucket, null for empty buckets
+  ULong_t* _hashArr ;      //! Hash value of object stored in each bucket
 
   ClassDef(RooHashTable,1) // Hash table
 };
@@ -46,6 +46,7 @@ public:
   }
 
   void setHashTableSize(Int_t size) ;
+  void rehashName(TObject* arg, const char* oldName) ;
 
   // Destructor
   virtual ~RooLinkedList() ;
@@ -49,6 +49,7 @@ public:
 
   // Run methods
   Bool_t generateAndFit(Int_t nSamples, Int_t nEvtPerSample=0, Bool_t keepGenData=kFALSE, const char* asciiFilePat=0) ;
+  Bool_t generateAndFitParallel(Int_t nSamples, Int_t nEvtPerSample=0, Int_t nWorkers=0) ;
   Bool_t generate(Int_t nSamples, Int_t nEvtPerSample=0, Bool_t keepGenData=kFALSE, const char* asciiFilePat=0) ;
   Bool_t fit(Int_t nSamples, const char* asciiFilePat) ;
   Bool_t fit(Int_t nSamples, TList& dataSetList) ;
@@ -142,6 +143,8 @@ protected:
   Bool_t      _verboseGen       ; // Verbose generation?
   Bool_t      _perExptGenParams ; // Do generation parameter change per event?
   Bool_t      _silence          ; // Silent running mode?
+  UInt_t      _toySeed          ; // Base random seed of the samples if each sample has its own seed (0 otherwise)
+  Int_t       _toyOffset        ; // Index of the first sample of this run for the seeds of the samples
 
   std::list<RooAbsMCStudyModule*> _modList ; // List of additional study modules ;
 
@@ -48,6 +48,7 @@ public:
   void setEps(Double_t eps) ;
   void optimizeConst(Int_t flag) ;
   void setEvalErrorWall(Bool_t flag) { _fcn->SetEvalErrorWall(flag); }
+  void setUseGradient(Bool_t flag=kTRUE) { _useGradient = flag ; }
 
   RooFitResult* fit(const char* options) ;
 
@@ -91,6 +92,8 @@ protected:
   inline std::ofstream* logfile() const { return _fcn->GetLogFile(); }
   inline Double_t& maxFCN() { return _fcn->GetMaxFCN() ; }
 
+  bool fitFcn() const ;
+
 private:
 
   Int_t       _printLevel ;
@@ -100,6 +103,7 @@ private:
   RooAbsReal* _func ;
 
   Bool_t      _verbose ;
+  Bool_t      _useGradient ;
   TStopwatch  _timer ;
   TStopwatch  _cumulTimer ;
 
@@ -30,7 +30,7 @@
 
 class RooMinimizer;
 
-class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
+class RooMinimizerFcn : public ROOT::Math::IMultiGradFunction {
 
  public:
 
@@ -52,6 +52,9 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
   std::ofstream* GetLogFile() { return _logfile; }
   void SetVerbose(Bool_t flag=kTRUE) { _verbose = flag ; }
 
+  Bool_t HasAnalyticalGradient() ;
+  virtual void Gradient(const double *x, double *grad) const ;
+
   Double_t& GetMaxFCN() { return _maxFCN; }
   Int_t GetNumInvalidNLL() { return _numBadNLL; }
 
@@ -72,6 +75,8 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
 
 
   virtual double DoEval(const double * x) const;  
+  virtual double DoDerivative(const double * x, unsigned int icoord) const ;
+  void NumericalGradient(const double *x, double *grad) const ;
   void updateFloatVec() ;
 
 private:
@@ -94,6 +99,9 @@ private:
   RooArgList* _initFloatParamList;
   RooArgList* _initConstParamList;
 
+  mutable std::vector<double> _gradX ;
+  mutable std::vector<double> _grad ;
+
 };
 
 #endif
@@ -36,11 +36,10 @@ protected:
 
   static RooNameReg* _instance ;
 
-  RooNameReg() : TNamed("RooNameReg","RooFit Name Registry"), _htable(31) {} 
+  RooNameReg() : TNamed("RooNameReg","RooFit Name Registry"), _list(31) {} 
   RooNameReg(const RooNameReg& other) ;
 
-  RooHashTable _htable ; // Repository of registered names
-  RooLinkedList _list ; // 
+  RooLinkedList _list ; // Repository of registered names, hashed by name once it grows beyond 31 entries
 
   ClassDef(RooNameReg,1) // String name registry
 };
@@ -34,6 +34,7 @@ public:
   virtual ~RooRealSumPdf() ;
 
   Double_t evaluate() const ;
+  virtual Bool_t evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
   virtual Bool_t checkObservables(const RooArgSet* nset) const ;	
 
   virtual Bool_t forceAnalyticalInt(const RooAbsArg&) const { return kTRUE ; }
@@ -45,6 +45,9 @@ public:
   void runProof(Int_t nExperiments, const char* proofHost="", Bool_t showGui=kTRUE) ;
   static void closeProof(Option_t *option = "s") ;
 
+  // Parallel running in forked processes on the local host
+  void runParallel(Int_t nExperiments, Int_t nWorkers=0) ;
+
   // Batch running
   void prepareBatchInput(const char* studyName, Int_t nExpPerJob, Bool_t unifiedInput) ;
   void processBatchOutput(const char* filePat) ;
@@ -55,6 +58,7 @@ public:
 protected:
 
   void aggregateData(TList* olist) ;
+  Bool_t readOutputFile(const char* fileName, TList& olist) ;
   void expandWildCardSpec(const char* spec, std::list<std::string>& result) ;
 
   RooStudyPackage* _pkg ;
@@ -40,12 +40,12 @@ public:
   RooWorkspace& wspace() { return *_ws ; }
   std::list<RooAbsStudy*>& studies() { return _studies ; }
     
-  void driver(Int_t nExperiments) ;
+  void driver(Int_t nExperiments, UInt_t firstSeed=0) ;
 
   Int_t initRandom() ;
   void initialize() ;
   void runOne() ;
-  void run(Int_t nExperiments) ;
+  void run(Int_t nExperiments, UInt_t firstSeed=0) ;
   void finalize() ;
   
   void exportData(TList* olist, Int_t seqno) ;
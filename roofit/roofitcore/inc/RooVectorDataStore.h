@@ -99,11 +99,21 @@ public:
   virtual void attachCache(const RooAbsArg* newOwner, const RooArgSet& cachedVars) ;
   virtual void resetCache() ;
   virtual void recalculateCache(const RooArgSet* /*proj*/, Int_t firstEvent, Int_t lastEvent, Int_t stepSize) ;
+  virtual Bool_t recalculateCachedArgs(const RooArgSet& args, const RooArgSet* nset=0) ;
 
   virtual void setArgStatus(const RooArgSet& set, Bool_t active) ;
 
   const RooVectorDataStore* cache() const { return _cache ; }
 
+  // Direct access to the columns for batch evaluation (see RooAbsReal::getValBatch)
+  const Double_t* realColumn(const RooAbsArg& arg) const ;
+  Double_t* realColumn(const RooAbsArg& arg) { 
+    // Writable access to the values of column 'arg', see realColumn() const
+    return const_cast<Double_t*>(static_cast<const RooVectorDataStore*>(this)->realColumn(arg)) ; 
+  }
+  const Double_t* weightColumn() const ;
+  Bool_t dependsOnColumns(const RooAbsArg& arg) const ;
+
   void loadValues(const RooAbsDataStore *tds, const RooFormulaVar* select=0, const char* rangeName=0, Int_t nStart=0, Int_t nStop=2000000000) ;
   
   void dump() ;
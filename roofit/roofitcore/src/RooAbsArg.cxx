@@ -142,8 +142,12 @@ RooAbsArg::RooAbsArg(const RooAbsArg& other, const char* name)
   // Copy constructor transfers all boolean and string properties of the original
   // object. Transient properties and client-server links are not copied
 
-  // Use name in argument, if supplied
-  if (name) SetName(name) ;
+  // Use name in argument, if supplied. This is not a renaming operation
+  // that affects any collection, as the clone is not contained in one yet
+  if (name) {
+    TNamed::SetName(name) ;
+    _namePtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;
+  }
 
   // Copy server list by hand
   RooFIter sIter = other._serverList.fwdIterator() ;
@@ -212,6 +216,11 @@ RooAbsArg::~RooAbsArg()
     _ownedComponents = 0 ;
   }
 
+  // Unregister from collections that index this object by name
+  for (set<RooAbsCollection*>::iterator iter = _hashedCollections.begin() ; iter != _hashedCollections.end() ; ++iter) {
+    (*iter)->_renameTracked.erase(this) ;
+  }
+
   RooTrace::destroy(this) ;
 }
 
@@ -714,6 +723,12 @@ Bool_t RooAbsArg::dependsOn(const RooAbsCollection& serverList, const RooAbsArg*
   // Test whether we depend on (ie, are served by) any object in the
   // specified collection. Uses the dependsOn(RooAbsArg&) member function.
 
+  // A node without servers can only match by its own name, which is
+  // a (hashed) lookup in the collection rather than a scan over it
+  if (_serverList.GetSize()==0) {
+    return (this!=ignoreArg && serverList.find(*this)) ? kTRUE : kFALSE ;
+  }
+
   Bool_t result(kFALSE);
   RooFIter sIter = serverList.fwdIterator();
   RooAbsArg* server ;
@@ -983,9 +998,15 @@ Bool_t RooAbsArg::redirectServers(const RooAbsCollection& newSetOrig, Bool_t mus
   setValueDirty() ;
   setShapeDirty() ;
 
-  // Take self out of newset disallowing cyclical dependencies
-  RooAbsCollection* newSet2 = (RooAbsCollection*) newSet->clone("newSet2") ;
-  newSet2->remove(*this,kTRUE,kTRUE) ;
+  // Take self out of newset disallowing cyclical dependencies. The copy
+  // of newSet is only needed if it contains an object with our name, 
+  // which is a hash-table lookup for large sets
+  RooAbsCollection* newSet2 = 0 ;
+  if (newSet->find(*this)) {
+    newSet2 = (RooAbsCollection*) newSet->clone("newSet2") ;
+    newSet2->remove(*this,kTRUE,kTRUE) ;
+  }
+  const RooAbsCollection& proxySet = newSet2 ? *newSet2 : *newSet ;
 
   // Process the proxies
   Bool_t allReplaced=kTRUE ;
@@ -993,7 +1014,7 @@ Bool_t RooAbsArg::redirectServers(const RooAbsCollection& newSetOrig, Bool_t mus
     // WVE: Need to make exception here too for newServer != this
     RooAbsProxy* p = getProxy(i) ;
     if (!p) continue ;
-    Bool_t ret2 = p->changePointer(*newSet2,nameChange) ;
+    Bool_t ret2 = p->changePointer(proxySet,nameChange) ;
     allReplaced &= ret2 ;
   }
 
@@ -2265,7 +2286,14 @@ void RooAbsArg::wireAllCaches()
 void RooAbsArg::SetName(const char* name) 
 {
   TNamed::SetName(name) ;
-  _namePtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;
+  TNamed* newPtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;
+  if (newPtr != _namePtr) {
+    // Move this object in the hash tables of the collections that contain it
+    for (set<RooAbsCollection*>::iterator iter = _hashedCollections.begin() ; iter != _hashedCollections.end() ; ++iter) {
+      (*iter)->_list.rehashName(this,_namePtr->GetName()) ;
+    }
+  }
+  _namePtr = newPtr ;
 }
 
 
@@ -2275,7 +2303,13 @@ void RooAbsArg::SetName(const char* name)
 void RooAbsArg::SetNameTitle(const char *name, const char *title)
 {
   TNamed::SetNameTitle(name,title) ;
-  _namePtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;
+  TNamed* newPtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;
+  if (newPtr != _namePtr) {
+    for (set<RooAbsCollection*>::iterator iter = _hashedCollections.begin() ; iter != _hashedCollections.end() ; ++iter) {
+      (*iter)->_list.rehashName(this,_namePtr->GetName()) ;
+    }
+  }
+  _namePtr = newPtr ;
 }
 
 
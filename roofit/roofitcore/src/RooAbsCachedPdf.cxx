@@ -170,20 +170,31 @@ RooAbsCachedPdf::PdfCacheElem* RooAbsCachedPdf::getCache(const RooArgSet* nset,
   // Create and fill cache
   cache = createCache(nset) ; 
 
-  // Check if we have contents registered already in global expensive object cache 
-  RooDataHist* htmp = (RooDataHist*) expensiveObjectCache().retrieveObject(cache->hist()->GetName(),RooDataHist::Class(),cache->paramTracker()->parameters()) ;
-
-  if (htmp) {    
-
-    cache->hist()->reset() ;
-    cache->hist()->add(*htmp) ;
+  // Check if we have contents registered already in global expensive object cache.
+  // The cache is shared by all threads, and registerObject() deletes any object
+  // of the same name, so the contents are copied under the lock
+  Bool_t fromEOCache(kFALSE) ;
+#ifdef _OPENMP
+#pragma omp critical (RooExpensiveObjectCache)
+#endif
+  {
+    RooDataHist* eohist = (RooDataHist*) expensiveObjectCache().retrieveObject(cache->hist()->GetName(),RooDataHist::Class(),cache->paramTracker()->parameters()) ;
+    if (eohist) {
+      cache->hist()->reset() ;
+      cache->hist()->add(*eohist) ;
+      fromEOCache = kTRUE ;
+    }
+  }
 
-  } else {
+  if (!fromEOCache) {
 
     fillCacheObject(*cache) ;  
 
     RooDataHist* eoclone = new RooDataHist(*cache->hist()) ;
     eoclone->removeSelfFromDir() ;
+#ifdef _OPENMP
+#pragma omp critical (RooExpensiveObjectCache)
+#endif
     expensiveObjectCache().registerObject(GetName(),cache->hist()->GetName(),*eoclone,cache->paramTracker()->parameters()) ;
     
   } 
@@ -194,7 +205,7 @@ RooAbsCachedPdf::PdfCacheElem* RooAbsCachedPdf::getCache(const RooArgSet* nset,
 
   coutI(Caching) << "RooAbsCachedPdf::getCache(" << GetName() << ") creating new cache " << cache << " with pdf "
 		 << cache->pdf()->GetName() << " for nset " << (nset?*nset:RooArgSet()) << " with code " << code ;
-  if (htmp) {
+  if (fromEOCache) {
     ccoutI(Caching) << " from preexisting content." ;
   }
   ccoutI(Caching) << endl ;
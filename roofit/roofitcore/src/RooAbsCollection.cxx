@@ -23,7 +23,8 @@
 // implementation can enforce unique names). The storage of objects in
 // implement through class RooLinkedList, a doubly linked list with an
 // an optional hash-table lookup mechanism for fast indexing of large
-// collections. 
+// collections. Collections switch automatically to hash-table lookups
+// when they grow beyond defaultHashThreshold() elements.
 // END_HTML
 //
 //
@@ -63,12 +64,17 @@ char* operator+( streampos&, char* );
 ClassImp(RooAbsCollection)
   ;
 
+Int_t RooAbsCollection::_defaultHashThreshold = 32 ;
+ULong_t RooAbsCollection::_lastContentsTag = 0 ;
+
 //_____________________________________________________________________________
 RooAbsCollection::RooAbsCollection() :
-  _list(0),
+  _list(_defaultHashThreshold),
   _ownCont(kFALSE), 
   _name(),
-  _allRRV(kTRUE)
+  _allRRV(kTRUE),
+  _trackRenames(kFALSE),
+  _contentsTag(0)
 {
   // Default constructor
 
@@ -79,10 +85,12 @@ RooAbsCollection::RooAbsCollection() :
 
 //_____________________________________________________________________________
 RooAbsCollection::RooAbsCollection(const char *name) :
-  _list(0),
+  _list(_defaultHashThreshold),
   _ownCont(kFALSE), 
   _name(name),
-  _allRRV(kTRUE)
+  _allRRV(kTRUE),
+  _trackRenames(kFALSE),
+  _contentsTag(0)
 {
   // Empty collection constructor
 
@@ -95,10 +103,12 @@ RooAbsCollection::RooAbsCollection(const char *name) :
 RooAbsCollection::RooAbsCollection(const RooAbsCollection& other, const char *name) :
   TObject(other),
   RooPrintable(other),
-  _list(other._list.getHashTableSize()) , 
+  _list(other._list.getHashTableSize()>0 ? other._list.getHashTableSize() : _defaultHashThreshold) , 
   _ownCont(kFALSE), 
   _name(name),
-  _allRRV(other._allRRV)
+  _allRRV(other._allRRV),
+  _trackRenames(kFALSE),
+  _contentsTag(0)
 {
   // Copy constructor. Note that a copy of a collection is always non-owning,
   // even the source collection is owning. To create an owning copy of
@@ -122,6 +132,8 @@ RooAbsCollection::~RooAbsCollection()
 {
   // Destructor
 
+  untrackAllRenames() ;
+
   // Delete all variables in our list if we own them
   if(_ownCont){ 
     safeDeleteList() ;
@@ -293,6 +305,8 @@ Bool_t RooAbsCollection::addServerClonesToList(const RooAbsArg& var)
       RooAbsArg* serverClone = (RooAbsArg*)server->Clone() ;      
       serverClone->setAttribute("SnapShot_ExtRefClone") ;
       _list.Add(serverClone) ;      
+      trackRename(*serverClone) ;
+      _contentsTag = 0 ;
       if (_allRRV && dynamic_cast<RooRealVar*>(serverClone)==0) {
 	_allRRV=kFALSE ;
       }
@@ -412,6 +426,8 @@ Bool_t RooAbsCollection::addOwned(RooAbsArg& var, Bool_t silent)
   _ownCont= kTRUE;
 
   _list.Add((RooAbsArg*)&var);
+  trackRename(var) ;
+  _contentsTag = 0 ;
   if (_allRRV && dynamic_cast<RooRealVar*>(&var)==0) {
     _allRRV=kFALSE ;
   }
@@ -439,7 +455,11 @@ RooAbsArg *RooAbsCollection::addClone(const RooAbsArg& var, Bool_t silent)
 
   // add a pointer to a clone of this variable to our list (we now own it!)
   RooAbsArg *clone2= (RooAbsArg*)var.Clone();
-  if(0 != clone2) _list.Add((RooAbsArg*)clone2);
+  if(0 != clone2) {
+    _list.Add((RooAbsArg*)clone2);
+    trackRename(*clone2) ;
+    _contentsTag = 0 ;
+  }
   if (_allRRV && dynamic_cast<const RooRealVar*>(&var)==0) {
     _allRRV=kFALSE ;
   }
@@ -464,6 +484,8 @@ Bool_t RooAbsCollection::add(const RooAbsArg& var, Bool_t silent)
 
   // add a pointer to this variable to our list (we don't own it!)
   _list.Add((RooAbsArg*)&var);
+  trackRename((RooAbsArg&)var) ;
+  _contentsTag = 0 ;
   if (_allRRV && dynamic_cast<const RooRealVar*>(&var)==0) {
     _allRRV=kFALSE ;
   }
@@ -565,13 +587,7 @@ Bool_t RooAbsCollection::replace(const RooAbsArg& var1, const RooAbsArg& var2)
   // is var1 already in this list?
   const char *name= var1.GetName();
 
-  Bool_t foundVar1(kFALSE) ;
-  RooFIter iter = fwdIterator() ;
-  RooAbsArg* arg ;
-  while((arg=iter.next())) {
-    if (arg==&var1) foundVar1=kTRUE ;
-  }
-  if (!foundVar1) {
+  if (!containsInstance(var1)) {
     coutE(ObjectHandling) << "RooAbsCollection: variable \"" << name << "\" is not in the list"
 	 << " and cannot be replaced" << endl;
     return kFALSE;
@@ -593,6 +609,11 @@ Bool_t RooAbsCollection::replace(const RooAbsArg& var1, const RooAbsArg& var2)
   _list.Replace(&var1,&var2) ;
 //   _list.AddBefore((RooAbsArg*)&var1,(RooAbsArg*)&var2);
 //   _list.Remove((RooAbsArg*)&var1);
+  trackRename((RooAbsArg&)var2) ;
+  _contentsTag = 0 ;
+  if (!containsInstance(var1)) {
+    untrackRename((RooAbsArg&)var1) ;
+  }
 
   if (_allRRV && dynamic_cast<const RooRealVar*>(&var2)==0) {
     _allRRV=kFALSE ;
@@ -612,18 +633,35 @@ Bool_t RooAbsCollection::remove(const RooAbsArg& var, Bool_t , Bool_t matchByNam
   // removed from a copied list and will be deleted at the same time.
 
   // is var already in this list?
-  TString name(var.GetName()) ;
   Bool_t anyFound(kFALSE) ;
 
+  // Without name matching the link is found directly, through the hash
+  // table of the list if it has one
+  if (!matchByNameOnly) {
+    while (_list.Remove((RooAbsArg*)&var)) {
+      anyFound=kTRUE ;
+    }
+    if (anyFound) {
+      untrackRename((RooAbsArg&)var) ;
+      _contentsTag = 0 ;
+    }
+    return anyFound ;
+  }
+
+  TString name(var.GetName()) ;
   RooFIter iter = fwdIterator() ;
   RooAbsArg* arg ;
   while((arg=iter.next())) {
     if ((&var)==arg) {
       _list.Remove(arg) ;
+      untrackRename(*arg) ;
+      _contentsTag = 0 ;
       anyFound=kTRUE ;
     } else if (matchByNameOnly) {
       if (!name.CompareTo(arg->GetName())) {
 	_list.Remove(arg) ;
+	untrackRename(*arg) ;
+	_contentsTag = 0 ;
 	anyFound=kTRUE ;
       }
     }
@@ -659,6 +697,9 @@ void RooAbsCollection::removeAll()
   // This effectively restores our object to the state it would have
   // just after calling the RooAbsCollection(const char*) constructor.
 
+  untrackAllRenames() ;
+  _contentsTag = 0 ;
+
   if(_ownCont) {
     safeDeleteList() ;
     _ownCont= kFALSE;
@@ -824,6 +865,7 @@ RooAbsArg *RooAbsCollection::find(const char *name) const
   // Find object with given name in list. A null pointer 
   // is returned if no object with the given name is found
 
+  if (!_trackRenames && _list.getHashTableSize()>0) const_cast<RooAbsCollection*>(this)->syncRenameTracking() ;
   return (RooAbsArg*) _list.find(name);
 }
 
@@ -835,11 +877,124 @@ RooAbsArg *RooAbsCollection::find(const RooAbsArg& arg) const
   // Find object with given name in list. A null pointer 
   // is returned if no object with the given name is found
 
+  if (!_trackRenames && _list.getHashTableSize()>0) const_cast<RooAbsCollection*>(this)->syncRenameTracking() ;
   return (RooAbsArg*) _list.findArg(&arg);
 }
 
 
 
+//_____________________________________________________________________________
+void RooAbsCollection::trackRename(RooAbsArg& var) 
+{
+  // Register var, which was added to this collection, so that renaming var
+  // moves it in the hash table by name of the list. Nothing is registered 
+  // while the list has no hash table
+
+  if (!_trackRenames) {
+    syncRenameTracking() ;
+    return ;
+  }
+  _renameTracked.insert(&var) ;
+  var._hashedCollections.insert(this) ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsCollection::untrackRename(RooAbsArg& var) 
+{
+  // Unregister var, which is no longer contained in this collection. 
+  // Deleted objects have unregistered themselves, so var is only 
+  // dereferenced if it still exists
+
+  if (_renameTracked.erase(&var)) {
+    var._hashedCollections.erase(this) ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsCollection::untrackAllRenames() 
+{
+  // Unregister all contents of this collection
+
+  for (set<RooAbsArg*>::iterator iter=_renameTracked.begin() ; iter!=_renameTracked.end() ; ++iter) {
+    (*iter)->_hashedCollections.erase(this) ;
+  }
+  _renameTracked.clear() ;
+  _trackRenames = kFALSE ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsCollection::syncRenameTracking() 
+{
+  // Register all contents when the list has created a hash table, or
+  // unregister them when it has dropped its hash table. Lists read from
+  // file are registered on their first lookup
+
+  Bool_t hashed = (_list.getHashTableSize()>0) ;
+  if (hashed==_trackRenames) return ;
+
+  if (!hashed) {
+    untrackAllRenames() ;
+    return ;
+  }
+
+  _trackRenames = kTRUE ;
+  RooFIter iter = fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg=iter.next())) {
+    _renameTracked.insert(arg) ;
+    arg->_hashedCollections.insert(this) ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+ULong_t RooAbsCollection::contentsTag() const 
+{
+  // Return a tag that identifies the current contents of this collection 
+  // and their order. It differs from the tags of all other collections 
+  // and changes whenever objects are added, removed, replaced or 
+  // reordered, so that information derived from the contents can be 
+  // cached with it. Tags are assigned on the first request after a change,
+  // which should not happen concurrently in several threads
+
+  if (_contentsTag==0) {
+    _contentsTag = ++_lastContentsTag ;
+  }
+  return _contentsTag ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsCollection::setDefaultHashThreshold(Int_t thresh) 
+{
+  // Set the size above which newly created collections switch to hash-table
+  // lookups of their contents by name. A value of zero disables the automatic
+  // creation of hash tables
+
+  _defaultHashThreshold = thresh ;
+}
+
+
+
+//_____________________________________________________________________________
+Int_t RooAbsCollection::defaultHashThreshold() 
+{
+  // Return the size above which newly created collections switch to 
+  // hash-table lookups of their contents by name
+
+  return _defaultHashThreshold ;
+}
+
+
+
 //_____________________________________________________________________________
 string RooAbsCollection::contentsString() const 
 {
@@ -121,9 +121,12 @@ RooAbsNumGenerator::RooAbsNumGenerator(const RooAbsReal &func, const RooArgSet &
     return;
   }
 
-  // create a fundamental type for storing function values
+  // create a fundamental type for storing function values. It is named differently
+  // from the function, so that the cache column is not taken for the function
+  // itself in batch evaluations over the cache (see RooAbsReal::getValBatch())
   _funcValStore= dynamic_cast<RooRealVar*>(_funcClone->createFundamental());
   assert(0 != _funcValStore);
+  _funcValStore->SetName(Form("%s_funcVal",_funcClone->GetName())) ;
 
   // create a new dataset to cache trial events and function values
   RooArgSet cacheArgs(_catVars);
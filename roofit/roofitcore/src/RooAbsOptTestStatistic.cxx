@@ -88,6 +88,7 @@ RooAbsOptTestStatistic:: RooAbsOptTestStatistic()
   _ownData = kTRUE ;
   _sealed = kFALSE ;
   _optimized = kFALSE ;
+  _optParamSnap = 0 ;
 }
 
 
@@ -99,6 +100,7 @@ RooAbsOptTestStatistic::RooAbsOptTestStatistic(const char *name, const char *tit
   RooAbsTestStatistic(name,title,real,indata,projDeps,rangeName, addCoefRangeName, nCPU, interleave, verbose, splitCutRange),
   _projDeps(0),
   _sealed(kFALSE), 
+  _optParamSnap(0),
   _optimized(kFALSE)
 {
   // Constructor taking function (real), a dataset (data), a set of projected observables (projSet). If 
@@ -138,7 +140,7 @@ RooAbsOptTestStatistic::RooAbsOptTestStatistic(const char *name, const char *tit
 
 //_____________________________________________________________________________
 RooAbsOptTestStatistic::RooAbsOptTestStatistic(const RooAbsOptTestStatistic& other, const char* name) : 
-  RooAbsTestStatistic(other,name), _sealed(other._sealed), _sealNotice(other._sealNotice), _optimized(kFALSE)
+  RooAbsTestStatistic(other,name), _sealed(other._sealed), _sealNotice(other._sealNotice), _optParamSnap(0), _optimized(kFALSE)
 {
   // Copy constructor
 
@@ -435,6 +437,7 @@ RooAbsOptTestStatistic::~RooAbsOptTestStatistic()
     }
   } 
   delete _normSet ;
+  delete _optParamSnap ;
 }
 
 
@@ -494,7 +497,9 @@ void RooAbsOptTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool
   // If code Activate is sent, constant term optimization will be executed.
   // If code Deacivate is sent, any existing constant term optimizations will
   // be abanoned. If codes ConfigChange or ValueChange are sent, any existing
-  // constant term optimizations will be redone.
+  // constant term optimizations will be updated: only the precalculated terms
+  // which depend on the changed parameters are recalculated (see updateConstantTerms()),
+  // the optimization is redone completely only if the set of constant terms changed.
 
 //   cout << "ROATS::constOpt(" << GetName() << ") funcClone structure dump BEFORE const-opt" << endl ;
 //   _funcClone->Print("t") ;
@@ -534,6 +539,9 @@ void RooAbsOptTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool
     break ;
 
   case ConfigChange: 
+    if (_optimized && updateConstantTerms()) {
+      break ;
+    }
     cxcoutI(Optimization) << "RooAbsOptTestStatistic::constOptimize(" << GetName() 
 			  << ") one ore more parameter were changed from constant to floating or vice versa, "
 			  << "re-evaluating constant term optimization" << endl ;
@@ -542,6 +550,9 @@ void RooAbsOptTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool
     break ;
 
   case ValueChange: 
+    if (_optimized && updateConstantTerms()) {
+      break ;
+    }
     cxcoutI(Optimization) << "RooAbsOptTestStatistic::constOptimize(" << GetName() 
 			  << ") the value of one ore more constant parameter were changed re-evaluating constant term optimization" << endl ;
     optimizeConstantTerms(kFALSE) ;
@@ -713,6 +724,16 @@ void RooAbsOptTestStatistic::optimizeConstantTerms(Bool_t activate, Bool_t apply
     // Disable reading of observables that are no longer used
     _dataClone->optimizeReadingWithCaching(*_funcClone, _cachedNodes,requiredExtraObservables()) ;
 
+    // Remember the constant expressions and the state of the parameters for incremental updates
+    _cachedConstNodes.removeAll() ;
+    RooArgSet* tmp = (RooArgSet*) _cachedNodes.selectByAttrib("ConstantExpression",kTRUE) ;
+    _cachedConstNodes.add(*tmp) ;
+    delete tmp ;
+    RooArgSet* params = _funcClone->getParameters(*_dataClone->get()) ;
+    delete _optParamSnap ;
+    _optParamSnap = (RooArgSet*) params->snapshot(kFALSE) ;
+    delete params ;
+
     _optimized = kTRUE ;
 
   } else {
@@ -729,7 +750,12 @@ void RooAbsOptTestStatistic::optimizeConstantTerms(Bool_t activate, Bool_t apply
     // Disable propagation of dirty state flags for observables
     _dataClone->setDirtyProp(kFALSE) ;  
 
+    // Forget constant expression state of formerly cached nodes, it is redetermined at the next activation
+    _cachedNodes.setAttribAll("ConstantExpression",kFALSE) ;
     _cachedNodes.removeAll() ;
+    _cachedConstNodes.removeAll() ;
+    delete _optParamSnap ;
+    _optParamSnap = 0 ;
 
 
     _optimized = kFALSE ;
@@ -738,6 +764,109 @@ void RooAbsOptTestStatistic::optimizeConstantTerms(Bool_t activate, Bool_t apply
 
 
 
+//_____________________________________________________________________________
+Bool_t RooAbsOptTestStatistic::updateConstantTerms()
+{
+  // Incremental update of the constant term optimization after a change of the
+  // values or of the constant state of parameters. The parameters of the function
+  // are compared with their state at the time of the optimization:
+  //
+  // - If none of them changed (e.g. the changed parameters belong to another
+  //   component of a simultaneous fit), nothing is done and the value of this
+  //   component is not recalculated.
+  // - If parameters changed from constant to floating or vice versa, the constant
+  //   nodes are searched again. If they are the same as before, the cache is kept.
+  // - The precalculated constant terms which depend on constant parameters whose
+  //   values changed are recalculated, the other ones are kept. Terms evaluated in
+  //   cache-and-track mode are updated by their change tracker as usual.
+  //
+  // Return false if the optimization must be redone completely, i.e. if the set of
+  // nodes to be cached changed or if the dataset cannot recalculate cached terms.
+
+  if (!_optParamSnap) return kFALSE ;
+
+  RooArgSet* params = _funcClone->getParameters(*_dataClone->get()) ;
+  RooArgSet changedConst ;
+  RooArgSet changedVal ;
+  RooFIter iter = params->fwdIterator() ;
+  RooAbsArg* param ;
+  while((param=iter.next())) {
+    RooAbsArg* snap = _optParamSnap->find(param->GetName()) ;
+    if (!snap) {
+      // Parameter did not exist at time of optimization
+      delete params ;
+      return kFALSE ;
+    }
+    if (param->isConstant()!=snap->isConstant()) {
+      changedConst.add(*param) ;
+    } else if (param->isConstant() && !(*param==*snap)) {
+      changedVal.add(*param) ;
+    }
+  }
+
+  if (changedConst.getSize()==0 && changedVal.getSize()==0) {
+    cxcoutD(Optimization) << "RooAbsOptTestStatistic::updateConstantTerms(" << GetName() 
+			  << ") no parameter of this test statistic changed, keeping constant term optimization" << endl ;
+    delete params ;
+    return kTRUE ;
+  }
+
+  if (changedConst.getSize()>0) {
+
+    // Find the nodes to be cached again, and apply the same selection as RooVectorDataStore::cacheArgs()
+    _cachedNodes.setAttribAll("ConstantExpression",kFALSE) ;
+    RooArgSet newNodes ;
+    _funcClone->findConstantNodes(*_dataClone->get(),newNodes) ;
+
+    Bool_t same(kTRUE) ;
+    Int_t nSel(0) ;
+    RooFIter niter = newNodes.fwdIterator() ;
+    RooAbsArg* node ;
+    while((node=niter.next())) {
+      Bool_t isConst = node->getAttribute("ConstantExpression") ;
+      if (node->getAttribute("NOCacheAndTrack") || (!isConst && !node->dependsOn(*_dataClone->get()))) continue ;
+      nSel++ ;
+      if (!_cachedNodes.containsInstance(*node) || isConst!=_cachedConstNodes.containsInstance(*node)) {
+	same = kFALSE ;
+	break ;
+      }
+    }
+    if (!same || nSel!=_cachedNodes.getSize()) {
+      delete params ;
+      return kFALSE ;
+    }
+  }
+
+  // Recalculate the constant terms depending on parameters whose value changed
+  RooArgSet recalcNodes ;
+  if (changedVal.getSize()>0) {
+    RooFIter citer = _cachedConstNodes.fwdIterator() ;
+    RooAbsArg* node ;
+    while((node=citer.next())) {
+      if (node->dependsOnValue(changedVal)) {
+	recalcNodes.add(*node) ;
+      }
+    }
+  }
+  if (recalcNodes.getSize()>0) {
+    if (!_dataClone->store()->recalculateCachedArgs(recalcNodes,_normSet)) {
+      delete params ;
+      return kFALSE ;
+    }
+    setValueDirty() ;
+  }
+
+  cxcoutI(Optimization) << "RooAbsOptTestStatistic::updateConstantTerms(" << GetName() << ") recalculated " 
+			<< recalcNodes.getSize() << " of " << _cachedConstNodes.getSize() << " precalculated constant terms" << endl ;
+
+  delete _optParamSnap ;
+  _optParamSnap = (RooArgSet*) params->snapshot(kFALSE) ;
+  delete params ;
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 Bool_t RooAbsOptTestStatistic::setDataSlave(RooAbsData& indata, Bool_t cloneData, Bool_t ownNewData) 
 { 
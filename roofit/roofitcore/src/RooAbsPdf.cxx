@@ -152,6 +152,7 @@
 #include "RooChi2Var.h"
 #include "RooMinimizer.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 #include <string>
 
 using namespace std;
@@ -302,6 +303,52 @@ Double_t RooAbsPdf::getValV(const RooArgSet* nset) const
 
 
 
+//_____________________________________________________________________________
+void RooAbsPdf::computeBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* nset) const
+{
+  // Batch version of getValV(): the values of evaluateBatch() are divided
+  // by the normalization integral over 'nset'. This is done only if the
+  // integral is the same for all events, i.e. if it does not depend on
+  // (conditional) observables of the data, otherwise the events are
+  // computed one by one. Events for which the unnormalized value is negative
+  // or not-a-number are recomputed with getVal(), which reports the
+  // evaluation error and returns zero.
+
+  Double_t normVal(1) ;
+  if (nset) {
+    if (nset!=_normSet || _norm==0) {
+      syncNormalization(nset) ;
+    }
+    normVal = _norm->getVal() ;
+    if (normVal<=0 || data.dependsOnColumns(*_norm)) {
+      getValEventByEvent(begin,end,output,data,nset) ;
+      return ;
+    }
+  }
+
+  if (!evaluateBatch(begin,end,output,data,nset)) {
+    getValEventByEvent(begin,end,output,data,nset) ;
+    return ;
+  }
+
+  const Double_t* wgt = data.weightColumn() ;
+  const Int_t n = end-begin ;
+  for (Int_t i=0 ; i<n ; i++) {
+    if (output[i]<0 || TMath::IsNaN(output[i])) {
+      if (wgt && wgt[begin+i]==0) {
+	output[i] = 0 ;
+      } else {
+	data.get(begin+i) ;
+	output[i] = getVal(nset) ;
+      }
+    } else if (nset) {
+      output[i] /= normVal ;
+    }
+  }
+}
+
+
+
 //_____________________________________________________________________________
 Double_t RooAbsPdf::analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName) const
 {
@@ -708,6 +755,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooCmdArg& arg1, const
   //                                    Multiple comma separated range names can be specified.
   // SumCoefRange(const char* name)  -- Set the range in which to interpret the coefficients of RooAddPdf components 
   // NumCPU(int num)                 -- Parallelize NLL calculation on num CPUs
+  // NumThreads(int num, Bool_t interleave) -- Parallelize NLL calculation on num threads of this process
+  //                                    (see RooAbsTestStatistic::setThreadMode())
   // Optimize(Bool_t flag)           -- Activate constant term optimization (on by default)
   // SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
   //                                    subsample is assumed to by rangeName_{indexState} where indexState
@@ -718,6 +767,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooCmdArg& arg1, const
   //                                        If none are specified the constrained parameters are used
   // Verbose(Bool_t flag)           -- Constrols RooFit informational messages in likelihood construction
   // CloneData(Bool flag)           -- Use clone of dataset in NLL (default is true)
+  // BatchMode(Bool_t flag)         -- Compute the p.d.f values for ranges of events at once, directly from
+  //                                   the data columns (see RooNLLVar::setBatchMode()), off by default
   // 
   // 
   
@@ -758,6 +809,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineInt("verbose","Verbose",0,0) ;
   pc.defineInt("optConst","Optimize",0,0) ;
   pc.defineInt("cloneData","CloneData",2,0) ;
+  pc.defineInt("batchMode","BatchMode",0,0) ;
+  pc.defineInt("numthreads","NumThreads",0,0) ;
+  pc.defineInt("threadInterleave","NumThreads",1,0) ;
   pc.defineSet("projDepSet","ProjectedObservables",0,0) ;
   pc.defineSet("cPars","Constrain",0,0) ;
   pc.defineSet("glObs","GlobalObservables",0,0) ;
@@ -766,6 +820,7 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineMutex("Range","RangeWithName") ;
   pc.defineMutex("Constrain","Constrained") ;
   pc.defineMutex("GlobalObservables","GlobalObservablesTag") ;
+  pc.defineMutex("NumCPU","NumThreads") ;
     
   // Process and check varargs 
   pc.process(cmdList) ;
@@ -783,6 +838,15 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   Bool_t verbose = pc.getInt("verbose") ;
   Int_t optConst = pc.getInt("optConst") ;
   Int_t cloneData = pc.getInt("cloneData") ;
+  Bool_t batchMode = pc.getInt("batchMode") ;
+  Int_t numthreads = pc.getInt("numthreads") ;
+  Bool_t interleave = kFALSE ;
+
+  // Threads use the same partitioning of the data as processes
+  if (numthreads>1) {
+    numcpu = numthreads ;
+    interleave = pc.getInt("threadInterleave") ;
+  }
   
   // If no explicit cloneData command is specified, cloneData is set to true if optimization is activated
   if (cloneData==2) {
@@ -846,7 +910,10 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     // Simple case: default range, or single restricted range
     //cout<<"FK: Data test 1: "<<data.sumEntries()<<endl;
 
-    nll = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,kFALSE,verbose,splitr,cloneData) ;
+    RooNLLVar* nllVar = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interleave,verbose,splitr,cloneData) ;
+    nllVar->setBatchMode(batchMode) ;
+    nllVar->setThreadMode(numthreads>1) ;
+    nll = nllVar ;
 
   } else {
     // Composite case: multiple ranges
@@ -856,7 +923,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     strlcpy(buf,rangeName,bufSize) ;
     char* token = strtok(buf,",") ;
     while(token) {
-      RooAbsReal* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,kFALSE,verbose,splitr,cloneData) ;
+      RooNLLVar* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interleave,verbose,splitr,cloneData) ;
+      nllComp->setBatchMode(batchMode) ;
+      nllComp->setThreadMode(numthreads>1) ;
       nllList.add(*nllComp) ;
       token = strtok(0,",") ;
     }
@@ -926,6 +995,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooCmdArg& arg1, const Ro
   //                                    Multiple comma separated range names can be specified.
   // SumCoefRange(const char* name)  -- Set the range in which to interpret the coefficients of RooAddPdf components 
   // NumCPU(int num)                 -- Parallelize NLL calculation on num CPUs
+  // NumThreads(int num, Bool_t interleave) -- Parallelize NLL calculation on num threads of this process
   // SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
   //                                    subsample is assumed to by rangeName_{indexState} where indexState
   //                                    is the state of the master index category of the simultaneous fit
@@ -934,6 +1004,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooCmdArg& arg1, const Ro
   // GlobalObservables(const RooArgSet&) -- Define the set of normalization observables to be used for the constraint terms.
   //                                        If none are specified the constrained parameters are used
   // ExternalConstraints(const RooArgSet& ) -- Include given external constraints to likelihood
+  // BatchMode(Bool_t flag)          -- Compute the p.d.f values for ranges of events at once (see RooNLLVar::setBatchMode())
   //
   // Options to control flow of fit procedure
   // ----------------------------------------
@@ -1007,7 +1078,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooLinkedList& cmdList)
   RooCmdConfig pc(Form("RooAbsPdf::fitTo(%s)",GetName())) ;
 
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag") ;
+  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,BatchMode,NumThreads") ;
 
   pc.defineString("fitOpt","FitOptions",0,"") ;
   pc.defineInt("optConst","Optimize",0,2) ;
@@ -2892,6 +2963,35 @@ Double_t RooAbsPdf::expectedEvents(const RooArgSet*) const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooAbsPdf::expectedEventsGradient(const RooArgList& /*params*/, Double_t* /*grad*/, const RooArgSet* /*nset*/) const
+{
+  // Compute the derivatives of expectedEvents(nset) with respect to the
+  // parameters 'params' in grad[0] ... grad[params.getSize()-1], for the
+  // analytical gradient of extended likelihoods. Return false if they
+  // cannot be calculated, which is the case in this default implementation.
+
+  return kFALSE ;
+}
+
+
+
+//_____________________________________________________________________________
+Int_t RooAbsPdf::gradientNormCode(const RooAbsReal& arg, const RooArgSet* normSet)
+{
+  // Helper for evaluateGradient() of p.d.f.s with analytical normalization 
+  // integrals: return 1 if 'arg' is one of the observables of 'normSet', 0 if it
+  // does not depend on them and -1 if it depends on them through a function
+  // (for which the normalization integral is not the analytical one)
+
+  if (!normSet || normSet->getSize()==0) return 0 ;
+  if (normSet->find(arg.GetName())) return 1 ;
+  if (arg.isDerived() && arg.dependsOn(*normSet)) return -1 ;
+  return 0 ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooAbsPdf::verboseEval(Int_t stat) 
 { 
@@ -95,6 +95,9 @@
 #include "TVector.h"
 
 #include <sstream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std ;
  
@@ -108,9 +111,18 @@ RooAbsReal::ErrorLoggingMode RooAbsReal::_evalErrorMode = RooAbsReal::PrintError
 Int_t RooAbsReal::_evalErrorCount = 0 ;
 map<const RooAbsArg*,pair<string,list<RooAbsReal::EvalError> > > RooAbsReal::_evalErrorList ;
 
+// Evaluation error logging mode of a thread that changed it inside a parallel region
+// (see setEvalErrorLoggingMode()), in use as long as it differs from _evalErrorMode
+static Bool_t threadEvalErrorModeSet = kFALSE ;
+static RooAbsReal::ErrorLoggingMode threadEvalErrorMode = RooAbsReal::PrintErrors ;
+#ifdef _OPENMP
+#pragma omp threadprivate(threadEvalErrorModeSet,threadEvalErrorMode)
+#endif
+
 
 //_____________________________________________________________________________
-RooAbsReal::RooAbsReal() : _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
+RooAbsReal::RooAbsReal() : _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0),
+  _gradParams(0), _gradParamsTag(0), _gradSelf(-1)
 {
   // coverity[UNINIT_CTOR]
   // Default constructor
@@ -121,7 +133,8 @@ RooAbsReal::RooAbsReal() : _specIntegratorConfig(0), _treeVar(kFALSE), _selectCo
 //_____________________________________________________________________________
 RooAbsReal::RooAbsReal(const char *name, const char *title, const char *unit) : 
   RooAbsArg(name,title), _plotMin(0), _plotMax(0), _plotBins(100), 
-  _value(0),  _unit(unit), _forceNumInt(kFALSE), _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
+  _value(0),  _unit(unit), _forceNumInt(kFALSE), _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0),
+  _gradParams(0), _gradParamsTag(0), _gradSelf(-1)
 {
   // Constructor with unit label
   setValueDirty() ;
@@ -135,7 +148,8 @@ RooAbsReal::RooAbsReal(const char *name, const char *title, const char *unit) :
 RooAbsReal::RooAbsReal(const char *name, const char *title, Double_t inMinVal,
 		       Double_t inMaxVal, const char *unit) :
   RooAbsArg(name,title), _plotMin(inMinVal), _plotMax(inMaxVal), _plotBins(100),
-  _value(0), _unit(unit), _forceNumInt(kFALSE), _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
+  _value(0), _unit(unit), _forceNumInt(kFALSE), _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0),
+  _gradParams(0), _gradParamsTag(0), _gradSelf(-1)
 {
   // Constructor with plot range and unit label
   setValueDirty() ;
@@ -149,7 +163,8 @@ RooAbsReal::RooAbsReal(const char *name, const char *title, Double_t inMinVal,
 RooAbsReal::RooAbsReal(const RooAbsReal& other, const char* name) : 
   RooAbsArg(other,name), _plotMin(other._plotMin), _plotMax(other._plotMax), 
   _plotBins(other._plotBins), _value(other._value), _unit(other._unit), _forceNumInt(other._forceNumInt), 
-  _treeVar(other._treeVar), _selectComp(other._selectComp), _lastNSet(0)
+  _treeVar(other._treeVar), _selectComp(other._selectComp), _lastNSet(0),
+  _gradParams(0), _gradParamsTag(0), _gradSelf(-1)
 {
   // coverity[UNINIT_CTOR]
   // Copy constructor
@@ -233,6 +248,234 @@ Double_t RooAbsReal::getValV(const RooArgSet* nset) const
 }
 
 
+//_____________________________________________________________________________
+void RooAbsReal::getValBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Compute the values of this function, normalized to 'normSet', for the
+  // events [begin,end) of the data store 'data' and write them in
+  // output[0] ... output[end-begin-1]. The results are the same as the ones
+  // of getVal(normSet) after loading each event, but for the classes that
+  // implement evaluateBatch() the whole range is computed at once from the
+  // data columns, without loading the events in the observables and without
+  // going through the expression tree (and its dirty state propagation) for
+  // each of them:
+  //
+  // - if this function is a column of the data (an observable or a
+  //   precalculated constant term) the values are copied from the column
+  // - if it does not depend on the data its current value is used for all events
+  // - otherwise computeBatch() is called, which uses evaluateBatch() on the 
+  //   values of the servers or, for classes which do not implement it, loads
+  //   the events one by one and calls getVal()
+  //
+  // Events with zero weight are not evaluated (their value is zero).
+
+  const Int_t n = end-begin ;
+  if (n<=0) return ;
+
+  const Double_t* column = data.realColumn(*this) ;
+  if (column) {
+    for (Int_t i=0 ; i<n ; i++) output[i] = column[begin+i] ;
+    return ;
+  }
+
+  if (!data.dependsOnColumns(*this)) {
+    Double_t val = getVal(normSet) ;
+    for (Int_t i=0 ; i<n ; i++) output[i] = val ;
+    return ;
+  }
+
+  computeBatch(begin,end,output,data,normSet) ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsReal::computeBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Compute the values for the events [begin,end) with evaluateBatch(), or
+  // event by event if the class does not implement it
+
+  if (!evaluateBatch(begin,end,output,data,normSet)) {
+    getValEventByEvent(begin,end,output,data,normSet) ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooAbsReal::evaluateBatch(Int_t /*begin*/, Int_t /*end*/, Double_t* /*output*/, 
+				 const RooVectorDataStore& /*data*/, const RooArgSet* /*normSet*/) const
+{
+  // Batch version of evaluate(): classes which can compute their values for
+  // a range of events at once overload this function, taking the values of
+  // their servers with batchValues(), and return true. The default
+  // implementation returns false and the values are computed event by event.
+
+  return kFALSE ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsReal::getValEventByEvent(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Compute the values for the events [begin,end) by loading each event
+  // in the observables and calling getVal()
+
+  const Double_t* wgt = data.weightColumn() ;
+  for (Int_t i=begin ; i<end ; i++) {
+    if (wgt && wgt[i]==0) {
+      output[i-begin] = 0 ;
+      continue ;
+    }
+    data.get(i) ;
+    output[i-begin] = getVal(normSet) ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+const Double_t* RooAbsReal::batchValues(const RooAbsReal& arg, Int_t begin, Int_t end, std::vector<Double_t>& buf, 
+					const RooVectorDataStore& data, const RooArgSet* normSet) 
+{
+  // Return a pointer to the values of 'arg' for the events [begin,end), for use
+  // in evaluateBatch(): this points directly into the data column if 'arg' is
+  // stored in the data, otherwise the values are computed in 'buf' with getValBatch()
+
+  const Double_t* column = data.realColumn(arg) ;
+  if (column) return column + begin ;
+
+  buf.resize(end-begin) ;
+  arg.getValBatch(begin,end,&buf[0],data,normSet) ;
+  return &buf[0] ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooAbsReal::getGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const
+{
+  // Compute the derivatives of getVal(normSet) with respect to each of the
+  // parameters in 'params' at their current values and store them in
+  // grad[0] ... grad[params.getSize()-1]. Return false if the derivatives
+  // cannot be calculated analytically, i.e. if the function depends on one of
+  // the parameters through a class that does not implement evaluateGradient().
+  //
+  // The derivatives are propagated through the expression tree with the chain
+  // rule: each class computes the derivatives of its value with respect to its
+  // servers and combines them with the gradients of the servers (see
+  // addGradient()). Fundamental objects and nodes marked as constant expressions
+  // by the constant term optimization only depend on the parameters if they
+  // are one of them.
+
+  const Int_t n = params.getSize() ;
+  for (Int_t i=0 ; i<n ; i++) grad[i] = 0 ;
+
+  return addGradient(*this,1,params,grad,normSet) ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooAbsReal::evaluateGradient(const RooArgList& /*params*/, Double_t* /*grad*/, const RooArgSet* /*normSet*/) const
+{
+  // Analytical gradient of evaluate() (of the normalized value for p.d.f.s
+  // if 'normSet' is not empty): classes which can compute the derivatives of 
+  // their value with respect to their servers overload this function, add the
+  // contributions of each server to 'grad' (which is zero on input) with 
+  // addGradient() and return true. The default implementation returns false.
+
+  return kFALSE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooAbsReal::addGradient(const RooAbsReal& arg, Double_t coef, const RooArgList& params, Double_t* grad, const RooArgSet* normSet)
+{
+  // Add coef times the gradient of arg.getVal(normSet) with respect to 'params'
+  // to 'grad', for use in evaluateGradient(). Return false if the gradient of
+  // 'arg' is not available.
+  //
+  // Only the elements of the parameters on which 'arg' depends are calculated 
+  // and added (see gradientIndex()), in a scratch buffer of 'arg' that is reused
+  // for all events
+
+  const std::vector<Int_t>& index = arg.gradientIndex(params) ;
+  if (arg._gradSelf>=0) {
+    grad[arg._gradSelf] += coef ;
+    return kTRUE ;
+  }
+  if (index.empty() || arg.getAttribute("ConstantExpression")) {
+    return kTRUE ;
+  }
+
+  const Int_t n = params.getSize() ;
+  std::vector<Double_t>& argGrad = arg._gradBuf ;
+  if ((Int_t)argGrad.size()!=n) {
+    argGrad.assign(n,0.) ;
+  }
+  const Int_t m = index.size() ;
+  Int_t i ;
+  for (i=0 ; i<m ; i++) argGrad[index[i]] = 0 ;
+
+  if (!arg.evaluateGradient(params,&argGrad[0],normSet)) {
+    // No analytical derivatives: the gradient is only known if it is zero
+    return !arg.dependsOnValue(params) ;
+  }
+  for (i=0 ; i<m ; i++) {
+    grad[index[i]] += coef*argGrad[index[i]] ;
+  }
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+const std::vector<Int_t>& RooAbsReal::gradientIndex(const RooArgList& params) const
+{
+  // Return the indices in 'params' of the parameters on which this object 
+  // depends, the only elements of its gradient that can be non-zero. They 
+  // are determined from the indices of the servers once for each parameter
+  // list, and again only if the contents of the list change, so that the
+  // gradient of each node costs a time proportional to its own number of
+  // parameters during a minimization
+
+  if (_gradParams==&params && _gradParamsTag==params.contentsTag()) {
+    return _gradIndex ;
+  }
+
+  std::set<Int_t> index ;
+  _gradSelf = params.index(this) ;
+  if (_gradSelf>=0) {
+    index.insert(_gradSelf) ;
+  } else if (isDerived()) {
+    RooFIter sIter = serverMIterator() ;
+    RooAbsArg* server ;
+    while((server=sIter.next())) {
+      RooAbsReal* rserver = dynamic_cast<RooAbsReal*>(server) ;
+      if (rserver) {
+	const std::vector<Int_t>& sIndex = rserver->gradientIndex(params) ;
+	index.insert(sIndex.begin(),sIndex.end()) ;
+      } else {
+	RooFIter pIter = params.fwdIterator() ;
+	RooAbsArg* param ;
+	for (Int_t i=0 ; (param=pIter.next()) ; i++) {
+	  if (server==param || server->dependsOnValue(*param)) index.insert(i) ;
+	}
+      }
+    }
+  }
+
+  _gradIndex.assign(index.begin(),index.end()) ;
+  _gradParams = &params ;
+  _gradParamsTag = params.contentsTag() ;
+  return _gradIndex ;
+}
+
+
+
 //_____________________________________________________________________________
 Int_t RooAbsReal::numEvalErrorItems() 
 { 
@@ -3343,16 +3586,22 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
 {
   // Interface to insert remote error logging messages received by RooRealMPFE into current error loggin stream
 
-  if (_evalErrorMode==Ignore) {
+  if (evalErrorLoggingMode()==Ignore) {
     return ;
   }
 
-  if (_evalErrorMode==CountErrors) {
+  if (evalErrorLoggingMode()==CountErrors) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
     _evalErrorCount++ ;
     return ;
   }
 
   static Bool_t inLogEvalError = kFALSE ;  
+#ifdef _OPENMP
+#pragma omp threadprivate(inLogEvalError)
+#endif
 
   if (inLogEvalError) {
     return ;
@@ -3366,15 +3615,21 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
     ee.setServerValues(serverValueString) ;
   } 
 
-  if (_evalErrorMode==PrintErrors) {
+  // Errors may be logged concurrently by the threads of a test statistic (see RooAbsTestStatistic::setThreadMode())
+#ifdef _OPENMP
+#pragma omp critical (RooAbsReal_logEvalError)
+#endif
+  {
+  if (evalErrorLoggingMode()==PrintErrors) {
    oocoutE((TObject*)0,Eval) << "RooAbsReal::logEvalError(" << "<STATIC>" << ") evaluation error, " << endl 
 		   << " origin       : " << origName << endl 
 		   << " message      : " << ee._msg << endl
 		   << " server values: " << ee._srvval << endl ;
-  } else if (_evalErrorMode==CollectErrors) {
+  } else if (evalErrorLoggingMode()==CollectErrors) {
     _evalErrorList[originator].first = origName ;
     _evalErrorList[originator].second.push_back(ee) ;
   }
+  }
 
 
   inLogEvalError = kFALSE ;
@@ -3398,16 +3653,22 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
   // A string with server names and values is constructed automatically for error logging
   // purposes, unless a custom string with similar information is passed as argument.
 
-  if (_evalErrorMode==Ignore) {
+  if (evalErrorLoggingMode()==Ignore) {
     return ;
   }
 
-  if (_evalErrorMode==CountErrors) {
+  if (evalErrorLoggingMode()==CountErrors) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
     _evalErrorCount++ ;
     return ;
   }
 
   static Bool_t inLogEvalError = kFALSE ;  
+#ifdef _OPENMP
+#pragma omp threadprivate(inLogEvalError)
+#endif
 
   if (inLogEvalError) {
     return ;
@@ -3440,15 +3701,20 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
   ostringstream oss2 ;
   printStream(oss2,kName|kClassName|kArgs,kInline)  ;
 
-  if (_evalErrorMode==PrintErrors) {
+#ifdef _OPENMP
+#pragma omp critical (RooAbsReal_logEvalError)
+#endif
+  {
+  if (evalErrorLoggingMode()==PrintErrors) {
    coutE(Eval) << "RooAbsReal::logEvalError(" << GetName() << ") evaluation error, " << endl 
 	       << " origin       : " << oss2.str() << endl 
 	       << " message      : " << ee._msg << endl
 	       << " server values: " << ee._srvval << endl ;
-  } else if (_evalErrorMode==CollectErrors) {
+  } else if (evalErrorLoggingMode()==CollectErrors) {
     _evalErrorList[this].first = oss2.str().c_str() ;
     _evalErrorList[this].second.push_back(ee) ;
   }
+  }
 
   inLogEvalError = kFALSE ;
   //coutE(Tracing) << "RooAbsReal::logEvalError(" << GetName() << ") message = " << message << endl ;
@@ -4380,6 +4646,11 @@ RooFitResult* RooAbsReal::chi2FitDriver(RooAbsReal& fcn, RooLinkedList& cmdList)
 RooAbsReal::ErrorLoggingMode RooAbsReal::evalErrorLoggingMode() 
 { 
   // Return current evaluation error logging mode. 
+#ifdef _OPENMP
+  if (threadEvalErrorModeSet && omp_in_parallel()) {
+    return threadEvalErrorMode ;
+  }
+#endif
   return _evalErrorMode ; 
 }
 
@@ -4393,7 +4664,16 @@ void RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::ErrorLoggingMode m)
   //                 to printEvalErrors() will print a summary
   // CountErrors - Accumulate error count, but do not print them. 
   //
+  // Inside a parallel region, e.g. in the threads evaluating the partitions of
+  // a test statistic, the mode is only changed for the calling thread.
 
+#ifdef _OPENMP
+  if (omp_in_parallel()) {
+    threadEvalErrorModeSet = (m!=_evalErrorMode) ;
+    threadEvalErrorMode = m ;
+    return ;
+  }
+#endif
   _evalErrorMode =  m; 
 }
 
@@ -29,7 +29,10 @@
 // organizes multi-processor parallel calculation of test statistic
 // values. For the latter, the test statistic value is calculated in
 // partitions in parallel executing processes and a posteriori
-// combined in the main thread.
+// combined in the main thread. With setThreadMode() the partitions
+// are calculated in threads of the main process instead, each
+// thread owning a clone of the test statistic with its own copy
+// of the parameters.
 // END_HTML
 //
 
@@ -49,6 +52,7 @@
 #include "RooMsgService.h"
 
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -69,6 +73,13 @@ RooAbsTestStatistic::RooAbsTestStatistic()
   _projDeps = 0 ;
   _gofOpMode = Slave ;
   _mpinterl = kFALSE ;
+  _mpThreads = kFALSE ;
+  _mtArray = 0 ;
+  _mtParamArray = 0 ;
+  _mtGradParams = 0 ;
+  _mtGradList = 0 ;
+  _mtGradListTag = 0 ;
+  _mtSerial = kTRUE ;
   _nCPU = 1 ;
   _nEvents = 0 ; 
   _nGof = 0 ;
@@ -99,7 +110,14 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _gofArray(0),
   _nCPU(nCPU),
   _mpfeArray(0),
-  _mpinterl(interleave)
+  _mpinterl(interleave),
+  _mpThreads(kFALSE),
+  _mtArray(0),
+  _mtParamArray(0),
+  _mtSerial(kTRUE),
+  _mtGradParams(0),
+  _mtGradList(0),
+  _mtGradListTag(0)
 {
   // Constructor taking function (real), a dataset (data), a set of projected observables (projSet). If
   // rangeName is not null, only events in the dataset inside the range will be used in the test
@@ -164,7 +182,14 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
   _gofArray(0),
   _nCPU(other._nCPU),
   _mpfeArray(0),
-  _mpinterl(other._mpinterl)
+  _mpinterl(other._mpinterl),
+  _mpThreads(other._mpThreads),
+  _mtArray(0),
+  _mtParamArray(0),
+  _mtSerial(kTRUE),
+  _mtGradParams(0),
+  _mtGradList(0),
+  _mtGradListTag(0)
 {
   // Copy constructor
 
@@ -208,10 +233,20 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
 
   if (_gofOpMode==MPMaster && _init) {
     Int_t i ;
-    for (i=0 ; i<_nCPU ; i++) {
-      delete _mpfeArray[i] ;
+    if (_mtArray) {
+      for (i=0 ; i<_nCPU ; i++) {
+	delete _mtArray[i] ;
+	delete _mtParamArray[i] ;
+      }
+      delete[] _mtArray ;
+      delete[] _mtParamArray ;
+      delete[] _mtGradParams ;
+    } else {
+      for (i=0 ; i<_nCPU ; i++) {
+	delete _mpfeArray[i] ;
+      }
+      delete[] _mpfeArray ;
     }
-    delete[] _mpfeArray ;
   }
 
   if (_gofOpMode==SimMaster && _init) {
@@ -256,6 +291,32 @@ Double_t RooAbsTestStatistic::evaluate() const
 
     return ret ;
 
+  } else if (_gofOpMode==MPMaster && _mtArray) {
+
+    // Copy changed parameters to the thread test statistics and calculate them in parallel. 
+    // The first evaluation after the initialization or a change of the constant term 
+    // optimization is made serially, as it creates the normalization integrals and caches.
+    // The state shared by the threads (dirty state inhibit of the numeric integrals, 
+    // memory pool of RooArgSet, expensive object cache, name registry and error 
+    // logging) is thread local or locked in parallel regions
+    syncThreadParams() ;
+    Int_t i ;
+    if (_mtSerial) {
+      for (i=0 ; i<_nCPU ; i++) {
+	_mtArray[i]->getVal() ;
+      }
+      _mtSerial = kFALSE ;
+    } else {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(_nCPU) schedule(static,1)
+#endif
+      for (i=0 ; i<_nCPU ; i++) {
+	_mtArray[i]->getVal() ;
+      }
+    }
+    Double_t ret = combinedValue((RooAbsReal**)_mtArray,_nCPU)/globalNormalization() ;
+    return ret ;
+
   } else if (_gofOpMode==MPMaster) {
 
     // Start calculations in parallel
@@ -296,6 +357,123 @@ Double_t RooAbsTestStatistic::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooAbsTestStatistic::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*normSet*/) const
+{
+  // Calculate the analytical gradient of the test statistic. The gradients of
+  // the components of a simultaneous p.d.f. and of the partitions calculated 
+  // in threads are combined in the same way as their values, the gradient of
+  // each partition is calculated by evaluatePartitionGradient(). Partitions
+  // calculated in separate processes are not supported and false is returned.
+
+  // One-time Initialization
+  if (!_init) {
+    const_cast<RooAbsTestStatistic*>(this)->initialize() ;
+  }
+
+  const Int_t n = params.getSize() ;
+  Int_t i,k ;
+
+  if (_gofOpMode==SimMaster) {
+
+    std::vector<Double_t> compGrad(n) ;
+    for (i=0 ; i<_nGof ; i++) {
+      if (!_gofArray[i]->getGradient(params,&compGrad[0])) return kFALSE ;
+      for (k=0 ; k<n ; k++) grad[k] += compGrad[k] ;
+    }
+
+    // Only apply global normalization if SimMaster doesn't have MP master
+    if (numSets()==1) {
+      for (k=0 ; k<n ; k++) grad[k] /= globalNormalization() ;
+    }
+    return kTRUE ;
+
+  } else if (_gofOpMode==MPMaster && _mtArray) {
+
+    // Map the parameters on the private parameter copies of the threads, which are
+    // in the same order as _paramSet. The mapping is only made again if the
+    // parameter list changes, so that the gradient index of each node in the
+    // threads remains valid (see RooAbsReal::gradientIndex())
+    if (_mtGradList!=&params || _mtGradListTag!=params.contentsTag()) {
+      RooArgList paramList(_paramSet) ;
+      std::vector<RooArgList> mtParamList(_nCPU) ;
+      _mtGradPos.clear() ;
+      for (i=0 ; i<_nCPU ; i++) {
+	mtParamList[i].add(*_mtParamArray[i]) ;
+	_mtGradParams[i].removeAll() ;
+      }
+      RooFIter pIter = params.fwdIterator() ;
+      for (k=0 ; k<n ; k++) {
+	Int_t idx = paramList.index(pIter.next()) ;
+	if (idx<0) continue ;
+	_mtGradPos.push_back(k) ;
+	for (i=0 ; i<_nCPU ; i++) {
+	  _mtGradParams[i].add(*mtParamList[i].at(idx)) ;
+	}
+      }
+      // Assign the contents tags here rather than concurrently in the threads
+      for (i=0 ; i<_nCPU ; i++) {
+	_mtGradParams[i].contentsTag() ;
+      }
+      _mtGradList = &params ;
+      _mtGradListTag = params.contentsTag() ;
+    }
+    syncThreadParams() ;
+    const std::vector<Int_t>& pos = _mtGradPos ;
+    const Int_t m = pos.size() ;
+    if (m==0) return kTRUE ;
+
+    std::vector<Double_t> mtGrad(_nCPU*m) ;
+    std::vector<Int_t> mtOK(_nCPU) ;
+    if (_mtSerial) {
+      for (i=0 ; i<_nCPU ; i++) {
+	mtOK[i] = _mtArray[i]->getGradient(_mtGradParams[i],&mtGrad[i*m]) ;
+      }
+      _mtSerial = kFALSE ;
+    } else {
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(_nCPU) schedule(static,1)
+#endif
+      for (i=0 ; i<_nCPU ; i++) {
+	mtOK[i] = _mtArray[i]->getGradient(_mtGradParams[i],&mtGrad[i*m]) ;
+      }
+    }
+
+    for (i=0 ; i<_nCPU ; i++) {
+      if (!mtOK[i]) return kFALSE ;
+      for (k=0 ; k<m ; k++) grad[pos[k]] += mtGrad[i*m+k] ;
+    }
+    for (k=0 ; k<n ; k++) grad[k] /= globalNormalization() ;
+    return kTRUE ;
+
+  } else if (_gofOpMode==MPMaster) {
+
+    return kFALSE ;
+
+  } else {
+
+    Int_t nFirst, nLast, nStep ;
+    if (_mpinterl) {
+      nFirst = _setNum ;
+      nLast  = _nEvents ;
+      nStep  = _numSets ;
+    } else {
+      nFirst = _nEvents * _setNum / _numSets ;
+      nLast  = _nEvents * (_setNum+1) / _numSets ;
+      nStep  = 1 ;
+    }
+
+    if (!evaluatePartitionGradient(nFirst,nLast,nStep,params,grad)) return kFALSE ;
+    if (numSets()==1) {
+      for (k=0 ; k<n ; k++) grad[k] /= globalNormalization() ;
+    }
+    return kTRUE ;
+
+  }
+}
+
+
+
 //_____________________________________________________________________________
 Bool_t RooAbsTestStatistic::initialize()
 {
@@ -305,7 +483,9 @@ Bool_t RooAbsTestStatistic::initialize()
   
   if (_init) return kFALSE ;
   
-  if (_gofOpMode==MPMaster) {
+  if (_gofOpMode==MPMaster && _mpThreads) {
+    initMTMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+  } else if (_gofOpMode==MPMaster) {
     initMPMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   } else if (_gofOpMode==SimMaster) {
     initSimMode((RooSimultaneous*)_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
@@ -331,7 +511,8 @@ Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServe
     }
   } else if (_gofOpMode==MPMaster && _mpfeArray) {
 
-    // Forward to slaves
+    // Forward to slaves (the thread test statistics are attached to their own
+    // parameters, they are synchronized by position with _paramSet)
     Int_t i ;
     for (i=0 ; i<_nCPU ; i++) {
       if (_mpfeArray[i]) {
@@ -383,6 +564,12 @@ void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t
     for (i=0 ; i<_nGof ; i++) {
       if (_gofArray[i]) _gofArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt) ;
     }
+  } else if (_gofOpMode==MPMaster && _mtArray) {
+    syncThreadParams() ;
+    for (i=0 ; i<_nCPU ; i++) {
+      _mtArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt) ;
+    }
+    _mtSerial = kTRUE ;
   } else if (_gofOpMode==MPMaster) {
     for (i=0 ; i<_nCPU ; i++) {
       _mpfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt) ;
@@ -443,6 +630,99 @@ void RooAbsTestStatistic::initMPMode(RooAbsReal* real, RooAbsData* data, const R
 
 
 
+//_____________________________________________________________________________
+void RooAbsTestStatistic::initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
+{
+  // Initialize multi-thread calculation mode. Create a component test statistic for each
+  // partition, with its own clone of the function and the data, attached to its own copy
+  // of the parameters. The partitions are the same as in multi-processor mode.
+
+  Int_t i ;
+  _mtArray = new pRooAbsTestStatistic[_nCPU] ;
+  _mtParamArray = new RooArgSet*[_nCPU] ;
+  _mtGradParams = new RooArgList[_nCPU] ;
+
+  for (i=0 ; i<_nCPU ; i++) {
+
+    RooAbsTestStatistic* gof = create(GetName(),GetTitle(),*real,*data,*projDeps,rangeName,addCoefRangeName,1,_mpinterl,_verbose,_splitRange) ;
+    gof->SetName(Form("%s_GOF%d",GetName(),i)) ;
+    gof->SetTitle(Form("%s_GOF%d",GetTitle(),i)) ;
+
+    // Attach the component to a private copy of the parameters, in the order of _paramSet
+    _mtParamArray[i] = (RooArgSet*) _paramSet.snapshot(kFALSE) ;
+    gof->recursiveRedirectServers(*_mtParamArray[i]) ;
+    gof->setMPSet(i,_nCPU) ;
+
+    _mtArray[i] = gof ;
+  }
+  coutI(Eval) << "RooAbsTestStatistic::initMTMode(" << GetName() << ") calculating " << _nCPU << " partitions in threads" << endl ;
+#ifndef _OPENMP
+  coutW(Eval) << "RooAbsTestStatistic::initMTMode(" << GetName() << ") WARNING: RooFitCore was built without openMP, "
+	      << "the partitions are calculated sequentially" << endl ;
+#endif
+
+  _mtSerial = kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsTestStatistic::syncThreadParams() const 
+{
+  // Copy the values and constant flags of the parameters which have changed to the 
+  // copies of the parameters owned by the thread test statistics. Only the changed 
+  // parameters are copied, so that the thread test statistics are only recalculated 
+  // when needed
+
+  Int_t n = _paramSet.getSize() ;
+  std::vector<RooAbsArg*> params(n) ;
+  RooFIter iter = _paramSet.fwdIterator() ;
+  Int_t j ;
+  for (j=0 ; j<n ; j++) {
+    params[j] = iter.next() ;
+  }
+
+  for (Int_t i=0 ; i<_nCPU ; i++) {
+    RooFIter titer = _mtParamArray[i]->fwdIterator() ;
+    for (j=0 ; j<n ; j++) {
+      RooAbsArg* tvar = titer.next() ;
+      if (!(*tvar==*params[j]) || tvar->isConstant()!=params[j]->isConstant()) {
+	tvar->setAttribute("Constant",params[j]->isConstant()) ;
+	if (dynamic_cast<RooAbsRealLValue*>(tvar)) {
+	  ((RooAbsRealLValue*)tvar)->setVal(((RooAbsReal*)params[j])->getVal()) ;
+	} else if (dynamic_cast<RooAbsCategoryLValue*>(tvar)) {
+	  ((RooAbsCategoryLValue*)tvar)->setIndex(((RooAbsCategory*)params[j])->getIndex()) ;
+	}
+      }
+    }
+  }
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsTestStatistic::setThreadMode(Bool_t flag) 
+{
+  // If flag is true, the partitions of the multi-processor mode (NumCPU) are
+  // calculated in threads of this process rather than in separate processes.
+  // Each thread calculates its partition with its own clone of the function
+  // and of the data, attached to a private copy of the parameters. The changed
+  // parameter values are copied to these copies before each calculation. The
+  // threads are run in parallel when RooFitCore is built with openMP (USE_OPENMP),
+  // otherwise they are calculated one after the other.
+  //
+  // The mode must be set before the first evaluation of the test statistic.
+
+  if (_init && _gofOpMode==MPMaster) {
+    coutE(Eval) << "RooAbsTestStatistic::setThreadMode(" << GetName() 
+		<< ") ERROR: parallel calculation is already initialized, thread mode is not changed" << endl ;
+    return ;
+  }
+  _mpThreads = flag ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooAbsTestStatistic::initSimMode(RooSimultaneous* simpdf, RooAbsData* data,
 				      const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
@@ -22,6 +22,12 @@
 // The RooAcceptReject generator is used by the various generator context
 // classes to take care of generation of observables for which p.d.fs
 // do not define internal methods
+// <p>
+// The trial samples are generated in blocks of 'batchSize' events (a parameter
+// of the RooAcceptReject section of RooNumGenConfig) and the function is evaluated
+// for each block at once with RooAbsReal::getValBatch(). The sequence of random
+// numbers, hence the generated events, is the same as for the event-by-event
+// evaluation (batchSize=1).
 // END_HTML
 //
 
@@ -39,6 +45,7 @@
 #include "RooErrorHandler.h"
 
 #include "TString.h"
+#include "TMath.h"
 #include "TIterator.h"
 #include "RooMsgService.h"
 #include "TClass.h"
@@ -46,8 +53,10 @@
 #include "RooRealBinding.h"
 #include "RooNumGenFactory.h"
 #include "RooNumGenConfig.h"
+#include "RooVectorDataStore.h"
 
 #include <assert.h>
+#include <vector>
 
 using namespace std;
 
@@ -63,9 +72,10 @@ void RooAcceptReject::registerSampler(RooNumGenFactory& fact)
   RooRealVar nTrial1D("nTrial1D","Number of trial samples for 1-dim generation",1000,0,1e9) ;
   RooRealVar nTrial2D("nTrial2D","Number of trial samples for 2-dim generation",100000,0,1e9) ;
   RooRealVar nTrial3D("nTrial3D","Number of trial samples for N-dim generation",10000000,0,1e9) ;
+  RooRealVar batchSize("batchSize","Number of trial samples evaluated at once",1024,1,1e9) ;
 
   RooAcceptReject* proto = new RooAcceptReject ;
-  fact.storeProtoSampler(proto,RooArgSet(nTrial0D,nTrial1D,nTrial2D,nTrial3D)) ;
+  fact.storeProtoSampler(proto,RooArgSet(nTrial0D,nTrial1D,nTrial2D,nTrial3D,batchSize)) ;
 }
 
 
@@ -83,6 +93,8 @@ RooAcceptReject::RooAcceptReject(const RooAbsReal &func, const RooArgSet &genVar
   _minTrialsArray[1] = static_cast<Int_t>(config.getConfigSection("RooAcceptReject").getRealValue("nTrial1D")) ;
   _minTrialsArray[2] = static_cast<Int_t>(config.getConfigSection("RooAcceptReject").getRealValue("nTrial2D")) ;
   _minTrialsArray[3] = static_cast<Int_t>(config.getConfigSection("RooAcceptReject").getRealValue("nTrial3D")) ;
+  _batchSize = static_cast<UInt_t>(config.getConfigSection("RooAcceptReject").getRealValue("batchSize",1)) ;
+  if (_batchSize<1) _batchSize = 1 ;
 
   _realSampleDim = _realVars.getSize() ;
   TIterator* iter = _catVars.createIterator() ;
@@ -184,7 +196,9 @@ const RooArgSet *RooAcceptReject::generateEvent(UInt_t remaining, Double_t& resa
     // maximum function value
 
     while(_totalEvents < _minTrials) {
-      addEventToCache();
+      // Add events up to the limit of the cache size
+      Int_t nMax = 1000001 - _cache->numEntries() ;
+      addEventsToCache(TMath::Min(_minTrials-_totalEvents,UInt_t(nMax>1?nMax:1)));
 
       // Limit cache size to 1M events
       if (_cache->numEntries()>1000000) {
@@ -220,14 +234,10 @@ const RooArgSet *RooAcceptReject::generateEvent(UInt_t remaining, Double_t& resa
       Long64_t extra= 1 + (Long64_t)(1.05*remaining/eff);
       cxcoutD(Generation) << "RooAcceptReject::generateEvent: adding " << extra << " events to the cache, eff = " << eff << endl;
       Double_t oldMax(_maxFuncVal);
-      while(extra--) {
-	addEventToCache();
-	if((_maxFuncVal > oldMax)) {
-	  cxcoutD(Generation) << "RooAcceptReject::generateEvent: estimated function maximum increased from "
-			      << oldMax << " to " << _maxFuncVal << endl;
-	  oldMax = _maxFuncVal ;
-	  // Trim cache here
-	}
+      addEventsToCache(UInt_t(extra));
+      if((_maxFuncVal > oldMax)) {
+	cxcoutD(Generation) << "RooAcceptReject::generateEvent: estimated function maximum increased from "
+			    << oldMax << " to " << _maxFuncVal << endl;
       }
     }
 
@@ -264,6 +274,27 @@ const RooArgSet *RooAcceptReject::nextAcceptedEvent()
   // not own the event and it will be overwritten by a subsequent call.
 
   const RooArgSet *event = 0;
+
+  // Compare with the function values in the cache column if the cache is 
+  // stored in vectors, and only load the accepted event 
+  RooVectorDataStore* store = dynamic_cast<RooVectorDataStore*>(_cache->store()) ;
+  const Double_t* funcVals = store ? store->realColumn(*_funcValPtr) : 0 ;
+  if (funcVals) {
+    const UInt_t nEvents = _cache->numEntries() ;
+    while(_eventsUsed < nEvents) {
+      const Double_t val = funcVals[_eventsUsed++] ;
+      Double_t r= RooRandom::uniform();
+      if(r*_maxFuncVal > val) continue;
+      event = _cache->get(_eventsUsed-1) ;
+      if(_verbose && (_eventsUsed%1000==0)) {
+	cerr << "RooAcceptReject: accepted event (used " << _eventsUsed << " of "
+	     << nEvents << " so far)" << endl;
+      }
+      break;
+    }
+    return event;
+  }
+
   while((event= _cache->get(_eventsUsed))) {    
     _eventsUsed++ ;
     // accept this cached event?
@@ -322,6 +353,64 @@ void RooAcceptReject::addEventToCache()
 
 }
 
+
+
+//_____________________________________________________________________________
+void RooAcceptReject::addEventsToCache(UInt_t nEvents) 
+{
+  // Add nEvents trial events to our cache and update our estimates
+  // of the function maximum value and integral. 
+  //
+  // If the cache is stored in vectors, the trial points are generated in
+  // blocks of _batchSize events and the function values of each block are
+  // calculated at once from the cache columns with RooAbsReal::getValBatch(),
+  // then written into the cache. The random numbers are drawn in the same 
+  // order as with addEventToCache().
+
+  RooVectorDataStore* store = _batchSize>1 ? dynamic_cast<RooVectorDataStore*>(_cache->store()) : 0 ;
+  if (!store) {
+    while(nEvents--) addEventToCache() ;
+    return ;
+  }
+
+  std::vector<Double_t> vals ;
+  while(nEvents>0) {
+    const UInt_t nb = TMath::Min(nEvents,_batchSize) ;
+    nEvents -= nb ;
+
+    // randomize and store trial points of this block
+    const Int_t begin = _cache->numEntries() ;
+    for (UInt_t i=0 ; i<nb ; i++) {
+      _nextCatVar->Reset();
+      RooCategory *cat = 0;
+      while((cat= (RooCategory*)_nextCatVar->Next())) cat->randomize();
+
+      _nextRealVar->Reset();
+      RooRealVar *real = 0;
+      while((real= (RooRealVar*)_nextRealVar->Next())) real->randomize();
+
+      _cache->fill();
+    }
+
+    // calculate and store the function values of the block
+    vals.resize(nb) ;
+    _funcClone->getValBatch(begin,begin+nb,&vals[0],*store) ;
+    Double_t* funcVals = store->realColumn(*_funcValPtr) ;
+    for (UInt_t i=0 ; i<nb ; i++) {
+      const Double_t val = vals[i] ;
+      funcVals[begin+i] = val ;
+      if(val > _maxFuncVal) _maxFuncVal= 1.05*val;
+      _funcSum+= val;
+    }
+    _totalEvents+= nb;
+  }
+
+  if (_verbose) {
+    cerr << "RooAcceptReject: generated " << _totalEvents << " events so far." << endl ;
+  }
+}
+
+
 Double_t RooAcceptReject::getFuncMax() 
 {
   // Empirically determine maximum value of function by taking a large number
@@ -330,7 +419,9 @@ Double_t RooAcceptReject::getFuncMax()
 
   // Generate the minimum required number of samples for a reliable maximum estimate
   while(_totalEvents < _minTrials) {
-    addEventToCache();
+    // Add events up to the limit of the cache size
+    Int_t nMax = 1000001 - _cache->numEntries() ;
+    addEventsToCache(TMath::Min(_minTrials-_totalEvents,UInt_t(nMax>1?nMax:1)));
 
     // Limit cache size to 1M events
     if (_cache->numEntries()>1000000) {
@@ -65,6 +65,7 @@
 #include "RooRecursiveFraction.h"
 #include "RooGlobalFunc.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 
 #include "Riostream.h"
 #include <algorithm>
@@ -843,6 +844,156 @@ Double_t RooAddPdf::evaluate() const
 }
 
 
+
+//_____________________________________________________________________________
+Bool_t RooAddPdf::evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const 
+{
+  // Batch version of evaluate(): the sum of the components is made on
+  // the arrays of their values. Coefficients (or coefficient projections)
+  // which depend on the data are not supported and false is returned.
+
+  const RooArgSet* nset = normSet ; 
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  RooFIter ci = _coefList.fwdIterator() ;
+  RooAbsArg* coef ;
+  while((coef=ci.next())) {
+    if (data.dependsOnColumns(*coef)) return kFALSE ;
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+
+  RooArgList cacheArgs(cache->containedArgs(RooAbsCacheElement::OperModeChange)) ;
+  cacheArgs.add(cache->_suppNormList) ;
+  RooFIter ai = cacheArgs.fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg=ai.next())) {
+    if (data.dependsOnColumns(*arg)) return kFALSE ;
+  }
+
+  updateCoefficients(*cache,nset) ;
+
+  const Int_t n = end-begin ;
+  for (Int_t j=0 ; j<n ; j++) output[j] = 0 ;
+
+  std::vector<Double_t> buf ;
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    const Double_t* pdfVal = batchValues(*pdf,begin,end,buf,data,nset) ;
+    if (pdf->isSelectedComp()) {
+      if (cache->_needSupNorm) {
+	Double_t snormVal = ((RooAbsReal*)cache->_suppNormList.at(i))->getVal() ;
+	for (Int_t j=0 ; j<n ; j++) output[j] += pdfVal[j]*_coefCache[i]/snormVal ;
+      } else {
+	for (Int_t j=0 ; j<n ; j++) output[j] += pdfVal[j]*_coefCache[i] ;
+      }
+    }
+    i++ ;
+  }
+
+  return kTRUE ;
+}
+
+
+//_____________________________________________________________________________
+Bool_t RooAddPdf::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const 
+{
+  // Analytical gradient of evaluate(): sum of the gradients of the components
+  // times their coefficients and of the gradients of the coefficients times the
+  // component values. Coefficients calculated from extended components and
+  // projected coefficients are not supported and false is returned.
+
+  const RooArgSet* nset = normSet ; 
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  if (_allExtendable) return kFALSE ;
+
+  CacheElem* cache = getProjCache(nset) ;
+  if (cache->_needSupNorm) return kFALSE ;
+  if ((_projectCoefs || _normRange.Length()>0) && cache->_projList.getSize()>0) return kFALSE ;
+  updateCoefficients(*cache,nset) ;
+
+  // Terms coef[i]*grad(pdf[i])
+  const Int_t nPdf = _pdfList.getSize() ;
+  std::vector<Double_t> pdfVal(nPdf) ;
+  Double_t value(0) ;
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    if (pdf->isSelectedComp()) {
+      pdfVal[i] = pdf->getVal(nset) ;
+      value += pdfVal[i]*_coefCache[i] ;
+      if (!addGradient(*pdf,_coefCache[i],params,grad,nset)) return kFALSE ;
+    }
+    i++ ;
+  }
+
+  // Terms pdf[i]*grad(coef[i])
+  RooFIter ci = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  i=0 ;
+  if (_haveLastCoef) {
+
+    // coef[i] = c[i]/SUM(c)
+    Double_t coefSum(0) ;
+    while((coef=(RooAbsReal*)ci.next())) {
+      coefSum += coef->getVal(nset) ;
+    }
+    if (coefSum==0.) return kFALSE ;
+    ci = _coefList.fwdIterator() ;
+    while((coef=(RooAbsReal*)ci.next())) {
+      if (!addGradient(*coef,(pdfVal[i]-value)/coefSum,params,grad,nset)) return kFALSE ;
+      i++ ;
+    }
+
+  } else {
+
+    // coef[n] = 1-SUM(coef[0...n-1])
+    while((coef=(RooAbsReal*)ci.next())) {
+      if (!addGradient(*coef,pdfVal[i]-pdfVal[nPdf-1],params,grad,nset)) return kFALSE ;
+      i++ ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooAddPdf::expectedEventsGradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const 
+{
+  // Gradient of expectedEvents(), which is the sum of the coefficients. 
+  // Extended components and range corrections are not supported.
+
+  const Int_t n = params.getSize() ;
+  for (Int_t i=0 ; i<n ; i++) grad[i] = 0 ;
+
+  if (_allExtendable || !_haveLastCoef) return kFALSE ;
+  CacheElem* cache = getProjCache(nset) ;
+  if (cache->_rangeProjList.getSize()>0) return kFALSE ;
+
+  RooFIter ci = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  while((coef=(RooAbsReal*)ci.next())) {
+    if (!addGradient(*coef,1.,params,grad,nset)) return kFALSE ;
+  }
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooAddPdf::resetErrorCounters(Int_t resetValue)
 {
@@ -174,6 +174,21 @@ Double_t RooAddition::evaluate() const
   return sum ;
 }
 
+
+
+//_____________________________________________________________________________
+Bool_t RooAddition::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const 
+{
+  // Gradient of the sum: sum of the gradients of the terms
+
+  RooFIter setIter = _set.fwdIterator() ;
+  RooAbsReal* comp ;
+  while((comp=(RooAbsReal*)setIter.next())) {
+    if (!addGradient(*comp,1.,params,grad,normSet)) return kFALSE ;
+  }
+  return kTRUE ;
+}
+
 //_____________________________________________________________________________
 Double_t RooAddition::defaultErrorLevel() const 
 {
@@ -106,6 +106,14 @@ void* RooArgSet::operator new (size_t bytes)
 
   //cout << " RooArgSet::operator new(" << bytes << ")" << endl ;
 
+  // The pool is shared by all threads, e.g. those evaluating the partitions
+  // of a test statistic (see RooAbsTestStatistic::setThreadMode)
+  char* ptr(0) ;
+#ifdef _OPENMP
+#pragma omp critical (RooArgSet_memPool)
+#endif
+  {
+
   if (!_poolBegin || _poolCur+(sizeof(RooArgSet)) >= _poolEnd) {
 
     if (_poolBegin!=0) {
@@ -149,12 +157,14 @@ void* RooArgSet::operator new (size_t bytes)
     RooSentinel::activate() ;
   }
 
-  char* ptr = _poolCur ;
+  ptr = _poolCur ;
   _poolCur += bytes ;
 
   // Increment use counter of pool
   (*((Int_t*)_poolBegin))++ ;
 
+  }
+
   return ptr ;
 
 }
@@ -167,6 +177,9 @@ void RooArgSet::operator delete (void* ptr)
   // Memory is owned by pool, we need to do nothing to release it
 
   // Decrease use count in pool that ptr is on
+#ifdef _OPENMP
+#pragma omp critical (RooArgSet_memPool)
+#endif
   for (std::list<POOLDATA>::iterator poolIter =  _memPoolList.begin() ; poolIter!=_memPoolList.end() ; ++poolIter) {
     if ((char*)ptr > (char*)poolIter->_base && (char*)ptr < (char*)poolIter->_base + POOLSIZE) {
       (*(Int_t*)(poolIter->_base))-- ;
@@ -129,6 +129,20 @@ void RooCompositeDataStore::recalculateCache(const RooArgSet* proj, Int_t firstE
 
 
 
+//_____________________________________________________________________________
+Bool_t RooCompositeDataStore::recalculateCachedArgs(const RooArgSet& args, const RooArgSet* nset) 
+{
+  // Forward recalculate request of cached arguments to all subsets
+  Bool_t ret(kTRUE) ;
+  map<int,RooAbsDataStore*>::const_iterator iter ;
+  for (iter = _dataMap.begin() ; iter!=_dataMap.end() ; ++iter) {    
+    ret &= iter->second->recalculateCachedArgs(args,nset) ;
+  }
+  return ret ;
+}
+
+
+
 //_____________________________________________________________________________
 Int_t RooCompositeDataStore::fill()
 {
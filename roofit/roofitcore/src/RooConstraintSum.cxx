@@ -126,3 +126,21 @@ Double_t RooConstraintSum::evaluate() const
   return sum ;
 }
 
+
+
+//_____________________________________________________________________________
+Bool_t RooConstraintSum::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*normSet*/) const 
+{
+  // Gradient of the sum of -log of the constraint p.d.f.s, normalized over
+  // the parameters
+
+  RooAbsReal* comp ;
+  RooFIter setIter1 = _set1.fwdIterator() ;
+  while((comp=(RooAbsReal*)setIter1.next())) {
+    Double_t val = comp->getVal(&_paramSet) ;
+    if (val<=0) return kFALSE ;
+    if (!addGradient(*comp,-1./val,params,grad,&_paramSet)) return kFALSE ;
+  }
+  return kTRUE ;
+}
+
@@ -45,6 +45,14 @@
  // which are stored in the cache. Subsequent evaluations of RooFFTConvPdf with
  // identical parameters will retrieve results from the cache. If one or more
  // of the parameters change, the cache will be updated.
+ //
+ // The Fourier transforms of the sampled input p.d.f.s are kept in the cache
+ // as well. When the cache is updated, only the input p.d.f.s whose parameters
+ // have changed are sampled and transformed again: in a fit of a physics model
+ // convolved with a resolution model, a change of the resolution parameters
+ // does not repeat the FFT of the physics model and vice versa. If there are 
+ // other cached observables than the convolution observable, the FFTs of the
+ // slices of the cache can be calculated in parallel threads, see setNumThreads()
  // 
  // The sampling density of the cache is controlled by the binning of the 
  // the convolution observable, which can be changed from RooRealVar::setBins(N)
@@ -121,6 +129,12 @@
 #include "RooConstVar.h"
 #include "TClass.h"
 #include "TSystem.h"
+#include "TMath.h"
+#include "RooAbsCategory.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std ;
 
@@ -140,7 +154,8 @@ RooFFTConvPdf::RooFFTConvPdf(const char *name, const char *title, RooRealVar& co
   _bufStrat(Extend),
   _shift1(0),
   _shift2(0),
-  _cacheObs("!cacheObs","Cached observables",this,kFALSE,kFALSE)
+  _cacheObs("!cacheObs","Cached observables",this,kFALSE,kFALSE),
+  _nThreads(1)
  { 
    // Constructor for convolution of pdf1 (x) pdf2 in observable convVar. The binning used for the FFT sampling is controlled
    // by the binning named "cache" in the convolution observable. The resulting FFT convolved histogram is interpolated at
@@ -170,7 +185,8 @@ RooFFTConvPdf::RooFFTConvPdf(const char *name, const char *title, RooAbsReal& pd
   _bufStrat(Extend),
   _shift1(0),
   _shift2(0),
-  _cacheObs("!cacheObs","Cached observables",this,kFALSE,kFALSE)
+  _cacheObs("!cacheObs","Cached observables",this,kFALSE,kFALSE),
+  _nThreads(1)
  { 
    // Constructor for convolution of pdf1 (x) pdf2 in observable convVar. The binning used for the FFT sampling is controlled
    // by the binning named "cache" in the convolution observable. The resulting FFT convolved histogram is interpolated at
@@ -199,7 +215,8 @@ RooFFTConvPdf::RooFFTConvPdf(const RooFFTConvPdf& other, const char* name) :
   _bufStrat(other._bufStrat),
   _shift1(other._shift1),
   _shift2(other._shift2),
-  _cacheObs("!cacheObs",this,other._cacheObs)
+  _cacheObs("!cacheObs",this,other._cacheObs),
+  _nThreads(other._nThreads)
  { 
    // Copy constructor
  } 
@@ -242,7 +259,7 @@ RooFFTConvPdf::PdfCacheElem* RooFFTConvPdf::createCache(const RooArgSet* nset) c
 //_____________________________________________________________________________
 RooFFTConvPdf::FFTCacheElem::FFTCacheElem(const RooFFTConvPdf& self, const RooArgSet* nsetIn) : 
   PdfCacheElem(self,nsetIn),
-  fftr2c1(0),fftr2c2(0),fftc2r(0) 
+  N2(0), bufStrat(-1), zeroBin1(0)
 {
 
   // Clone input pdf and attach to dataset
@@ -307,6 +324,16 @@ RooFFTConvPdf::FFTCacheElem::FFTCacheElem(const RooFFTConvPdf& self, const RooAr
 
   delete fftParams ;
 
+  // Keep track of the parameters of each input p.d.f, so that only the 
+  // transforms of the input p.d.f.s whose parameters change are recalculated
+  pdf1Params = pdf1Clone->getParameters(*hist()->get()) ;
+  pdf2Params = pdf2Clone->getParameters(*hist()->get()) ;
+
+  RooArgSet otherObs(*hist()->get()) ;
+  otherObs.remove(*convObs,kTRUE,kTRUE) ;
+  pdf1SliceDep = pdf1Clone->dependsOn(otherObs) ;
+  pdf2SliceDep = pdf2Clone->dependsOn(otherObs) ;
+
   // Save copy of original histX binning and make alternate binning
   // for extended range scanning
 
@@ -356,9 +383,10 @@ RooArgList RooFFTConvPdf::FFTCacheElem::containedArgs(Action a)
 //_____________________________________________________________________________
 RooFFTConvPdf::FFTCacheElem::~FFTCacheElem() 
 { 
-  delete fftr2c1 ; 
-  delete fftr2c2 ; 
-  delete fftc2r ; 
+  clearPlans() ;
+
+  delete pdf1Params ;
+  delete pdf2Params ;
 
   delete pdf1Clone ;
   delete pdf2Clone ;
@@ -372,13 +400,62 @@ RooFFTConvPdf::FFTCacheElem::~FFTCacheElem()
 
 
 //_____________________________________________________________________________
-void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const 
+Bool_t RooFFTConvPdf::FFTCacheElem::updateParamValues(const RooArgSet& params, std::vector<Double_t>& vals)
 {
-  // Fill the contents of the cache the FFT convolution output
+  // Store the current values of 'params' in 'vals'. Return true if any of
+  // the values differs from the value that was previously stored in 'vals'
+
+  Bool_t changed = ((Int_t)vals.size()!=params.getSize()) ;
+  vals.resize(params.getSize()) ;
+
+  RooFIter iter = params.fwdIterator() ;
+  RooAbsArg* arg ;
+  Int_t i(0) ;
+  while((arg=iter.next())) {
+    Double_t val(0) ;
+    RooAbsReal* real = dynamic_cast<RooAbsReal*>(arg) ;
+    if (real) {
+      val = real->getVal() ;
+    } else {
+      RooAbsCategory* cat = dynamic_cast<RooAbsCategory*>(arg) ;
+      if (cat) val = cat->getIndex() ;
+    }
+    if (val!=vals[i]) changed = kTRUE ;
+    vals[i++] = val ;
+  }
+
+  return changed ;
+}
+
+
+//_____________________________________________________________________________
+void RooFFTConvPdf::FFTCacheElem::clearPlans()
+{
+  // Delete the FFT transformation plans of all threads
+
+  for (UInt_t i=0 ; i<fftr2c.size() ; i++) {
+    delete fftr2c[i] ;
+    delete fftc2r[i] ;
+  }
+  fftr2c.clear() ;
+  fftc2r.clear() ;
+}
+
+
+
+
+//_____________________________________________________________________________
+void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
+{
+  // Fill the contents of the cache the FFT convolution output. An input p.d.f.
+  // is only sampled and transformed again if its parameters have changed since
+  // the cache was last filled, otherwise its transforms kept in the cache are reused
+
+  FFTCacheElem& aux = (FFTCacheElem&) cache ;
   RooDataHist& cacheHist = *cache.hist() ;
-  
-  ((FFTCacheElem&)cache).pdf1Clone->setOperMode(ADirty,kTRUE) ;
-  ((FFTCacheElem&)cache).pdf2Clone->setOperMode(ADirty,kTRUE) ;
+
+  aux.pdf1Clone->setOperMode(ADirty,kTRUE) ;
+  aux.pdf2Clone->setOperMode(ADirty,kTRUE) ;
 
   // Determine if there other observables than the convolution observable in the cache
   RooArgSet otherObs ;
@@ -388,54 +465,43 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
   if (histArg) {
     otherObs.remove(*histArg,kTRUE,kTRUE) ;
     delete histArg ;
-  } 
-
-//   cout << "RooFFTConvPdf::fillCacheObject() otherObs = " << otherObs << endl ;
-
-  // Handle trivial scenario -- no other observables
-  if (otherObs.getSize()==0) {
-    fillCacheSlice((FFTCacheElem&)cache,RooArgSet()) ;
-    return ;
   }
 
-  // Handle cases where there are other cache slices
-  // Iterator over available slice positions and fill each
-
-  // Determine number of bins for each slice position observable
+  // Determine number of bins for each slice position observable and
+  // list the bin numbers of all slice positions
   Int_t n = otherObs.getSize() ;
-  Int_t* binCur = new Int_t[n+1] ;
-  Int_t* binMax = new Int_t[n+1] ;
-  Int_t curObs = 0 ;
+  std::vector<Int_t> binCur(n+1) ;
+  std::vector<Int_t> binMax(n+1) ;
+  std::vector<RooAbsLValue*> obsLV(n) ;
 
-  RooAbsLValue** obsLV = new RooAbsLValue*[n] ;
-  TIterator* iter = otherObs.createIterator() ;
+  RooFIter iter = otherObs.fwdIterator() ;
   RooAbsArg* arg ;
   Int_t i(0) ;
-  while((arg=(RooAbsArg*)iter->Next())) {
+  while((arg=iter.next())) {
     RooAbsLValue* lvarg = dynamic_cast<RooAbsLValue*>(arg) ;
     obsLV[i] = lvarg ;
     binCur[i] = 0 ;
     // coverity[FORWARD_NULL]
-    binMax[i] = lvarg->numBins(binningName())-1 ;    
+    binMax[i] = lvarg->numBins(binningName())-1 ;
     i++ ;
   }
-  delete iter ;
 
+  std::vector<Int_t> sliceBins ;
+  Int_t nSlice(0) ;
+  Int_t curObs(0) ;
   Bool_t loop(kTRUE) ;
   while(loop) {
-    // Set current slice position
-    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(binCur[j],binningName()) ; }
-
-//     cout << "filling slice: bin of obsLV[0] = " << obsLV[0]->getBin() << endl ;
+    sliceBins.insert(sliceBins.end(),binCur.begin(),binCur.begin()+n) ;
+    nSlice++ ;
 
-    // Fill current slice
-    fillCacheSlice((FFTCacheElem&)cache,otherObs) ;
+    // Handle trivial scenario -- no other observables
+    if (n==0) break ;
 
     // Determine which iterator to increment
     while(binCur[curObs]==binMax[curObs]) {
-      
+
       // Reset current iterator and consider next iterator ;
-      binCur[curObs]=0 ;      
+      binCur[curObs]=0 ;
       curObs++ ;
 
       // master termination condition
@@ -447,82 +513,153 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
 
     // Increment current iterator
     binCur[curObs]++ ;
-    curObs=0 ;      
-    
+    curObs=0 ;
   }
 
-  delete[] obsLV ;
-  delete[] binMax ;
-  delete[] binCur ;
-  
-}
-
-
-//_____________________________________________________________________________
-void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos) const 
-{
-  // Fill a slice of cachePdf with the output of the FFT convolution calculation
+  // Determine size of the sampling arrays including the buffer zones (see scanPdf())
+  RooRealVar* histX = (RooRealVar*) cacheHist.get()->find(_x.arg().GetName()) ;
+  Int_t N = histX->numBins(binningName()) ;
+  Int_t Nbuf = static_cast<Int_t>((N*bufferFraction())/2 + 0.5) ;
+  Int_t N2 = N+2*Nbuf ;
 
-  // Extract histogram that is the basis of the RooHistPdf
-  RooDataHist& cacheHist = *aux.hist() ;
+  // Forget the transforms calculated with a different sampling
+  if (N2!=aux.N2 || _bufStrat!=aux.bufStrat) {
+    aux.clearPlans() ;
+    aux.spec1.clear() ;
+    aux.spec2.clear() ;
+    aux.N2 = N2 ;
+    aux.bufStrat = _bufStrat ;
+  }
 
-  // Sample array of input points from both pdfs 
-  // Note that returned arrays have optional buffers zones below and above range ends
+  // Determine which input p.d.f.s need to be sampled and transformed again. An input
+  // that does not depend on the slice position has a single transform for all slices
+  Int_t nSpec1 = aux.pdf1SliceDep ? nSlice : 1 ;
+  Int_t nSpec2 = aux.pdf2SliceDep ? nSlice : 1 ;
+  Bool_t changed1 = aux.updateParamValues(*aux.pdf1Params,aux.pdf1ParamVals) ;
+  Bool_t changed2 = aux.updateParamValues(*aux.pdf2Params,aux.pdf2ParamVals) ;
+  Bool_t redo1 = changed1 || (Int_t)aux.spec1.size()!=nSpec1 ;
+  Bool_t redo2 = changed2 || (Int_t)aux.spec2.size()!=nSpec2 ;
+
+  // Sample array of input points from the p.d.f.s that need to be transformed again.
+  // This is done in this thread for all slices, as the evaluation of the p.d.f.s is not
+  // thread safe. Note that sampled arrays have optional buffers zones below and above range ends
   // to reduce cyclical effects and have been cyclically rotated so that bin containing
   // zero value is at position zero. Example:
-  // 
+  //
   //     original:                -5 -4 -3 -2 -1 0 +1 +2 +3 +4 +5
   //     add buffer zones:    U U -5 -4 -3 -2 -1 0 +1 +2 +3 +4 +5 O O
   //     rotate:              0 +1 +2 +3 +4 +5 O O U U -5 -4 -3 -2 -1
   //
-  // 
+  //
+  if (redo1) {
+    aux.input1.resize(nSpec1) ;
+    aux.spec1.resize(nSpec1) ;
+  }
+  if (redo2) {
+    aux.input2.resize(nSpec2) ;
+    aux.spec2.resize(nSpec2) ;
+  }
+  Int_t nScan = TMath::Max(redo1?nSpec1:0,redo2?nSpec2:0) ;
+  Int_t s ;
+  for (s=0 ; s<nScan ; s++) {
 
-  Int_t N,N2,binShift1,binShift2 ;
-  
-  RooRealVar* histX = (RooRealVar*) cacheHist.get()->find(_x.arg().GetName()) ;
-  if (_bufStrat==Extend) histX->setBinning(*aux.scanBinning) ;
-  Double_t* input1 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf1Clone,cacheHist,slicePos,N,N2,binShift1,_shift1) ;
-  Double_t* input2 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf2Clone,cacheHist,slicePos,N,N2,binShift2,_shift2) ;
-  if (_bufStrat==Extend) histX->setBinning(*aux.histBinning) ;
+    // Set current slice position
+    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(sliceBins[s*n+j],binningName()) ; }
+
+    Int_t NS,NS2,zeroBin2 ;
+    if (_bufStrat==Extend) histX->setBinning(*aux.scanBinning) ;
+    if (redo1 && s<nSpec1) {
+      Double_t* input = scanPdf((RooRealVar&)_x.arg(),*aux.pdf1Clone,cacheHist,otherObs,NS,NS2,aux.zeroBin1,_shift1) ;
+      aux.input1[s].assign(input,input+N2) ;
+      delete[] input ;
+    }
+    if (redo2 && s<nSpec2) {
+      Double_t* input = scanPdf((RooRealVar&)_x.arg(),*aux.pdf2Clone,cacheHist,otherObs,NS,NS2,zeroBin2,_shift2) ;
+      aux.input2[s].assign(input,input+N2) ;
+      delete[] input ;
+    }
+    if (_bufStrat==Extend) histX->setBinning(*aux.histBinning) ;
+  }
 
+  // Create the transformation plans of the threads. The plans are kept in the
+  // cache and reused for all slices and all following updates of the cache
+  Int_t nThread(1) ;
+#ifdef _OPENMP
+  nThread = TMath::Min(_nThreads,nSlice) ;
+#endif
+  while((Int_t)aux.fftr2c.size()<nThread) {
+    aux.fftr2c.push_back(TVirtualFFT::FFT(1, &N2, "R2CK")) ;
+    aux.fftc2r.push_back(TVirtualFFT::FFT(1, &N2, "C2RK")) ;
+  }
 
+  // Real->Complex FFT Transform of the inputs that are shared by all slices
+  if (redo1 && !aux.pdf1SliceDep) transformInput(aux,0,aux.input1[0],aux.spec1[0]) ;
+  if (redo2 && !aux.pdf2SliceDep) transformInput(aux,0,aux.input2[0],aux.spec2[0]) ;
+
+  // Calculate the convolution of each slice
+  std::vector<Double_t> output(nSlice*N) ;
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(nThread) schedule(static)
+#endif
+  for (s=0 ; s<nSlice ; s++) {
+#ifdef _OPENMP
+    Int_t thread = omp_get_thread_num() ;
+#else
+    Int_t thread = 0 ;
+#endif
+    fillCacheSlice(aux,s,thread,N,&output[s*N]) ;
+  }
+  aux.input1.clear() ;
+  aux.input2.clear() ;
 
+  // Store FFT result in cache
+  for (s=0 ; s<nSlice ; s++) {
+    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(sliceBins[s*n+j],binningName()) ; }
 
-  // Retrieve previously defined FFT transformation plans
-  if (!aux.fftr2c1) {
-    aux.fftr2c1 = TVirtualFFT::FFT(1, &N2, "R2CK");
-    aux.fftr2c2 = TVirtualFFT::FFT(1, &N2, "R2CK");
-    aux.fftc2r  = TVirtualFFT::FFT(1, &N2, "C2RK");
+    TIterator* hiter = cacheHist.sliceIterator(const_cast<RooAbsReal&>(_x.arg()),otherObs) ;
+    for (i=0 ; i<N ; i++) {
+      hiter->Next() ;
+      cacheHist.set(output[s*N+i]) ;
+    }
+    delete hiter ;
   }
-  
-  // Real->Complex FFT Transform on p.d.f. 1 sampling
-  aux.fftr2c1->SetPoints(input1);
-  aux.fftr2c1->Transform();
 
-  // Real->Complex FFT Transform on p.d.f 2 sampling
-  aux.fftr2c2->SetPoints(input2);
-  aux.fftr2c2->Transform();
+}
+
 
-  // Loop over first half +1 of complex output results, multiply 
+//_____________________________________________________________________________
+void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, Int_t slice, Int_t thread, Int_t N, Double_t* output) const
+{
+  // Calculate the FFT convolution output for slice number 'slice' of the cache with the transformation
+  // plans of thread 'thread', and store the N values of the convolution observable range in 'output'.
+  // Sampled inputs that depend on the slice position are transformed first. Slices can be
+  // calculated in parallel as long as each thread uses its own plans
+
+  // Real->Complex FFT Transform of the inputs of this slice
+  if (aux.pdf1SliceDep && !aux.input1.empty()) transformInput(aux,thread,aux.input1[slice],aux.spec1[slice]) ;
+  if (aux.pdf2SliceDep && !aux.input2.empty()) transformInput(aux,thread,aux.input2[slice],aux.spec2[slice]) ;
+
+  const std::vector<Double_t>& spec1 = aux.spec1[aux.pdf1SliceDep ? slice : 0] ;
+  const std::vector<Double_t>& spec2 = aux.spec2[aux.pdf2SliceDep ? slice : 0] ;
+  TVirtualFFT* fftc2r = aux.fftc2r[thread] ;
+  Int_t N2 = aux.N2 ;
+
+  // Loop over first half +1 of complex output results, multiply
   // and set as input of reverse transform
   for (Int_t i=0 ; i<N2/2+1 ; i++) {
-    Double_t re1,re2,im1,im2 ;
-    aux.fftr2c1->GetPointComplex(i,re1,im1) ;
-    aux.fftr2c2->GetPointComplex(i,re2,im2) ;
+    Double_t re1(spec1[2*i]), im1(spec1[2*i+1]) ;
+    Double_t re2(spec2[2*i]), im2(spec2[2*i+1]) ;
     Double_t re = re1*re2 - im1*im2 ;
     Double_t im = re1*im2 + re2*im1 ;
     TComplex t(re,im) ;
-    aux.fftc2r->SetPointComplex(i,t) ;
+    fftc2r->SetPointComplex(i,t) ;
   }
 
   // Reverse Complex->Real FFT transform product
-  aux.fftc2r->Transform() ;
-
-  Int_t totalShift = binShift1 + (N2-N)/2 ;
+  fftc2r->Transform() ;
 
-  // Store FFT result in cache
+  Int_t totalShift = aux.zeroBin1 + (N2-N)/2 ;
 
-  TIterator* iter = const_cast<RooDataHist&>(cacheHist).sliceIterator(const_cast<RooAbsReal&>(_x.arg()),slicePos) ;
   for (Int_t i =0 ; i<N ; i++) {
 
     // Cyclically shift array back so that bin containing zero is back in zeroBin
@@ -530,17 +667,27 @@ void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos)
     while (j<0) j+= N2 ;
     while (j>=N2) j-= N2 ;
 
-    iter->Next() ;
-    cacheHist.set(aux.fftc2r->GetPointReal(j)) ;    
+    output[i] = fftc2r->GetPointReal(j) ;
   }
-  delete iter ;
-
-  // cacheHist.dump2() ;
+}
 
-  // Delete input arrays
-  delete[] input1 ;
-  delete[] input2 ;
 
+//_____________________________________________________________________________
+void RooFFTConvPdf::transformInput(FFTCacheElem& aux, Int_t thread, const std::vector<Double_t>& input, std::vector<Double_t>& spec) const
+{
+  // Real->Complex FFT transform of the sampled input p.d.f. values 'input' with the plan of
+  // thread 'thread'. The first half+1 of the complex output is stored in 'spec' as pairs
+  // of real and imaginary parts
+
+  TVirtualFFT* fftr2c = aux.fftr2c[thread] ;
+  fftr2c->SetPoints(&input[0]) ;
+  fftr2c->Transform() ;
+
+  Int_t nc = aux.N2/2+1 ;
+  spec.resize(2*nc) ;
+  for (Int_t i=0 ; i<nc ; i++) {
+    fftr2c->GetPointComplex(i,spec[2*i],spec[2*i+1]) ;
+  }
 }
 
 
@@ -821,6 +968,21 @@ void RooFFTConvPdf::setBufferFraction(Double_t frac)
 }
 
 
+//_____________________________________________________________________________
+void RooFFTConvPdf::setShift(Double_t val1, Double_t val2) 
+{
+  // Change the shifts of the convolution observable applied to pdf1 and pdf2 
+  // before sampling them for the FFT
+
+  _shift1 = val1 ;
+  _shift2 = val2 ;
+
+  // Sterilize the cache as the input p.d.f.s and their cached transforms depend on the shifts
+  _cacheMgr.sterilize() ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooFFTConvPdf::setBufferStrategy(BufStrat bs) 
 {
@@ -839,6 +1001,33 @@ void RooFFTConvPdf::setBufferStrategy(BufStrat bs)
 
 
 
+//_____________________________________________________________________________
+void RooFFTConvPdf::setNumThreads(Int_t nThreads) 
+{
+  // Calculate the FFTs of the slices of the cache in up to nThreads threads.
+  // This only has an effect if the cache has other observables than the 
+  // convolution observable (see setCacheObservables()). The input p.d.f.s are 
+  // always sampled in the calling thread, only the transformations and the 
+  // products of the transforms are calculated in parallel, each thread with its
+  // own transformation plans. The threads are run in parallel when RooFitCore is 
+  // built with openMP (USE_OPENMP), otherwise the slices are calculated one after
+  // the other
+
+  if (nThreads<1) {
+    coutE(InputArguments) << "RooFFTConvPdf::setNumThreads(" << GetName() << ") number of threads should be at least one" << endl ;
+    return ;
+  }
+#ifndef _OPENMP
+  if (nThreads>1) {
+    coutW(InputArguments) << "RooFFTConvPdf::setNumThreads(" << GetName() << ") WARNING: RooFitCore was built without openMP, "
+			  << "the slices are calculated sequentially" << endl ;
+  }
+#endif
+  _nThreads = nThreads ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooFFTConvPdf::printMetaArgs(ostream& os) const 
 {
@@ -32,6 +32,7 @@
 #include "Riostream.h"
 #include "Riostream.h"
 #include <stdlib.h>
+#include <math.h>
 #include "TROOT.h"
 #include "TClass.h"
 #include "TObjString.h"
@@ -47,7 +48,7 @@ ClassImp(RooFormula)
 
 
 //_____________________________________________________________________________
-RooFormula::RooFormula() : TFormula(), _nset(0)
+RooFormula::RooFormula() : TFormula(), _nset(0), _shiftCode(-1), _shift(0)
 {
   // Default constructor
   // coverity[UNINIT_CTOR]
@@ -56,7 +57,7 @@ RooFormula::RooFormula() : TFormula(), _nset(0)
 
 //_____________________________________________________________________________
 RooFormula::RooFormula(const char* name, const char* formula, const RooArgList& list) : 
-  TFormula(), _isOK(kTRUE), _compiled(kFALSE)
+  TFormula(), _isOK(kTRUE), _compiled(kFALSE), _shiftCode(-1), _shift(0)
 {
   // Constructor with expression string and list of RooAbsArg variables
 
@@ -82,7 +83,7 @@ RooFormula::RooFormula(const char* name, const char* formula, const RooArgList&
 
 //_____________________________________________________________________________
 RooFormula::RooFormula(const RooFormula& other, const char* name) : 
-  TFormula(), RooPrintable(other), _isOK(other._isOK), _compiled(kFALSE) 
+  TFormula(), RooPrintable(other), _isOK(other._isOK), _compiled(kFALSE), _shiftCode(-1), _shift(0)
 {
   // Copy constructor
 
@@ -243,6 +244,34 @@ Double_t RooFormula::eval(const RooArgSet* nset)
 }
 
 
+
+//_____________________________________________________________________________
+Double_t RooFormula::evalDerivative(const RooAbsArg& arg, const RooArgSet* nset)
+{
+  // Return the derivative of the formula with respect to its real-valued
+  // variable 'arg', calculated with a central finite difference of the 
+  // expression only: the value of the variable is shifted inside the formula
+  // evaluation, the variable itself and its dependents are not modified and
+  // not recalculated. Zero is returned if 'arg' is not used in the formula.
+
+  Int_t code = _useList.IndexOf(&arg) ;
+  if (code<0 || _useIsCat[code]) return 0 ;
+
+  Double_t val = ((const RooAbsReal&)arg).getVal(nset) ;
+  Double_t h = 1e-6*(fabs(val)>1 ? fabs(val) : 1) ;
+
+  _shiftCode = code ;
+  _shift = h ;
+  Double_t up = eval(nset) ;
+  _shift = -h ;
+  Double_t down = eval(nset) ;
+  _shiftCode = -1 ;
+  _shift = 0 ;
+
+  return (up-down)/(2*h) ;
+}
+
+
 Double_t
 
 //_____________________________________________________________________________
@@ -270,6 +299,7 @@ RooFormula::DefinedValue(Int_t code)
 
     // Process as real 
     const RooAbsReal *absReal= (const RooAbsReal*)(arg);  
+    if (code==_shiftCode) return absReal->getVal(_nset) + _shift ;
     return absReal->getVal(_nset) ;
     
   }
@@ -128,6 +128,28 @@ Double_t RooFormulaVar::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooFormulaVar::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const
+{
+  // Gradient with the chain rule: the derivatives of the formula expression
+  // with respect to its variables are calculated numerically by the formula 
+  // engine (see RooFormula::evalDerivative()), the gradients of the variables 
+  // analytically
+
+  RooFIter iter = _actualVars.fwdIterator() ;
+  RooAbsArg* arg ;
+  while((arg=iter.next())) {
+    RooAbsReal* real = dynamic_cast<RooAbsReal*>(arg) ;
+    if (!real) continue ;
+    // Fundamental variables which are not parameters do not contribute
+    if (!real->isDerived() && params.index(real)<0) continue ;
+    if (!addGradient(*real,formula().evalDerivative(*real,_lastNSet),params,grad,normSet)) return kFALSE ;
+  }
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 Bool_t RooFormulaVar::isValidReal(Double_t /*value*/, Bool_t /*printError*/) const 
 {
@@ -36,6 +36,13 @@ ClassImp(RooHashTable)
 // done on the object addresses, object names, or using the objects
 // internal hash method. This is a utility class for RooLinkedList
 // that uses RooHashTable to speed up direct access to large collections.
+// <p>
+// The table uses open addressing with linear probing: objects and their
+// hash values are stored in two flat arrays of at least twice the nominal
+// size of the table, so that a lookup inspects a few adjacent buckets
+// rather than following a chain of separately allocated lists. The
+// stored hash values are compared before the (more expensive) name
+// comparison, and allow to remove entries without recalculating hashes.
 // END_HTML
 //
 
@@ -49,8 +56,12 @@ RooHashTable::RooHashTable(Int_t capacity, HashMethod hashMethod) :
     capacity = TCollection::kInitHashTableCapacity;
   }  
   _size = (Int_t)TMath::NextPrime(TMath::Max(capacity,(int)TCollection::kInitHashTableCapacity));
-  _arr  = new RooLinkedList* [_size] ;
-  memset(_arr, 0, _size*sizeof(RooLinkedList*));
+
+  _capacity = 1 ;
+  while (_capacity < 2*_size) _capacity <<= 1 ;
+  _arr  = new TObject* [_capacity] ;
+  _hashArr = new ULong_t [_capacity] ;
+  memset(_arr, 0, _capacity*sizeof(TObject*));
 
   _usedSlots = 0 ;
   _entries   = 0 ;
@@ -64,16 +75,113 @@ RooHashTable::RooHashTable(const RooHashTable& other) :
   _hashMethod(other._hashMethod),
   _usedSlots(other._usedSlots), 
   _entries(other._entries), 
-  _size(other._size)
+  _size(other._size),
+  _capacity(other._capacity)
 {
   // Copy constructor
 
-  _arr  = new RooLinkedList* [_size] ;
-  memset(_arr, 0, _size*sizeof(RooLinkedList*));  
-  Int_t i ;
-  for (i=0 ; i<_size ; i++) {
-    if (other._arr[i]) {
-      _arr[i] = new RooLinkedList(*other._arr[i]) ;
+  _arr  = new TObject* [_capacity] ;
+  _hashArr = new ULong_t [_capacity] ;
+  memcpy(_arr, other._arr, _capacity*sizeof(TObject*));  
+  memcpy(_hashArr, other._hashArr, _capacity*sizeof(ULong_t));  
+}
+
+
+
+//_____________________________________________________________________________
+void RooHashTable::insert(TObject* arg, ULong_t hashVal) 
+{
+  // Store object with given hash value in the first free bucket 
+  // following its home bucket
+
+  Int_t mask = _capacity-1 ;
+  Int_t slot = hashVal & mask ;
+  while (_arr[slot]) {
+    slot = (slot+1) & mask ;
+  }
+  _arr[slot] = arg ;
+  _hashArr[slot] = hashVal ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooHashTable::rehash(Int_t newCapacity) 
+{
+  // Move all entries to a new table with given number of buckets.
+  // The old table is traversed starting from an empty bucket, so that
+  // objects with the same hash value keep their relative order
+
+  TObject** oldArr = _arr ;
+  ULong_t* oldHashArr = _hashArr ;
+  Int_t oldCapacity = _capacity ;
+
+  _capacity = newCapacity ;
+  _arr  = new TObject* [_capacity] ;
+  _hashArr = new ULong_t [_capacity] ;
+  memset(_arr, 0, _capacity*sizeof(TObject*));
+
+  Int_t start(0) ;
+  while (start<oldCapacity && oldArr[start]) start++ ;
+  for (Int_t i=0 ; i<oldCapacity ; i++) {
+    Int_t slot = (start+i) % oldCapacity ;
+    if (oldArr[slot]) {
+      insert(oldArr[slot],oldHashArr[slot]) ;
+    }
+  }
+
+  delete[] oldArr ;
+  delete[] oldHashArr ;
+}
+
+
+
+//_____________________________________________________________________________
+Int_t RooHashTable::findSlot(const TObject* arg, ULong_t hashVal) const
+{
+  // Return the bucket holding the given object, or -1 if it is not in the table.
+  // If the object is not found from the bucket pointed to by the hash value,
+  // all buckets are searched: the hash value of an object hashed by name
+  // is stale if the object was renamed after it was added.
+
+  Int_t mask = _capacity-1 ;
+  Int_t slot = hashVal & mask ;
+  while (_arr[slot]) {
+    if (_arr[slot]==arg) return slot ;
+    slot = (slot+1) & mask ;
+  }
+
+  for (slot=0 ; slot<_capacity ; slot++) {
+    if (_arr[slot]==arg) return slot ;
+  }
+  return -1 ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooHashTable::removeSlot(Int_t slot) 
+{
+  // Empty given bucket. Subsequent entries of the same probe sequence 
+  // are shifted back to fill the gap, so that no lookup ends prematurely
+  // at the emptied bucket
+
+  Int_t mask = _capacity-1 ;
+  _arr[slot] = 0 ;
+
+  Int_t next = slot ;
+  while(kTRUE) {
+    next = (next+1) & mask ;
+    if (!_arr[next]) break ;
+
+    // Move entry into the gap unless its home bucket lies cyclically in (slot,next]
+    Int_t home = _hashArr[next] & mask ;
+    Bool_t stay = (slot<=next) ? (home>slot && home<=next) : (home>slot || home<=next) ;
+    if (!stay) {
+      _arr[slot] = _arr[next] ;
+      _hashArr[slot] = _hashArr[next] ;
+      _arr[next] = 0 ;
+      slot = next ;
     }
   }
 }
@@ -86,13 +194,14 @@ void RooHashTable::add(TObject* arg, TObject* hashArg)
   // Add given object to table. If hashArg is given, hash will be calculation
   // on that rather than on 'arg'
 
-  Int_t slot = hash(hashArg?hashArg:arg) % _size ;
-  if (!_arr[slot]) {
-    _arr[slot] = new RooLinkedList(0) ;
-    _usedSlots++ ;
-   }
-   _arr[slot]->Add(arg);
-   _entries++;
+  // Keep load factor of table below one half
+  if (2*(_entries+1) > _capacity) {
+    rehash(2*_capacity) ;
+  }
+
+  insert(arg,hash(hashArg?hashArg:arg)) ;
+  _usedSlots++ ;
+  _entries++;
 }
 
 
@@ -103,19 +212,13 @@ Bool_t RooHashTable::remove(TObject* arg, TObject* hashArg)
   // Remove given object from table. If hashArg is given, hash will be calculation
   // on that rather than on 'arg'
 
-  Int_t slot = hash(hashArg?hashArg:arg) % _size ;
-  if (_arr[slot]) {
-    if (_arr[slot]->Remove(arg)) {
-      _entries-- ;
-      if (_arr[slot]->GetSize()==0) {
-	delete _arr[slot] ;
-	_arr[slot] = 0 ;
-	_usedSlots-- ;
-      }
-      return kTRUE ;
-    }
-  }
-  return kFALSE ;
+  Int_t slot = findSlot(arg,hash(hashArg?hashArg:arg)) ;
+  if (slot<0) return kFALSE ;
+
+  removeSlot(slot) ;
+  _usedSlots-- ;
+  _entries-- ;
+  return kTRUE ;
 }
 
 
@@ -123,25 +226,20 @@ Bool_t RooHashTable::remove(TObject* arg, TObject* hashArg)
 //_____________________________________________________________________________
 Double_t RooHashTable::avgCollisions() const 
 {
-  // Calculate the average number of collisions (table slots with >1 filled entry)
-  
-  Int_t i,h[20] ;
-  for (i=0 ;  i<20 ; i++) h[i]=0 ; 
+  // Calculate the average number of buckets that is probed in addition 
+  // to the home bucket when looking up a stored object
+
+  if (_entries==0) return 0 ;
 
-  for (i=0 ; i<_size ; i++) {
+  Int_t mask = _capacity-1 ;
+  Double_t sum(0) ;
+  for (Int_t i=0 ; i<_capacity ; i++) {
     if (_arr[i]) {
-      Int_t count = _arr[i]->GetSize() ;
-      if (count<20) {
-	h[count]++ ;
-      } else {
-	h[19]++ ;
-      }
-    } else {
-      h[0]++ ;
+      sum += (i - (Int_t)(_hashArr[i] & mask)) & mask ;
     }
   }
 
-  return 0 ;
+  return sum/_entries ;
 }
 
 
@@ -152,11 +250,36 @@ Bool_t RooHashTable::replace(const TObject* oldArg, const TObject* newArg, const
   // Replace oldArg with newArg in the table. If oldHashArg is given, use that to calculate
   // the hash associated with oldArg
 
-  Int_t slot = hash(oldHashArg?oldHashArg:oldArg) % _size ;
-  if (_arr[slot]) {
-    return _arr[slot]->Replace(oldArg,newArg) ;
+  Int_t slot = findSlot(oldArg,hash(oldHashArg?oldHashArg:oldArg)) ;
+  if (slot<0) return kFALSE ;
+
+  // Objects hashed by name need to move if newArg has a different name
+  ULong_t newHash = oldHashArg ? _hashArr[slot] : hash(newArg) ;
+  if (newHash==_hashArr[slot]) {
+    _arr[slot] = (TObject*)newArg ;
+  } else {
+    removeSlot(slot) ;
+    insert((TObject*)newArg,newHash) ;
   }
-  return kFALSE ;
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooHashTable::rehashName(TObject* arg, const char* oldName) 
+{
+  // Move an object that was renamed after it was added, and is still stored
+  // in the bucket of its old name oldName, to the bucket of its current name
+
+  if (_hashMethod != Name) assert(0) ;
+
+  Int_t slot = findSlot(arg,TString::Hash(oldName,strlen(oldName))) ;
+  if (slot<0) return kFALSE ;
+
+  removeSlot(slot) ;
+  insert(arg,hash(arg)) ;
+  return kTRUE ;
 }
 
 
@@ -168,8 +291,13 @@ TObject* RooHashTable::find(const char* name) const
 
   if (_hashMethod != Name) assert(0) ;
 
-  Int_t slot = TMath::Hash(name) % _size ;
-  if (_arr[slot]) return _arr[slot]->find(name) ;
+  ULong_t hashVal = TString::Hash(name,strlen(name)) ;
+  Int_t mask = _capacity-1 ;
+  for (Int_t slot = hashVal & mask ; _arr[slot] ; slot = (slot+1) & mask) {
+    if (_hashArr[slot]==hashVal && !strcmp(_arr[slot]->GetName(),name)) {
+      return _arr[slot] ;
+    }
+  }
   return 0;  
 }
 
@@ -178,10 +306,18 @@ TObject* RooHashTable::find(const char* name) const
 //_____________________________________________________________________________
 RooAbsArg* RooHashTable::findArg(const RooAbsArg* arg) const 
 {
+  // Return the object with the same name as 'arg' from the table.
+  // Objects are compared through their unique name pointers
+
   if (_hashMethod != Name) assert(0) ;
   
-  Int_t slot = TMath::Hash(arg->GetName()) % _size ;
-  if (_arr[slot]) return _arr[slot]->findArg(arg) ;
+  ULong_t hashVal = hash(arg) ;
+  Int_t mask = _capacity-1 ;
+  for (Int_t slot = hashVal & mask ; _arr[slot] ; slot = (slot+1) & mask) {
+    if (_hashArr[slot]==hashVal && ((RooAbsArg*)_arr[slot])->namePtr()==arg->namePtr()) {
+      return (RooAbsArg*)_arr[slot] ;
+    }
+  }
   return 0;  
 }
 
@@ -194,8 +330,11 @@ TObject* RooHashTable::find(const TObject* hashArg) const
 
   if (_hashMethod != Pointer) assert(0) ;
 
-  Int_t slot = hash(hashArg) % _size ;
-  if (_arr[slot]) return _arr[slot]->FindObject(hashArg) ;
+  ULong_t hashVal = hash(hashArg) ;
+  Int_t mask = _capacity-1 ;
+  for (Int_t slot = hashVal & mask ; _arr[slot] ; slot = (slot+1) & mask) {
+    if (_arr[slot]==hashArg) return _arr[slot] ;
+  }
   return 0;  
 }
 
@@ -208,13 +347,11 @@ RooLinkedListElem* RooHashTable::findLinkTo(const TObject* hashArg) const
 
   if (_hashMethod != Pointer) assert(0) ;
 
-  Int_t slot = hash(hashArg) % _size ;
-  if (_arr[slot]) {
-    Int_t i ; 
-    for (i=0 ; i<_arr[slot]->GetSize() ; i++) {
-      RooLinkedListElem* elem = (RooLinkedListElem*)_arr[slot]->At(i) ;
-      if (elem->_arg == hashArg) return elem ;
-    }
+  ULong_t hashVal = hash(hashArg) ;
+  Int_t mask = _capacity-1 ;
+  for (Int_t slot = hashVal & mask ; _arr[slot] ; slot = (slot+1) & mask) {
+    RooLinkedListElem* elem = (RooLinkedListElem*)_arr[slot] ;
+    if (_hashArr[slot]==hashVal && elem->_arg == hashArg) return elem ;
   }
   return 0;  
 }
@@ -228,14 +365,12 @@ RooSetPair* RooHashTable::findSetPair(const RooArgSet* set1, const RooArgSet* se
 
   if (_hashMethod != Intrinsic) assert(0) ;
 
-  Int_t slot = RooSetPair(set1,set2).Hash() % _size ;
-  if (_arr[slot]) {
-    Int_t i ; 
-    for (i=0 ; i<_arr[slot]->GetSize() ; i++) {
-      RooSetPair* pair = (RooSetPair*)_arr[slot]->At(i) ;
-      if (pair->_set1==set1 && pair->_set2==set2) {
-	return pair ;
-      }
+  ULong_t hashVal = RooSetPair(set1,set2).Hash() ;
+  Int_t mask = _capacity-1 ;
+  for (Int_t slot = hashVal & mask ; _arr[slot] ; slot = (slot+1) & mask) {
+    RooSetPair* pair = (RooSetPair*)_arr[slot] ;
+    if (pair->_set1==set1 && pair->_set2==set2) {
+      return pair ;
     }
   }
 
@@ -250,9 +385,6 @@ RooHashTable::~RooHashTable()
 {  
   // Destructor
 
-  Int_t i ;
-  for (i=0 ; i<_size ; i++) {
-    if (_arr[i]) delete _arr[i] ;  
-  }
   delete[] _arr ;
+  delete[] _hashArr ;
 }
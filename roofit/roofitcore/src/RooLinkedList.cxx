@@ -188,6 +188,19 @@ void RooLinkedList::setHashTableSize(Int_t size)
 
  
 
+//_____________________________________________________________________________
+void RooLinkedList::rehashName(TObject* arg, const char* oldName) 
+{
+  // Update the hash table by name for an object of this list that has
+  // been renamed from oldName
+
+  if (_htableName) {
+    _htableName->rehashName(arg,oldName) ;
+  }
+}
+
+
+
 //_____________________________________________________________________________
 RooLinkedList::~RooLinkedList() 
 {
@@ -641,10 +654,14 @@ void RooLinkedList::Streamer(TBuffer &R__b)
     Int_t size ;
     TObject* arg ;
 
+    // The elements of a written list are unique: they are appended directly,
+    // without the duplicate search of RooRefCountList::Add(), which makes
+    // reading of the client and server lists of nodes with many clients
+    // (e.g. the shared parameters of large models in a workspace) quadratic
     R__b >> size ;
     while(size--) {
       R__b >> arg ;
-      Add(arg) ;      
+      RooLinkedList::Add(arg,1) ;      
     }
 
     if (v>1) {
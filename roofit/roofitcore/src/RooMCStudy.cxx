@@ -35,6 +35,11 @@
 // extra steps in the cycle. Output of these modules can be stored
 // alongside the fit results in the aggregate results dataset.
 // These study modules should derive from classs RooAbsMCStudyModel
+// <p>
+// Method generateAndFitParallel() distributes the generate and fit cycles
+// over a number of forked worker processes on the local host. Each sample
+// is generated with its own random seed, so that the merged results do not
+// depend on the number of workers.
 //
 // END_HTML
 //
@@ -64,6 +69,17 @@
 #include "RooPullVar.h"
 #include "RooMsgService.h"
 #include "RooProdPdf.h"
+#include "TFile.h"
+#include "TSystem.h"
+#include <vector>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+#endif
 
 using namespace std ;
 
@@ -230,6 +246,8 @@ RooMCStudy::RooMCStudy(const RooAbsPdf& model, const RooArgSet& observables,
   _allDependents.add(_dependents) ;  
   _fitOptions = pc.getString("fitOpts") ;
   _canAddFitResults = kTRUE ;
+  _toySeed = 0 ;
+  _toyOffset = 0 ;
   
   if (_extendedGen && _genProtoData && !_randProto) {
     oocoutW(_fitModel,Generation) << "RooMCStudy::RooMCStudy: WARNING Using generator option 'e' (Poisson distribution of #events) together " << endl
@@ -323,7 +341,9 @@ RooMCStudy::RooMCStudy(const RooAbsPdf& genModel, const RooAbsPdf& fitModel,
   _fitOptions(fitOptions),
   _canAddFitResults(kTRUE),
   _perExptGenParams(0),
-  _silence(kFALSE)
+  _silence(kFALSE),
+  _toySeed(0),
+  _toyOffset(0)
 {
   // OBSOLETE, RETAINED FOR BACKWARD COMPATIBILY. PLEASE
   // USE CONSTRUCTOR WITH NAMED ARGUMENTS
@@ -472,6 +492,7 @@ Bool_t RooMCStudy::run(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nE
   }  
   
   Int_t prescale = nSamples>100 ? Int_t(nSamples/100) : 1 ;
+  Int_t nTotal = nSamples ;
 
   while(nSamples--) {
     
@@ -483,6 +504,13 @@ Bool_t RooMCStudy::run(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nE
       ooccoutP(_fitModel,Generation) << "sample " << nSamples << endl ;
     }
 
+    // Seed generator for this sample if each sample has its own seed. The seeds
+    // increase with the sample index, so that the results of the workers of
+    // generateAndFitParallel are merged in the same order as for a single worker
+    if (_toySeed) {
+      RooRandom::randomGenerator()->SetSeed(_toySeed + _toyOffset + (nTotal-1-nSamples)) ;
+    }
+
     _genSample = 0;
     Bool_t existingData = kFALSE ;
     if (doGenerate) {
@@ -664,6 +692,135 @@ Bool_t RooMCStudy::generateAndFit(Int_t nSamples, Int_t nEvtPerSample, Bool_t ke
 
 
 
+//_____________________________________________________________________________
+Bool_t RooMCStudy::generateAndFitParallel(Int_t nSamples, Int_t nEvtPerSample, Int_t nWorkers) 
+{
+  // Generate and fit 'nSamples' samples of 'nEvtPerSample' events in 'nWorkers'
+  // forked processes on the local host. If nWorkers is zero, one process per CPU
+  // is used. Each worker processes a contiguous block of samples and returns its
+  // fit parameter dataset (and saved RooFitResults) through a temporary ROOT file,
+  // these are merged in this object after all workers have finished.
+  //
+  // Each sample is generated with its own seed of RooRandom, derived from a base seed
+  // drawn from RooRandom in this process, so that the results for a given initial state 
+  // of the random generator do not depend on the number of workers. The generated 
+  // samples are not kept, and the internal state of the study modules is not propagated 
+  // from the workers: only the output they add to the fit parameter dataset is.
+
+  // Clear any previous data in memory
+  _fitResList.Delete() ;
+  _genDataList.Delete() ;
+  _fitParData->reset() ;
+
+  if (nWorkers<=0) {
+    SysInfo_t info ;
+    gSystem->GetSysInfo(&info) ;
+    nWorkers = info.fCpus>0 ? info.fCpus : 1 ;
+  }
+  if (nWorkers>nSamples) nWorkers = nSamples ;
+
+  _toySeed = RooRandom::integer(1000000000) + 1 ;
+
+#ifndef _WIN32
+  if (nWorkers>1) {
+
+    Int_t ppid = gSystem->GetPid() ;
+    vector<pid_t> pids(nWorkers) ;
+    vector<string> files(nWorkers) ;
+
+    // Flush output buffers to avoid duplicating them in the workers
+    cout.flush() ;
+    fflush(stdout) ;
+
+    Int_t first(0) ;
+    for (Int_t iw=0 ; iw<nWorkers ; iw++) {
+      Int_t nw = nSamples/nWorkers + (iw < nSamples%nWorkers ? 1 : 0) ;
+      files[iw] = Form("%s/roomcstudy_%s_%d_%d.root",gSystem->TempDirectory(),GetName(),ppid,iw) ;
+
+      pids[iw] = fork() ;
+
+      if (pids[iw]==0) {
+	// Worker process: run assigned samples and save results
+	_toyOffset = first ;
+	run(kTRUE,kTRUE,nw,nEvtPerSample,kFALSE,0) ;
+
+	TFile f(files[iw].c_str(),"RECREATE") ;
+	_fitParData->Write("fitParData") ;
+	for (Int_t i=0 ; i<_fitResList.GetSize() ; i++) {
+	  _fitResList.At(i)->Write(Form("fitResult_%d",i)) ;
+	}
+	f.Close() ;
+	_exit(0) ;
+
+      } else if (pids[iw]<0) {
+	coutE(Generation) << "RooMCStudy::generateAndFitParallel(" << GetName() << ") ERROR fork() failed for worker " << iw 
+			  << ", its samples are not processed" << endl ;	
+      }
+
+      first += nw ;
+    }
+
+    // Collect results of workers in order
+    Bool_t error(kFALSE) ;
+    RooDataSet* merged(0) ;
+    for (Int_t iw=0 ; iw<nWorkers ; iw++) {
+      if (pids[iw]<0) {
+	error = kTRUE ;
+	continue ;
+      }
+
+      // Retry if interrupted by a signal, a worker that cannot be waited for has failed
+      int status(0) ;
+      pid_t ret ;
+      while ((ret=waitpid(pids[iw],&status,0))==-1 && errno==EINTR) ;
+      Bool_t waited = (ret==pids[iw]) ;
+
+      TFile f(files[iw].c_str()) ;
+      TObject* obj = f.IsZombie() ? 0 : f.Get("fitParData") ;
+      RooDataSet* wdata = obj ? dynamic_cast<RooDataSet*>(obj->Clone(obj->GetName())) : 0 ;
+      delete obj ;
+      if (!waited || !WIFEXITED(status) || WEXITSTATUS(status)!=0 || !wdata) {
+	coutE(Generation) << "RooMCStudy::generateAndFitParallel(" << GetName() << ") ERROR worker " << iw 
+			  << " did not return results" << endl ;
+	delete wdata ;
+	error = kTRUE ;
+      } else {
+	if (merged) {
+	  merged->append(*wdata) ;
+	  delete wdata ;
+	} else {
+	  merged = wdata ;
+	}
+	Int_t i(0) ;
+	RooFitResult* fr ;
+	while((fr = dynamic_cast<RooFitResult*>(f.Get(Form("fitResult_%d",i++))))) {
+	  _fitResList.Add(fr) ;
+	}
+      }
+      f.Close() ;
+      gSystem->Unlink(files[iw].c_str()) ;
+    }
+
+    if (merged) {
+      delete _fitParData ;
+      _fitParData = merged ;
+    }
+    _canAddFitResults = kFALSE ;
+    _toySeed = 0 ;
+    _toyOffset = 0 ;
+
+    return error ;
+  }
+#endif // _WIN32
+
+  // Single worker: run all samples in this process
+  Bool_t ret = run(kTRUE,kTRUE,nSamples,nEvtPerSample,kFALSE,0) ;
+  _toySeed = 0 ;
+  return ret ;
+}
+
+
+
 //_____________________________________________________________________________
 Bool_t RooMCStudy::generate(Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat) 
 {
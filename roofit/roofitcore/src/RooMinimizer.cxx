@@ -36,6 +36,12 @@
 // <p>
 // Various methods are available to control verbosity, profiling,
 // automatic PDF optimization.
+// <p>
+// With setUseGradient() the analytical gradient of the function with
+// respect to the floating parameters (see RooAbsReal::getGradient()) is
+// passed to the minimizer, which then does not calculate it from finite
+// differences. This requires that all components of the function depending
+// on the parameters implement it.
 // END_HTML
 //
 
@@ -121,6 +127,7 @@ RooMinimizer::RooMinimizer(RooAbsReal& function)
   _optConst = kFALSE ;
   _verbose = kFALSE ;
   _profile = kFALSE ;
+  _useGradient = kFALSE ;
   _printLevel = 1 ;
   _minimizerType = "Minuit"; // default minimizer
 
@@ -210,6 +217,27 @@ void RooMinimizer::setEps(Double_t eps)
 
 
 
+//_____________________________________________________________________________
+bool RooMinimizer::fitFcn() const
+{
+  // Run the minimizer on the function. If the use of the analytical gradient
+  // is requested with setUseGradient() and the function provides it (see
+  // RooAbsReal::getGradient()) the gradient is passed to the minimizer, which 
+  // then does not compute it from finite differences (for Minuit2 through
+  // its FCNGradientBase interface).
+
+  if (_useGradient) {
+    if (_fcn->HasAnalyticalGradient()) {
+      return _theFitter->FitFCN(static_cast<const ROOT::Math::IMultiGradFunction&>(*_fcn)) ;
+    }
+    coutW(Minimization) << "RooMinimizer::fitFcn: analytical gradient not available for function " 
+			<< _func->GetName() << ", the minimizer calculates it numerically" << endl ;
+  }
+  return _theFitter->FitFCN(static_cast<const ROOT::Math::IMultiGenFunction&>(*_fcn)) ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooMinimizer::setMinimizerType(const char* type)
 {
@@ -267,7 +295,7 @@ Int_t RooMinimizer::minimize(const char* type, const char* alg)
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::CollectErrors) ;
   RooAbsReal::clearEvalErrorLog() ;
 
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -296,7 +324,7 @@ Int_t RooMinimizer::migrad()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"migrad");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -457,7 +485,7 @@ Int_t RooMinimizer::seek()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"seek");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -486,7 +514,7 @@ Int_t RooMinimizer::simplex()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"simplex");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -515,7 +543,7 @@ Int_t RooMinimizer::improve()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"migradimproved");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFcn();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -20,6 +20,8 @@
 //                                                                                   
 
 #include <iostream>
+#include <algorithm>
+#include <math.h>
 
 #include "RooFit.h"
 #include "RooMinimizerFcn.h"
@@ -539,5 +541,79 @@ double RooMinimizerFcn::DoEval(const double *x) const
   return fvalue;
 }
 
+
+
+Bool_t RooMinimizerFcn::HasAnalyticalGradient() 
+{
+  // Return true if the function provides the analytical gradient with 
+  // respect to the floating parameters at their current values (see
+  // RooAbsReal::getGradient())
+
+  if (_nDim==0) return kFALSE ;
+  std::vector<double> grad(_nDim) ;
+  Bool_t ret = _funct->getGradient(*_floatParamList,&grad[0]) ;
+  RooAbsPdf::clearEvalError() ;
+  RooAbsReal::clearEvalErrorLog() ;
+  return ret ;
+}
+
+
+
+void RooMinimizerFcn::Gradient(const double *x, double *grad) const
+{
+  // Calculate the gradient with RooAbsReal::getGradient(). If it is not 
+  // available for these parameter values (e.g. in case of evaluation errors)
+  // it is calculated with central finite differences of DoEval() instead.
+
+  for (int index = 0; index < _nDim; index++) {
+    SetPdfParamVal(index,x[index]);
+  }
+
+  if (_funct->getGradient(*_floatParamList,grad) && !RooAbsPdf::evalError() && RooAbsReal::numEvalErrors()==0) {
+    return ;
+  }
+
+  RooAbsPdf::clearEvalError() ;
+  RooAbsReal::clearEvalErrorLog() ;
+  NumericalGradient(x,grad) ;
+}
+
+
+
+double RooMinimizerFcn::DoDerivative(const double *x, unsigned int icoord) const
+{
+  // Return the derivative with respect to parameter 'icoord': the whole
+  // gradient is calculated once for each new set of parameter values
+
+  if (_gradX.size()!=(unsigned int)_nDim || !std::equal(_gradX.begin(),_gradX.end(),x)) {
+    _gradX.assign(x,x+_nDim) ;
+    _grad.resize(_nDim) ;
+    Gradient(x,&_grad[0]) ;
+  }
+  return _grad[icoord] ;
+}
+
+
+
+void RooMinimizerFcn::NumericalGradient(const double *x, double *grad) const
+{
+  // Gradient from central finite differences of DoEval()
+
+  std::vector<double> xs(x,x+_nDim) ;
+  for (int index = 0; index < _nDim; index++) {
+    double h = 1e-5*(fabs(x[index])>1 ? fabs(x[index]) : 1) ;
+    xs[index] = x[index] + h ;
+    double fup = DoEval(&xs[0]) ;
+    xs[index] = x[index] - h ;
+    double fdown = DoEval(&xs[0]) ;
+    xs[index] = x[index] ;
+    grad[index] = (fup-fdown)/(2*h) ;
+  }
+  // Restore the parameter values
+  for (int index = 0; index < _nDim; index++) {
+    SetPdfParamVal(index,x[index]);
+  }
+}
+
 #endif
 
@@ -36,8 +36,13 @@
 #include "RooMsgService.h"
 #include "RooAbsDataStore.h"
 #include "RooRealMPFE.h"
+#include "RooDataSet.h"
+#include "RooVectorDataStore.h"
 
 #include "RooRealVar.h"
+#include "TMath.h"
+
+#include <vector>
 
 
 using namespace std;
@@ -74,10 +79,12 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
   //  ConditionalObservables() -- Define conditional observables 
   //  Verbose()      -- Verbose output of GOF framework classes
   //  CloneData()    -- Clone input dataset for internal use (default is kTRUE)
+  //  BatchMode()    -- Compute the p.d.f values for ranges of events at once (see setBatchMode())
 
   RooCmdConfig pc("RooNLLVar::RooNLLVar") ;
   pc.allowUndefined() ;
   pc.defineInt("extended","Extended",0,kFALSE) ;
+  pc.defineInt("batchMode","BatchMode",0,kFALSE) ;
 
   pc.process(arg1) ;  pc.process(arg2) ;  pc.process(arg3) ;
   pc.process(arg4) ;  pc.process(arg5) ;  pc.process(arg6) ;
@@ -85,6 +92,7 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
 
   _extended = pc.getInt("extended") ;
   _weightSq = kFALSE ;
+  _batchMode = pc.getInt("batchMode") ;
   _first = kTRUE ;
 
 }
@@ -98,6 +106,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,RooArgSet(),rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE)
 {
   // Construct likelihood from given p.d.f and (binned or unbinned dataset)
@@ -114,6 +123,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,projDeps,rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE)
 {
   // Construct likelihood from given p.d.f and (binned or unbinned dataset)
@@ -129,6 +139,7 @@ RooNLLVar::RooNLLVar(const RooNLLVar& other, const char* name) :
   RooAbsOptTestStatistic(other,name),
   _extended(other._extended),
   _weightSq(other._weightSq),
+  _batchMode(other._batchMode),
   _first(kTRUE)
 {
   // Copy constructor
@@ -153,6 +164,13 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
     _weightSq = flag ; 
     setValueDirty() ; 
 
+  } else if ( _gofOpMode==MPMaster && _mtArray) {
+
+    for (Int_t i=0 ; i<_nCPU ; i++) {
+      ((RooNLLVar*)_mtArray[i])->applyWeightSquared(flag) ;
+    }    
+    setValueDirty() ;
+
   } else if ( _gofOpMode==MPMaster) {
 
     for (Int_t i=0 ; i<_nCPU ; i++) {
@@ -170,6 +188,36 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
 
 
 
+//_____________________________________________________________________________
+void RooNLLVar::setBatchMode(Bool_t flag) 
+{ 
+  // If flag is true, the p.d.f values are computed for ranges of events at
+  // once (see RooAbsReal::getValBatch()) when the data are unbinned and
+  // stored in a RooVectorDataStore. The p.d.f classes which implement
+  // evaluateBatch() (e.g. RooGaussian, RooExponential, RooPolynomial,
+  // RooAddPdf, RooProdPdf and RooRealSumPdf) compute their values directly
+  // from the data columns, the other ones are evaluated event by event.
+  // The likelihood value is the same as without batch mode.
+  //
+  // In multi-process mode (NumCPU) the flag must be set before the first 
+  // evaluation, as it is passed to the server processes when they are created.
+
+  _batchMode = flag ;
+  setValueDirty() ;
+
+  if (_gofOpMode==SimMaster) {
+    for (Int_t i=0 ; i<_nGof ; i++) {
+      ((RooNLLVar*)_gofArray[i])->setBatchMode(flag) ;
+    }
+  } else if (_gofOpMode==MPMaster && _mtArray) {
+    for (Int_t i=0 ; i<_nCPU ; i++) {
+      ((RooNLLVar*)_mtArray[i])->setBatchMode(flag) ;
+    }
+  }
+} 
+
+
+
 //_____________________________________________________________________________
 Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const 
 {
@@ -188,32 +236,40 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
   _dataClone->store()->recalculateCache( _projDeps, firstEvent, lastEvent, stepSize ) ;
 
   Double_t sumWeight(0) ;
-  for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+
+  // Batch computation for unbinned data in a vector store
+  RooVectorDataStore* vstore = dynamic_cast<RooVectorDataStore*>(_dataClone->store()) ;
+  Bool_t batch = _batchMode && stepSize==1 && vstore && dynamic_cast<RooDataSet*>(_dataClone) ;
+  if (batch) {
+    result = evaluateBatchPartition(firstEvent,lastEvent,sumWeight) ;
+  } else {
+    for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
     
-    // get the data values for this event
-    //Double_t wgt = _dataClone->weight(i) ;
-    //if (wgt==0) continue ;
+      // get the data values for this event
+      //Double_t wgt = _dataClone->weight(i) ;
+      //if (wgt==0) continue ;
 
-    _dataClone->get(i) ;
-    //cout << "NLL - now loading event #" << i << endl ;
-//     _funcObsSet->Print("v") ;
+      _dataClone->get(i) ;
+      //cout << "NLL - now loading event #" << i << endl ;
+  //     _funcObsSet->Print("v") ;
     
 
-    if (!_dataClone->valid()) {
-      continue ;
-    }
+      if (!_dataClone->valid()) {
+        continue ;
+      }
 
-    if (_dataClone->weight()==0) continue ;
+      if (_dataClone->weight()==0) continue ;
 
 
-    Double_t eventWeight = _dataClone->weight() ;
-    if (_weightSq) eventWeight *= eventWeight ;
+      Double_t eventWeight = _dataClone->weight() ;
+      if (_weightSq) eventWeight *= eventWeight ;
 
-    Double_t term = eventWeight * pdfClone->getLogVal(_normSet);
-    //cout << "term = " << term << endl ;
-    sumWeight += eventWeight ;
+      Double_t term = eventWeight * pdfClone->getLogVal(_normSet);
+      //cout << "term = " << term << endl ;
+      sumWeight += eventWeight ;
 
-    result-= term;
+      result-= term;
+    }
   }
   
   // include the extended maximum likelihood term, if requested
@@ -256,3 +312,105 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
 
 
+
+//_____________________________________________________________________________
+Bool_t RooNLLVar::evaluatePartitionGradient(Int_t firstEvent, Int_t lastEvent, Int_t stepSize, const RooArgList& params, Double_t* grad) const 
+{
+  // Calculate the analytical gradient of the likelihood on the same subset of
+  // events as evaluatePartition(): -sum(w*grad(p)/p), plus the gradient of the
+  // extended term (1-Nobserved/Nexpected)*grad(Nexpected). Return false if the 
+  // p.d.f. (or its expected number of events) does not provide an analytical 
+  // gradient, or if it is not positive for one of the events.
+
+  Int_t i,k ;
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+
+  _dataClone->store()->recalculateCache( _projDeps, firstEvent, lastEvent, stepSize ) ;
+
+  for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+
+    _dataClone->get(i) ;
+    if (!_dataClone->valid()) {
+      continue ;
+    }
+    if (_dataClone->weight()==0) continue ;
+
+    Double_t eventWeight = _dataClone->weight() ;
+    if (_weightSq) eventWeight *= eventWeight ;
+
+    Double_t val = pdfClone->getVal(_normSet) ;
+    if (!(val>0)) return kFALSE ;
+    if (!addGradient(*pdfClone,-eventWeight/val,params,grad,_normSet)) return kFALSE ;
+  }
+
+  // include the extended maximum likelihood term, if requested
+  if(_extended && firstEvent==0) {
+    Double_t observed(0) ;
+    if (_weightSq) {
+      for (i=0 ; i<_dataClone->numEntries() ; i++) {
+	_dataClone->get(i) ;
+	Double_t eventWeight = _dataClone->weight() ;
+	observed += eventWeight * eventWeight ;	
+      }
+    } else {
+      observed = _dataClone->sumEntries() ;
+    }
+    Double_t expected = pdfClone->expectedEvents(_dataClone->get()) ;
+    if (!(expected>0)) return kFALSE ;
+    const Int_t n = params.getSize() ;
+    std::vector<Double_t> pdfGrad(n) ;
+    if (!pdfClone->expectedEventsGradient(params,&pdfGrad[0],_dataClone->get())) return kFALSE ;
+    for (k=0 ; k<n ; k++) {
+      grad[k] += (1-observed/expected)*pdfGrad[k] ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+
+//_____________________________________________________________________________
+Double_t RooNLLVar::evaluateBatchPartition(Int_t firstEvent, Int_t lastEvent, Double_t& sumWeight) const 
+{
+  // Calculate the -log(likelihood) terms of the events from firstEvent to lastEvent
+  // with the batch interface of the p.d.f, for ranges of batchSize events. Events 
+  // with a zero or invalid probability are recomputed with getLogVal() to report 
+  // the evaluation errors as in the event by event calculation.
+
+  const Int_t batchSize = 1024 ;
+
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+  const RooVectorDataStore& vstore = (const RooVectorDataStore&) *_dataClone->store() ;
+  const Double_t* wgt = vstore.weightColumn() ;
+
+  std::vector<Double_t> prob(batchSize) ;
+  Double_t result(0) ;
+  for (Int_t begin=firstEvent ; begin<lastEvent ; begin+=batchSize) {
+    Int_t end = TMath::Min(begin+batchSize,lastEvent) ;
+    pdfClone->getValBatch(begin,end,&prob[0],vstore,_normSet) ;
+
+    for (Int_t i=begin ; i<end ; i++) {
+      Double_t eventWeight = wgt ? wgt[i] : 1 ;
+      if (eventWeight==0) continue ;
+      if (_weightSq) eventWeight *= eventWeight ;
+
+      Double_t p = prob[i-begin] ;
+      Double_t term ;
+      if (p>0) {
+	term = eventWeight * log(p) ;
+      } else {
+	_dataClone->get(i) ;
+	term = eventWeight * pdfClone->getLogVal(_normSet) ;
+      }
+      sumWeight += eventWeight ;
+      result -= term ;
+    }
+  }
+
+  return result ;
+}
+
+
+
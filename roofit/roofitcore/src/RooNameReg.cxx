@@ -89,16 +89,24 @@ const TNamed* RooNameReg::constPtr(const char* inStr)
   // Handle null pointer case explicitly
   if (inStr==0) return 0 ;
 
-//   cout << "RooNameReg::constPtr(inStr=" << inStr << ") _htable entries = " << _htable.entries() << endl ;
-
-  // See if name is already registered ;
-  TNamed* t = (TNamed*) _htable.find(inStr) ;
-  if (t) return t ;
-
-  // If not, register now
-  t = new TNamed(inStr,inStr) ;
-  _htable.add(t) ;
-  _list.Add(t) ;
+  // See if name is already registered. The hash table of the list grows 
+  // with the number of names, so that the lookup time does not increase
+  // with the size of the models (e.g. when reading large workspaces).
+  // Names may be registered by the threads of a test statistic 
+  // (see RooAbsTestStatistic::setThreadMode())
+  TNamed* t(0) ;
+#ifdef _OPENMP
+#pragma omp critical (RooNameReg_list)
+#endif
+  {
+    t = (TNamed*) _list.find(inStr) ;
+
+    // If not, register now
+    if (!t) {
+      t = new TNamed(inStr,inStr) ;
+      _list.Add(t) ;
+    }
+  }
   
   return t ;
 }
@@ -62,6 +62,7 @@
 #include "RooRangeBoolean.h"
 #include "RooCustomizer.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 
 #include <string.h>
 #include <sstream>
@@ -533,6 +534,101 @@ Double_t RooProdPdf::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooProdPdf::evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* normSet) const 
+{
+  // Batch version of evaluate(): the running product of the terms is
+  // made on the arrays of their values, with the same cutoff as calculate().
+  // Rearranged products are not supported and false is returned.
+
+  _curNormSet = (RooArgSet*)normSet ;
+
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+  if (cache->_isRearranged) return kFALSE ;
+
+  const Int_t n = end-begin ;
+  for (Int_t j=0 ; j<n ; j++) output[j] = 1 ;
+
+  std::vector<Double_t> buf ;
+  RooFIter plIter = cache->_partList.fwdIterator() ;
+  RooFIter nlIter = cache->_normList.fwdIterator() ;
+  RooAbsReal* partInt ;
+  Bool_t first(kTRUE) ;
+  while((partInt = (RooAbsReal*) plIter.next())) {
+    RooArgSet* nset = (RooArgSet*) nlIter.next() ;
+    const Double_t* piVal = batchValues(*partInt,begin,end,buf,data,nset->getSize()>0 ? nset : 0) ;
+    for (Int_t j=0 ; j<n ; j++) {
+      // terms after the running product dropped below the cutoff are skipped
+      if (first || output[j]>_cutOff) output[j] *= piVal[j] ;
+    }
+    first = kFALSE ;
+  }
+
+  return kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooProdPdf::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const 
+{
+  // Analytical gradient of evaluate(): product rule on the terms of the
+  // running product, each with its own normalization set. Rearranged products
+  // and values below the cutoff of the running product are not supported and 
+  // false is returned.
+
+  if (!_selfNorm) return kFALSE ;
+
+  _curNormSet = (RooArgSet*)normSet ;
+
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+  if (cache->_isRearranged) return kFALSE ;
+
+  const Int_t n = cache->_partList.getSize() ;
+  std::vector<Double_t> piVal(n), prodAfter(n+1) ;
+  std::vector<RooArgSet*> piNormSet(n) ;
+  RooFIter plIter = cache->_partList.fwdIterator() ;
+  RooFIter nlIter = cache->_normList.fwdIterator() ;
+  Double_t value(1) ;
+  Int_t i ;
+  for (i=0 ; i<n ; i++) {
+    RooAbsReal* partInt = (RooAbsReal*) plIter.next() ;
+    RooArgSet* nset = (RooArgSet*) nlIter.next() ;
+    piNormSet[i] = nset->getSize()>0 ? nset : 0 ;
+    piVal[i] = partInt->getVal(piNormSet[i]) ;
+    value *= piVal[i] ;
+    if (value<=_cutOff && i<n-1) return kFALSE ;
+  }
+
+  // d(prod)/d(term i) = (product of the terms before i) * (product of the terms after i) 
+  prodAfter[n] = 1 ;
+  for (i=n-1 ; i>=0 ; i--) prodAfter[i] = prodAfter[i+1]*piVal[i] ;
+
+  Double_t prodBefore(1) ;
+  for (i=0 ; i<n ; i++) {
+    if (!addGradient(*(RooAbsReal*)cache->_partList.at(i),prodBefore*prodAfter[i+1],params,grad,piNormSet[i])) return kFALSE ;
+    prodBefore *= piVal[i] ;
+  }
+
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 Double_t RooProdPdf::calculate(const RooArgList* partIntList, const RooLinkedList* normSetList) const
 {
@@ -383,6 +383,41 @@ Double_t RooProduct::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooProduct::evaluateGradient(const RooArgList& params, Double_t* grad, const RooArgSet* normSet) const
+{
+  // Gradient of the product of the input functions with the product rule.
+  // Category inputs are constant factors.
+
+  Double_t catProd(1) ;
+  RooFIter compCIter = _compCSet.fwdIterator() ;
+  RooAbsCategory* ccomp ;
+  while((ccomp=(RooAbsCategory*)compCIter.next())) {
+    catProd *= ccomp->getIndex() ;
+  }
+
+  const Int_t n = _compRSet.getSize() ;
+  std::vector<Double_t> val(n), prodAfter(n+1) ;
+  std::vector<RooAbsReal*> comp(n) ;
+  RooFIter compRIter = _compRSet.fwdIterator() ;
+  Int_t i ;
+  for (i=0 ; i<n ; i++) {
+    comp[i] = (RooAbsReal*)compRIter.next() ;
+    val[i] = comp[i]->getVal(normSet) ;
+  }
+  prodAfter[n] = catProd ;
+  for (i=n-1 ; i>=0 ; i--) prodAfter[i] = prodAfter[i+1]*val[i] ;
+
+  Double_t prodBefore(1) ;
+  for (i=0 ; i<n ; i++) {
+    if (!addGradient(*comp[i],prodBefore*prodAfter[i+1],params,grad,normSet)) return kFALSE ;
+    prodBefore *= val[i] ;
+  }
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 std::list<Double_t>* RooProduct::binBoundaries(RooAbsRealLValue& obs, Double_t xlo, Double_t xhi) const
 {
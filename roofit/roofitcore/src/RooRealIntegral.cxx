@@ -49,6 +49,9 @@
 #include "RooExpensiveObjectCache.h"
 #include "RooConstVar.h"
 #include "RooDouble.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -845,21 +848,49 @@ Double_t RooRealIntegral::evaluate() const
   case Hybrid: 
     {      
       // Cache numeric integrals in >1d expensive object cache
-      RooDouble* cacheVal(0) ;
-      if ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) {
-	cacheVal = (RooDouble*) expensiveObjectCache().retrieveObject(GetName(),RooDouble::Class(),parameters())  ;
+      Bool_t useCache = ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) ;
+      Bool_t cacheHit(kFALSE) ;
+      if (useCache) {
+	// The cache is shared by all threads, and registerObject() deletes any 
+	// object of the same name, so the cached value is copied under the lock
+#ifdef _OPENMP
+#pragma omp critical (RooExpensiveObjectCache)
+#endif
+	{
+	  RooDouble* cacheVal = (RooDouble*) expensiveObjectCache().retrieveObject(GetName(),RooDouble::Class(),parameters())  ;
+	  if (cacheVal) {
+	    retVal = *cacheVal ;
+	    cacheHit = kTRUE ;
+	    //	cout << "using cached value of integral" << GetName() << endl ;
+	  }
+	}
       }
 
-      if (cacheVal) {
-	retVal = *cacheVal ;
-	//	cout << "using cached value of integral" << GetName() << endl ;
-      } else {
-
+      if (!cacheHit) {
 
 	// Find any function dependents that are AClean 
-	// and switch them temporarily to ADirty
+	// and switch them temporarily to ADirty. The global dirty inhibit 
+	// flag cannot be used inside a parallel region, as it would affect 
+	// the graphs evaluated by the other threads, switch the operation 
+	// mode of the branch nodes of the integrand instead
+	Bool_t inParallel(kFALSE) ;
+#ifdef _OPENMP
+	inParallel = omp_in_parallel() ;
+#endif
 	Bool_t origState = inhibitDirty() ;
-	setDirtyInhibit(kTRUE) ;
+	RooArgSet branches ;
+	std::vector<OperMode> origModes ;
+	if (inParallel) {
+	  _function.arg().branchNodeServerList(&branches) ;
+	  RooFIter biter = branches.fwdIterator() ;
+	  RooAbsArg* branch ;
+	  while((branch=biter.next())) {
+	    origModes.push_back(branch->operMode()) ;
+	    branch->setOperMode(ADirty,kFALSE) ;
+	  }
+	} else {
+	  setDirtyInhibit(kTRUE) ;
+	}
 	
 	// try to initialize our numerical integration engine
 	if(!(_valid= initNumIntegrator())) {
@@ -876,15 +907,27 @@ Double_t RooRealIntegral::evaluate() const
 	retVal = sum() ;
 
 	// This must happen BEFORE restoring dependents, otherwise no dirty state propagation in restore step
-	setDirtyInhibit(origState) ;
+	if (inParallel) {
+	  RooFIter biter = branches.fwdIterator() ;
+	  RooAbsArg* branch ;
+	  Int_t i(0) ;
+	  while((branch=biter.next())) {
+	    branch->setOperMode(origModes[i++],kFALSE) ;
+	  }
+	} else {
+	  setDirtyInhibit(origState) ;
+	}
 	
 	// Restore integral dependent values
 	_intList=_saveInt ;
 	_sumList=_saveSum ;
 
 	// Cache numeric integrals in >1d expensive object cache
-	if ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) {
+	if (useCache) {
 	  RooDouble* val = new RooDouble(retVal) ;
+#ifdef _OPENMP
+#pragma omp critical (RooExpensiveObjectCache)
+#endif
 	  expensiveObjectCache().registerObject(_function.arg().GetName(),GetName(),*val,parameters())  ;
 //  	  cout << "### caching value of integral" << GetName() << " in " << &expensiveObjectCache() << endl ;
 	}
@@ -42,6 +42,7 @@
 #include "RooRealIntegral.h"
 #include "RooMsgService.h"
 #include "RooNameReg.h"
+#include "RooVectorDataStore.h"
 #include <memory>
 #include <algorithm>
 
@@ -254,6 +255,62 @@ Double_t RooRealSumPdf::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooRealSumPdf::evaluateBatch(Int_t begin, Int_t end, Double_t* output, const RooVectorDataStore& data, const RooArgSet* /*normSet*/) const 
+{
+  // Batch version of evaluate(): the sum of the functions is made on the
+  // arrays of their values. Coefficients which depend on the data are not
+  // supported and false is returned.
+
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    if (data.dependsOnColumns(*coef)) return kFALSE ;
+  }
+
+  const Int_t n = end-begin ;
+  for (Int_t j=0 ; j<n ; j++) output[j] = 0 ;
+
+  std::vector<Double_t> buf ;
+  RooFIter funcIter = _funcList.fwdIterator() ;
+  coefIter = _coefList.fwdIterator() ;
+  RooAbsReal* func ;
+
+  // N funcs, N-1 coefficients 
+  Double_t lastCoef(1) ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    func = (RooAbsReal*)funcIter.next() ;
+    Double_t coefVal = coef->getVal() ;
+    if (coefVal) {
+      if (func->isSelectedComp()) {
+	const Double_t* funcVal = batchValues(*func,begin,end,buf,data) ;
+	for (Int_t j=0 ; j<n ; j++) output[j] += funcVal[j]*coefVal ;
+      }
+      lastCoef -= coef->getVal() ;
+    }
+  }
+  
+  if (!_haveLastCoef) {
+    // Add last func with correct coefficient
+    func = (RooAbsReal*) funcIter.next() ;
+    if (func->isSelectedComp()) {
+      const Double_t* funcVal = batchValues(*func,begin,end,buf,data) ;
+      for (Int_t j=0 ; j<n ; j++) output[j] += funcVal[j]*lastCoef ;
+    }
+
+    // Warn about coefficient degeneration
+    if (lastCoef<0 || lastCoef>1) {
+      coutW(Eval) << "RooRealSumPdf::evaluateBatch(" << GetName() 
+		  << " WARNING: sum of FUNC coefficients not in range [0-1], value=" 
+		  << 1-lastCoef << endl ;
+    } 
+  }
+
+  return kTRUE ;
+}
+
+
+
 
 //_____________________________________________________________________________
 Bool_t RooRealSumPdf::checkObservables(const RooArgSet* nset) const 
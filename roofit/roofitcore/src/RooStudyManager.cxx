@@ -19,6 +19,11 @@
 // BEGIN_HTML
 // RooStudyManager is a utility class to manage studies that consist of
 // repeated applications of generate-and-fit operations on a workspace
+// <p>
+// The experiments can be run interactively in the current process (run()),
+// in forked processes on the local host (runParallel()), on a PROOF
+// cluster (runProof()) or as batch jobs (prepareBatchInput() and 
+// processBatchOutput()).
 //
 // END_HTML
 //
@@ -34,14 +39,23 @@
 #include "RooDataSet.h"
 #include "RooMsgService.h"
 #include "RooStudyPackage.h"
+#include "RooRandom.h"
 #include "TTree.h"
 #include "TFile.h"
 #include "TRegexp.h"
 #include "TKey.h"
 #include <string>
+#include <vector>
 #include "TROOT.h"
 #include "TSystem.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <errno.h>
+#endif
+
 using namespace std ;
 
 ClassImp(RooStudyManager)
@@ -93,6 +107,97 @@ void RooStudyManager::run(Int_t nExperiments)
 
 
 
+//_____________________________________________________________________________
+void RooStudyManager::runParallel(Int_t nExperiments, Int_t nWorkers) 
+{
+  // Run 'nExperiments' experiments in 'nWorkers' processes forked from this process
+  // on the local host. If nWorkers is zero, one process per CPU is used. 
+  //
+  // Each worker runs a contiguous block of experiments and returns the output
+  // of the studies through a temporary ROOT file, which is aggregated in the 
+  // studies of this manager after all workers have finished, as for processBatchOutput().
+  // Each experiment is run with its own seed of RooRandom, derived from a base seed
+  // drawn from RooRandom in this process, so that the results do not depend on the
+  // number of workers.
+
+  if (nWorkers<=0) {
+    SysInfo_t info ;
+    gSystem->GetSysInfo(&info) ;
+    nWorkers = info.fCpus>0 ? info.fCpus : 1 ;
+  }
+  if (nWorkers>nExperiments) nWorkers = nExperiments ;
+
+  UInt_t seed = RooRandom::integer(1000000000) + 1 ;
+
+#ifndef _WIN32
+  Int_t ppid = gSystem->GetPid() ;
+  vector<pid_t> pids(nWorkers) ;
+  vector<string> files(nWorkers) ;
+
+  coutP(Generation) << "RooStudyManager::runParallel(" << GetName() << ") starting " << nWorkers 
+		    << " workers for processing of " << nExperiments << " experiments" << endl ;
+
+  // Flush output buffers to avoid duplicating them in the workers
+  cout.flush() ;
+  fflush(stdout) ;
+
+  Int_t first(0) ;
+  for (Int_t iw=0 ; iw<nWorkers ; iw++) {
+    Int_t nw = nExperiments/nWorkers + (iw < nExperiments%nWorkers ? 1 : 0) ;
+    files[iw] = Form("%s/study_result_%s_%d_%d.root",gSystem->TempDirectory(),GetName(),ppid,iw) ;
+
+    pids[iw] = fork() ;
+
+    if (pids[iw]==0) {
+      // Worker process: run assigned experiments and save results
+      _pkg->driver(nw,seed+first) ;
+
+      TList res ;
+      _pkg->exportData(&res,iw) ;
+      TFile fout(files[iw].c_str(),"RECREATE") ;
+      res.Write() ;
+      fout.Close() ;
+      _exit(0) ;
+
+    } else if (pids[iw]<0) {
+      coutE(Generation) << "RooStudyManager::runParallel(" << GetName() << ") ERROR fork() failed for worker " << iw 
+			<< ", its experiments are not processed" << endl ;
+    }
+
+    first += nw ;
+  }
+
+  // Collect results of workers
+  TList olist ;
+  for (Int_t iw=0 ; iw<nWorkers ; iw++) {
+    if (pids[iw]<0) continue ;
+
+    // Retry if interrupted by a signal, a worker that cannot be waited for has failed
+    int status(0) ;
+    pid_t ret ;
+    while ((ret=waitpid(pids[iw],&status,0))==-1 && errno==EINTR) ;
+    Bool_t waited = (ret==pids[iw]) ;
+
+    if (!waited || !WIFEXITED(status) || WEXITSTATUS(status)!=0 || readOutputFile(files[iw].c_str(),olist)) {
+      coutE(Generation) << "RooStudyManager::runParallel(" << GetName() << ") ERROR worker " << iw 
+			<< " did not return results" << endl ;
+    }
+    gSystem->Unlink(files[iw].c_str()) ;
+  }
+
+  // Aggregate results data
+  coutP(Generation) << "RooStudyManager::runParallel(" << GetName() << ") aggregating results data" << endl ;
+  aggregateData(&olist) ;
+  olist.Delete() ;
+
+#else
+  // No fork() available: run all experiments in this process
+  _pkg->driver(nExperiments,seed) ;
+#endif // _WIN32
+}
+
+
+
 //_____________________________________________________________________________
 void RooStudyManager::runProof(Int_t nExperiments, const char* proofHost, Bool_t showGui) 
 {
@@ -219,25 +324,40 @@ void RooStudyManager::processBatchOutput(const char* filePat)
 
   for (list<string>::iterator iter = flist.begin() ; iter!=flist.end() ; ++iter) {
     coutP(DataHandling) << "RooStudyManager::processBatchOutput() now reading file " << *iter << endl ;
-    TFile f(iter->c_str()) ;
-
-    TList* list = f.GetListOfKeys() ;
-    TIterator* kiter = list->MakeIterator();
-    
-    TObject* obj ;
-    TKey* key ;
-    while((key=(TKey*)kiter->Next())) {      
-      obj = f.Get(key->GetName()) ;
-      TObject* clone = obj->Clone(obj->GetName()) ;
-      olist.Add(clone) ;
-    }
-    delete kiter ;
+    readOutputFile(iter->c_str(),olist) ;
   }
   aggregateData(&olist) ;
   olist.Delete() ;
 }
 
 
+
+//_____________________________________________________________________________
+Bool_t RooStudyManager::readOutputFile(const char* fileName, TList& olist) 
+{
+  // Add clones of all objects in output file 'fileName' of a study job to olist.
+  // Return true if the file could not be read
+
+  TFile f(fileName) ;
+  if (f.IsZombie()) {
+    return kTRUE ;
+  }
+
+  TList* list = f.GetListOfKeys() ;
+  TIterator* kiter = list->MakeIterator();
+    
+  TObject* obj ;
+  TKey* key ;
+  while((key=(TKey*)kiter->Next())) {      
+    obj = f.Get(key->GetName()) ;
+    TObject* clone = obj->Clone(obj->GetName()) ;
+    olist.Add(clone) ;
+  }
+  delete kiter ;
+  return kFALSE ;
+}
+
+
 //_____________________________________________________________________________
 void RooStudyManager::aggregateData(TList* olist) 
 {
@@ -81,10 +81,12 @@ void RooStudyPackage::addStudy(RooAbsStudy& study)
 
 
 //_____________________________________________________________________________
-void RooStudyPackage::driver(Int_t nExperiments)
+void RooStudyPackage::driver(Int_t nExperiments, UInt_t firstSeed)
 {
+  // Initialize studies, run 'nExperiments' experiments and finalize studies.
+  // If firstSeed is not zero, experiment i is run with random seed firstSeed+i
   initialize() ;
-  run(nExperiments) ;
+  run(nExperiments,firstSeed) ;
   finalize() ;
 } 
 
@@ -103,15 +105,20 @@ void RooStudyPackage::initialize()
 
 
 //_____________________________________________________________________________
-void RooStudyPackage::run(Int_t nExperiments) 
+void RooStudyPackage::run(Int_t nExperiments, UInt_t firstSeed) 
 {
+  // Run the requested number of experiments. If firstSeed is not zero
+  // the random generator is seeded with firstSeed+i before experiment i,
+  // so that each experiment has its own random sequence
 
-  // Run the requested number of experiments
   Int_t prescale = nExperiments>100 ? Int_t(nExperiments/100) : 1 ;
   for (Int_t i=0 ; i<nExperiments ; i++) {
     if (i%prescale==0) {
       coutP(Generation) << "RooStudyPackage::run(" << GetName() << ") processing experiment " << i << "/" << nExperiments << endl ;
     }    
+    if (firstSeed) {
+      RooRandom::randomGenerator()->SetSeed(firstSeed+i) ;
+    }
     runOne() ;
   }
 }
@@ -1227,6 +1227,61 @@ void RooVectorDataStore::recalculateCache( const RooArgSet *projectedArgs, Int_t
 
 
 
+//_____________________________________________________________________________
+Bool_t RooVectorDataStore::recalculateCachedArgs(const RooArgSet& args, const RooArgSet* nset) 
+{
+  // Recalculate for all events the cached values of the given arguments, which
+  // must have been cached with cacheArgs(). This is used to update the precalculated
+  // constant terms whose constant parameters have changed value, without recalculating
+  // the other cached terms. Return false if any of the arguments is not cached here
+
+  if (!_cache) return kFALSE ;
+
+  vector<RealVector*> tv ;
+  for (Int_t i=0 ; i<_cache->_nReal ; i++) {
+    RealVector* rv = *(_cache->_firstReal+i) ;
+    if (args.containsInstance(*rv->_nativeReal)) {
+      tv.push_back(rv) ;
+    }
+  }
+  if ((Int_t)tv.size()!=args.getSize()) {
+    return kFALSE ;
+  }
+
+  // The constant terms are not sorted, but RooAbsArg::findConstantNodes() does not descend
+  // below a constant node, so no cached constant term depends on another one and they can 
+  // be recalculated in any order
+  for (UInt_t j=0 ; j<tv.size() ; j++) {
+    tv[j]->_nativeReal->setOperMode(RooAbsArg::ADirty) ;
+    tv[j]->_nativeReal->_operMode=RooAbsArg::Auto ;
+  }
+
+  RooAbsReal::ErrorLoggingMode origMode = RooAbsReal::evalErrorLoggingMode() ;
+  for (Int_t i=0 ; i<numEntries() ; i++) {
+    get(i) ;    
+    Bool_t zeroWeight = (weight()==0) ;
+    if (zeroWeight) {
+      RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::Ignore) ;
+    }
+    for (UInt_t j=0 ; j<tv.size() ; j++) {
+      tv[j]->_nativeReal->_valueDirty=kTRUE ;
+      tv[j]->_nativeReal->getValV(nset) ;
+      tv[j]->write(i) ;
+    }
+    if (zeroWeight) {
+      RooAbsReal::setEvalErrorLoggingMode(origMode) ;
+    }
+  }  
+
+  for (UInt_t j=0 ; j<tv.size() ; j++) {
+    tv[j]->_nativeReal->setOperMode(RooAbsArg::AClean) ;
+  }  
+
+  return kTRUE ;
+}
+
+
+
 
 //_____________________________________________________________________________
 void RooVectorDataStore::attachCache(const RooAbsArg* newOwner, const RooArgSet& cachedVarsIn) 
@@ -1325,6 +1380,63 @@ void RooVectorDataStore::resetBuffers()
 
 
 
+//_____________________________________________________________________________
+const Double_t* RooVectorDataStore::realColumn(const RooAbsArg& arg) const
+{
+  // Return a pointer to the values of 'arg' for all events, if 'arg' is a
+  // real-valued column of this store or of its cache of precalculated
+  // (constant) terms. The value for event i is at index i. If 'arg' is
+  // not stored, zero is returned. Columns are matched by name.
+
+  if (_nEntries==0) return 0 ;
+
+  for (Int_t i=0 ; i<_nReal ; i++) {
+    const RealVector* rv = *(_firstReal+i) ;
+    if (rv->bufArg() && rv->bufArg()->namePtr()==arg.namePtr()) {
+      return rv->_vec0 ;
+    }
+  }
+  for (Int_t i=0 ; i<_nRealF ; i++) {
+    const RealFullVector* rv = *(_firstRealF+i) ;
+    if (rv->bufArg() && rv->bufArg()->namePtr()==arg.namePtr()) {
+      return rv->_vec0 ;
+    }
+  }
+
+  if (_cache) {
+    return _cache->realColumn(arg) ;
+  }
+
+  return 0 ;
+}
+
+
+
+//_____________________________________________________________________________
+const Double_t* RooVectorDataStore::weightColumn() const
+{
+  // Return a pointer to the event weights, or zero if the store
+  // is not weighted (all weights are one)
+
+  if (_extWgtArray) return _extWgtArray ;
+  if (_wgtVar) return realColumn(*_wgtVar) ;
+  return 0 ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooVectorDataStore::dependsOnColumns(const RooAbsArg& arg) const
+{
+  // Return true if the value of 'arg' depends on any of the columns
+  // of this store or of its cache, i.e. if it changes from event to event
+
+  if (arg.dependsOnValue(_varsww)) return kTRUE ;
+  return _cache ? _cache->dependsOnColumns(arg) : kFALSE ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooVectorDataStore::dump()
 {
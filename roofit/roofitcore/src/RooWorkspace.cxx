@@ -142,6 +142,7 @@ void RooWorkspace::autoImportClassCode(Bool_t flag)
 RooWorkspace::RooWorkspace() : _classes(this), _dir(0), _factory(0), _doExport(kFALSE), _openTrans(kFALSE)
 {
   // Default constructor
+  _allOwnedNodes.setHashTableSize(1000) ;
 }
 
 
@@ -151,6 +152,7 @@ RooWorkspace::RooWorkspace(const char* name, const char* title) :
   TNamed(name,title?title:name), _classes(this), _dir(0), _factory(0), _doExport(kFALSE), _openTrans(kFALSE)
 {
   // Construct empty workspace with given name and title
+  _allOwnedNodes.setHashTableSize(1000) ;
 }
 
 
@@ -158,6 +160,7 @@ RooWorkspace::RooWorkspace(const char* name, Bool_t doCINTExport)  :
   TNamed(name,name), _classes(this), _dir(0), _factory(0), _doExport(kFALSE), _openTrans(kFALSE)
 {
   // Construct empty workspace with given name and option to export reference to all workspace contents to a CINT namespace with the same name
+  _allOwnedNodes.setHashTableSize(1000) ;
   if (doCINTExport) {
     exportToCint(name) ;
   }
@@ -171,6 +174,7 @@ RooWorkspace::RooWorkspace(const RooWorkspace& other) :
   // Workspace copy constructor
 
   // Copy owned nodes
+  _allOwnedNodes.setHashTableSize(1000) ;
   other._allOwnedNodes.snapshot(_allOwnedNodes,kTRUE) ;
 
   // Copy datasets
@@ -459,6 +463,7 @@ Bool_t RooWorkspace::import(const RooAbsArg& inArg, const RooCmdArg& arg1, const
   // Make list of conflicting nodes
   RooArgSet conflictNodes ;
   RooArgSet branchSet ;
+  branchSet.setHashTableSize(1000) ;
   inArg.branchNodeServerList(&branchSet) ;
   TIterator* iter = branchSet.createIterator() ;
   RooAbsArg* branch ;
@@ -578,6 +583,8 @@ Bool_t RooWorkspace::import(const RooAbsArg& inArg, const RooCmdArg& arg1, const
 
   RooArgSet recycledNodes ;
   RooArgSet nodesToBeDeleted ;
+  recycledNodes.setHashTableSize(1000) ;
+  nodesToBeDeleted.setHashTableSize(1000) ;
   while((node=(RooAbsArg*)iter->Next())) {
 
     if (_autoClass) {
@@ -62,6 +62,13 @@
 // Test  27:  'tree' with 'gaus2Dn'.................................OK
 // Test  28:  'tree' with 'gausND'..................................OK
 
+// Test compiled formulae
+
+// Test  29:  'compiled formula' with 'gausPol1'....................OK
+// Test  30:  'compiled formula' with 'dampedSin'...................OK
+// Test  31:  'compiled formula' with 'twoGaus'.....................OK
+// (each compiled formula test prints also the evaluation and fit times)
+
 // ****************************************************************************
 // stressHistoFit: Real Time =  37.49 seconds Cpu Time =  37.24 seconds
 //  ROOTMARKS = 2663.8 ROOT version: 5.27/01	trunk@32822
@@ -104,6 +111,7 @@
 #include "TROOT.h"
 //#include "RConfigure.h"
 #include "TBenchmark.h"
+#include "TStopwatch.h"
 #include "TCanvas.h"
 #include "TApplication.h"
 
@@ -970,6 +978,86 @@ int testUnBinnedFit(int n = 10000)
    return globalStatus;
 }
 
+// Test the natively compiled formulae (TFormula::CompileNative): compare the
+// values with the interpreted formula and the results of a histogram fit, and
+// print the evaluation and fit times of both
+int testCompiledFormula(int n = 100000)
+{
+   // Counts how many tests failed.
+   int globalStatus = 0;
+   // To control if an individual test failed
+   int status = 0;
+
+   const int nform = 3;
+   const char * names[nform] = { "gausPol1", "dampedSin", "twoGaus" };
+   const char * formulas[nform] = { "[0]*exp(-0.5*((x-[1])/[2])^2)+[3]+[4]*x",
+                                    "[0]*sin([1]*x)*exp(-[2]*x)+[3]",
+                                    "gaus(0)+gaus(3)" };
+   const double pars[nform][6] = { { 100, 0.5, 1.2, 10, 1, 0},
+                                   { 50, 2., 0.1, 100, 0, 0},
+                                   { 100, -1, 0.8, 50, 2, 1.5} };
+
+   TStopwatch w;
+   vector<double> xv(n);
+   for (int i = 0; i < n; ++i) xv[i] = -5. + 10.*i/n;
+
+   for (int k = 0; k < nform; ++k) {
+      status = 0;
+      TF1 * fint = new TF1(TString(names[k]) + "_int", formulas[k], -5, 5);
+      TF1 * fnat = new TF1(names[k], formulas[k], -5, 5);
+      fint->SetParameters(pars[k]);
+      fnat->SetParameters(pars[k]);
+
+      TString str = Form("Test %3d:  'compiled formula' with '%s'...", ++gTestIndex, names[k]);
+      while ( str.Length() < 65 ) str += '.';
+      printf("%s", str.Data());
+      fflush(stdout);
+
+      if (!fnat->CompileNative()) {
+         // no compiler available: nothing to compare
+         printf("SKIPPED\n");
+         delete fint; delete fnat;
+         continue;
+      }
+
+      // compare the function values
+      double tint = 0, tnat = 0, sum1 = 0, sum2 = 0;
+      w.Start(kTRUE);
+      for (int i = 0; i < n; ++i) sum1 += fint->EvalPar(&xv[i]);
+      tint = w.RealTime();
+      w.Start(kTRUE);
+      for (int i = 0; i < n; ++i) sum2 += fnat->EvalPar(&xv[i]);
+      tnat = w.RealTime();
+      for (int i = 0; i < n; i += 100)
+         if (!TMath::AreEqualRel(fint->EvalPar(&xv[i]), fnat->EvalPar(&xv[i]), 1.E-12)) status++;
+      if (!TMath::AreEqualRel(sum1, sum2, 1.E-10)) status++;
+
+      // compare the fit results
+      TH1D h1("hcomp","hcomp",100,-5,5);
+      h1.FillRandom(fint->GetName(), 20000);
+      fint->SetParameters(pars[k]);
+      w.Start(kTRUE);
+      h1.Fit(fint,"Q0");
+      double tfitint = w.RealTime();
+      w.Start(kTRUE);
+      h1.Fit(fnat,"Q0");
+      double tfitnat = w.RealTime();
+      for (int ipar = 0; ipar < fint->GetNpar(); ++ipar)
+         if (!TMath::AreEqualAbs(fint->GetParameter(ipar), fnat->GetParameter(ipar),
+                                 1.E-3*fint->GetParError(ipar))) status++;
+
+      globalStatus += status;
+      printf("%s\n", (status?"FAILED":"OK"));
+      printf("           eval time (s): interpreted %7.4f compiled %7.4f - fit time (s): interpreted %7.4f compiled %7.4f\n",
+             tint, tnat, tfitint, tfitnat);
+
+      delete fint;
+      delete fnat;
+   }
+
+   return globalStatus;
+}
+
 // Initialize the data for the tests: List of different algorithms and
 // fitting functions.
 void init_structures()
@@ -1152,6 +1240,8 @@ int stressHistoFit()
    // tree test
    std::cout << "\nTest unbinned fits\n\n";
    iret += testUnBinnedFit(2000);  // reduce statistics
+   std::cout << "\nTest compiled formulae\n\n";
+   iret += testCompiledFormula();
    
    bm.Stop("stressHistoFit");
    std::cout <<"\n****************************************************************************\n";
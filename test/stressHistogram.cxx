@@ -3592,6 +3592,61 @@ bool testMergeHn()
    return ret;
 }
 
+bool testMergeMany1D() 
+{
+   // Tests the merge method for many 1D Histograms with the same binning,
+   // including an empty one
+
+   const Int_t nHists = 100;
+   TH1D* h1 = new TH1D("mergeMany1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h4 = new TH1D("mergeMany1D-h4", "h4-Title", numberOfBins, minRange, maxRange);
+   h1->Sumw2();
+
+   FillHistograms(h1, h4);
+
+   TList *list = new TList;
+   for ( Int_t i = 0; i < nHists; ++i ) {
+      TH1D* h = new TH1D(TString::Format("mergeMany1D-h%d", i + 10), "h-Title", numberOfBins, minRange, maxRange);
+      h->Sumw2();
+      if ( i != nHists / 2 ) FillHistograms(h, h4);
+      list->Add(h);
+   }
+
+   h1->Merge(list);
+
+   bool ret = equals("MergeMany1D", h1, h4, cmpOptStats, 1E-10);
+   list->Delete();
+   delete list;
+   delete h1;
+   return ret;
+}
+
+bool testMergeManyProf1D() 
+{
+   // Tests the merge method for many 1D Profiles with the same binning
+
+   const Int_t nHists = 100;
+   TProfile* p1 = new TProfile("mergeMany1D-p1", "p1-Title", numberOfBins, minRange, maxRange);
+   TProfile* p4 = new TProfile("mergeMany1D-p4", "p4-Title", numberOfBins, minRange, maxRange);
+
+   FillProfiles(p1, p4);
+
+   TList *list = new TList;
+   for ( Int_t i = 0; i < nHists; ++i ) {
+      TProfile* p = new TProfile(TString::Format("mergeMany1D-p%d", i + 10), "p-Title", numberOfBins, minRange, maxRange);
+      FillProfiles(p, p4);
+      list->Add(p);
+   }
+
+   p1->Merge(list);
+
+   bool ret = equals("MergeMany1DProf", p1, p4, cmpOptStats, 1E-10);
+   list->Delete();
+   delete list;
+   delete p1;
+   return ret;
+}
+
 bool testMerge1DLabelSame()
 {
    // Tests the merge with some equal labels method for 1D Histograms
@@ -9309,12 +9364,13 @@ int stressHistogram()
 
    // Test 10
    // Merge Tests
-   const unsigned int numberOfMerge = 43;
+   const unsigned int numberOfMerge = 45;
    pointer2Test mergeTestPointer[numberOfMerge] = { testMerge1D,                 testMergeProf1D,
                                                     testMergeVar1D,              testMergeProfVar1D,
                                                     testMerge2D,                 testMergeProf2D,
                                                     testMerge3D,                 testMergeProf3D,
                                                     testMergeHn<THnD>,           testMergeHn<THnSparseD>,
+                                                    testMergeMany1D,             testMergeManyProf1D,
                                                     testMerge1DLabelSame,        testMergeProf1DLabelSame,
                                                     testMerge2DLabelSame,        testMergeProf2DLabelSame,
                                                     testMerge3DLabelSame,        testMergeProf3DLabelSame,
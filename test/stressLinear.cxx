@@ -85,6 +85,14 @@
 // Test  4 : Eigen - Values/Vectors.................................OK  //
 // Test  5 : Decomposition Persistence..............................OK  //
 // *******************************************************************  //
+// *  Starting  Backward IO compatibility - S T R E S S             *  //
+// *******************************************************************  //
+// Test  1 : Streamers..............................................OK  //
+// *******************************************************************  //
+// *  Starting  Large Matrix - B E N C H M A R K                     *  //
+// *******************************************************************  //
+// Test  1 : Blocked Multiplications and Decompositions.............OK  //
+// *******************************************************************  //
 //                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
@@ -93,6 +101,7 @@
 #include <TSystem.h>
 #include <TFile.h>
 #include <TBenchmark.h>
+#include <TStopwatch.h>
 #include <TArrayD.h>
 #include <TF1.h>
 #include <TGraph.h>
@@ -166,6 +175,8 @@ void   astress_decomp_io           (Int_t msize);
 
 void   stress_backward_io          ();
 
+void   lstress_large_matrix        (Int_t msize);
+
 void   cleanup                     ();
 
 //_____________________________batch only_____________________
@@ -288,6 +299,14 @@ void stressLinear(Int_t maxSizeReq,Int_t verbose)
 
   gBenchmark->Stop("stressLinear");
 
+  //Blocked algorithms for large matrices, not included in the ROOTMARKS
+  {
+    cout << "*  Starting  Large Matrix - B E N C H M A R K                    *" <<endl;
+    cout << "******************************************************************" <<endl;
+    lstress_large_matrix(maxSize);
+    cout << "******************************************************************" <<endl;
+  }
+
   //Print table with results
   Bool_t UNIX = strcmp(gSystem->GetName(), "Unix") == 0;
   printf("******************************************************************\n");
@@ -4412,6 +4431,120 @@ void stress_backward_io()
   StatusPrint(1,"Streamers",ok);
 }
 
+//------------------------------------------------------------------------
+//     Test the cache-blocked (and, with OpenMP, multi-threaded) matrix
+//     multiplications and LU/Cholesky decompositions used for large
+//     matrices. In verbose mode the time of each operation is printed.
+//
+void lstress_large_matrix(Int_t msize)
+{
+  if (gVerbose)
+    cout << "\nBlocked algorithms with " << msize << "x" << msize << " matrices" <<endl;
+
+  Bool_t ok = kTRUE;
+  TStopwatch timer;
+
+  const Int_t nrows  = msize;
+  const Int_t ninner = msize+3;
+  const Int_t ncols  = msize-1;
+  TMatrixD a(nrows,ninner);
+  TMatrixD b(ninner,ncols);
+  for (Int_t i = 0; i < nrows; i++)
+    for (Int_t k = 0; k < ninner; k++)
+      a(i,k) = TMath::Sin(0.37*i+1.13*k);
+  for (Int_t k = 0; k < ninner; k++)
+    for (Int_t j = 0; j < ncols; j++)
+      b(k,j) = TMath::Cos(0.71*k-0.29*j);
+
+  // reference product with the simple loops
+  TMatrixD ref(nrows,ncols);
+  for (Int_t i = 0; i < nrows; i++) {
+    for (Int_t j = 0; j < ncols; j++) {
+      Double_t sum = 0;
+      for (Int_t k = 0; k < ninner; k++)
+        sum += a(i,k)*b(k,j);
+      ref(i,j) = sum;
+    }
+  }
+
+  {
+    timer.Start();
+    const TMatrixD c(a,TMatrixD::kMult,b);
+    timer.Stop();
+    if (gVerbose)
+      printf("A * B       : real %8.3f s  cpu %8.3f s\n",timer.RealTime(),timer.CpuTime());
+    ok &= VerifyMatrixIdentity(c,ref,gVerbose,msize*EPSILON);
+  }
+
+  {
+    const TMatrixD at(TMatrixD::kTransposed,a);
+    timer.Start();
+    const TMatrixD c(at,TMatrixD::kTransposeMult,b);
+    timer.Stop();
+    if (gVerbose)
+      printf("A^T * B     : real %8.3f s  cpu %8.3f s\n",timer.RealTime(),timer.CpuTime());
+    ok &= VerifyMatrixIdentity(c,ref,gVerbose,msize*EPSILON);
+  }
+
+  {
+    const TMatrixD bt(TMatrixD::kTransposed,b);
+    timer.Start();
+    const TMatrixD c(a,TMatrixD::kMultTranspose,bt);
+    timer.Stop();
+    if (gVerbose)
+      printf("A * B^T     : real %8.3f s  cpu %8.3f s\n",timer.RealTime(),timer.CpuTime());
+    ok &= VerifyMatrixIdentity(c,ref,gVerbose,msize*EPSILON);
+  }
+
+  {
+    const TMatrixF af = a;
+    const TMatrixF bf = b;
+    const TMatrixF reff = ref;
+    timer.Start();
+    const TMatrixF cf(af,TMatrixF::kMult,bf);
+    timer.Stop();
+    if (gVerbose)
+      printf("A * B float : real %8.3f s  cpu %8.3f s\n",timer.RealTime(),timer.CpuTime());
+    ok &= VerifyMatrixIdentity(cf,reff,gVerbose,Float_t(msize*1.0e-5));
+  }
+
+  {
+    // positive definite matrix A^T * A + msize * I
+    TMatrixDSym s(TMatrixDSym::kAtA,a);
+    for (Int_t i = 0; i < s.GetNrows(); i++)
+      s(i,i) += msize;
+    timer.Start();
+    TDecompChol chol(s);
+    ok &= chol.Decompose();
+    timer.Stop();
+    if (gVerbose)
+      printf("Cholesky    : real %8.3f s  cpu %8.3f s\n",timer.RealTime(),timer.CpuTime());
+    ok &= VerifyMatrixIdentity(chol.GetMatrix(),s,gVerbose,msize*msize*EPSILON);
+  }
+
+  {
+    TMatrixD g(msize,msize);
+    for (Int_t i = 0; i < msize; i++)
+      for (Int_t j = 0; j < msize; j++)
+        g(i,j) = TMath::Sin(0.53*i*j+0.17*i+0.41*j);
+    for (Int_t implicit = 0; implicit <= 1; implicit++) {
+      timer.Start();
+      TDecompLU lu(g,0.0,implicit);
+      ok &= lu.Decompose();
+      timer.Stop();
+      if (gVerbose)
+        printf("LU (%s) : real %8.3f s  cpu %8.3f s\n",(implicit ? "Crout" : "Gauss"),
+               timer.RealTime(),timer.CpuTime());
+      ok &= VerifyMatrixIdentity(lu.GetMatrix(),g,gVerbose,msize*msize*EPSILON);
+    }
+  }
+
+  if (gVerbose)
+    cout << "\nDone" <<endl;
+
+  StatusPrint(1,"Blocked Multiplications and Decompositions",ok);
+}
+
 void cleanup()
 {
   gSystem->Unlink("vmatrix.root");
@@ -149,6 +149,15 @@ Int_t stressRooFit(const char* refFile, Bool_t writeRef, Int_t doVerbose, Int_t
   testList.push_back(new TestBasic606(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic607(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic609(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic610(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic611(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic612(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic613(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic614(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic615(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic616(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic617(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic618(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic701(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic702(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic703(fref,writeRef,doVerbose)) ;
@@ -4970,6 +4970,1283 @@ public:
 
 
 
+//////////////////////////////////////////////////////////////////////////
+//
+// 'LIKELIHOOD AND MINIMIZATION' RooFit test #610
+// 
+// Likelihood evaluated in batch mode: the values of the p.d.f.s are
+// computed for ranges of events directly from the columns of the dataset.
+// The value of the -log(L) and the result of the fit must be the same as
+// with the event-by-event evaluation
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooExponential.h"
+#include "RooPolynomial.h"
+#include "RooChebychev.h"
+#include "RooAddPdf.h"
+#include "RooProdPdf.h"
+#include "RooRealSumPdf.h"
+#include "RooFitResult.h"
+using namespace RooFit ;
+
+class TestBasic610 : public RooUnitTest
+{
+public: 
+  TestBasic610(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Likelihood in batch mode",refFile,writeRef,verbose) {} ;
+
+  Bool_t compareNLL(RooAbsPdf& pdf, RooDataSet& data, Bool_t optConst) {
+    // Compare value of -log(L) with and without batch mode
+    RooAbsReal* nll = pdf.createNLL(data) ;
+    RooAbsReal* nllBatch = pdf.createNLL(data,BatchMode()) ;
+    if (optConst) {
+      nll->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+      nllBatch->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+    }
+    Double_t val = nll->getVal() ;
+    Double_t valBatch = nllBatch->getVal() ;
+    delete nll ;
+    delete nllBatch ;
+    if (fabs(val-valBatch)>1e-9*fabs(val)) {
+      cout << "TestBasic610: -log(L) of " << pdf.GetName() << " differs in batch mode: " << val << " vs " << valBatch << endl ;
+      return kFALSE ;
+    }
+    return kTRUE ;
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   m o d e l s
+  // -----------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar y("y","y",-10,10) ;
+
+  // Signal : gaussian in x times gaussian in y
+  RooRealVar mean("mean","mean",1,-10,10) ;
+  RooRealVar sigma("sigma","sigma",2,0.1,10) ;
+  RooGaussian gx("gx","gx",x,mean,sigma) ;
+  RooGaussian gy("gy","gy",y,mean,sigma) ;
+  RooProdPdf sig("sig","sig",RooArgSet(gx,gy)) ;
+
+  // Background : exponential in x times polynomial in y
+  RooRealVar c("c","c",-0.1,-1,1) ;
+  RooExponential ex("ex","ex",x,c) ;
+  RooRealVar a1("a1","a1",0.05,-1,1) ;
+  RooPolynomial py("py","py",y,RooArgList(a1)) ;
+  RooProdPdf bkg("bkg","bkg",RooArgSet(ex,py)) ;
+
+  RooRealVar fsig("fsig","fsig",0.3,0.,1.) ;
+  RooAddPdf model("model","model",RooArgList(sig,bkg),fsig) ;
+
+  // Extended sum with a component without batch evaluation (RooChebychev)
+  RooRealVar b1("b1","b1",-0.2,-1,1) ;
+  RooChebychev cx("cx","cx",x,RooArgList(b1)) ;
+  RooRealVar nsig("nsig","nsig",500,0,5000) ;
+  RooRealVar nbkg("nbkg","nbkg",1500,0,5000) ;
+  RooAddPdf emodel("emodel","emodel",RooArgList(gx,cx),RooArgList(nsig,nbkg)) ;
+
+  // Sum of amplitudes
+  RooRealVar f2("f2","f2",0.4,0.,1.) ;
+  RooRealSumPdf rsum("rsum","rsum",RooArgList(gx,ex),RooArgList(f2)) ;
+
+  RooDataSet* data = model.generate(RooArgSet(x,y),2000) ;
+  RooDataSet* datax = emodel.generate(x,2000) ;
+
+
+  // C o m p a r e   - l o g ( L )   w i t h   a n d   w i t h o u t   b a t c h   m o d e
+  // ---------------------------------------------------------------------------------------
+
+  Bool_t ok = kTRUE ;
+  for (Int_t i=0 ; i<2 ; i++) {
+    ok &= compareNLL(model,*data,i==1) ;
+    ok &= compareNLL(emodel,*datax,i==1) ;
+    ok &= compareNLL(rsum,*datax,i==1) ;
+  }
+
+
+  // C o m p a r e   f i t   r e s u l t s
+  // -------------------------------------
+
+  RooArgSet* params = model.getParameters(*data) ;
+  RooArgSet* initParams = (RooArgSet*) params->snapshot() ;
+  RooFitResult* r = model.fitTo(*data,Save(),PrintLevel(-1)) ;
+  *params = *initParams ;
+  RooFitResult* rBatch = model.fitTo(*data,Save(),PrintLevel(-1),BatchMode()) ;
+  if (!r->isIdentical(*rBatch,1e-6,1e-4)) {
+    cout << "TestBasic610: fit result differs in batch mode" << endl ;
+    ok = kFALSE ;
+  }
+
+  delete r ;
+  delete rBatch ;
+  delete initParams ;
+  delete params ;
+  delete data ;
+  delete datax ;
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// 'LIKELIHOOD AND MINIMIZATION' RooFit test #611
+// 
+// Likelihood calculated in partitions in threads: the value of -log(L)
+// and the result of the fit must be the same as with the calculation
+// in a single partition, with bulk and interleaved partitioning, for a 
+// simultaneous p.d.f. and for a p.d.f. normalized by a numeric integral,
+// which is then calculated in the threads
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooChebychev.h"
+#include "RooGenericPdf.h"
+#include "RooAddPdf.h"
+#include "RooCategory.h"
+#include "RooSimultaneous.h"
+#include "RooFitResult.h"
+using namespace RooFit ;
+
+class TestBasic611 : public RooUnitTest
+{
+public: 
+  TestBasic611(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Likelihood calculated in threads",refFile,writeRef,verbose) {} ;
+
+  Bool_t compareNLL(RooAbsPdf& pdf, RooDataSet& data, RooArgSet& params, Bool_t interleave) {
+    // Compare value of -log(L) calculated in one and in three threads, for
+    // two sets of parameter values
+    RooAbsReal* nll = pdf.createNLL(data) ;
+    RooAbsReal* nllThreads = pdf.createNLL(data,NumThreads(3,interleave)) ;
+    nll->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+    nllThreads->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+    RooArgSet* initParams = (RooArgSet*) params.snapshot() ;
+    Bool_t ok = kTRUE ;
+    for (Int_t i=0 ; i<2 ; i++) {
+      Double_t val = nll->getVal() ;
+      Double_t valThreads = nllThreads->getVal() ;
+      if (fabs(val-valThreads)>1e-9*fabs(val)) {
+	cout << "TestBasic611: -log(L) of " << pdf.GetName() << " differs in threads: " << val << " vs " << valThreads << endl ;
+	ok = kFALSE ;
+      }
+      // Change all parameters
+      RooFIter iter = params.fwdIterator() ;
+      RooAbsArg* arg ;
+      while((arg=iter.next())) {
+	RooRealVar* var = dynamic_cast<RooRealVar*>(arg) ;
+	if (var) var->setVal(0.9*var->getVal()+0.1*var->getMin()) ;
+      }
+    }
+    params = *initParams ;
+    delete initParams ;
+    delete nll ;
+    delete nllThreads ;
+    return ok ;
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   m o d e l s
+  // -----------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar mean("mean","mean",1,-10,10) ;
+  RooRealVar sigma("sigma","sigma",2,0.1,10) ;
+  RooGaussian gx("gx","gx",x,mean,sigma) ;
+  RooRealVar a0("a0","a0",-0.2,-1,1) ;
+  RooChebychev bkg("bkg","bkg",x,RooArgList(a0)) ;
+  RooRealVar fsig("fsig","fsig",0.3,0.,1.) ;
+  RooAddPdf model("model","model",RooArgList(gx,bkg),fsig) ;
+
+  // Simultaneous p.d.f with a second sample with a different width
+  RooRealVar sigma2("sigma2","sigma2",3,0.1,10) ;
+  RooGaussian gx2("gx2","gx2",x,mean,sigma2) ;
+  RooAddPdf model2("model2","model2",RooArgList(gx2,bkg),fsig) ;
+  RooCategory c("c","c") ;
+  c.defineType("A") ;
+  c.defineType("B") ;
+  RooSimultaneous simPdf("simPdf","simPdf",c) ;
+  simPdf.addPdf(model,"A") ;
+  simPdf.addPdf(model2,"B") ;
+
+  RooDataSet* data = model.generate(x,1000) ;
+  RooDataSet* data2 = model2.generate(x,1000) ;
+  RooDataSet combData("combData","combData",x,Index(c),Import("A",*data),Import("B",*data2)) ;
+
+  // P.d.f without analytical integral, its 2-dimensional normalization integral
+  // is also stored in the expensive object cache shared by the threads
+  RooRealVar y("y","y",-5,5) ;
+  RooRealVar a1("a1","a1",0.2,0.,1.) ;
+  RooGenericPdf genPdf("genPdf","genPdf","(1+a1*y*y)*exp(-0.5*(y*y+(x-mean)*(x-mean))/(sigma*sigma))",RooArgList(x,y,mean,sigma,a1)) ;
+  RooDataSet* genData = genPdf.generate(RooArgSet(x,y),500) ;
+
+
+  // C o m p a r e   - l o g ( L )   i n   o n e   a n d   i n   t h r e e   t h r e a d s 
+  // ---------------------------------------------------------------------------------------
+
+  RooArgSet* params = model.getParameters(*data) ;
+  RooArgSet* simParams = simPdf.getParameters(combData) ;
+
+  Bool_t ok = kTRUE ;
+  ok &= compareNLL(model,*data,*params,kFALSE) ;
+  ok &= compareNLL(model,*data,*params,kTRUE) ;
+  ok &= compareNLL(simPdf,combData,*simParams,kFALSE) ;
+
+  RooArgSet* genParams = genPdf.getParameters(*genData) ;
+  ok &= compareNLL(genPdf,*genData,*genParams,kFALSE) ;
+  ok &= compareNLL(genPdf,*genData,*genParams,kTRUE) ;
+
+
+  // C o m p a r e   f i t   r e s u l t s
+  // -------------------------------------
+
+  RooArgSet* initParams = (RooArgSet*) params->snapshot() ;
+  RooFitResult* r = model.fitTo(*data,Save(),PrintLevel(-1)) ;
+  *params = *initParams ;
+  RooFitResult* rThreads = model.fitTo(*data,Save(),PrintLevel(-1),NumThreads(2)) ;
+  if (!r->isIdentical(*rThreads,1e-6,1e-4)) {
+    cout << "TestBasic611: fit result differs in threads" << endl ;
+    ok = kFALSE ;
+  }
+
+  delete r ;
+  delete rThreads ;
+  delete initParams ;
+  delete params ;
+  delete simParams ;
+  delete genParams ;
+  delete data ;
+  delete data2 ;
+  delete genData ;
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// 'LIKELIHOOD AND MINIMIZATION' RooFit test #612
+// 
+// Incremental update of the constant term optimization of a likelihood
+// when the values or the constant state of parameters are changed between
+// fits: the value of -log(L) must be the same as the one of a likelihood
+// optimized from scratch
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooExponential.h"
+#include "RooAddPdf.h"
+#include "RooCategory.h"
+#include "RooSimultaneous.h"
+using namespace RooFit ;
+
+class TestBasic612 : public RooUnitTest
+{
+public: 
+  TestBasic612(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Incremental constant term optimization",refFile,writeRef,verbose) {} ;
+
+  Bool_t compareNLL(RooAbsReal& nll, RooAbsPdf& pdf, RooAbsData& data, RooAbsArg::ConstOpCode opcode, const char* step) {
+    // Update optimization of nll and compare its value with that of a new likelihood
+    nll.constOptimizeTestStatistic(opcode) ;
+    RooAbsReal* nllRef = pdf.createNLL(data) ;
+    nllRef->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+    Double_t val = nll.getVal() ;
+    Double_t valRef = nllRef->getVal() ;
+    delete nllRef ;
+    if (fabs(val-valRef)>1e-9*fabs(valRef)) {
+      cout << "TestBasic612: -log(L) after " << step << " differs from reference: " << val << " vs " << valRef << endl ;
+      return kFALSE ;
+    }
+    return kTRUE ;
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   s i m u l t a n e o u s   m o d e l   w i t h   t h r e e   c h a n n e l s
+  // -----------------------------------------------------------------------------------------
+
+  RooRealVar x("x","x",0,10) ;
+  RooRealVar mean("mean","mean",5,0,10) ;
+  RooRealVar fsig("fsig","fsig",0.5,0.,1.) ;
+  RooCategory c("c","c") ;
+  RooArgList owned ;
+  RooSimultaneous simPdf("simPdf","simPdf",c) ;
+  RooDataSet* combData = 0 ;
+  for (Int_t i=0 ; i<3 ; i++) {
+    const char* label = Form("ch%d",i) ;
+    c.defineType(label) ;
+    RooRealVar* sigma = new RooRealVar(Form("sigma%d",i),"sigma",0.5+0.5*i,0.1,5) ;
+    RooRealVar* tau = new RooRealVar(Form("tau%d",i),"tau",-0.1*(i+1),-2.,0.) ;
+    sigma->setConstant() ;
+    tau->setConstant() ;
+    RooGaussian* sig = new RooGaussian(Form("sig%d",i),"sig",x,mean,*sigma) ;
+    RooExponential* bkg = new RooExponential(Form("bkg%d",i),"bkg",x,*tau) ;
+    RooAddPdf* model = new RooAddPdf(Form("model%d",i),"model",RooArgList(*sig,*bkg),fsig) ;
+    owned.addOwned(RooArgSet(*sigma,*tau,*sig,*bkg,*model)) ;
+    simPdf.addPdf(*model,label) ;
+
+    RooDataSet* d = model->generate(x,500) ;
+    if (!combData) {
+      combData = new RooDataSet("combData","combData",x,Index(c),Import(label,*d)) ;
+    } else {
+      RooDataSet dc("dc","dc",x,Index(c),Import(label,*d)) ;
+      combData->append(dc) ;
+    }
+    delete d ;
+  }
+
+
+  // C h a n g e   c o n s t a n t   p a r a m e t e r s   a n d   c o m p a r e   - l o g ( L )
+  // -------------------------------------------------------------------------------------------
+
+  RooAbsReal* nll = simPdf.createNLL(*combData) ;
+  nll->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+  nll->getVal() ;
+
+  RooRealVar* sigma1 = (RooRealVar*) owned.find("sigma1") ;
+  RooRealVar* tau1 = (RooRealVar*) owned.find("tau1") ;
+  RooRealVar* tau2 = (RooRealVar*) owned.find("tau2") ;
+
+  Bool_t ok = kTRUE ;
+
+  // Values of constant parameters of one channel (precalculated and tracked terms)
+  sigma1->setVal(1.3) ;
+  tau1->setVal(-0.4) ;
+  ok &= compareNLL(*nll,simPdf,*combData,RooAbsArg::ValueChange,"change of value") ;
+
+  // Floating parameter made constant, without changing the cached terms
+  fsig.setConstant() ;
+  fsig.setVal(0.45) ;
+  ok &= compareNLL(*nll,simPdf,*combData,RooAbsArg::ConfigChange,"fixing parameter") ;
+
+  // Constant parameter made floating, the cached terms change
+  tau2->setConstant(kFALSE) ;
+  tau2->setVal(-0.5) ;
+  ok &= compareNLL(*nll,simPdf,*combData,RooAbsArg::ConfigChange,"releasing parameter") ;
+  mean.setConstant() ;
+  ok &= compareNLL(*nll,simPdf,*combData,RooAbsArg::ConfigChange,"fixing parameter") ;
+
+  delete nll ;
+  delete combData ;
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Analytical gradient of an extended likelihood with an external
+// constraint, compared with finite differences, and fit using it. The
+// gradient of each node must only be calculated for the parameters it
+// depends on, so that its cost does not grow with the number of parameters
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooExponential.h"
+#include "RooPolynomial.h"
+#include "RooFormulaVar.h"
+#include "RooProduct.h"
+#include "RooProdPdf.h"
+#include "RooAddPdf.h"
+#include "RooMinimizer.h"
+#include "TStopwatch.h"
+using namespace RooFit ;
+
+
+class TestBasic613 : public RooUnitTest
+{
+public: 
+  TestBasic613(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Analytical gradient of likelihood",refFile,writeRef,verbose) {} ;
+
+  Bool_t sparseGradient(Int_t nComp) {
+
+    // Extended likelihood of a sum of nComp Gaussians, each with its own mean, width and
+    // yield. The gradient index of each Gaussian must only contain its mean and width, 
+    // the one of the sum all the parameters
+
+    Bool_t ok = kTRUE ;
+    RooRealVar x("x","x",-10,10) ;
+    RooArgSet owned ;
+    RooArgList pdfs, yields ;
+    for (Int_t i=0 ; i<nComp ; i++) {
+      RooRealVar* mean = new RooRealVar(Form("mean%d",i),"mean",-8+16.*i/nComp,-10,10) ;
+      RooRealVar* sigma = new RooRealVar(Form("sigma%d",i),"sigma",1,0.1,5) ;
+      RooRealVar* nevt = new RooRealVar(Form("n%d",i),"n",2000./nComp,0,10000) ;
+      RooGaussian* g = new RooGaussian(Form("g%d",i),"g",x,*mean,*sigma) ;
+      pdfs.add(*g) ;
+      yields.add(*nevt) ;
+      owned.addOwned(RooArgSet(*mean,*sigma,*nevt,*g)) ;
+    }
+    RooAddPdf model("model","model",pdfs,yields) ;
+    RooDataSet* data = model.generate(x) ;
+    RooAbsReal* nll = model.createNLL(*data,Extended()) ;
+
+    RooArgSet* allParams = nll->getParameters(RooArgSet()) ;
+    RooArgList params(*allParams) ;
+    delete allParams ;
+    RooRealVar* mean0 = (RooRealVar*) params.find("mean0") ;
+
+    // Compare the derivatives w.r.t. the first mean and the last yield with finite differences
+    std::vector<Double_t> grad(params.getSize()) ;
+    if (!nll->getGradient(params,&grad[0])) {
+      cout << "TestBasic613: analytical gradient not available for " << nComp << " components" << endl ;
+      ok = kFALSE ;
+    }
+    TString lastYield(Form("n%d",nComp-1)) ;
+    const char* checked[2] = { "mean0", lastYield.Data() } ;
+    for (Int_t j=0 ; ok && j<2 ; j++) {
+      Int_t i = params.index(checked[j]) ;
+      RooRealVar* par = (RooRealVar*) params.at(i) ;
+      Double_t val = par->getVal() ;
+      Double_t h = 1e-4*(fabs(val)>1 ? fabs(val) : 1) ;
+      par->setVal(val+h) ;
+      Double_t up = nll->getVal() ;
+      par->setVal(val-h) ;
+      Double_t down = nll->getVal() ;
+      par->setVal(val) ;
+      Double_t num = (up-down)/(2*h) ;
+      if (fabs(grad[i]-num)>1e-4*(fabs(num)>1 ? fabs(num) : 1)) {
+	cout << "TestBasic613: derivative w.r.t. " << par->GetName() << " = " << grad[i] 
+	     << " differs from finite difference " << num << " for " << nComp << " components" << endl ;
+	ok = kFALSE ;
+      }
+    }
+
+    // Check the parameters for which the gradient of each node is calculated
+    if ((Int_t)model.gradientIndex(params).size()!=params.getSize()) {
+      cout << "TestBasic613: gradient index of the sum has " << model.gradientIndex(params).size() 
+	   << " parameters instead of " << params.getSize() << endl ;
+      ok = kFALSE ;
+    }
+    for (Int_t i=0 ; ok && i<nComp ; i++) {
+      const std::vector<Int_t>& index = ((RooAbsReal*)pdfs.at(i))->gradientIndex(params) ;
+      Int_t iMean = params.index(Form("mean%d",i)) ;
+      Int_t iSigma = params.index(Form("sigma%d",i)) ;
+      if (index.size()!=2 || index[0]!=(iMean<iSigma?iMean:iSigma) || index[1]!=(iMean<iSigma?iSigma:iMean)) {
+	cout << "TestBasic613: gradient index of " << pdfs.at(i)->GetName() << " has " << index.size() 
+	     << " parameters instead of its mean and width" << endl ;
+	ok = kFALSE ;
+      }
+    }
+
+    // Time value and gradient for changing parameter values
+    if (_verb>0) {
+      const Int_t nIter = 20 ;
+      Double_t m0 = mean0->getVal() ;
+      TStopwatch tVal ;
+      for (Int_t k=0 ; k<nIter ; k++) {
+	mean0->setVal(m0+1e-3*(k+1)) ;
+	nll->getVal() ;
+      }
+      tVal.Stop() ;
+      TStopwatch tGrad ;
+      for (Int_t k=0 ; k<nIter ; k++) {
+	mean0->setVal(m0-1e-3*(k+1)) ;
+	nll->getGradient(params,&grad[0]) ;
+      }
+      tGrad.Stop() ;
+      mean0->setVal(m0) ;
+      cout << "TestBasic613: " << params.getSize() << " parameters: value " << tVal.CpuTime()/nIter 
+	   << " s, gradient " << tGrad.CpuTime()/nIter << " s" << endl ;
+    }
+
+    delete nll ;
+    delete data ;
+    return ok ;
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   m o d e l
+  // ---------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar y("y","y",-5,5) ;
+
+  // Signal: Gaussian in x with mean m0+dm and width sigma0*scale, times Gaussian in y
+  RooRealVar m0("m0","m0",1,-5,5) ;
+  RooRealVar dm("dm","dm",0.5,-1.,1.) ;
+  RooFormulaVar mean("mean","m0+dm",RooArgList(m0,dm)) ;
+  RooRealVar sigma0("sigma0","sigma0",2,0.1,10) ;
+  RooRealVar scale("scale","scale",1,0.5,1.5) ;
+  RooProduct sigma("sigma","sigma",RooArgList(sigma0,scale)) ;
+  RooGaussian gx("gx","gx",x,mean,sigma) ;
+  RooRealVar sy("sy","sy",1.5,0.1,5) ;
+  RooGaussian gy("gy","gy",y,RooConst(0),sy) ;
+  RooProdPdf sig("sig","sig",RooArgList(gx,gy)) ;
+
+  // Background: exponential in x times polynomial in y
+  RooRealVar tau("tau","tau",-0.1,-1.,0.) ;
+  RooExponential ex("ex","ex",x,tau) ;
+  RooRealVar a1("a1","a1",0.05,-0.15,0.15) ;
+  RooPolynomial py("py","py",y,a1) ;
+  RooProdPdf bkg("bkg","bkg",RooArgList(ex,py)) ;
+
+  RooRealVar nsig("nsig","nsig",600,0.,2000.) ;
+  RooRealVar nbkg("nbkg","nbkg",400,0.,2000.) ;
+  RooAddPdf model("model","model",RooArgList(sig,bkg),RooArgList(nsig,nbkg)) ;
+
+  // Constraint on the scale factor, dm is fixed
+  RooGaussian cons("cons","cons",scale,RooConst(1),RooConst(0.1)) ;
+  dm.setConstant() ;
+
+  RooDataSet* data = model.generate(RooArgSet(x,y)) ;
+  RooAbsReal* nll = model.createNLL(*data,Extended(),ExternalConstraints(cons)) ;
+
+
+  // C o m p a r e   g r a d i e n t   w i t h   f i n i t e   d i f f e r e n c e s
+  // ---------------------------------------------------------------------------------
+
+  m0.setVal(1.3) ; sigma0.setVal(2.2) ; scale.setVal(0.9) ; sy.setVal(1.4) ;
+  tau.setVal(-0.15) ; a1.setVal(0.02) ; nsig.setVal(550) ; nbkg.setVal(480) ;
+
+  RooArgSet* allParams = nll->getParameters(RooArgSet()) ;
+  RooArgList params ;
+  params.add(*allParams->selectByAttrib("Constant",kFALSE),kTRUE) ;
+  delete allParams ;
+
+  Bool_t ok = kTRUE ;
+  std::vector<Double_t> grad(params.getSize()) ;
+  if (!nll->getGradient(params,&grad[0])) {
+    cout << "TestBasic613: analytical gradient not available" << endl ;
+    ok = kFALSE ;
+  }
+  for (Int_t i=0 ; ok && i<params.getSize() ; i++) {
+    RooRealVar* par = (RooRealVar*) params.at(i) ;
+    Double_t val = par->getVal() ;
+    Double_t h = 1e-4*(fabs(val)>1 ? fabs(val) : 1) ;
+    par->setVal(val+h) ;
+    Double_t up = nll->getVal() ;
+    par->setVal(val-h) ;
+    Double_t down = nll->getVal() ;
+    par->setVal(val) ;
+    Double_t num = (up-down)/(2*h) ;
+    if (fabs(grad[i]-num)>1e-4*(fabs(num)>1 ? fabs(num) : 1)) {
+      cout << "TestBasic613: derivative w.r.t. " << par->GetName() << " = " << grad[i] 
+	   << " differs from finite difference " << num << endl ;
+      ok = kFALSE ;
+    }
+  }
+
+#ifndef __ROOFIT_NOROOMINIMIZER
+
+  // F i t   w i t h   a n d   w i t h o u t   g r a d i e n t
+  // -----------------------------------------------------------
+
+  RooArgSet* snap = (RooArgSet*) params.snapshot() ;
+
+  RooMinimizer m1(*nll) ;
+  m1.setMinimizerType("Minuit2") ;
+  m1.setPrintLevel(-1) ;
+  m1.migrad() ;
+  m1.hesse() ;
+  RooFitResult* r1 = m1.save() ;
+
+  params = *snap ;
+  RooMinimizer m2(*nll) ;
+  m2.setMinimizerType("Minuit2") ;
+  m2.setPrintLevel(-1) ;
+  m2.setUseGradient() ;
+  m2.migrad() ;
+  m2.hesse() ;
+  RooFitResult* r2 = m2.save() ;
+
+  if (r1->status()!=0 || r2->status()!=0) {
+    cout << "TestBasic613: fit status " << r1->status() << " (numerical gradient), " << r2->status() << " (analytical gradient)" << endl ;
+    ok = kFALSE ;
+  }
+  for (Int_t i=0 ; i<r1->floatParsFinal().getSize() ; i++) {
+    RooRealVar* p1 = (RooRealVar*) r1->floatParsFinal().at(i) ;
+    RooRealVar* p2 = (RooRealVar*) r2->floatParsFinal().find(p1->GetName()) ;
+    if (!p2 || fabs(p1->getVal()-p2->getVal())>1e-2*p1->getError() || fabs(p1->getError()-p2->getError())>1e-2*p1->getError()) {
+      cout << "TestBasic613: fitted parameter " << p1->GetName() << " differs: " << p1->getVal() << " +/- " << p1->getError() ;
+      if (p2) cout << " vs " << p2->getVal() << " +/- " << p2->getError() ;
+      cout << endl ;
+      ok = kFALSE ;
+    }
+  }
+
+  delete r1 ;
+  delete r2 ;
+  delete snap ;
+
+#endif
+
+  delete nll ;
+  delete data ;
+
+
+  // S c a l i n g   w i t h   t h e   n u m b e r   o f   p a r a m e t e r s
+  // -------------------------------------------------------------------------
+
+  // The relative cost of the gradient grows with the number of parameters if the
+  // gradients of all nodes are calculated and added for all parameters
+  ok &= sparseGradient(8) ;
+  ok &= sparseGradient(64) ;
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Toy study run in forked worker processes: the merged fit results 
+// do not depend on the number of workers
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooMCStudy.h"
+#include "RooRandom.h"
+#include <algorithm>
+#include <vector>
+using namespace RooFit ;
+
+
+class TestBasic614 : public RooUnitTest
+{
+public: 
+  TestBasic614(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Toy study in parallel workers",refFile,writeRef,verbose) {} ;
+
+  void fittedValues(const RooDataSet& data, const char* name, std::vector<Double_t>& vals) {
+    // Return list of values of fitted parameter in study results, in the order of the samples
+    vals.clear() ;
+    for (Int_t i=0 ; i<data.numEntries() ; i++) {
+      vals.push_back(data.get(i)->getRealValue(name)) ;
+    }
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   m o d e l   a n d   s t u d y
+  // -----------------------------------------
+
+  RooRealVar x("x","x",-10,10) ;
+  RooRealVar mean("mean","mean",1,-5,5) ;
+  RooRealVar sigma("sigma","sigma",2,0.1,10) ;
+  RooGaussian gauss("gauss","gauss",x,mean,sigma) ;
+
+  RooMCStudy mcs(gauss,x,Silence()) ;
+
+
+  // R u n   s t u d y   w i t h   o n e   a n d   t h r e e   w o r k e r s
+  // -----------------------------------------------------------------------
+
+  // Each toy has its own seed derived from the state of RooRandom at the start of the study,
+  // the results must be the same and in the same order
+  const Int_t nToys = 10 ;
+  RooRandom::randomGenerator()->SetSeed(614) ;
+  mcs.generateAndFitParallel(nToys,500,1) ;
+  std::vector<Double_t> mean1, sigma1 ;
+  fittedValues(mcs.fitParDataSet(),"mean",mean1) ;
+  fittedValues(mcs.fitParDataSet(),"sigma",sigma1) ;
+
+  RooRandom::randomGenerator()->SetSeed(614) ;
+  Bool_t error = mcs.generateAndFitParallel(nToys,500,3) ;
+  std::vector<Double_t> mean3, sigma3 ;
+  fittedValues(mcs.fitParDataSet(),"mean",mean3) ;
+  fittedValues(mcs.fitParDataSet(),"sigma",sigma3) ;
+
+
+  // C o m p a r e   r e s u l t s
+  // -----------------------------
+
+  if (error || mean1.size()!=UInt_t(nToys) || mean3.size()!=UInt_t(nToys)) {
+    cout << "TestBasic614: number of fit results differ: " << mean1.size() << " vs " << mean3.size() << endl ;
+    return kFALSE ;
+  }
+
+  Bool_t ok(kTRUE) ;
+  for (Int_t i=0 ; i<nToys ; i++) {
+    if (fabs(mean1[i]-mean3[i])>1e-6 || fabs(sigma1[i]-sigma3[i])>1e-6) {
+      cout << "TestBasic614: fit result " << i << " differs: mean " << mean1[i] << " vs " << mean3[i] 
+	   << ", sigma " << sigma1[i] << " vs " << sigma3[i] << endl ;
+      ok = kFALSE ;
+    }
+  }
+
+  // The samples of different toys must differ
+  if (mean1[0]==mean1[nToys-1]) {
+    cout << "TestBasic614: all toys have the same fit result" << endl ;
+    ok = kFALSE ;
+  }
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Accept/reject generation with batch evaluation of the trial samples
+// gives the same events as the evaluation one by one
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooPolynomial.h"
+#include "RooNumGenConfig.h"
+#include "RooRandom.h"
+using namespace RooFit ;
+
+
+class TestBasic615 : public RooUnitTest
+{
+public: 
+  TestBasic615(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Batched accept/reject generation",refFile,writeRef,verbose) {} ;
+
+  RooDataSet* generate(RooAbsPdf& pdf, const RooArgSet& obs, Int_t nEvt, Double_t batchSize) {
+    // Generate nEvt events with given batch size of the accept/reject sampler
+    RooArgSet& config = RooNumGenConfig::defaultConfig().getConfigSection("RooAcceptReject") ;
+    Double_t oldSize = config.getRealValue("batchSize") ;
+    config.setRealValue("batchSize",batchSize) ;
+    RooRandom::randomGenerator()->SetSeed(615) ;
+    RooDataSet* data = pdf.generate(obs,nEvt) ;
+    config.setRealValue("batchSize",oldSize) ;
+    return data ;
+  }
+
+  Bool_t sameData(const RooDataSet& d1, const RooDataSet& d2, const char* what) {
+    // Compare events of two datasets
+    if (d1.numEntries()!=d2.numEntries()) {
+      cout << "TestBasic615: number of " << what << " events differs: " << d1.numEntries() << " vs " << d2.numEntries() << endl ;
+      return kFALSE ;
+    }
+    for (Int_t i=0 ; i<d1.numEntries() ; i++) {
+      const RooArgSet* ev1 = d1.get(i) ;
+      Double_t x1 = ev1->getRealValue("x"), y1 = ev1->getRealValue("y") ;
+      const RooArgSet* ev2 = d2.get(i) ;
+      if (x1!=ev2->getRealValue("x") || y1!=ev2->getRealValue("y")) {
+	cout << "TestBasic615: " << what << " event " << i << " differs" << endl ;
+	return kFALSE ;
+      }
+    }
+    return kTRUE ;
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   m o d e l s   w i t h o u t   i n t e r n a l   g e n e r a t o r
+  // -----------------------------------------------------------------------------
+
+  RooRealVar x("x","x",-5,5) ;
+  RooRealVar y("y","y",-2,2) ;
+
+  // Polynomial in x
+  RooRealVar a1("a1","a1",0.1,-1.,1.) ;
+  RooRealVar a2("a2","a2",0.02,-1.,1.) ;
+  RooPolynomial poly("poly","poly",x,RooArgList(a1,a2)) ;
+
+  // Gaussian in x with y as mean: sampled in (x,y)
+  RooRealVar sigma("sigma","sigma",1.5,0.1,10) ;
+  RooGaussian gxy("gxy","gxy",x,y,sigma) ;
+
+
+  // G e n e r a t e   w i t h   a n d   w i t h o u t   b a t c h e s
+  // -----------------------------------------------------------------
+
+  RooDataSet* p1 = generate(poly,x,5000,1) ;
+  RooDataSet* pb = generate(poly,x,5000,1024) ;
+  RooDataSet* g1 = generate(gxy,RooArgSet(x,y),5000,1) ;
+  RooDataSet* gb = generate(gxy,RooArgSet(x,y),5000,100) ;
+
+  Bool_t ok = sameData(*p1,*pb,"polynomial") && sameData(*g1,*gb,"gaussian") ;
+
+  delete p1 ;
+  delete pb ;
+  delete g1 ;
+  delete gb ;
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Import, writing and reading of a workspace with a large binned model 
+// of the HistFactory type (one Poisson term and one constraint per bin).
+// With verbose output the times of the three steps are printed
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooConstVar.h"
+#include "RooGaussian.h"
+#include "RooPoisson.h"
+#include "RooProduct.h"
+#include "RooProdPdf.h"
+#include "RooWorkspace.h"
+#include "TMemFile.h"
+#include "TStopwatch.h"
+using namespace RooFit ;
+
+
+class TestBasic616 : public RooUnitTest
+{
+public: 
+  TestBasic616(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Persistence of large workspace",refFile,writeRef,verbose) {} ;
+
+  Int_t numClients(const RooAbsArg& arg) {
+    // Return number of clients of arg
+    Int_t n(0) ;
+    TIterator* iter = arg.clientIterator() ;
+    while(iter->Next()) n++ ;
+    delete iter ;
+    return n ;
+  }
+
+  Bool_t testCode() {
+
+  // B u i l d   m o d e l   w i t h   n B i n s   c h a n n e l   b i n s
+  // ---------------------------------------------------------------------
+
+  // Expected events in bin i: mu*lumi*gamma_i*nominal_i, with a Gaussian constraint on gamma_i
+  const Int_t nBins = 2000 ;
+  RooRealVar mu("mu","mu",1,0,10) ;
+  RooRealVar lumi("lumi","lumi",1,0.5,1.5) ;
+  RooConstVar one("one","one",1) ;
+  RooConstVar gsig("gsig","gsig",0.1) ;
+
+  RooArgSet owned ;
+  RooArgList terms ;
+  for (Int_t i=0 ; i<nBins ; i++) {
+    RooRealVar* n = new RooRealVar(Form("n_%d",i),"n",100+i%50,0,1000) ;
+    RooRealVar* gamma = new RooRealVar(Form("gamma_%d",i),"gamma",1+0.001*(i%20),0,2) ;
+    RooConstVar* nominal = new RooConstVar(Form("nominal_%d",i),"nominal",100+i%37) ;
+    RooProduct* nu = new RooProduct(Form("nu_%d",i),"nu",RooArgList(mu,lumi,*gamma,*nominal)) ;
+    RooPoisson* pois = new RooPoisson(Form("pois_%d",i),"pois",*n,*nu) ;
+    RooGaussian* cons = new RooGaussian(Form("cons_%d",i),"cons",*gamma,one,gsig) ;
+    owned.addOwned(RooArgSet(*n,*gamma,*nominal,*nu,*pois,*cons)) ;
+    terms.add(RooArgSet(*pois,*cons)) ;
+  }
+  RooProdPdf model("model","model",terms) ;
+
+
+  // I m p o r t ,   w r i t e   a n d   r e a d   w o r k s p a c e
+  // ----------------------------------------------------------------
+
+  TStopwatch timer ;
+  RooWorkspace* w = new RooWorkspace("w") ;
+  w->import(model,Silence()) ;
+  Double_t tImport = timer.RealTime() ;
+
+  timer.Start() ;
+  TMemFile f("stressRooFit_616.root","RECREATE") ;
+  w->Write() ;
+  Double_t tWrite = timer.RealTime() ;
+
+  timer.Start() ;
+  RooWorkspace* w2 = (RooWorkspace*) f.Get("w") ;
+  Double_t tRead = timer.RealTime() ;
+
+  if (_verb>0) {
+    cout << "TestBasic616: workspace with " << w->components().getSize() << " nodes: import " << tImport 
+	 << " s, write " << tWrite << " s, read " << tRead << " s" << endl ;
+  }
+
+
+  // C o m p a r e   w o r k s p a c e s
+  // ------------------------------------
+
+  Bool_t ok(kTRUE) ;
+  if (!w2 || w2->components().getSize()!=w->components().getSize()) {
+    cout << "TestBasic616: number of nodes in workspace read back differs" << endl ;
+    ok = kFALSE ;
+  } else {
+    if (numClients(*w2->var("mu"))!=nBins || numClients(*w2->var("mu"))!=numClients(*w->var("mu"))) {
+      cout << "TestBasic616: number of clients of mu differs: " << numClients(*w2->var("mu")) << " vs " << numClients(*w->var("mu")) << endl ;
+      ok = kFALSE ;
+    }
+    w2->var("mu")->setVal(1.2) ;
+    w->var("mu")->setVal(1.2) ;
+    for (Int_t i=0 ; i<nBins && ok ; i++) {
+      Double_t v1 = w->pdf(Form("pois_%d",i))->getVal() * w->pdf(Form("cons_%d",i))->getVal() ;
+      Double_t v2 = w2->pdf(Form("pois_%d",i))->getVal() * w2->pdf(Form("cons_%d",i))->getVal() ;
+      if (v1!=v2) {
+	cout << "TestBasic616: value of terms of bin " << i << " differs: " << v1 << " vs " << v2 << endl ;
+	ok = kFALSE ;
+      }
+    }
+  }
+
+  delete w2 ;
+  delete w ;
+
+  return ok ;
+  }
+} ;
+
+
+
+//////////////////////////////////////////////////////////////////////////
+//
+// Lookups by name in collections of 10^3 to 10^5 elements, which are
+// indexed by a hash table above RooAbsCollection::defaultHashThreshold(),
+// compared to the linear search. Also checks that lookups remain correct
+// after elements have been removed or renamed, and that getParameters() 
+// and getObservables() work on a function with many servers. With verbose
+// output the times of the lookups are printed
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooArgSet.h"
+#include "RooArgList.h"
+#include "RooAddition.h"
+#include "TStopwatch.h"
+using namespace RooFit ;
+
+
+class TestBasic617 : public RooUnitTest
+{
+public: 
+  TestBasic617(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Lookups in large collections",refFile,writeRef,verbose) {} ;
+
+  Bool_t testLookups(Int_t nElem, Bool_t hashed) {
+    // Fill set with nElem variables and look each of them up by name and by object
+
+    Int_t oldThresh = RooAbsCollection::defaultHashThreshold() ;
+    if (!hashed) RooAbsCollection::setDefaultHashThreshold(0) ;
+
+    RooArgSet vars ;
+    for (Int_t i=0 ; i<nElem ; i++) {
+      vars.addOwned(*new RooRealVar(Form("x_%d",i),"x",i)) ;
+    }
+    RooArgSet probe ;
+    for (Int_t i=0 ; i<nElem ; i+=2) {
+      probe.addOwned(*new RooRealVar(Form("x_%d",i),"x",0)) ;
+    }
+    RooAbsCollection::setDefaultHashThreshold(oldThresh) ;
+
+    Bool_t ok(kTRUE) ;
+    TStopwatch timer ;
+    for (Int_t i=0 ; i<nElem ; i++) {
+      RooRealVar* x = (RooRealVar*) vars.find(Form("x_%d",i)) ;
+      if (!x || x->getVal()!=i) ok = kFALSE ;
+    }
+    if (vars.find("y_0")) ok = kFALSE ;
+    Double_t tFind = timer.RealTime() ;
+
+    timer.Start() ;
+    Int_t nCont(0) ;
+    RooFIter iter = probe.fwdIterator() ;
+    RooAbsArg* arg ;
+    while((arg=iter.next())) {
+      if (vars.contains(*arg)) nCont++ ;
+    }
+    Double_t tContains = timer.RealTime() ;
+    if (nCont!=probe.getSize()) ok = kFALSE ;
+
+    if (_verb>0) {
+      cout << "TestBasic617: " << nElem << " elements, " << (hashed?"hashed":"linear") << " lookup: find " << tFind 
+	   << " s, contains " << tContains << " s" << endl ;
+    }
+    if (!ok) {
+      cout << "TestBasic617: lookup in set of " << nElem << " elements failed" << endl ;
+    }
+    return ok ;
+  }
+
+  Bool_t testCode() {
+
+  // C o m p a r e   h a s h e d   a n d   l i n e a r   l o o k u p s
+  // ------------------------------------------------------------------
+
+  Bool_t ok(kTRUE) ;
+  ok &= testLookups(1000,kFALSE) ;
+  ok &= testLookups(1000,kTRUE) ;
+  ok &= testLookups(10000,kFALSE) ;
+  ok &= testLookups(10000,kTRUE) ;
+  ok &= testLookups(100000,kTRUE) ;
+
+
+  // R e m o v e   a n d   r e n a m e   e l e m e n t s   o f   l a r g e   s e t
+  // ----------------------------------------------------------------------------
+
+  const Int_t nElem = 10000 ;
+  RooArgList vars ;
+  RooArgSet all ;
+  for (Int_t i=0 ; i<nElem ; i++) {
+    RooRealVar* x = new RooRealVar(Form("x_%d",i),"x",i) ;
+    vars.addOwned(*x) ;
+    all.add(*x) ;
+  }
+  if (all.getHashTableSize()==0) {
+    cout << "TestBasic617: no hash table created for set of " << nElem << " elements" << endl ;
+    ok = kFALSE ;
+  }
+
+  for (Int_t i=0 ; i<nElem ; i+=2) {
+    all.remove(*vars.at(i)) ;
+  }
+  vars.at(1)->SetName("renamed") ;
+  for (Int_t i=0 ; i<nElem ; i++) {
+    RooAbsArg* x = all.find(Form("x_%d",i)) ;
+    if ((i%2==0 || i==1) ? x!=0 : x!=vars.at(i)) {
+      cout << "TestBasic617: wrong result of lookup of x_" << i << " after removal and renaming" << endl ;
+      ok = kFALSE ;
+      break ;
+    }
+  }
+  if (all.find("renamed")!=vars.at(1) || !all.contains(*vars.at(1))) {
+    cout << "TestBasic617: renamed element not found" << endl ;
+    ok = kFALSE ;
+  }
+
+  // Renames interleaved with lookups, as in RooWorkspace::import(), only
+  // move the renamed element in the hash tables. Collections deleted before 
+  // the renaming are no longer updated
+  RooArgSet* tmp = new RooArgSet(all) ;
+  delete tmp ;
+  TStopwatch timerRename ;
+  for (Int_t i=3 ; i<nElem ; i+=4) {
+    vars.at(i)->SetName(Form("y_%d",i)) ;
+    if (all.find(Form("y_%d",i))!=vars.at(i) || all.find(Form("x_%d",i))!=0 || vars.find(Form("y_%d",i))!=vars.at(i)) {
+      cout << "TestBasic617: wrong result of lookup of y_" << i << " after renaming" << endl ;
+      ok = kFALSE ;
+      break ;
+    }
+  }
+  if (_verb>0) {
+    cout << "TestBasic617: " << nElem/4 << " renames with lookups: " << timerRename.RealTime() << " s" << endl ;
+  }
+  for (Int_t i=3 ; i<nElem ; i+=4) {
+    all.remove(*vars.at(i)) ;
+    if (all.contains(*vars.at(i))) {
+      cout << "TestBasic617: renamed element y_" << i << " not removed" << endl ;
+      ok = kFALSE ;
+      break ;
+    }
+  }
+
+  // A list can hold several elements of the same name: the first one is returned
+  RooRealVar dup("x_5","x",-1) ;
+  vars.add(dup,kTRUE) ;
+  if (vars.find("x_5")!=vars.at(5)) {
+    cout << "TestBasic617: lookup in list with duplicate names does not return first element" << endl ;
+    ok = kFALSE ;
+  }
+  vars.remove(dup) ;
+
+
+  // P a r a m e t e r s   a n d   o b s e r v a b l e s   o f   l a r g e   f u n c t i o n
+  // ----------------------------------------------------------------------------------------
+
+  RooAddition sum("sum","sum",vars) ;
+  RooArgSet obs ;
+  for (Int_t i=0 ; i<nElem ; i+=4) {
+    obs.add(*vars.at(i)) ;
+  }
+
+  TStopwatch timer ;
+  RooArgSet* params = sum.getParameters(obs) ;
+  RooArgSet* observables = sum.getObservables(obs) ;
+  Double_t tGet = timer.RealTime() ;
+  if (_verb>0) {
+    cout << "TestBasic617: getParameters and getObservables of function with " << nElem << " servers: " << tGet << " s" << endl ;
+  }
+
+  if (params->getSize()!=nElem-obs.getSize() || observables->getSize()!=obs.getSize() || params->overlaps(*observables)) {
+    cout << "TestBasic617: wrong number of parameters (" << params->getSize() << ") or observables (" 
+	 << observables->getSize() << ")" << endl ;
+    ok = kFALSE ;
+  }
+  delete params ;
+  delete observables ;
+
+  return ok ;
+  }
+} ;
+
+
+
+/////////////////////////////////////////////////////////////////////////
+//
+// Incremental update of the cache of an FFT convolution: after a change
+// of the parameters of only one of the input p.d.f.s, the cached FFT of 
+// the other input is reused. With openMP (USE_OPENMP) the slices of the
+// convolution with per-event errors are calculated in two threads
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooGaussian.h"
+#include "RooLandau.h"
+#include "RooProduct.h"
+#include "RooFFTConvPdf.h"
+#include "TPluginManager.h"
+#include "TROOT.h"
+using namespace RooFit ;
+
+
+class TestBasic618 : public RooUnitTest
+{
+public: 
+  TestBasic618(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("FFT convolution with cached transforms",refFile,writeRef,verbose) {} ;
+
+  Bool_t isTestAvailable() { 
+
+    TPluginHandler *h;
+    if ((h = gROOT->GetPluginManager()->FindHandler("TVirtualFFT"))) {
+      if (h->LoadPlugin() == -1) {
+	gROOT->ProcessLine("new TNamed ;") ;
+	return kFALSE;
+      } else {
+	return kTRUE ;
+      }
+    }
+    return kFALSE ;
+  }
+
+  Bool_t compare(const char* label, RooAbsPdf& cached, RooAbsPdf& fresh, RooRealVar& t, RooRealVar* dt) {
+    // Compare values of the updated convolution with those of a convolution with an empty cache
+    
+    Bool_t ok(kTRUE) ;
+    RooArgSet nset(t) ;
+    for (Int_t i=0 ; i<10 ; i++) {
+      t.setVal(-8+3.5*i) ;
+      if (dt) dt->setVal(0.5+0.2*i) ;
+      Double_t v1 = cached.getVal(nset) ;
+      Double_t v2 = fresh.getVal(nset) ;
+      if (TMath::Abs(v1-v2)>1e-9*TMath::Abs(v2)) {
+	cout << "TestBasic618: " << label << ": value at t=" << t.getVal() << " is " << v1 << ", should be " << v2 << endl ;
+	ok = kFALSE ;
+      }
+    }
+    return ok ;
+  }
+
+  Bool_t testCode() {
+
+  // C o n v o l u t i o n   i n   o n e   o b s e r v a b l e
+  // ----------------------------------------------------------
+
+  RooRealVar t("t","t",-10,30) ;
+  t.setBins(2000,"cache") ;
+  RooRealVar ml("ml","mean landau",5.,-20,20) ;
+  RooRealVar sl("sl","sigma landau",1,0.1,10) ;
+  RooLandau landau("lx","lx",t,ml,sl) ;
+  RooRealVar mg("mg","mg",0) ;
+  RooRealVar sg("sg","sg",2,0.1,10) ;
+  RooGaussian gauss("gauss","gauss",t,mg,sg) ;
+
+  RooFFTConvPdf lxg("lxg","landau (X) gauss",t,landau,gauss) ;
+  lxg.getVal(RooArgSet(t)) ;
+
+  Bool_t ok(kTRUE) ;
+
+  // Change only the resolution, only the physics and both
+  sg.setVal(1.5) ;
+  RooFFTConvPdf lxg1("lxg1","landau (X) gauss",t,landau,gauss) ;
+  ok &= compare("resolution changed",lxg,lxg1,t,0) ;
+
+  ml.setVal(7) ;
+  RooFFTConvPdf lxg2("lxg2","landau (X) gauss",t,landau,gauss) ;
+  ok &= compare("physics changed",lxg,lxg2,t,0) ;
+
+  sl.setVal(1.3) ;
+  sg.setVal(2.5) ;
+  RooFFTConvPdf lxg3("lxg3","landau (X) gauss",t,landau,gauss) ;
+  ok &= compare("both changed",lxg,lxg3,t,0) ;
+
+  // Change the shifts and then only the resolution: the cached transform of the 
+  // landau must not be reused with the old shift
+  lxg.setShift(0.5,10.5) ;
+  lxg.getVal(RooArgSet(t)) ;
+  sg.setVal(2.2) ;
+  RooFFTConvPdf lxg4("lxg4","landau (X) gauss",t,landau,gauss) ;
+  lxg4.setShift(0.5,10.5) ;
+  ok &= compare("shifts changed",lxg,lxg4,t,0) ;
+
+
+  // C o n v o l u t i o n   w i t h   p e r - e v e n t   e r r o r s
+  // ------------------------------------------------------------------
+
+  // Resolution depends on the conditional observable dt, the landau does not
+  RooRealVar dt("dt","per-event error",0.5,2.5) ;
+  dt.setBins(10,"cache") ;
+  RooProduct sgdt("sgdt","sg*dt",RooArgList(sg,dt)) ;
+  RooGaussian gaussdt("gaussdt","gaussdt",t,mg,sgdt) ;
+
+  RooFFTConvPdf lxgdt("lxgdt","landau (X) gauss(dt)",t,landau,gaussdt) ;
+  lxgdt.setCacheObservables(dt) ;
+#ifdef _OPENMP
+  // The slices are calculated in threads if RooFitCore is built with openMP as well
+  lxgdt.setNumThreads(2) ;
+#endif
+  lxgdt.getVal(RooArgSet(t)) ;
+
+  sg.setVal(1.2) ;
+  RooFFTConvPdf lxgdt1("lxgdt1","landau (X) gauss(dt)",t,landau,gaussdt) ;
+  lxgdt1.setCacheObservables(dt) ;
+  ok &= compare("resolution changed, sliced",lxgdt,lxgdt1,t,&dt) ;
+
+  ml.setVal(4) ;
+  RooFFTConvPdf lxgdt2("lxgdt2","landau (X) gauss(dt)",t,landau,gaussdt) ;
+  lxgdt2.setCacheObservables(dt) ;
+  ok &= compare("physics changed, sliced",lxgdt,lxgdt2,t,&dt) ;
+
+  return ok ;
+  }
+} ;
+
+
+
 //////////////////////////////////////////////////////////////////////////
 //
 // 'SPECIAL PDFS' RooFit tutorial macro #701
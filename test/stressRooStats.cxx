@@ -190,6 +190,9 @@ Int_t stressRooStats(const char* refFile, Bool_t writeRef, Int_t verbose, Bool_t
    testList.push_back(new TestHypoTestInverter2(fref, writeRef, verbose, kFrequentist, kRatioLR));
    testList.push_back(new TestHypoTestInverter2(fref, writeRef, verbose, kFrequentist, kProfileLROneSided));
    testList.push_back(new TestHypoTestInverter2(fref, writeRef, verbose, kHybrid, kSimpleLR));
+
+   // TEST HISTFACTORY FAST LIKELIHOOD : HistFactoryNLL against the generic -log(L) of a two channel model
+   testList.push_back(new TestHistFactoryNLL(fref, writeRef, verbose));
  
    
    TString suiteType = TString::Format(" Starting S.T.R.E.S.S. %s",
@@ -1707,6 +1707,288 @@ public:
 
 
 
+//_____________________________________________________________________________
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+//
+// PART SIX:
+//    HISTFACTORY LIKELIHOOD UNIT TESTS
+//
+
+#include "TH1D.h"
+#include "TStopwatch.h"
+#include "RooCategory.h"
+#include "RooDataHist.h"
+#include "RooHistFunc.h"
+#include "RooProduct.h"
+#include "RooFormulaVar.h"
+#include "RooRealSumPdf.h"
+#include "RooGaussian.h"
+#include "RooProdPdf.h"
+#include "RooSimultaneous.h"
+#include "RooNumIntConfig.h"
+#include "RooMinuit.h"
+#include "RooStats/HistFactory/PiecewiseInterpolation.h"
+#include "RooStats/HistFactory/FlexibleInterpVar.h"
+#include "RooStats/HistFactory/ParamHistFunc.h"
+#include "RooStats/HistFactory/HistFactoryNLL.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// HISTFACTORY FAST LIKELIHOOD - TWO CHANNEL MODEL
+//
+// Compare the -log(L) computed by HistFactoryNLL on the flattened model with
+// the one computed by the generic RooFit path (RooAbsPdf::createNLL) for a
+// two channel model built in the same way as HistToWorkspaceFactoryFast does:
+// RooRealSumPdf of RooProducts of RooHistFunc, PiecewiseInterpolation,
+// FlexibleInterpVar and ParamHistFunc nodes, with Gaussian constraints. The
+// values at several parameter points and the fitted signal strength must
+// agree.
+//
+// Input Parameters:
+//    none
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+class TestHistFactoryNLL : public RooUnitTest {
+public:
+   TestHistFactoryNLL(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("HistFactory - Fast Likelihood", refFile, writeRef, verbose) {};
+
+   // Build the p.d.f. of a single channel, the signal sample is optional
+   RooAbsPdf* buildChannel(const char* name, const Double_t* sig, const Double_t* bkg, Bool_t statError, Bool_t slope,
+                           RooArgSet& owned, TList& hists, RooArgSet& params) {
+
+      const Int_t nBins = 5;
+      RooRealVar* x = new RooRealVar(Form("obs_x_%s", name), "x", 0, 10);
+      x->setBins(nBins);
+      owned.addOwned(*x);
+
+      TH1D hSig("hSig", "hSig", nBins, 0, 10), hBkg("hBkg", "hBkg", nBins, 0, 10);
+      TH1D hLow("hLow", "hLow", nBins, 0, 10), hHigh("hHigh", "hHigh", nBins, 0, 10);
+      for (Int_t i = 0; i < nBins; i++) {
+         hSig.SetBinContent(i + 1, sig ? sig[i] : 0);
+         hBkg.SetBinContent(i + 1, bkg[i]);
+         hLow.SetBinContent(i + 1, bkg[i] * (1 - 0.05 * (i - 2)));
+         hHigh.SetBinContent(i + 1, bkg[i] * (1 + 0.08 * (i - 2)));
+      }
+      RooDataHist* dhSig = new RooDataHist(Form("%s_signal_hist", name), "", RooArgList(*x), &hSig);
+      RooDataHist* dhBkg = new RooDataHist(Form("%s_background_hist", name), "", RooArgList(*x), &hBkg);
+      RooDataHist* dhLow = new RooDataHist(Form("%s_background_low", name), "", RooArgList(*x), &hLow);
+      RooDataHist* dhHigh = new RooDataHist(Form("%s_background_high", name), "", RooArgList(*x), &hHigh);
+      hists.Add(dhSig); hists.Add(dhBkg); hists.Add(dhLow); hists.Add(dhHigh);
+
+      RooHistFunc* fSig = new RooHistFunc(Form("%s_signal_nominal", name), "", RooArgSet(*x), *dhSig);
+      RooHistFunc* fBkg = new RooHistFunc(Form("%s_background_nominal", name), "", RooArgSet(*x), *dhBkg);
+      RooHistFunc* fLow = new RooHistFunc(Form("%s_background_alpha_shape_low", name), "", RooArgSet(*x), *dhLow);
+      RooHistFunc* fHigh = new RooHistFunc(Form("%s_background_alpha_shape_high", name), "", RooArgSet(*x), *dhHigh);
+      owned.addOwned(RooArgSet(*fSig, *fBkg, *fLow, *fHigh));
+
+      RooRealVar& mu = (RooRealVar&) params["mu"];
+      RooRealVar& lumi = (RooRealVar&) params["Lumi"];
+      RooRealVar& alphaNorm = (RooRealVar&) params["alpha_norm"];
+      RooRealVar& alphaShape = (RooRealVar&) params["alpha_shape"];
+
+      std::vector<double> low(1, 0.9), high(1, 1.12);
+      RooStats::HistFactory::FlexibleInterpVar* fiv =
+         new RooStats::HistFactory::FlexibleInterpVar(Form("%s_signal_epsilon", name), "", RooArgList(alphaNorm), 1., low, high);
+      fiv->setAllInterpCodes(4);
+      PiecewiseInterpolation* interp = new PiecewiseInterpolation(Form("%s_background_Hist_alpha", name), "", *fBkg,
+                                                                   RooArgList(*fLow), RooArgList(*fHigh), RooArgList(alphaShape));
+      interp->setPositiveDefinite();
+      interp->setAllInterpCodes(4);
+      owned.addOwned(RooArgSet(*fiv, *interp));
+
+      RooArgList sigFactors(*fSig, mu, lumi, *fiv);
+      RooArgList bkgFactors(*interp, lumi);
+      if (statError) {
+         RooArgList gammas;
+         for (Int_t i = 0; i < nBins; i++) {
+            RooRealVar* gamma = new RooRealVar(Form("gamma_stat_%s_bin_%d", name, i), "", 1, 0, 2);
+            RooRealVar* sigma = new RooRealVar(Form("gamma_stat_%s_bin_%d_sigma", name, i), "", 0.1);
+            RooRealVar* nomGamma = new RooRealVar(Form("nom_gamma_stat_%s_bin_%d", name, i), "", 1);
+            RooGaussian* constr = new RooGaussian(Form("gamma_stat_%s_bin_%d_constraint", name, i), "", *nomGamma, *gamma, *sigma);
+            owned.addOwned(RooArgSet(*gamma, *sigma, *nomGamma, *constr));
+            gammas.add(*gamma);
+            params.add(*gamma);
+         }
+         ParamHistFunc* phf = new ParamHistFunc(Form("mc_stat_%s", name), "", RooArgList(*x), gammas);
+         owned.addOwned(*phf);
+         bkgFactors.add(*phf);
+      }
+      if (slope) {
+         // Factor depending on both a parameter and the observable, which is evaluated bin by bin
+         RooFormulaVar* f = new RooFormulaVar(Form("%s_background_slope", name), "1+slope*(@0-5)", RooArgList(*x, params["slope"]));
+         owned.addOwned(*f);
+         bkgFactors.add(*f);
+      }
+
+      RooArgList funcs, coefs;
+      if (sig) {
+         RooProduct* sigProd = new RooProduct(Form("L_x_signal_%s_overallSyst_x_Exp", name), "", sigFactors);
+         RooRealVar* sigCoef = new RooRealVar(Form("binWidth_obs_x_%s_0", name), "", 0.5);
+         owned.addOwned(RooArgSet(*sigProd, *sigCoef));
+         funcs.add(*sigProd);
+         coefs.add(*sigCoef);
+      }
+      RooProduct* bkgProd = new RooProduct(Form("L_x_background_%s_overallSyst_x_StatUncert", name), "", bkgFactors);
+      RooRealVar* bkgCoef = new RooRealVar(Form("binWidth_obs_x_%s_1", name), "", 0.5);
+      owned.addOwned(RooArgSet(*bkgProd, *bkgCoef));
+      funcs.add(*bkgProd);
+      coefs.add(*bkgCoef);
+
+      RooRealSumPdf* sumPdf = new RooRealSumPdf(Form("%s_model", name), "", funcs, coefs, kTRUE);
+      sumPdf->specialIntegratorConfig(kTRUE)->method1D().setLabel("RooBinIntegrator");
+      sumPdf->forceNumInt();
+      owned.addOwned(*sumPdf);
+
+      RooArgList terms(*sumPdf);
+      terms.add(*owned.find("alpha_normConstraint"));
+      terms.add(*owned.find("alpha_shapeConstraint"));
+      if (statError) {
+         for (Int_t i = 0; i < nBins; i++) terms.add(*owned.find(Form("gamma_stat_%s_bin_%d_constraint", name, i)));
+      }
+      RooProdPdf* model = new RooProdPdf(Form("model_%s", name), "", terms);
+      owned.addOwned(*model);
+
+      return model;
+   }
+
+   Bool_t testCode() {
+
+      const Int_t nBins = 5;
+      const Double_t sigA[nBins] = { 2., 6., 12., 6., 2. };
+      const Double_t bkgA[nBins] = { 30., 25., 20., 15., 10. };
+      const Double_t bkgB[nBins] = { 45., 32., 24., 18., 11. };
+      const Double_t obsA[nBins] = { 33., 31., 35., 22., 12. };
+      const Double_t obsB[nBins] = { 40., 34., 21., 19., 13. };
+
+      TList hists;
+      hists.SetOwner();
+      RooArgSet owned;
+      RooArgSet params;
+
+      RooRealVar* mu = new RooRealVar("mu", "mu", 1, -5, 10);
+      RooRealVar* lumi = new RooRealVar("Lumi", "Lumi", 1);
+      RooRealVar* slope = new RooRealVar("slope", "slope", 0.02);
+      RooRealVar* alphaNorm = new RooRealVar("alpha_norm", "alpha_norm", 0, -5, 5);
+      RooRealVar* alphaShape = new RooRealVar("alpha_shape", "alpha_shape", 0, -5, 5);
+      RooRealVar* nomAlphaNorm = new RooRealVar("nom_alpha_norm", "nom_alpha_norm", 0);
+      RooRealVar* nomAlphaShape = new RooRealVar("nom_alpha_shape", "nom_alpha_shape", 0);
+      RooRealVar* one = new RooRealVar("one", "one", 1);
+      RooGaussian* cNorm = new RooGaussian("alpha_normConstraint", "", *nomAlphaNorm, *alphaNorm, *one);
+      RooGaussian* cShape = new RooGaussian("alpha_shapeConstraint", "", *nomAlphaShape, *alphaShape, *one);
+      owned.addOwned(RooArgSet(*mu, *lumi, *slope, *alphaNorm, *alphaShape, *nomAlphaNorm, *nomAlphaShape, *one));
+      owned.addOwned(RooArgSet(*cNorm, *cShape));
+      params.add(RooArgSet(*mu, *lumi, *slope, *alphaNorm, *alphaShape));
+
+      RooAbsPdf* modelA = buildChannel("A", sigA, bkgA, kTRUE, kFALSE, owned, hists, params);
+      RooAbsPdf* modelB = buildChannel("B", 0, bkgB, kFALSE, kTRUE, owned, hists, params);
+
+      RooCategory* channelCat = new RooCategory("channelCat", "channelCat");
+      channelCat->defineType("A");
+      channelCat->defineType("B");
+      RooSimultaneous* simPdf = new RooSimultaneous("simPdf", "simPdf", *channelCat);
+      simPdf->addPdf(*modelA, "A");
+      simPdf->addPdf(*modelB, "B");
+      owned.addOwned(RooArgSet(*channelCat, *simPdf));
+
+      // Observed data as weighted entries at the bin centers
+      RooRealVar& xA = (RooRealVar&) owned["obs_x_A"];
+      RooRealVar& xB = (RooRealVar&) owned["obs_x_B"];
+      RooRealVar weightVar("weightVar", "weightVar", 0, 1000);
+      RooDataSet data("obsData", "obsData", RooArgSet(xA, xB, *channelCat, weightVar), WeightVar(weightVar));
+      for (Int_t i = 0; i < nBins; i++) {
+         xA.setVal(1 + 2 * i);
+         xB.setVal(1 + 2 * i);
+         channelCat->setLabel("A");
+         data.add(RooArgSet(xA, xB, *channelCat), obsA[i]);
+         channelCat->setLabel("B");
+         data.add(RooArgSet(xA, xB, *channelCat), obsB[i]);
+      }
+
+      RooArgSet constrained(*alphaNorm, *alphaShape);
+      for (Int_t i = 0; i < nBins; i++) constrained.add(params[Form("gamma_stat_A_bin_%d", i)]);
+
+      RooAbsReal* genericNll = simPdf->createNLL(data, Constrain(constrained));
+      RooAbsReal* fastNll = RooStats::HistFactory::HistFactoryNLL::createNLL(*simPdf, data, &constrained);
+
+      Bool_t ok = kTRUE;
+
+      // Check that the model was flattened: only the slope factor is evaluated bin by bin
+      RooStats::HistFactory::HistFactoryNLL flatNll("flatNll", "flatNll", *simPdf, data);
+      if (flatNll.numChannels() != 2 || flatNll.numBins() != 2 * nBins || flatNll.numGenericFactors() != 1) {
+         if (_verb >= 0) std::cout << "HistFactoryNLL: model not flattened as expected: channels = " << flatNll.numChannels()
+                                 << " bins = " << flatNll.numBins() << " generic factors = " << flatNll.numGenericFactors() << std::endl;
+         ok = kFALSE;
+      }
+
+      // Compare the values at several parameter points, including the extrapolation region of the interpolations
+      const Int_t nPoints = 4;
+      const Double_t muVals[nPoints] = { 1.0, 0.5, 2.0, 0.0 };
+      const Double_t normVals[nPoints] = { 0.0, 1.2, -1.5, 0.3 };
+      const Double_t shapeVals[nPoints] = { 0.0, -0.7, 1.8, -2.5 };
+      const Double_t gammaVals[nPoints] = { 1.0, 1.1, 0.9, 1.3 };
+      for (Int_t p = 0; p < nPoints; p++) {
+         mu->setVal(muVals[p]);
+         alphaNorm->setVal(normVals[p]);
+         alphaShape->setVal(shapeVals[p]);
+         ((RooRealVar&) params["gamma_stat_A_bin_2"]).setVal(gammaVals[p]);
+         Double_t vGeneric = genericNll->getVal();
+         Double_t vFast = fastNll->getVal();
+         if (_verb > 0) std::cout << "HistFactoryNLL: point " << p << " generic = " << vGeneric << " fast = " << vFast << std::endl;
+         if (TMath::Abs(vFast - vGeneric) > 1e-9 * TMath::Max(1., TMath::Abs(vGeneric))) {
+            if (_verb >= 0) std::cout << "HistFactoryNLL: value " << vFast << " differs from generic value " << vGeneric << std::endl;
+            ok = kFALSE;
+         }
+      }
+
+      // Compare the best fit signal strength
+      RooArgSet* allParams = simPdf->getParameters(data);
+      RooArgSet* init = (RooArgSet*) allParams->snapshot();
+      Double_t muHat[2];
+      Double_t fitTime[2];
+      for (Int_t k = 0; k < 2; k++) {
+         *allParams = *init;
+         TStopwatch timer;
+         RooMinuit m(k == 0 ? *genericNll : *fastNll);
+         m.setPrintLevel(-1);
+         m.setVerbose(kFALSE);
+         m.migrad();
+         muHat[k] = mu->getVal();
+         fitTime[k] = timer.RealTime();
+      }
+      if (_verb > 0) std::cout << "HistFactoryNLL: mu generic = " << muHat[0] << " (" << fitTime[0] << " s) fast = "
+                             << muHat[1] << " (" << fitTime[1] << " s)" << std::endl;
+      if (TMath::Abs(muHat[0] - muHat[1]) > 1e-4) {
+         if (_verb >= 0) std::cout << "HistFactoryNLL: fitted mu " << muHat[1] << " differs from generic fit " << muHat[0] << std::endl;
+         ok = kFALSE;
+      }
+
+      *allParams = *init;
+      delete init;
+      delete allParams;
+      delete fastNll;
+      delete genericNll;
+
+      return ok;
+   }
+};
+
+
+//
+// END OF PART SIX
+//
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+//_____________________________________________________________________________
+
+
+
+
+
+
+
 
 // Other tests currently not included in any suite
 
@@ -7,6 +7,7 @@
 //    ====================
 //
 // This stress program tests many elements of the TSpectrum, TSpectrum2 classes.
+// The deconvolution of TSpectrum2 is compared to a reference serial implementation.
 //
 // To run in batch, do
 //   stressSpectrum        : run 100 experiments with graphics (default)
@@ -247,6 +248,154 @@ void stress2(Int_t np2) {
    printf("Peak2 : found =%d/%d, good =%d, ghost =%2d,---------------------------- %s\n",
           nfound,npeaks,ngood,nghost,sok);
 }
+
+// reference serial implementation of the Gold deconvolution used by
+// TSpectrum2::Deconvolution (the response is assumed to be smaller than
+// half of the spectrum)
+void deconvolutionRef(Double_t **source, Double_t **resp, Int_t ssizex, Int_t ssizey,
+                      Int_t numberIterations, Int_t numberRepetitions, Double_t boost) {
+   Int_t i, j, i1, i2, j1, j2, lhx = -1, lhy = -1, positx = 0, posity = 0;
+   Double_t ldb, area = 0, maximum = 0;
+   for (i = 0; i < ssizex; i++) {
+      for (j = 0; j < ssizey; j++) {
+         if (resp[i][j] != 0) {
+            if (i + 1 > lhx) lhx = i + 1;
+            if (j + 1 > lhy) lhy = j + 1;
+         }
+         area += resp[i][j];
+         if (resp[i][j] > maximum) {
+            maximum = resp[i][j];
+            positx = i, posity = j;
+         }
+      }
+   }
+   Int_t nbx = 2*lhx - 1, nby = 2*lhy - 1;
+   Double_t *p  = new Double_t[ssizex*ssizey];
+   Double_t *x  = new Double_t[ssizex*ssizey];
+   Double_t *xn = new Double_t[ssizex*ssizey];
+   Double_t *b  = new Double_t[nbx*nby];
+   //ht*y
+   for (i2 = 0; i2 < ssizey; i2++) {
+      for (i1 = 0; i1 < ssizex; i1++) {
+         ldb = 0;
+         for (j2 = 0; j2 < lhy && i2 + j2 < ssizey; j2++) {
+            for (j1 = 0; j1 < lhx && i1 + j1 < ssizex; j1++)
+               ldb += resp[j1][j2] * source[i1 + j1][i2 + j2];
+         }
+         p[i1*ssizey + i2] = ldb;
+         x[i1*ssizey + i2] = 1;
+      }
+   }
+   //b=ht*h
+   for (i2 = -(lhy - 1); i2 < lhy; i2++) {
+      for (i1 = -(lhx - 1); i1 < lhx; i1++) {
+         ldb = 0;
+         for (j2 = TMath::Max(0, -i2); j2 < lhy && i2 + j2 < lhy; j2++) {
+            for (j1 = TMath::Max(0, -i1); j1 < lhx && i1 + j1 < lhx; j1++)
+               ldb += resp[j1][j2] * resp[i1 + j1][i2 + j2];
+         }
+         b[(i1 + lhx - 1)*nby + i2 + lhy - 1] = ldb;
+      }
+   }
+   for (Int_t repet = 0; repet < numberRepetitions; repet++) {
+      if (repet != 0) {
+         for (i = 0; i < ssizex*ssizey; i++) x[i] = TMath::Power(x[i], boost);
+      }
+      for (Int_t it = 0; it < numberIterations; it++) {
+         for (i2 = 0; i2 < ssizey; i2++) {
+            for (i1 = 0; i1 < ssizex; i1++) {
+               ldb = 0;
+               for (j2 = -TMath::Min(i2, lhy - 1); j2 <= TMath::Min(ssizey - i2 - 1, lhy - 1); j2++) {
+                  for (j1 = -TMath::Min(i1, lhx - 1); j1 <= TMath::Min(ssizex - i1 - 1, lhx - 1); j1++)
+                     ldb += x[(i1 + j1)*ssizey + i2 + j2] * b[(j1 + lhx - 1)*nby + j2 + lhy - 1];
+               }
+               Double_t xp = x[i1*ssizey + i2] * p[i1*ssizey + i2];
+               xn[i1*ssizey + i2] = (xp != 0 && ldb != 0) ? xp / ldb : 0;
+            }
+         }
+         for (i = 0; i < ssizex*ssizey; i++) x[i] = xn[i];
+      }
+   }
+   for (i = 0; i < ssizex; i++) {
+      for (j = 0; j < ssizey; j++)
+         source[(i + positx) % ssizex][(j + posity) % ssizey] = area * x[i*ssizey + j];
+   }
+   delete [] p;
+   delete [] x;
+   delete [] xn;
+   delete [] b;
+}
+
+Bool_t decon2(Int_t nbins, Double_t sigma, Int_t niter, Int_t nrep, Double_t boost, Double_t &maxdiff) {
+   // compare TSpectrum2::Deconvolution with the reference serial implementation
+   TRandom r(nbins);
+   Float_t  **source = new Float_t*[nbins];
+   Float_t  **resp   = new Float_t*[nbins];
+   Double_t **sref   = new Double_t*[nbins];
+   Double_t **rref   = new Double_t*[nbins];
+   Int_t i, j;
+   for (i = 0; i < nbins; i++) {
+      source[i] = new Float_t[nbins];
+      resp[i]   = new Float_t[nbins];
+      sref[i]   = new Double_t[nbins];
+      rref[i]   = new Double_t[nbins];
+   }
+   Double_t x[5], y[5], s[5];
+   for (Int_t p = 0; p < 5; p++) {
+      x[p] = r.Uniform(0.2*nbins, 0.8*nbins);
+      y[p] = r.Uniform(0.2*nbins, 0.8*nbins);
+      s[p] = r.Uniform(1.5*sigma, 3*sigma);
+   }
+   for (i = 0; i < nbins; i++) {
+      for (j = 0; j < nbins; j++) {
+         Double_t v = 10;
+         for (Int_t p = 0; p < 5; p++)
+            v += 1000*TMath::Gaus(i,x[p],s[p])*TMath::Gaus(j,y[p],s[p]);
+         source[i][j] = r.Poisson(v);
+         resp[i][j] = (Int_t)(1000*TMath::Gaus(i,3*sigma,sigma)*TMath::Gaus(j,3*sigma,sigma));
+         sref[i][j] = source[i][j];
+         rref[i][j] = resp[i][j];
+      }
+   }
+   TSpectrum2 s2;
+   s2.Deconvolution(source,resp,nbins,nbins,niter,nrep,boost);
+   deconvolutionRef(sref,rref,nbins,nbins,niter,nrep,boost);
+   Double_t vmax = 0;
+   maxdiff = 0;
+   for (i = 0; i < nbins; i++) {
+      for (j = 0; j < nbins; j++) {
+         vmax = TMath::Max(vmax, TMath::Abs(sref[i][j]));
+         maxdiff = TMath::Max(maxdiff, TMath::Abs(source[i][j] - sref[i][j]));
+      }
+   }
+   if (vmax > 0) maxdiff /= vmax;
+   for (i = 0; i < nbins; i++) {
+      delete [] source[i];
+      delete [] resp[i];
+      delete [] sref[i];
+      delete [] rref[i];
+   }
+   delete [] source;
+   delete [] resp;
+   delete [] sref;
+   delete [] rref;
+   return (maxdiff < 1.E-5);
+}
+
+void stress3() {
+   // small response (direct sum) and large response (FFT, when available)
+   Double_t diff1, diff2;
+   Bool_t ok1 = decon2(100, 2, 100, 2, 1.2, diff1);
+   Bool_t ok2 = decon2(128, 5, 20, 1, 1, diff2);
+   char sok[20];
+   if (ok1 && ok2) {
+      snprintf(sok,20,"OK");
+   } else {
+      snprintf(sok,20,"failed");
+   }
+   printf("Decon2: max rel. difference = %8.2g /%8.2g, tolerance 1e-5,-------- %s\n",
+          diff1,diff2,sok);
+}
    
 #ifndef __CINT__
 void stressSpectrum(Int_t ntimes) {
@@ -259,6 +408,7 @@ void stressSpectrum(Int_t ntimes=100) {
    gBenchmark->Start("stressSpectrum");
    stress1(ntimes);
    stress2(300);
+   stress3();
    gBenchmark->Stop ("stressSpectrum");
    Double_t reftime100 = 19.04; //pcbrun compiled
    Double_t ct = gBenchmark->GetCpuTime("stressSpectrum");